@@ -0,0 +1,162 @@
+"""
+Ingest throughput: events/s of ingest_path on a generated multi-million-line JSONL file.
+
+  python bench_ingest.py [--lines 2000000] [--modes row,batch,bulk] [--input FILE] [--json report.json]
+
+modes (fresh DB each):
+  row    one event per statement (BATCH_EVENTS=1, the old per-line path)
+  batch  run.py on a DB with events: executemany per BATCH_EVENTS events, one transaction per file
+  bulk   run.py --bulk / first import into an empty DB: batch + bulk_load
+         (pragmas, secondary indexes rebuilt after the load)
+
+The generated file looks like collector TEXT output: proc_start (with parent guid and
+cmdline heuristics), proc_end, net_connect, net_flow_summary, tag. --input ingests an
+existing file instead (collector / bench_pipeline output).
+"""
+import argparse
+import json
+import random
+import sys
+import tempfile
+import time
+from contextlib import nullcontext
+from pathlib import Path
+
+from minisysmon import ingest
+from minisysmon.db import bulk_load, init_db
+
+IMAGES = [
+    "C:\\Windows\\System32\\svchost.exe",
+    "C:\\Windows\\System32\\conhost.exe",
+    "C:\\Windows\\System32\\cmd.exe",
+    "C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe",
+    "C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe",
+    "C:\\Program Files\\Git\\mingw64\\bin\\git.exe",
+    "C:\\Users\\alice\\AppData\\Local\\Temp\\setup.exe",
+    "C:\\Users\\alice\\Downloads\\tool.exe",
+]
+TIERS = [0, 0, 0, 0, 1, 1, 2, 2]
+
+BATCH_DEFAULT = ingest.BATCH_EVENTS
+
+
+def _ts(ms: int) -> str:
+    s, ms = divmod(ms, 1000)
+    m, s = divmod(s, 60)
+    h, m = divmod(m, 60)
+    return f"2026-10-17T{h % 24:02d}:{m:02d}:{s:02d}.{ms:03d}Z"
+
+
+def generate(path: Path, lines: int, seed: int = 1) -> int:
+    """Process lifecycles interleaved: ~1 proc_start per 5 lines, 2/3 of them end."""
+    rng = random.Random(seed)
+    live = []           # (guid, pid)
+    next_pid = 4
+    ms = 0
+    n = 0
+    with path.open("w", encoding="utf-8", newline="\n") as f:
+        while n < lines:
+            ms += rng.randint(0, 3)
+            ts = _ts(ms)
+            r = rng.random()
+            if r < 0.2 or len(live) < 16:
+                guid = "p-%016x" % rng.getrandbits(64)
+                pid = next_pid
+                next_pid = 4 if next_pid >= 65532 else next_pid + 4
+                k = rng.randrange(len(IMAGES))
+                parent = live[rng.randrange(len(live))] if live else None
+                cmd = f"\"{IMAGES[k]}\" --id {rng.getrandbits(32):08x} --mode {rng.randrange(8)}"
+                evt = {
+                    "ts": ts, "event_type": "proc_start", "pid": pid,
+                    "ppid": parent[1] if parent else 4, "image": IMAGES[k], "cmdline": cmd,
+                    "host": "bench-host", "process_guid": guid,
+                    "parent_process_guid": parent[0] if parent and rng.random() < 0.9 else "",
+                    "risk_path_tier": TIERS[k], "cmd_flags": "", "base64_sus": 0,
+                }
+                live.append((guid, pid))
+                f.write(json.dumps(evt, separators=(",", ":")) + "\n")
+                n += 1
+                if TIERS[k] == 2 and n < lines:
+                    f.write(json.dumps({
+                        "ts": ts, "event_type": "tag", "process_guid": guid, "rule_id": "bench.user_path",
+                        "technique": "T1204", "severity": 10, "evidence": "user-writable image",
+                    }, separators=(",", ":")) + "\n")
+                    n += 1
+            elif r < 0.33:
+                guid, pid = live.pop(rng.randrange(len(live)))
+                f.write(json.dumps({"ts": ts, "event_type": "proc_end", "pid": pid, "process_guid": guid},
+                                   separators=(",", ":")) + "\n")
+                n += 1
+            elif r < 0.9:
+                guid, pid = live[rng.randrange(len(live))]
+                f.write(json.dumps({
+                    "ts": ts, "event_type": "net_connect", "pid": pid, "process_guid": guid,
+                    "src_ip": "10.0.0.5", "src_port": rng.randint(49152, 65535),
+                    "dst_ip": f"203.0.113.{rng.randrange(256)}", "dst_port": rng.choice((80, 443, 53, 8080)),
+                }, separators=(",", ":")) + "\n")
+                n += 1
+            else:
+                guid, pid = live[rng.randrange(len(live))]
+                f.write(json.dumps({
+                    "ts": ts, "event_type": "net_flow_summary", "pid": pid, "process_guid": guid,
+                    "dst_ip": f"203.0.113.{rng.randrange(256)}", "dst_port": 443, "proto": 6,
+                    "count": rng.randint(2, 50), "first_ts": _ts(max(ms - 5000, 0)), "last_ts": ts,
+                }, separators=(",", ":")) + "\n")
+                n += 1
+    return n
+
+
+def run_mode(mode: str, src: Path, work: Path) -> dict:
+    db = work / f"bench_{mode}.db"
+    for p in (db, db.with_name(db.name + "-wal"), db.with_name(db.name + "-shm")):
+        p.unlink(missing_ok=True)
+
+    conn = init_db(db)
+    ingest.BATCH_EVENTS = 1 if mode == "row" else BATCH_DEFAULT
+    t0 = time.perf_counter()
+    with bulk_load(conn) if mode == "bulk" else nullcontext():
+        n = ingest.ingest_path(conn, src)
+    dt = time.perf_counter() - t0
+    conn.close()
+    ingest.BATCH_EVENTS = BATCH_DEFAULT
+
+    res = {"mode": mode, "events": n, "seconds": round(dt, 3), "events_per_sec": round(n / dt) if dt else 0,
+           "db_bytes": db.stat().st_size}
+    print(f"  {mode:<6} {n} events  {dt:7.2f} s  {res['events_per_sec']:>8} ev/s", file=sys.stderr)
+    return res
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--lines", type=int, default=2_000_000, help="generated JSONL lines")
+    ap.add_argument("--input", default=None, help="ingest this file instead of generating one")
+    ap.add_argument("--modes", default="row,batch,bulk")
+    ap.add_argument("--dir", default=None, help="work directory for the file and DBs (default: temp)")
+    ap.add_argument("--json", default=None, help="write the result here (default: stdout)")
+    args = ap.parse_args()
+
+    with (nullcontext(args.dir) if args.dir else tempfile.TemporaryDirectory()) as d:
+        work = Path(d)
+        work.mkdir(parents=True, exist_ok=True)
+        if args.input:
+            src = Path(args.input)
+        else:
+            src = work / "bench_ingest.jsonl"
+            t0 = time.perf_counter()
+            generate(src, args.lines)
+            print(f"generated {args.lines} lines ({src.stat().st_size / 1e6:.0f} MB) "
+                  f"in {time.perf_counter() - t0:.1f} s", file=sys.stderr)
+
+        results = [run_mode(m.strip(), src, work) for m in args.modes.split(",") if m.strip()]
+        out = {"bench": "ingest", "input": str(src) if args.input else "generated",
+               "bytes": src.stat().st_size, "batch_events": BATCH_DEFAULT, "results": results}
+
+    text = json.dumps(out)
+    if args.json:
+        Path(args.json).write_text(text + "\n", encoding="utf-8")
+    else:
+        print(text)
+
+
+if __name__ == "__main__":
+    main()
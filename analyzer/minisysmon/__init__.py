@@ -1,6 +1,7 @@
 __all__ = [
     "db",
     "ingest",
+    "binlog",
     "correlate",
     "enrich",
     "tagger",
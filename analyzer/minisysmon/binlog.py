@@ -0,0 +1,320 @@
+"""
+Reader for the collector's binary telemetry format (controller/bin_format.h).
+
+Yields the same dicts json.loads would give for the TEXT output, without
+parsing JSON: varint fields, per-file host/image dictionary, CRC32 per record.
+"""
+import gzip
+import json
+import struct
+import zlib
+from datetime import datetime, timedelta
+from pathlib import Path
+from typing import Any, Dict, Iterator, Optional
+
+from .enrich import CMD_FLAG_KEYWORDS
+
+MAGIC = b"MSYB"
+VERSION = 1
+HEADER_SIZE = 8
+
+REC_DICT_RESET = 0x01
+REC_DICT = 0x02
+REC_TS_BASE = 0x03
+REC_PROC_START = 0x10
+REC_PROC_END = 0x11
+REC_NET_CONNECT = 0x12
+REC_NET_FLOW = 0x13
+REC_TAG = 0x14
+REC_STATS = 0x20
+
+NET_HAS_IMAGE = 0x01
+NET_HAS_PARENT = 0x02
+
+FLAG_TS_US = 0x01       # header flags: 6 fractional digits in ts (collector ts_digits)
+
+_FILETIME_EPOCH = datetime(1601, 1, 1)
+_U32 = struct.Struct("<I").unpack_from      # record crc
+
+
+class BinlogError(ValueError):
+    pass
+
+
+def _open(path: Path):
+    # 닫힌 segment는 .gz (collector의 background 압축)
+    return gzip.open(path, "rb") if path.suffix == ".gz" else path.open("rb")
+
+
+def is_binlog(path: Path) -> bool:
+    with _open(path) as f:
+        return f.read(4) == MAGIC
+
+
+class _TsCache:
+    """FILETIME(100ns) -> 'YYYY-MM-DDTHH:MM:SS.fffZ' (or .ffffffZ), prefix cached per second."""
+
+    __slots__ = ("sec", "prefix", "div", "frac_fmt")
+
+    def __init__(self, digits: int = 3):
+        self.sec = -1
+        self.prefix = ""
+        self.div = 10 ** (7 - digits)
+        self.frac_fmt = "%s.%0" + str(digits) + "dZ"
+
+    def format(self, ft: int) -> str:
+        sec, frac = divmod(ft, 10_000_000)
+        if sec != self.sec:
+            self.sec = sec
+            self.prefix = (_FILETIME_EPOCH + timedelta(seconds=sec)).strftime("%Y-%m-%dT%H:%M:%S")
+        return self.frac_fmt % (self.prefix, frac // self.div)
+
+
+def iter_events(path: Path, stats: Dict[str, Any] = None, start: int = 0,
+                state: Optional[Dict[str, Any]] = None) -> Iterator[Dict[str, Any]]:
+    """
+    start: resume offset, a record boundary from an earlier stats["end"].
+    state: the reader state at start (stats["state"] of that read): the file is
+    read from start on. Without it the file is read from the header, records
+    before start are not yielded, but dictionary / TS_BASE records are still
+    applied (later records refer to them).
+    Once exhausted, stats["end"] / ["last_off"] / ["last_record"] describe the
+    last complete record and stats["state"] the dictionary / TS_BASE in effect
+    after it; a record cut off by a collector still writing is left for the
+    next read.
+    """
+    with _open(path) as f:
+        head = f.read(HEADER_SIZE)
+        if head[:4] != MAGIC or len(head) < HEADER_SIZE or head[4] != VERSION:
+            raise BinlogError(f"not a binary telemetry file: {path}")
+        # segment 단위로 통째로 읽음 (collector rotation이 크기를 제한); resume은 start부터만
+        if state is not None and start > HEADER_SIZE:
+            f.seek(start)
+            base = start
+            data = f.read()
+        else:
+            base = 0
+            data = head + f.read()
+
+    mv = memoryview(data)
+    crc32 = zlib.crc32
+    ts_fmt = _TsCache(6 if head[5] & FLAG_TS_US else 3).format
+    d = data
+    end = len(data)
+    pos = 0 if base else HEADER_SIZE
+    skip_to = start - base
+    if base:
+        strings = dict(state["strings"])
+        ts_base = state["ts_base"]
+    else:
+        strings = {0: ""}
+        ts_base = 0
+    # packed guid / IPv4 -> text: 같은 process / 주소가 record마다 반복됨
+    guids = {}
+    ips = {}
+    st = stats if stats is not None else {}
+    st.setdefault("records", 0)
+    st.setdefault("crc_errors", 0)
+    st.setdefault("bad_records", 0)
+    st.setdefault("truncated", 0)
+    last_off = done = pos
+    records = 0
+
+    # varint: 대부분 1~2 byte -> 그 둘은 loop 없이
+    def varint(p):
+        b = d[p]
+        if b < 0x80:
+            return b, p + 1
+        c = d[p + 1]
+        if c < 0x80:
+            return (b & 0x7F) | c << 7, p + 2
+        v = (b & 0x7F) | (c & 0x7F) << 7
+        shift = 14
+        p += 2
+        while True:
+            b = d[p]
+            p += 1
+            v |= (b & 0x7F) << shift
+            if b < 0x80:
+                return v, p
+            shift += 7
+
+    def text(p):
+        n = d[p]
+        if n < 0x80:
+            p += 1
+        else:
+            n, p = varint(p)
+        return d[p:p + n].decode("utf-8", "replace"), p + n
+
+    # guid/ip tag는 거의 항상 1 byte (0, 1, 짧은 문자열 길이)
+    def guid(p):
+        tag = d[p]
+        if tag == 1:
+            k = d[p + 1:p + 9]
+            g = guids.get(k)
+            if g is None:
+                if len(k) < 8:
+                    raise IndexError
+                g = guids[k] = "p-" + k[::-1].hex()     # u64 LE -> %016x
+            return g, p + 9
+        if tag == 0:
+            return "", p + 1
+        tag, p = varint(p)
+        n = tag - 2
+        return d[p:p + n].decode("utf-8", "replace"), p + n
+
+    def ip(p):
+        tag = d[p]
+        if tag == 1:
+            k = d[p + 1:p + 5]
+            a = ips.get(k)
+            if a is None:
+                if len(k) < 4:
+                    raise IndexError
+                a = ips[k] = "%d.%d.%d.%d" % tuple(k)
+            return a, p + 5
+        if tag == 0:
+            return "", p + 1
+        tag, p = varint(p)
+        n = tag - 2
+        return d[p:p + n].decode("utf-8", "replace"), p + n
+
+    while pos < end:
+        try:
+            n, body = varint(pos)
+        except IndexError:
+            st["truncated"] += 1
+            break
+        rec_end = body + n
+        if rec_end + 4 > end:
+            st["truncated"] += 1
+            break
+        last_off, done, pos = pos, rec_end + 4, rec_end + 4
+        t = d[body]
+        if pos <= skip_to and t not in (REC_DICT, REC_TS_BASE, REC_DICT_RESET):
+            continue  # 이전 실행에서 ingest한 record: dictionary만 다시 적용
+        records += 1
+
+        if crc32(mv[body:rec_end]) != _U32(d, rec_end)[0]:
+            st["crc_errors"] += 1
+            continue
+
+        try:
+            if t == REC_DICT_RESET:
+                strings = {0: ""}
+                continue
+            z, p = varint(body + 1)     # ts (DICT: id, TS_BASE: base)
+            if t == REC_NET_CONNECT:
+                ts = ts_base + ((z >> 1) ^ -(z & 1))
+                pid, p = varint(p)
+                process_guid, p = guid(p)
+                src_ip, p = ip(p)
+                src_port, p = varint(p)
+                dst_ip, p = ip(p)
+                dst_port, p = varint(p)
+                flags = d[p]
+                p += 1
+                evt = {
+                    "ts": ts_fmt(ts), "event_type": "net_connect", "pid": pid,
+                    "process_guid": process_guid, "src_ip": src_ip, "src_port": src_port,
+                    "dst_ip": dst_ip, "dst_port": dst_port,
+                }
+                if flags & NET_HAS_IMAGE:
+                    image_id, p = varint(p)
+                    evt["image"] = strings[image_id]
+                if flags & NET_HAS_PARENT:
+                    evt["parent_process_guid"], p = guid(p)
+            elif t == REC_PROC_START:
+                ts = ts_base + ((z >> 1) ^ -(z & 1))
+                pid, p = varint(p)
+                ppid, p = varint(p)
+                image_id, p = varint(p)
+                cmdline, p = text(p)
+                host_id, p = varint(p)
+                process_guid, p = guid(p)
+                parent_guid, p = guid(p)
+                evt = {
+                    "ts": ts_fmt(ts), "event_type": "proc_start", "pid": pid, "ppid": ppid,
+                    "image": strings[image_id], "cmdline": cmdline, "host": strings[host_id],
+                    "process_guid": process_guid, "parent_process_guid": parent_guid,
+                }
+                if p < rec_end:     # cmd_scan (newer writers): flag bits, tier | base64_sus << 2
+                    cmd_flags, p = varint(p)
+                    v, p = varint(p)
+                    evt["risk_path_tier"] = v & 3
+                    evt["cmd_flags"] = ",".join(
+                        kw for i, kw in enumerate(CMD_FLAG_KEYWORDS) if cmd_flags >> i & 1)
+                    evt["base64_sus"] = v >> 2 & 1
+            elif t == REC_NET_FLOW:
+                ts = ts_base + ((z >> 1) ^ -(z & 1))
+                pid, p = varint(p)
+                process_guid, p = guid(p)
+                dst_ip, p = ip(p)
+                dst_port, p = varint(p)
+                proto, p = varint(p)
+                count, p = varint(p)
+                first_back, p = varint(p)
+                last_back, p = varint(p)
+                evt = {
+                    "ts": ts_fmt(ts), "event_type": "net_flow_summary", "pid": pid,
+                    "process_guid": process_guid, "dst_ip": dst_ip, "dst_port": dst_port,
+                    "proto": proto, "count": count,
+                    "first_ts": ts_fmt(ts - first_back), "last_ts": ts_fmt(ts - last_back),
+                }
+            elif t == REC_TAG:
+                ts = ts_base + ((z >> 1) ^ -(z & 1))
+                process_guid, p = guid(p)
+                rule_id, p = text(p)
+                technique, p = text(p)
+                z, p = varint(p)
+                evidence, p = text(p)
+                evt = {
+                    "ts": ts_fmt(ts), "event_type": "tag", "process_guid": process_guid,
+                    "rule_id": rule_id, "technique": technique,
+                    "severity": (z >> 1) ^ -(z & 1), "evidence": evidence,
+                }
+            elif t == REC_PROC_END:
+                ts = ts_base + ((z >> 1) ^ -(z & 1))
+                pid, p = varint(p)
+                process_guid, p = guid(p)
+                evt = {"ts": ts_fmt(ts), "event_type": "proc_end", "pid": pid, "process_guid": process_guid}
+            elif t == REC_STATS:
+                ts = ts_base + ((z >> 1) ^ -(z & 1))
+                host_id, p = varint(p)
+                fields, p = text(p)
+                evt = {"ts": ts_fmt(ts), "event_type": "collector_stats", "host": strings[host_id]}
+                evt.update(json.loads("{" + fields + "}"))
+            elif t == REC_DICT:
+                strings[z], p = text(p)
+                continue
+            elif t == REC_TS_BASE:
+                ts_base = z
+                continue
+            else:
+                continue  # newer record type
+        except (IndexError, KeyError, ValueError):
+            st["bad_records"] += 1
+            continue
+
+        if p > rec_end:
+            st["bad_records"] += 1
+            continue
+        yield evt
+
+    st["records"] += records
+    st["end"] = base + done
+    st["last_off"] = base + last_off
+    st["last_record"] = d[last_off:done]
+    st["state"] = {"strings": strings, "ts_base": ts_base}
+
+
+def state_to_text(state: Dict[str, Any]) -> str:
+    """stats["state"] -> text for the ingest checkpoint (ingest_checkpoints.state)."""
+    return json.dumps({"ts_base": state["ts_base"], "strings": list(state["strings"].items())},
+                      ensure_ascii=False, separators=(",", ":"))
+
+
+def state_from_text(text: str) -> Dict[str, Any]:
+    v = json.loads(text)
+    return {"ts_base": v["ts_base"], "strings": {int(k): s for k, s in v["strings"]}}
@@ -1,45 +1,59 @@
 import sqlite3
 
+# children still waiting for a parent: ingested this run (dirty=1), or earlier but
+# a process ingested this run has their ppid (the parent arrived in a later file)
+_PENDING = """
+SELECT process_guid, ppid, host, first_seen FROM processes
+WHERE dirty = 1 AND parent_guid IS NULL AND ppid IS NOT NULL AND parent_src = 0
+UNION
+SELECT c.process_guid, c.ppid, c.host, c.first_seen
+FROM (SELECT DISTINCT pid FROM processes WHERE dirty = 1) n
+JOIN processes c ON c.ppid = n.pid
+WHERE c.parent_guid IS NULL AND c.ppid IS NOT NULL AND c.parent_src = 0
+"""
 
-def correlate_parent_child(conn: sqlite3.Connection) -> None:
+
+def correlate_parent_child(conn: sqlite3.Connection) -> int:
     """
-    Very simple correlation:
+    Fallback correlation for processes the collector could not parent
+    (proc_start without parent_process_guid, e.g. parent started before the collector):
       child.ppid == parent.pid
       parent.first_seen <= child.first_seen
       same host (if host exists)
-      parent not ended before child starts (if ended time exists, we keep it simple here)
+    Rows with parent_src=1 already carry the collector's answer and are skipped.
+    Looks at rows ingested since the last run (dirty=1) and at older unresolved rows
+    whose ppid matches a process ingested since then. A child resolved that way is
+    marked dirty again, so enrich / tagger re-evaluate it with its parent.
+    Returns the number of rows considered.
     """
-    rows = conn.execute(
-        """
-        SELECT c.process_guid AS child_guid, c.host AS host, c.ppid AS ppid, c.first_seen AS child_ts
-        FROM processes c
-        WHERE c.parent_guid IS NULL AND c.ppid IS NOT NULL
-        """
-    ).fetchall()
-
-    for r in rows:
-        child_guid = r["child_guid"]
-        host = r["host"]
-        ppid = r["ppid"]
-        child_ts = r["child_ts"]
-
-        parent = conn.execute(
-            """
-            SELECT p.process_guid
-            FROM processes p
-            WHERE p.pid = ?
-              AND ( ? IS NULL OR p.host = ? )
-              AND p.first_seen <= ?
-            ORDER BY p.first_seen DESC
-            LIMIT 1
-            """,
-            (ppid, host, host, child_ts),
-        ).fetchone()
-
-        if parent:
-            conn.execute(
-                "UPDATE processes SET parent_guid=? WHERE process_guid=?",
-                (parent["process_guid"], child_guid),
-            )
+    # fast path: collector가 다 풀었으면 아무것도 안 함
+    pending = conn.execute(f"SELECT COUNT(*) FROM ({_PENDING})").fetchone()[0]
+    if not pending:
+        return 0
 
+    # 한 번의 UPDATE (child마다 SELECT 왕복 없음), idx_proc_dirty / idx_proc_unresolved / idx_proc_pid_ts 사용
+    # parent를 찾은 row만 바뀜
+    conn.execute(
+        f"""
+        WITH pending AS ({_PENDING}),
+        found AS (
+            SELECT c.process_guid AS guid, (
+                SELECT p.process_guid
+                FROM processes p
+                WHERE p.pid = c.ppid
+                  AND ( c.host IS NULL OR p.host = c.host )
+                  AND p.first_seen <= c.first_seen
+                  AND p.process_guid <> c.process_guid
+                ORDER BY p.first_seen DESC
+                LIMIT 1
+            ) AS parent_guid
+            FROM pending c
+        )
+        UPDATE processes
+        SET parent_guid = found.parent_guid, dirty = 1
+        FROM found
+        WHERE processes.process_guid = found.guid AND found.parent_guid IS NOT NULL
+        """
+    )
     conn.commit()
+    return pending
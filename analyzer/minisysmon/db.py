@@ -1,8 +1,114 @@
 import sqlite3
+from contextlib import contextmanager
 from pathlib import Path
+from typing import Iterator
 
 SCHEMA_PATH = Path(__file__).with_name("db_schema.sql")
 
+# columns added after the first schema: (table, column, decl)
+# CREATE TABLE IF NOT EXISTS does not touch existing DBs, so add them here
+MIGRATIONS = [
+    ("processes", "parent_src", "INTEGER DEFAULT 0"),
+    ("netflows", "cnt", "INTEGER DEFAULT 1"),
+    ("netflows", "last_ts", "TEXT"),
+    ("processes", "enriched", "INTEGER DEFAULT 0"),
+    ("processes", "dirty", "INTEGER DEFAULT 1"),
+    ("netflows", "image", "TEXT"),
+    ("netflows", "parent_guid", "TEXT"),
+    ("ingest_checkpoints", "state", "TEXT"),
+]
+
+# indexes on migrated columns: the schema script runs before _migrate
+MIGRATION_INDEXES = [
+    # correlate / enrich / tagger: only rows ingested since the last run
+    "CREATE INDEX IF NOT EXISTS idx_proc_dirty ON processes(dirty) WHERE dirty = 1",
+    # correlate: older children still without a parent, by ppid
+    "CREATE INDEX IF NOT EXISTS idx_proc_unresolved ON processes(ppid) "
+    "WHERE parent_guid IS NULL AND ppid IS NOT NULL AND parent_src = 0",
+]
+
+
+def _migrate(conn: sqlite3.Connection) -> None:
+    for table, column, decl in MIGRATIONS:
+        cols = {r["name"] for r in conn.execute(f"PRAGMA table_info({table})")}
+        if column not in cols:
+            conn.execute(f"ALTER TABLE {table} ADD COLUMN {column} {decl}")
+    for sql in MIGRATION_INDEXES:
+        conn.execute(sql)
+    conn.commit()
+
+
+# secondary indexes nothing reads during ingest: bulk_load drops them and rebuilds once
+# (idx_tags_guid stays: the tag insert checks (process_guid, rule_id) per row)
+BULK_DEFERRED_INDEXES = (
+    "idx_events_type_ts",
+    "idx_events_guid_ts",
+    "idx_proc_pid_ts",
+    "idx_proc_parent",
+    "idx_proc_dirty",
+    "idx_proc_unresolved",
+    "idx_nf_guid_ts",
+    "idx_nf_dst",
+    "idx_tags_rule",
+)
+
+BULK_CACHE_KIB = 256 * 1024
+
+
+@contextmanager
+def bulk_load(conn: sqlite3.Connection) -> Iterator[None]:
+    """
+    For big loads (first import of a long history, backfill):
+      - synchronous=OFF: no fsync per commit. An OS crash mid-load can lose or damage
+        the DB, which is rebuilt from the collector output
+      - a 256 MiB page cache, temp b-trees in memory
+      - BULK_DEFERRED_INDEXES dropped for the load, rebuilt once at the end: one sort
+        per index instead of a b-tree insert per row
+    Everything is restored on exit. On an exception the open transaction is rolled back
+    (rows the load did not commit together with their checkpoint are dropped), then the
+    indexes and pragmas are restored the same way. If the process dies inside, init_db
+    recreates the indexes on the next start (schema / MIGRATION_INDEXES).
+    """
+    names = ",".join("?" * len(BULK_DEFERRED_INDEXES))
+    deferred = conn.execute(
+        f"SELECT name, sql FROM sqlite_master WHERE type='index' AND name IN ({names})",
+        BULK_DEFERRED_INDEXES,
+    ).fetchall()
+    synchronous = conn.execute("PRAGMA synchronous").fetchone()[0]
+    cache_size = conn.execute("PRAGMA cache_size").fetchone()[0]
+    temp_store = conn.execute("PRAGMA temp_store").fetchone()[0]
+
+    conn.execute("PRAGMA synchronous=OFF")
+    conn.execute(f"PRAGMA cache_size=-{BULK_CACHE_KIB}")
+    conn.execute("PRAGMA temp_store=MEMORY")
+    for r in deferred:
+        conn.execute(f"DROP INDEX IF EXISTS {r['name']}")
+    conn.commit()
+    try:
+        yield
+    except BaseException:
+        # 예외 전의 미완성 batch: checkpoint 없이 commit하면 다음 실행에서 중복
+        conn.rollback()
+        raise
+    else:
+        conn.commit()
+    finally:
+        for r in deferred:
+            conn.execute(r["sql"])
+        conn.commit()
+        conn.execute(f"PRAGMA synchronous={synchronous}")
+        conn.execute(f"PRAGMA cache_size={cache_size}")
+        conn.execute(f"PRAGMA temp_store={temp_store}")
+        # load 전체가 WAL에 쌓여 있음: DB 파일로 옮기고 WAL을 비움
+        conn.execute("PRAGMA wal_checkpoint(TRUNCATE)")
+
+
+def clear_dirty(conn: sqlite3.Connection) -> int:
+    """After correlate / enrich / tagger: the next run starts from newly ingested rows."""
+    n = conn.execute("UPDATE processes SET dirty = 0 WHERE dirty = 1").rowcount
+    conn.commit()
+    return n
+
 
 def init_db(db_path: Path) -> sqlite3.Connection:
     conn = sqlite3.connect(str(db_path))
@@ -13,4 +119,5 @@ def init_db(db_path: Path) -> sqlite3.Connection:
 
     schema = SCHEMA_PATH.read_text(encoding="utf-8")
     conn.executescript(schema)
+    _migrate(conn)
     return conn
@@ -23,11 +23,14 @@ CREATE TABLE IF NOT EXISTS processes (
   ended INTEGER DEFAULT 0,
 
   parent_guid TEXT,
+  parent_src INTEGER DEFAULT 0,   -- 1: parent_process_guid from collector (skip correlate)
   score INTEGER DEFAULT 0,
 
   risk_path_tier INTEGER DEFAULT 0,
   cmd_flags TEXT DEFAULT "",
-  base64_sus INTEGER DEFAULT 0
+  base64_sus INTEGER DEFAULT 0,
+  enriched INTEGER DEFAULT 0,     -- 1: risk_path_tier..base64_sus set, score added (collector or enrich.py)
+  dirty INTEGER DEFAULT 1         -- 1: added / updated by ingest since the last correlate / enrich / tag pass
 );
 
 CREATE INDEX IF NOT EXISTS idx_proc_pid_ts ON processes(pid, first_seen);
@@ -40,6 +43,10 @@ CREATE TABLE IF NOT EXISTS netflows (
   pid INTEGER,
   src_ip TEXT, src_port INTEGER,
   dst_ip TEXT, dst_port INTEGER,
+  cnt INTEGER DEFAULT 1,          -- net_flow_summary: connections folded (ts..last_ts)
+  last_ts TEXT,
+  image TEXT,                     -- net_connect: inlined by the collector (NET_INLINE_PROCESS), else NULL
+  parent_guid TEXT,
   FOREIGN KEY(process_guid) REFERENCES processes(process_guid)
 );
 
@@ -59,3 +66,16 @@ CREATE TABLE IF NOT EXISTS tags (
 
 CREATE INDEX IF NOT EXISTS idx_tags_guid ON tags(process_guid);
 CREATE INDEX IF NOT EXISTS idx_tags_rule ON tags(rule_id);
+
+-- ingest resume point per input file (ingest.py _ingest_file)
+CREATE TABLE IF NOT EXISTS ingest_checkpoints (
+  file_key TEXT PRIMARY KEY,      -- resolved path without .gz (a segment compressed in place is the same file)
+  path TEXT,                      -- file actually read
+  file_id TEXT,                   -- st_dev:st_ino
+  size INTEGER,                   -- file size before that read (compressed size for .gz)
+  end_off INTEGER,                -- bytes consumed (decompressed), a record boundary
+  last_off INTEGER,               -- [last_off, end_off): last record consumed
+  last_hash TEXT,                 -- blake2b-64 of that record: same file, same place?
+  state TEXT,                     -- binary: dictionary / ts_base at end_off (binlog.state_to_text)
+  updated_ts TEXT
+);
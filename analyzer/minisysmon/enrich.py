@@ -34,9 +34,24 @@ def _tier_from_image(image: str | None) -> int:
     return 1  # unknown / medium
 
 
+def enrich_score(tier: int, n_flags: int, base64_sus: int) -> int:
+    # 점수(아주 단순) - collector가 계산한 proc_start(ingest)도 같은 점수
+    score = 0
+    if tier == 2:
+        score += 15
+    elif tier == 1:
+        score += 5
+    score += 8 * n_flags
+    if base64_sus:
+        score += 15
+    return score
+
+
 def enrich_processes(conn: sqlite3.Connection) -> None:
+    # collector (cmd_scan) 결과가 있는 process / 이전 실행에서 한 process: 건너뜀 (score 중복 방지)
+    # 이번 실행에서 들어온 row만 (idx_proc_dirty)
     rows = conn.execute(
-        "SELECT process_guid, image, cmdline FROM processes"
+        "SELECT process_guid, image, cmdline FROM processes WHERE dirty=1 AND enriched=0"
     ).fetchall()
 
     for r in rows:
@@ -54,23 +69,13 @@ def enrich_processes(conn: sqlite3.Connection) -> None:
 
         base64_sus = 1 if BASE64_LIKE.search(cmdline) else 0
 
-        # 점수(아주 단순)
-        score = 0
-        if tier == 2:
-            score += 15
-        elif tier == 1:
-            score += 5
-        score += 8 * len(flags)
-        if base64_sus:
-            score += 15
-
         conn.execute(
             """
             UPDATE processes
-            SET risk_path_tier=?, cmd_flags=?, base64_sus=?, score=score+?
+            SET risk_path_tier=?, cmd_flags=?, base64_sus=?, score=score+?, enriched=1
             WHERE process_guid=?
             """,
-            (tier, ",".join(flags), base64_sus, score, guid),
+            (tier, ",".join(flags), base64_sus, enrich_score(tier, len(flags), base64_sus), guid),
         )
 
     conn.commit()
@@ -1,7 +1,13 @@
+import gzip
+import hashlib
 import json
+import os
 import sqlite3
 from pathlib import Path
-from typing import Any, Dict
+from typing import Any, Dict, List, Optional
+
+from . import binlog
+from .enrich import enrich_score
 
 
 def _safe_get(d: Dict[str, Any], key: str, default=None):
@@ -9,81 +15,442 @@ def _safe_get(d: Dict[str, Any], key: str, default=None):
     return v if v is not None else default
 
 
-def ingest_jsonl(conn: sqlite3.Connection, jsonl_path: Path) -> int:
+def _in_range(ts: str, since: Optional[str], until: Optional[str]) -> bool:
+    """ISO8601 strings compare as text. until is inclusive at its own precision ("2026-10-17" = whole day)."""
+    if since and ts < since:
+        return False
+    if until and ts[:len(until)] > until:
+        return False
+    return True
+
+
+def _record_hash(raw: bytes) -> str:
+    return hashlib.blake2b(raw, digest_size=8).hexdigest()
+
+
+def ingest_jsonl(conn: sqlite3.Connection, jsonl_path: Path,
+                 since: Optional[str] = None, until: Optional[str] = None,
+                 cursor: Optional[Dict[str, Any]] = None) -> int:
     """
     Expected minimal event formats (collector output):
-      proc_start: ts, event_type, pid, ppid, image, cmdline, host, process_guid
+      proc_start: ts, event_type, pid, ppid, image, cmdline, host, process_guid, parent_process_guid
       proc_end:   ts, event_type, pid, process_guid
       net_connect:ts, event_type, pid, process_guid, src_ip, src_port, dst_ip, dst_port
+                  [+ image, parent_process_guid when the collector inlines them]
+      net_flow_summary: ts, event_type, pid, process_guid, dst_ip, dst_port, proto,
+                  count, first_ts, last_ts (repeats of a flow folded by the collector)
+      tag:        ts, event_type, process_guid, rule_id, technique, severity, evidence
+                  (rule fired in the collector at process start, right after its proc_start)
+    .gz segments are decompressed while reading (no temp file).
+    Lines are parsed BATCH_EVENTS at a time and written through _EventBatch.
+
+    cursor (incremental ingest): {"end_off": byte offset to resume from}; on return
+    end_off / last_off / last_hash of the last line consumed. A last line without
+    its newline (collector mid-write) is left for the next read. The caller
+    commits, together with the checkpoint.
     """
     n = 0
-    with jsonl_path.open("r", encoding="utf-8") as f:
+    ranged = since or until
+    opener = gzip.open if jsonl_path.suffix == ".gz" else open
+    pos = cursor["end_off"] if cursor else 0
+    last = None
+    batch = _EventBatch(conn)
+    lines: List[str] = []
+
+    def store() -> int:
+        # BATCH_EVENTS줄을 json.loads 한 번으로 (잘못된 줄이 있으면 줄 단위로 다시: 그 줄에서 예외)
+        try:
+            evts = json.loads("[" + ",".join(lines) + "]")
+            if len(evts) != len(lines):
+                raise ValueError("line is not one JSON value")
+        except ValueError:
+            evts = [json.loads(line) for line in lines]
+        k = 0
+        for evt, line in zip(evts, lines):
+            if ranged and not _in_range(str(evt.get("ts") or ""), since, until):
+                continue
+            batch.add(evt, line)
+            k += 1
+        lines.clear()
+        return k
+
+    with opener(jsonl_path, "rb") as f:
+        if pos:
+            f.seek(pos)
+        for raw in f:
+            if cursor is not None and not raw.endswith(b"\n"):
+                break
+            last = (pos, raw)
+            pos += len(raw)
+            line = raw.decode("utf-8").strip()
+            if not line:
+                continue
+            lines.append(line)
+            if len(lines) >= BATCH_EVENTS:
+                n += store()
+    n += store()
+    batch.flush()
+
+    if cursor is None:
+        conn.commit()
+    elif last:
+        cursor.update(end_off=pos, last_off=last[0], last_hash=_record_hash(last[1]))
+    return n
+
+
+def ingest_binlog(conn: sqlite3.Connection, bin_path: Path,
+                  since: Optional[str] = None, until: Optional[str] = None,
+                  cursor: Optional[Dict[str, Any]] = None) -> int:
+    """
+    Binary collector output (binlog.py): same events, no json.loads per line.
+    events.raw_json is left empty (the .msb file is the raw record), except for
+    collector_stats whose counters only live there.
+    cursor: as in ingest_jsonl (record boundaries instead of lines), plus "state":
+    the dictionary / TS_BASE at end_off (binlog.state_to_text). With it a resume
+    reads only what follows end_off; without it (older checkpoint) the whole file.
+    """
+    n = 0
+    ranged = since or until
+    stats: Dict[str, Any] = {}
+    start = cursor["end_off"] if cursor else 0
+    state = binlog.state_from_text(cursor["state"]) if cursor and cursor.get("state") else None
+    batch = _EventBatch(conn)
+    for evt in binlog.iter_events(bin_path, stats, start, state):
+        if ranged and not _in_range(evt["ts"], since, until):
+            continue
+        raw = json.dumps(evt) if evt["event_type"] == "collector_stats" else ""
+        batch.add(evt, raw)
+        n += 1
+    batch.flush()
+
+    # incremental: a cut-off last record is the collector still writing (next run reads it)
+    truncated = stats["truncated"] if cursor is None else 0
+    if stats["crc_errors"] or stats["bad_records"] or truncated:
+        print(f"[!] {bin_path}: crc_errors={stats['crc_errors']} bad={stats['bad_records']} "
+              f"truncated={truncated}")
+    if cursor is None:
+        conn.commit()
+    elif stats["end"] > max(start, binlog.HEADER_SIZE):
+        cursor.update(end_off=stats["end"], last_off=stats["last_off"],
+                      last_hash=_record_hash(stats["last_record"]),
+                      state=binlog.state_to_text(stats["state"]))
+    return n
+
+
+# ============================================================
+# checkpoints: each run reads only what the collector appended since the last one
+# ============================================================
+def _file_key(path: Path) -> str:
+    """A segment compressed in place (x -> x.gz) keeps its checkpoint."""
+    p = path.resolve()
+    return str(p.with_suffix("") if p.suffix == ".gz" else p)
+
+
+def _file_id(st: os.stat_result) -> str:
+    return f"{st.st_dev}:{st.st_ino}"
+
+
+def _read_at(path: Path, off: int, n: int) -> bytes:
+    opener = gzip.open if path.suffix == ".gz" else open
+    with opener(path, "rb") as f:
+        f.seek(off)
+        return f.read(n)
+
+
+def _resume_cursor(conn: sqlite3.Connection, path: Path, st: os.stat_result) -> Optional[Dict[str, Any]]:
+    """
+    None: unchanged since the checkpoint (same file, same size), nothing to read.
+    Otherwise the cursor to continue from: the checkpoint (end_off, binary reader
+    state) when the last record consumed is still there byte for byte (appended
+    to, or compressed in place), else offset 0 (truncated, or rotated / replaced
+    by another file at the same path).
+    """
+    cp = conn.execute(
+        "SELECT * FROM ingest_checkpoints WHERE file_key=?", (_file_key(path),)
+    ).fetchone()
+    if cp is None or not cp["end_off"]:
+        return {"end_off": 0}
+    if cp["file_id"] == _file_id(st) and cp["size"] == st.st_size:
+        return None
+
+    # 뒤에 붙었거나 .gz로 바뀐 것: 마지막 record 하나만 비교 (gz는 그 위치까지 풀어야 함)
+    n = cp["end_off"] - cp["last_off"]
+    if _record_hash(_read_at(path, cp["last_off"], n)) == cp["last_hash"]:
+        return {"end_off": cp["end_off"], "state": cp["state"]}
+    print(f"[!] {path}: changed since its checkpoint (truncated or rotated), reading from the start")
+    return {"end_off": 0}
+
+
+def _save_checkpoint(conn: sqlite3.Connection, path: Path, st: os.stat_result,
+                     cursor: Dict[str, Any]) -> None:
+    conn.execute(
+        """
+        INSERT INTO ingest_checkpoints(file_key, path, file_id, size, end_off, last_off, last_hash, state, updated_ts)
+        VALUES(?,?,?,?,?,?,?,?, strftime('%Y-%m-%dT%H:%M:%SZ', 'now'))
+        ON CONFLICT(file_key) DO UPDATE SET
+          path=excluded.path,
+          file_id=excluded.file_id,
+          size=excluded.size,
+          end_off=excluded.end_off,
+          last_off=COALESCE(excluded.last_off, ingest_checkpoints.last_off),
+          last_hash=COALESCE(excluded.last_hash, ingest_checkpoints.last_hash),
+          state=excluded.state,
+          updated_ts=excluded.updated_ts
+        """,
+        (_file_key(path), str(path), _file_id(st), st.st_size, cursor["end_off"],
+         cursor.get("last_off"), cursor.get("last_hash"), cursor.get("state")),
+    )
+
+
+def _ingest_file(conn: sqlite3.Connection, path: Path,
+                 since: Optional[str] = None, until: Optional[str] = None) -> int:
+    """
+    JSONL or binary (optionally .gz), decided by the file's magic bytes.
+    Continues from the file's checkpoint; the new rows and the moved checkpoint
+    commit together, so an interrupted run re-reads nothing twice.
+    A --since / --until slice is a one-off read: checkpoints are neither used nor moved.
+    """
+    if since or until:
+        ingest = ingest_binlog if binlog.is_binlog(path) else ingest_jsonl
+        return ingest(conn, path, since, until)
+
+    # 읽기 전의 크기: 읽는 동안 붙은 것은 다음 실행에서 size가 달라 확인함
+    st = path.stat()
+    cursor = _resume_cursor(conn, path, st)
+    if cursor is None:
+        return 0
+    ingest = ingest_binlog if binlog.is_binlog(path) else ingest_jsonl
+    n = ingest(conn, path, cursor=cursor)
+    _save_checkpoint(conn, path, st, cursor)
+    conn.commit()
+    return n
+
+
+def index_path_for(path: Path) -> Path:
+    """Rotation index written by the collector next to its base output name."""
+    return path if path.name.endswith(".index") else path.with_name(path.name + ".index")
+
+
+def select_segments(index_path: Path, since: Optional[str] = None,
+                    until: Optional[str] = None) -> List[Path]:
+    """
+    Closed segments from the index whose [first_ts, last_ts] overlaps the range, in order.
+    A segment listed as .gz whose compression has not finished yet is read uncompressed.
+    """
+    segments = []
+    with index_path.open("r", encoding="utf-8") as f:
         for line in f:
             line = line.strip()
             if not line:
                 continue
+            ent = json.loads(line)
+            if since and ent["last_ts"] < since:
+                continue
+            if until and ent["first_ts"][:len(until)] > until:
+                continue
 
-            evt = json.loads(line)
-            n += 1
-
-            ts = str(_safe_get(evt, "ts", ""))
-            event_type = str(_safe_get(evt, "event_type", "unknown"))
-            pid = _safe_get(evt, "pid")
-            ppid = _safe_get(evt, "ppid")
-            process_guid = _safe_get(evt, "process_guid")
-            raw_json = line
-
-            conn.execute(
-                "INSERT INTO events(ts, event_type, pid, ppid, process_guid, raw_json) VALUES(?,?,?,?,?,?)",
-                (ts, event_type, pid, ppid, process_guid, raw_json),
-            )
-
-            if event_type == "proc_start":
-                host = _safe_get(evt, "host")
-                image = _safe_get(evt, "image")
-                cmdline = _safe_get(evt, "cmdline")
-                conn.execute(
-                    """
-                    INSERT INTO processes(process_guid, host, pid, ppid, image, cmdline, first_seen, last_seen, ended)
-                    VALUES(?,?,?,?,?,?,?, ?, 0)
-                    ON CONFLICT(process_guid) DO UPDATE SET
-                      host=COALESCE(excluded.host, processes.host),
-                      pid=COALESCE(excluded.pid, processes.pid),
-                      ppid=COALESCE(excluded.ppid, processes.ppid),
-                      image=COALESCE(excluded.image, processes.image),
-                      cmdline=COALESCE(excluded.cmdline, processes.cmdline),
-                      first_seen=COALESCE(processes.first_seen, excluded.first_seen),
-                      last_seen=excluded.last_seen
-                    """,
-                    (process_guid, host, pid, ppid, image, cmdline, ts, ts),
-                )
-
-            elif event_type == "proc_end":
-                conn.execute(
-                    """
-                    UPDATE processes
-                    SET last_seen = ?, ended = 1
-                    WHERE process_guid = ?
-                    """,
-                    (ts, process_guid),
-                )
-
-            elif event_type == "net_connect":
-                conn.execute(
-                    """
-                    INSERT INTO netflows(ts, process_guid, pid, src_ip, src_port, dst_ip, dst_port)
-                    VALUES(?,?,?,?,?,?,?)
-                    """,
-                    (
-                        ts,
-                        process_guid,
-                        pid,
-                        _safe_get(evt, "src_ip"),
-                        _safe_get(evt, "src_port"),
-                        _safe_get(evt, "dst_ip"),
-                        _safe_get(evt, "dst_port"),
-                    ),
-                )
+            p = index_path.parent / ent["path"]
+            if not p.exists() and p.suffix == ".gz":
+                p = p.with_suffix("")
+            if not p.exists():
+                print(f"[!] segment missing: {p}")
+                continue
+            segments.append((ent["seq"], p))
 
-    conn.commit()
+    segments.sort(key=lambda x: x[0])
+    return [p for _, p in segments]
+
+
+def ingest_segments(conn: sqlite3.Connection, index_path: Path,
+                    since: Optional[str] = None, until: Optional[str] = None) -> int:
+    n = 0
+    for seg in select_segments(index_path, since, until):
+        n += _ingest_file(conn, seg, since, until)
     return n
+
+
+def ingest_path(conn: sqlite3.Connection, path: Path,
+                since: Optional[str] = None, until: Optional[str] = None) -> int:
+    """
+    A single output file (JSONL / binary, plain or .gz), or rotated segments:
+    either the .index itself or the collector's base output name next to it.
+    """
+    idx = index_path_for(path)
+    if idx.exists() and (path == idx or not path.exists()):
+        return ingest_segments(conn, idx, since, until)
+    return _ingest_file(conn, path, since, until)
+
+
+# ============================================================
+# batched writes: rows collected per statement, one executemany each
+# (was up to three conn.execute per event)
+# ============================================================
+BATCH_EVENTS = 5000
+
+_SQL_EVENT = "INSERT INTO events(ts, event_type, pid, ppid, process_guid, raw_json) VALUES(?,?,?,?,?,?)"
+
+# 끝의 5개: collector가 계산한 cmdline heuristics (cmd_scan.h), enriched=1이면 enrich.py는 건너뜀
+# 이미 있는 row는 아직 enriched=0일 때만 받음 (proc_start가 두 번 온 경우 score 한 번)
+# first_seen: 더 이른 쪽. net_connect가 먼저 만든 row(_SQL_NET_PROCESS)는 connect의 ts를 갖고 있음
+_SQL_PROC_START = """
+INSERT INTO processes(process_guid, host, pid, ppid, image, cmdline, first_seen, last_seen, ended,
+                      parent_guid, parent_src, risk_path_tier, cmd_flags, base64_sus, score, enriched)
+VALUES(?,?,?,?,?,?,?, ?, 0, ?, ?, ?, ?, ?, ?, ?)
+ON CONFLICT(process_guid) DO UPDATE SET
+  host=COALESCE(excluded.host, processes.host),
+  pid=COALESCE(excluded.pid, processes.pid),
+  ppid=COALESCE(excluded.ppid, processes.ppid),
+  image=COALESCE(excluded.image, processes.image),
+  cmdline=COALESCE(excluded.cmdline, processes.cmdline),
+  first_seen=MIN(COALESCE(NULLIF(processes.first_seen, ''), excluded.first_seen),
+                 COALESCE(NULLIF(excluded.first_seen, ''), processes.first_seen)),
+  last_seen=excluded.last_seen,
+  parent_guid=COALESCE(excluded.parent_guid, processes.parent_guid),
+  parent_src=MAX(excluded.parent_src, processes.parent_src),
+  risk_path_tier=CASE WHEN excluded.enriched > processes.enriched THEN excluded.risk_path_tier ELSE processes.risk_path_tier END,
+  cmd_flags=CASE WHEN excluded.enriched > processes.enriched THEN excluded.cmd_flags ELSE processes.cmd_flags END,
+  base64_sus=CASE WHEN excluded.enriched > processes.enriched THEN excluded.base64_sus ELSE processes.base64_sus END,
+  score=processes.score + CASE WHEN excluded.enriched > processes.enriched THEN excluded.score ELSE 0 END,
+  enriched=MAX(excluded.enriched, processes.enriched),
+  dirty=1
+"""
+
+_SQL_PROC_END = """
+UPDATE processes
+SET last_seen = ?, ended = 1
+WHERE process_guid = ?
+"""
+
+# image / parent_guid: collector가 inline한 경우만 (proc_start 없이도 report에 image가 나옴)
+_SQL_NET_CONNECT = """
+INSERT INTO netflows(ts, process_guid, pid, src_ip, src_port, dst_ip, dst_port, image, parent_guid)
+VALUES(?,?,?,?,?,?,?,?,?)
+"""
+
+# net_connect의 process가 processes에 없을 때 (proc_start를 못 본 process: collector 시작 전부터 실행 중 등)
+# netflows FK를 위한 row, inline된 image / parent guid가 있으면 채움. 있는 row는 그대로
+_SQL_NET_PROCESS = """
+INSERT INTO processes(process_guid, pid, image, first_seen, last_seen, parent_guid, parent_src)
+VALUES(?,?,?,?,?,?,?)
+ON CONFLICT(process_guid) DO NOTHING
+"""
+
+# 반복된 net_connect 묶음: 첫 연결은 net_connect로 이미 들어옴
+_SQL_NET_FLOW = """
+INSERT INTO netflows(ts, process_guid, pid, dst_ip, dst_port, cnt, last_ts)
+VALUES(?,?,?,?,?,?,?)
+"""
+
+# collector가 rules를 이미 평가함: tagger.apply_rules는 같은 (process, rule)을 건너뜀
+# 같은 process의 proc_start가 두 번 온 경우: 한 번만 (tagger와 같음)
+_SQL_TAG = """
+INSERT INTO tags(ts, process_guid, rule_id, technique, severity, evidence)
+SELECT ?,?,?,?,?,?
+WHERE NOT EXISTS (SELECT 1 FROM tags WHERE process_guid=? AND rule_id=?)
+"""
+
+# executemany는 row별 rowcount가 없음: 이번 batch에서 실제로 들어간 tag (id > ?)만 합산
+_SQL_TAG_SCORE = """
+UPDATE processes
+SET score = score + (SELECT SUM(t.severity) FROM tags t
+                     WHERE t.id > ? AND t.process_guid = processes.process_guid)
+WHERE process_guid IN (SELECT process_guid FROM tags WHERE id > ?)
+"""
+
+
+# schema defaults: enrich.py fills these later
+_NO_SCAN = (0, "", 0, 0, 0)
+
+
+class _EventBatch:
+    """
+    Rows of up to BATCH_EVENTS events, written by flush() in dependency order:
+    processes first, then proc_end / netflows / tags that refer to them.
+    A proc_start for a process whose proc_end is still pending flushes first,
+    so last_seen ends up as if written one event at a time.
+    """
+
+    def __init__(self, conn: sqlite3.Connection):
+        self.conn = conn
+        self.limit = BATCH_EVENTS
+        self._reset()
+
+    def _reset(self) -> None:
+        self.events: List[tuple] = []
+        self.starts: List[tuple] = []
+        self.ends: List[tuple] = []
+        self.ended = set()
+        self.connects: List[tuple] = []
+        self.net_procs: Dict[str, tuple] = {}
+        self.flows: List[tuple] = []
+        self.tags: List[tuple] = []
+
+    def add(self, evt: Dict[str, Any], raw_json: str) -> None:
+        ts = str(_safe_get(evt, "ts", ""))
+        event_type = str(_safe_get(evt, "event_type", "unknown"))
+        pid = evt.get("pid")
+        process_guid = evt.get("process_guid")
+        if event_type == "proc_start" and process_guid in self.ended:
+            self.flush()
+
+        self.events.append((ts, event_type, pid, evt.get("ppid"), process_guid, raw_json))
+
+        if event_type == "proc_start":
+            # collector가 시작 시점에 ppid를 풀어둔 경우: correlate 불필요
+            parent_guid = evt.get("parent_process_guid") or None
+            if "risk_path_tier" in evt:
+                tier = int(evt["risk_path_tier"])
+                cmd_flags = _safe_get(evt, "cmd_flags", "")
+                base64_sus = int(_safe_get(evt, "base64_sus", 0))
+                n_flags = len(cmd_flags.split(",")) if cmd_flags else 0
+                scan = (tier, cmd_flags, base64_sus, enrich_score(tier, n_flags, base64_sus), 1)
+            else:
+                scan = _NO_SCAN
+            self.starts.append((process_guid, evt.get("host"), pid, evt.get("ppid"), evt.get("image"),
+                                evt.get("cmdline"), ts, ts, parent_guid, 1 if parent_guid else 0) + scan)
+
+        elif event_type == "proc_end":
+            self.ends.append((ts, process_guid))
+            self.ended.add(process_guid)
+
+        elif event_type == "net_connect":
+            image = evt.get("image") or None
+            parent_guid = evt.get("parent_process_guid") or None
+            self.connects.append((ts, process_guid, pid, evt.get("src_ip"), evt.get("src_port"),
+                                  evt.get("dst_ip"), evt.get("dst_port"), image, parent_guid))
+            if process_guid and process_guid not in self.net_procs:
+                self.net_procs[process_guid] = (process_guid, pid, image, ts, ts, parent_guid,
+                                                1 if parent_guid else 0)
+
+        elif event_type == "net_flow_summary":
+            self.flows.append((str(_safe_get(evt, "first_ts", ts)), process_guid, pid, evt.get("dst_ip"),
+                               evt.get("dst_port"), int(_safe_get(evt, "count", 1)), evt.get("last_ts")))
+
+        elif event_type == "tag":
+            rule_id = _safe_get(evt, "rule_id", "rule.unknown")
+            self.tags.append((ts, process_guid, rule_id, evt.get("technique") or None,
+                              int(_safe_get(evt, "severity", 0)), _safe_get(evt, "evidence", ""),
+                              process_guid, rule_id))
+
+        if len(self.events) >= self.limit:
+            self.flush()
+
+    def flush(self) -> None:
+        conn = self.conn
+        if self.events:
+            conn.executemany(_SQL_EVENT, self.events)
+        if self.starts:
+            conn.executemany(_SQL_PROC_START, self.starts)
+        if self.ends:
+            conn.executemany(_SQL_PROC_END, self.ends)
+        if self.net_procs:
+            conn.executemany(_SQL_NET_PROCESS, self.net_procs.values())
+        if self.connects:
+            conn.executemany(_SQL_NET_CONNECT, self.connects)
+        if self.flows:
+            conn.executemany(_SQL_NET_FLOW, self.flows)
+        if self.tags:
+            last_id = conn.execute("SELECT COALESCE(MAX(id), 0) FROM tags").fetchone()[0]
+            conn.executemany(_SQL_TAG, self.tags)
+            conn.execute(_SQL_TAG_SCORE, (last_id, last_id))
+        self._reset()
@@ -48,7 +48,9 @@ def _fetch_top_processes(conn: sqlite3.Connection, limit: int = 20) -> List[Dict
 def _fetch_top_connections(conn: sqlite3.Connection, limit: int = 50) -> List[Dict[str, Any]]:
     rows = conn.execute(
         """
-        SELECT nf.process_guid, p.image, p.score, nf.dst_ip, nf.dst_port, COUNT(*) AS cnt
+        SELECT nf.process_guid, COALESCE(MAX(nf.image), p.image) AS image,
+               COALESCE(MAX(nf.parent_guid), p.parent_guid) AS parent_guid,
+               p.score, nf.dst_ip, nf.dst_port, SUM(nf.cnt) AS cnt
         FROM netflows nf
         LEFT JOIN processes p ON p.process_guid = nf.process_guid
         GROUP BY nf.process_guid, nf.dst_ip, nf.dst_port
@@ -106,6 +108,54 @@ def _fetch_top_chains(conn: sqlite3.Connection, limit: int = 20) -> List[Dict[st
     return out
 
 
+_LOSS_COUNTERS = ("dropped", "events_lost", "buffers_lost", "decode_failures", "write_lost")
+
+
+def _fetch_collector_health(conn: sqlite3.Connection, limit: int = 50) -> List[Dict[str, Any]]:
+    """
+    collector_stats records per host: latest counters + intervals where a loss
+    counter went up. Counters are cumulative per collector run (reset on restart),
+    percentiles (decode_ns, latency_ns, ...) are per interval.
+    """
+    rows = conn.execute(
+        "SELECT ts, raw_json FROM events WHERE event_type='collector_stats' ORDER BY ts"
+    ).fetchall()
+
+    hosts: Dict[str, Dict[str, Any]] = {}
+    for r in rows:
+        if not r["raw_json"]:
+            continue
+        st = json.loads(r["raw_json"])
+        host = st.get("host") or ""
+        h = hosts.setdefault(host, {"host": host, "records": 0, "latest": None, "loss_intervals": []})
+        prev = h["latest"]
+        h["records"] += 1
+        h["latest"] = st
+
+        # 카운터가 줄었으면 collector 재시작: 새 run의 값 자체가 증가분
+        restarted = prev is None or st.get("events", 0) < prev.get("events", 0)
+        delta = {}
+        for k in _LOSS_COUNTERS:
+            d = st.get(k, 0) - (0 if restarted else prev.get(k, 0))
+            if d > 0:
+                delta[k] = d
+        if delta and len(h["loss_intervals"]) < limit:
+            h["loss_intervals"].append({"ts": r["ts"], "interval_ms": st.get("interval_ms"), **delta})
+
+    out = []
+    for h in hosts.values():
+        st = h["latest"]
+        h["latest"] = {
+            "ts": st.get("ts"),
+            "source": st.get("source"),
+            **{k: st.get(k, 0) for k in ("events", "filtered", "tags", "written", "bytes", "segments", "decode_fallbacks")},
+            **{k: st.get(k, 0) for k in _LOSS_COUNTERS},
+            "latency_ns": st.get("latency_ns"),
+        }
+        out.append(h)
+    return out
+
+
 def build_report(conn: sqlite3.Connection) -> Dict[str, Any]:
     generated_at = conn.execute("SELECT datetime('now') AS now").fetchone()["now"]
     return {
@@ -113,6 +163,7 @@ def build_report(conn: sqlite3.Connection) -> Dict[str, Any]:
         "top_processes": _fetch_top_processes(conn, 20),
         "top_chains": _fetch_top_chains(conn, 20),
         "top_connections": _fetch_top_connections(conn, 50),
+        "collector_health": _fetch_collector_health(conn),
     }
 
 
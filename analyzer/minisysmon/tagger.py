@@ -24,12 +24,34 @@ def _match_image_endswith(image: str, suffixes: list[str]) -> bool:
 
 
 def apply_rules(conn: sqlite3.Connection, rules: List[Dict[str, Any]]) -> None:
+    # 이번 실행에서 들어온 / 바뀐 process만 (dirty=1, correlate가 parent를 채운 것 포함)
     procs = conn.execute(
-        "SELECT process_guid, first_seen, image, cmdline, parent_guid FROM processes"
+        "SELECT process_guid, first_seen, image, cmdline, parent_guid FROM processes WHERE dirty=1"
     ).fetchall()
 
-    # 간단 parent lookup 캐시
-    proc_by_guid = {p["process_guid"]: p for p in procs}
+    # 간단 parent lookup 캐시: parent는 이전 실행에서 들어왔을 수 있음
+    proc_by_guid = {
+        p["process_guid"]: p
+        for p in conn.execute(
+            """
+            SELECT p.process_guid, p.image, p.cmdline
+            FROM processes c JOIN processes p ON p.process_guid = c.parent_guid
+            WHERE c.dirty = 1
+            """
+        )
+    }
+
+    # collector (--rules) tag / 이전 실행의 tag: 다시 넣지 않음 (score 중복 방지)
+    tagged = set(
+        (r["process_guid"], r["rule_id"])
+        for r in conn.execute(
+            """
+            SELECT t.process_guid, t.rule_id
+            FROM processes p JOIN tags t ON t.process_guid = p.process_guid
+            WHERE p.dirty = 1
+            """
+        )
+    )
 
     for p in procs:
         guid = p["process_guid"]
@@ -43,6 +65,8 @@ def apply_rules(conn: sqlite3.Connection, rules: List[Dict[str, Any]]) -> None:
 
         for rule in rules:
             rid = rule.get("id", "rule.unknown")
+            if (guid, rid) in tagged:
+                continue
             technique = rule.get("technique")
             severity = int(rule.get("severity", 0))
             evidence = rule.get("evidence", "")
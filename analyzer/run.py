@@ -1,8 +1,9 @@
 import argparse
+from contextlib import nullcontext
 from pathlib import Path
 
-from minisysmon.db import init_db
-from minisysmon.ingest import ingest_jsonl
+from minisysmon.db import bulk_load, clear_dirty, init_db
+from minisysmon.ingest import index_path_for, ingest_path
 from minisysmon.correlate import correlate_parent_child
 from minisysmon.enrich import enrich_processes
 from minisysmon.tagger import load_rules, apply_rules
@@ -15,9 +16,16 @@ def main():
         "--input",
         required=False,
         default="telemetry-raw.jsonl",
-        help="telemetry-raw.jsonl path (optional)"
+        help="telemetry-raw.jsonl / .msb (plain or .gz), or the base name / .index of rotated segments; "
+             "each run reads only what was appended since the last one (per-file checkpoint in the db)"
     )
+    ap.add_argument("--since", default=None, help="ISO8601 (prefix) lower bound on event ts, e.g. 2026-10-17T09")
+    ap.add_argument("--until", default=None, help="ISO8601 (prefix) upper bound on event ts, inclusive "
+                    "(with --since / --until the input is read as a one-off slice, checkpoints untouched)")
     ap.add_argument("--db", default="minisysmon.db", help="sqlite db path")
+    ap.add_argument("--bulk", action="store_true",
+                    help="big load (backfill): no fsync, large cache, secondary indexes rebuilt "
+                         "once after the load (always on for the first import into an empty db)")
     ap.add_argument("--rules", default=str(Path(__file__).parent / "minisysmon" / "rules" / "mitre_rules.yaml"))
     ap.add_argument("--out", default="report.json", help="output report.json path")
     args = ap.parse_args()
@@ -29,8 +37,11 @@ def main():
 
     conn = init_db(db_path)
 
-    if input_path.exists():
-        n_events = ingest_jsonl(conn, input_path)
+    if input_path.exists() or index_path_for(input_path).exists():
+        # 빈 DB의 첫 import는 항상 큰 load
+        bulk = args.bulk or conn.execute("SELECT 1 FROM events LIMIT 1").fetchone() is None
+        with bulk_load(conn) if bulk else nullcontext():
+            n_events = ingest_path(conn, input_path, args.since, args.until)
     else:
         print(f"[!] input file not found: {input_path}")
         print("[!] skipping ingest (0 events)")
@@ -41,6 +52,8 @@ def main():
 
     rules = load_rules(rules_path)
     apply_rules(conn, rules)
+    # 위 pass들은 이번 실행에서 들어온 process만 봄 (processes.dirty)
+    clear_dirty(conn)
 
     report_obj = build_report(conn)
     write_report(out_path, report_obj)
@@ -0,0 +1,141 @@
+"""
+binary ingest resumed from a checkpoint: dictionary / TS_BASE come from the
+checkpoint, the bytes before it are not read again.
+
+  python -m unittest discover -s tests      (from analyzer/)
+"""
+import struct
+import sys
+import tempfile
+import unittest
+import zlib
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from minisysmon import binlog  # noqa: E402
+from minisysmon.db import init_db  # noqa: E402
+from minisysmon.ingest import ingest_path  # noqa: E402
+
+TS0 = 134_000_000_000_000_000     # FILETIME, 2025-08
+
+
+def varint(v: int) -> bytes:
+    out = bytearray()
+    while v >= 0x80:
+        out.append(v & 0x7F | 0x80)
+        v >>= 7
+    out.append(v)
+    return bytes(out)
+
+
+def text(s: str) -> bytes:
+    b = s.encode("utf-8")
+    return varint(len(b)) + b
+
+
+def record(body: bytes) -> bytes:
+    return varint(len(body)) + body + struct.pack("<I", zlib.crc32(body))
+
+
+def header() -> bytes:
+    return binlog.MAGIC + bytes([binlog.VERSION, 0, 0, 0])
+
+
+def dict_rec(i: int, s: str) -> bytes:
+    return record(bytes([binlog.REC_DICT]) + varint(i) + text(s))
+
+
+def ts_base_rec(base: int) -> bytes:
+    return record(bytes([binlog.REC_TS_BASE]) + varint(base))
+
+
+def proc_start_rec(delta: int, pid: int, image_id: int, host_id: int, guid: str) -> bytes:
+    g = guid.encode("utf-8")
+    return record(bytes([binlog.REC_PROC_START]) + varint(delta << 1) + varint(pid) + varint(4)
+                  + varint(image_id) + text("x") + varint(host_id)
+                  + varint(len(g) + 2) + g + b"\x00")
+
+
+class BinlogResumeTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+        self.conn = init_db(self.dir / "t.db")
+        self.path = self.dir / "telemetry.msb"
+        self.first = (header() + dict_rec(1, "h1") + dict_rec(2, "C:\\a.exe") + ts_base_rec(TS0)
+                      + proc_start_rec(10, 100, 2, 1, "g-a"))
+        # refers to ids / ts_base from the first part
+        self.second = (dict_rec(3, "C:\\b.exe") + proc_start_rec(20, 200, 3, 1, "g-b")
+                       + proc_start_rec(30, 300, 2, 1, "g-c"))
+
+    def tearDown(self):
+        self.conn.close()
+        self.tmp.cleanup()
+
+    def proc(self, guid: str):
+        return self.conn.execute("SELECT * FROM processes WHERE process_guid=?", (guid,)).fetchone()
+
+    def checkpoint(self):
+        return self.conn.execute("SELECT * FROM ingest_checkpoints").fetchone()
+
+    def test_state_round_trip(self):
+        self.path.write_bytes(self.first)
+        stats = {}
+        self.assertEqual(len(list(binlog.iter_events(self.path, stats))), 1)
+        state = binlog.state_from_text(binlog.state_to_text(stats["state"]))
+        self.assertEqual(state, {"strings": {0: "", 1: "h1", 2: "C:\\a.exe"}, "ts_base": TS0})
+
+        self.path.write_bytes(self.first + self.second)
+        resumed, full = {}, {}
+        a = list(binlog.iter_events(self.path, resumed, stats["end"], state))
+        b = list(binlog.iter_events(self.path, full, stats["end"]))
+        self.assertEqual(a, b)
+        self.assertEqual([e["image"] for e in a], ["C:\\b.exe", "C:\\a.exe"])
+        self.assertEqual((resumed["end"], resumed["last_off"], resumed["state"]),
+                         (full["end"], full["last_off"], full["state"]))
+
+    def test_resume_reads_only_appended(self):
+        self.path.write_bytes(self.first)
+        self.assertEqual(ingest_path(self.conn, self.path), 1)
+        cp = self.checkpoint()
+        self.assertEqual(cp["end_off"], len(self.first))
+        self.assertIsNotNone(cp["state"])
+
+        # the bytes before the checkpoint's last record are garbled: a re-read from
+        # the header would lose DICT 2 ("C:\a.exe": crc error) and fail g-c
+        garbled = bytearray(self.first + self.second)
+        at = garbled.index(b"C:\\a.exe")
+        garbled[at:at + 8] = b"C:\\z.exe"
+        self.path.write_bytes(bytes(garbled))
+
+        self.assertEqual(ingest_path(self.conn, self.path), 2)
+        self.assertEqual(self.proc("g-b")["image"], "C:\\b.exe")
+        self.assertEqual(self.proc("g-c")["image"], "C:\\a.exe")
+        self.assertEqual(self.proc("g-c")["host"], "h1")
+        self.assertEqual(self.checkpoint()["end_off"], len(garbled))
+
+        # only a cut-off record appended (collector mid-write): checkpoint and state stay
+        cp = self.checkpoint()
+        with self.path.open("ab") as f:
+            f.write(proc_start_rec(40, 400, 3, 1, "g-d")[:5])
+        self.assertEqual(ingest_path(self.conn, self.path), 0)
+        after = self.checkpoint()
+        self.assertEqual((after["end_off"], after["last_hash"], after["state"]),
+                         (cp["end_off"], cp["last_hash"], cp["state"]))
+
+    def test_checkpoint_without_state(self):
+        # checkpoint from before the state column: read from the header again
+        self.path.write_bytes(self.first)
+        ingest_path(self.conn, self.path)
+        self.conn.execute("UPDATE ingest_checkpoints SET state=NULL")
+        self.conn.commit()
+
+        self.path.write_bytes(self.first + self.second)
+        self.assertEqual(ingest_path(self.conn, self.path), 2)
+        self.assertEqual(self.proc("g-c")["image"], "C:\\a.exe")
+        self.assertIsNotNone(self.checkpoint()["state"])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,91 @@
+"""
+bulk_load on a failing ingest: rows and checkpoints commit together or not at all.
+
+  python -m unittest discover -s tests      (from analyzer/)
+"""
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from bench_ingest import generate  # noqa: E402
+from minisysmon.db import BULK_DEFERRED_INDEXES, bulk_load, init_db  # noqa: E402
+from minisysmon.ingest import ingest_path  # noqa: E402
+
+LINES = 13000
+BAD_AT = 10000      # 0-based: after two full BATCH_EVENTS batches
+BAD_LINE = '{"ts":"2026-10-17T00:00:00.000Z","event_type":"proc_end",\n'
+
+
+class BulkLoadFailureTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+        self.conn = init_db(self.dir / "t.db")
+
+        src = self.dir / "gen.jsonl"
+        generate(src, LINES)
+        self.lines = src.read_text(encoding="utf-8").splitlines(keepends=True)
+        self.assertEqual(len(self.lines), LINES)
+        self.path = self.dir / "telemetry-raw.jsonl"
+
+    def tearDown(self):
+        self.conn.close()
+        self.tmp.cleanup()
+
+    def write(self, bad: bool) -> None:
+        lines = list(self.lines)
+        if bad:
+            lines[BAD_AT] = BAD_LINE
+        self.path.write_text("".join(lines), encoding="utf-8", newline="")
+
+    def counts(self):
+        events = self.conn.execute("SELECT COUNT(*) FROM events").fetchone()[0]
+        cps = self.conn.execute("SELECT COUNT(*), COALESCE(MAX(end_off), 0) FROM ingest_checkpoints").fetchone()
+        return events, cps[0], cps[1]
+
+    def load(self) -> int:
+        # run.py: first import into an empty db goes through bulk_load
+        with bulk_load(self.conn):
+            return ingest_path(self.conn, self.path)
+
+    def test_bad_line_then_rerun(self):
+        self.write(bad=True)
+        with self.assertRaises(ValueError):
+            self.load()
+
+        # nothing half-done: no events without a checkpoint
+        events, ncp, _ = self.counts()
+        self.assertEqual((events, ncp), (0, 0))
+        self.assertEqual(self.conn.execute("SELECT COUNT(*) FROM processes").fetchone()[0], 0)
+
+        # indexes and pragmas restored after the failure too
+        names = {r["name"] for r in self.conn.execute("SELECT name FROM sqlite_master WHERE type='index'")}
+        self.assertTrue(set(BULK_DEFERRED_INDEXES) <= names)
+        self.assertEqual(self.conn.execute("PRAGMA synchronous").fetchone()[0], 1)     # NORMAL (init_db)
+
+        # fixed file: every line exactly once, checkpoint at the end
+        self.write(bad=False)
+        self.assertEqual(self.load(), LINES)
+        events, ncp, end_off = self.counts()
+        self.assertEqual((events, ncp, end_off), (LINES, 1, self.path.stat().st_size))
+
+        # and nothing more on the next run
+        self.assertEqual(self.load(), 0)
+        self.assertEqual(self.counts()[0], LINES)
+
+    def test_success_commits(self):
+        self.write(bad=False)
+        self.assertEqual(self.load(), LINES)
+        self.conn.close()
+
+        # committed, not just visible on this connection
+        self.conn = init_db(self.dir / "t.db")
+        events, ncp, end_off = self.counts()
+        self.assertEqual((events, ncp, end_off), (LINES, 1, self.path.stat().st_size))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,119 @@
+"""
+correlate across runs: a child ingested before its parent (parent's proc_start in a later file).
+
+  python -m unittest discover -s tests      (from analyzer/)
+"""
+import json
+import sqlite3
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from minisysmon.correlate import correlate_parent_child  # noqa: E402
+from minisysmon.db import clear_dirty, init_db  # noqa: E402
+from minisysmon.enrich import enrich_processes  # noqa: E402
+from minisysmon.ingest import ingest_path  # noqa: E402
+from minisysmon.tagger import apply_rules, load_rules  # noqa: E402
+
+RULES = Path(__file__).resolve().parents[1] / "minisysmon" / "rules" / "mitre_rules.yaml"
+
+
+def proc_start(ts: str, pid: int, ppid: int, image: str, guid: str) -> dict:
+    return {"ts": ts, "event_type": "proc_start", "pid": pid, "ppid": ppid, "image": image,
+            "cmdline": image, "host": "h1", "process_guid": guid, "parent_process_guid": ""}
+
+
+def write_jsonl(path: Path, events: list) -> None:
+    with path.open("w", encoding="utf-8", newline="\n") as f:
+        for e in events:
+            f.write(json.dumps(e) + "\n")
+
+
+class CorrelateAcrossFilesTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+        self.conn = init_db(self.dir / "t.db")
+        self.rules = load_rules(RULES)
+
+    def tearDown(self):
+        self.conn.close()
+        self.tmp.cleanup()
+
+    def run_passes(self, path: Path) -> int:
+        """run.py without the report: ingest, then the passes over dirty rows."""
+        n = ingest_path(self.conn, path)
+        correlate_parent_child(self.conn)
+        enrich_processes(self.conn)
+        apply_rules(self.conn, self.rules)
+        clear_dirty(self.conn)
+        return n
+
+    def proc(self, guid: str) -> sqlite3.Row:
+        return self.conn.execute("SELECT * FROM processes WHERE process_guid=?", (guid,)).fetchone()
+
+    def tags(self, guid: str) -> set:
+        return {r["rule_id"] for r in self.conn.execute("SELECT rule_id FROM tags WHERE process_guid=?", (guid,))}
+
+    def test_parent_in_later_file(self):
+        # child first: its parent (pid 100) started earlier, but that proc_start is only in b.jsonl
+        a = self.dir / "a.jsonl"
+        write_jsonl(a, [
+            proc_start("2026-10-17T10:00:05.000Z", 200, 100, "C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe", "g-child"),
+            # pid 300's parent is only seen after it started: never its parent
+            proc_start("2026-10-17T10:00:01.000Z", 300, 400, "C:\\Windows\\System32\\cmd.exe", "g-early"),
+        ])
+        b = self.dir / "b.jsonl"
+        write_jsonl(b, [
+            proc_start("2026-10-17T10:00:00.000Z", 100, 4, "C:\\Program Files\\Microsoft Office\\WINWORD.EXE", "g-word"),
+            proc_start("2026-10-17T10:00:02.000Z", 400, 4, "C:\\Windows\\explorer.exe", "g-late"),
+        ])
+
+        self.assertEqual(self.run_passes(a), 2)
+        self.assertIsNone(self.proc("g-child")["parent_guid"])
+        self.assertNotIn("mitre.office_spawn_script", self.tags("g-child"))
+        score_before = self.proc("g-child")["score"]
+
+        self.assertEqual(self.run_passes(b), 2)
+        child = self.proc("g-child")
+        self.assertEqual(child["parent_guid"], "g-word")
+        self.assertEqual(child["parent_src"], 0)
+        self.assertEqual(child["dirty"], 0)
+        # re-evaluated with its parent: parent condition fires once, score added once
+        self.assertIn("mitre.office_spawn_script", self.tags("g-child"))
+        self.assertEqual(child["score"], score_before + 25)
+        self.assertIsNone(self.proc("g-early")["parent_guid"])
+
+        # nothing new: nothing re-resolved, no second tag
+        c = self.dir / "c.jsonl"
+        write_jsonl(c, [])
+        self.assertEqual(self.run_passes(c), 0)
+        self.assertEqual(self.proc("g-child")["score"], score_before + 25)
+        n = self.conn.execute("SELECT COUNT(*) FROM tags WHERE process_guid='g-child' "
+                              "AND rule_id='mitre.office_spawn_script'").fetchone()[0]
+        self.assertEqual(n, 1)
+
+    def test_same_result_as_one_file(self):
+        events_a = [proc_start("2026-10-17T10:00:05.000Z", 200, 100, "C:\\x\\child.exe", "g-child")]
+        events_b = [proc_start("2026-10-17T10:00:00.000Z", 100, 4, "C:\\x\\parent.exe", "g-parent")]
+        a, b, ab = self.dir / "a.jsonl", self.dir / "b.jsonl", self.dir / "ab.jsonl"
+        write_jsonl(a, events_a)
+        write_jsonl(b, events_b)
+        write_jsonl(ab, events_a + events_b)
+        self.run_passes(a)
+        self.run_passes(b)
+
+        one = init_db(self.dir / "one.db")
+        ingest_path(one, ab)
+        correlate_parent_child(one)
+        expect = one.execute("SELECT parent_guid FROM processes WHERE process_guid='g-child'").fetchone()[0]
+        one.close()
+        self.assertEqual(expect, "g-parent")
+        self.assertEqual(self.proc("g-child")["parent_guid"], expect)
+
+
+if __name__ == "__main__":
+    unittest.main()
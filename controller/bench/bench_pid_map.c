@@ -0,0 +1,104 @@
+// ============================================================
+// pid_map churn benchmark (Linux / any POSIX)
+//   cc -O2 -I.. bench_pid_map.c ../pid_map.c -o bench_pid_map
+//   ./bench_pid_map [processes] [live] [max_entries] [max_age_sec]
+// - start/lookup/end for N short-lived processes with PID reuse
+// - some end events dropped on purpose (lost events) -> cap/age eviction
+// - defaults: max_entries a little above live + 100us per start, 5s age: lost
+//   entries pile up past the cap (evict_for_room) and age out (sweep), so both
+//   counters are non-zero. missing = live process evicted by the cap (approx LRU)
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pid_map.h"
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 5000000;
+    size_t live_n = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 4096;
+    size_t max_entries = argc > 3 ? (size_t)strtoull(argv[3], NULL, 10) : live_n + live_n / 8;
+    uint64_t max_age_sec = argc > 4 ? strtoull(argv[4], NULL, 10) : 5;
+
+    PID_MAP m;
+    if (!pid_map_init(&m, 1024, max_entries, max_age_sec * 10000000ULL)) return 1;
+
+    uint32_t* live_pid = (uint32_t*)calloc(live_n, sizeof(uint32_t));
+    uint32_t* live_gen = (uint32_t*)calloc(live_n, sizeof(uint32_t));
+    uint8_t* in_use = (uint8_t*)calloc(65536, 1);   // OS side: live pid set
+    if (!live_pid || !live_gen || !in_use) return 1;
+
+    uint64_t ts = 132000000000000000ULL;
+    uint64_t wrong = 0, missing = 0;
+    uint64_t t0 = now_ns();
+
+    for (uint64_t i = 0; i < n; i++) {
+        ts += 1000; // 100us per process start
+        size_t s = (size_t)(rng() % live_n);
+
+        // retire the process in slot s (1/64: end event lost)
+        if (live_pid[s]) {
+            PID_ENTRY e;
+            if (!pid_map_get(&m, live_pid[s], ts, &e)) missing++;
+            else if (e.gen != live_gen[s]) wrong++;
+            if (rng() & 63) pid_map_del(&m, live_pid[s], live_gen[s]);
+            in_use[live_pid[s] / 4 - 1] = 0;
+        }
+
+        // Windows style PIDs: multiple of 4, small space -> frequent reuse
+        uint32_t k;
+        do k = (uint32_t)(rng() % 65536); while (in_use[k]);
+        in_use[k] = 1;
+        uint32_t pid = k * 4 + 4;
+        live_pid[s] = pid;
+        live_gen[s] = pid_map_put(&m, pid, ts, rng());
+
+        // a network event from a random live process
+        size_t q = (size_t)(rng() % live_n);
+        if (live_pid[q]) pid_map_get(&m, live_pid[q], ts, NULL);
+
+        pid_map_sweep(&m, ts, 8);
+    }
+
+    uint64_t dt = now_ns() - t0;
+
+    PID_MAP_STATS st;
+    pid_map_get_stats(&m, &st);
+    printf("processes=%llu  %.1f ns/process  wrong_gen=%llu missing=%llu\n",
+           (unsigned long long)n, (double)dt / (double)n, (unsigned long long)wrong, (unsigned long long)missing);
+    printf("size=%llu cap=%llu bytes=%llu grows=%llu\n",
+           (unsigned long long)st.size, (unsigned long long)st.cap,
+           (unsigned long long)st.bytes, (unsigned long long)st.grows);
+    printf("lookups=%llu hits=%llu stale=%llu inserts=%llu replaced=%llu deletes=%llu\n",
+           (unsigned long long)st.lookups, (unsigned long long)st.hits,
+           (unsigned long long)st.stale_rejects, (unsigned long long)st.inserts,
+           (unsigned long long)st.replaced, (unsigned long long)st.deletes);
+    printf("evict_age=%llu evict_cap=%llu probes/op=%.2f probe_max=%llu\n",
+           (unsigned long long)st.evict_age, (unsigned long long)st.evict_cap,
+           (double)st.probes / (double)(st.lookups + st.inserts + st.deletes),
+           (unsigned long long)st.probe_max);
+
+    free(live_pid);
+    free(live_gen);
+    free(in_use);
+    pid_map_free(&m);
+    return 0;
+}
@@ -0,0 +1,366 @@
+// ============================================================
+// end-to-end pipeline benchmark (Linux / any POSIX)
+//   cc -O2 -DPIPELINE_TIMING=1 -I.. bench_pipeline.c loadgen.c ../pipeline.c ../replay.c
+//      ../event_writer.c ../event_ring.c ../event_dispatch.c ../jsonl_writer.c
+//      ../segment.c ../gz_deflate.c ../bin_format.c ../json_out.c ../ts_format.c
+//      ../mof_decode.c ../pid_map.c ../proc_table.c ../guid.c ../lat_hist.c ../collector_stats.c
+//      ../raw_queue.c ../scratch.c ../flow_agg.c ../event_filter.c ../rule_engine.c ../cmd_scan.c
+//      -lpthread -o bench_pipeline
+//   ./bench_pipeline [--replay rec.msyr | load options] [--loops N] [--rate EV/S]
+//                    [--workers N] [--out out.jsonl] [--format text|binary] [--mode line|buffered]
+//                    [--policy block|drop]
+//                    [--flow-window SEC] [--filter drop.conf] [--rules rules.yaml]
+//                    [--save rec.msyr] [--json report.json]
+// - source: synthetic load (loadgen.h) or a recording (replay.h, --rate ignored)
+// - out defaults to /dev/null (pipeline + serialization, no disk)
+// - --mode: writer output mode (jsonl_writer.h, default buffered). LINE flushes every
+//   line; compare events_per_sec and writes_per_line with --out on a real disk
+// - --workers: decode workers (default PIPELINE_WORKERS, 0: source thread decodes);
+//   scaling: run 0, 1, 2, 4 ... and compare events_per_sec / source_events_per_sec
+// - --flow-window: net_connect aggregation (flow_agg.h, default NET_FLOW_WINDOW_SEC),
+//   with --dests N for repeated destinations; compare written / bytes
+// - --filter: drop filter config (event_filter.h); loadgen images are svchost.exe,
+//   chrome.exe, cl.exe, link.exe, powershell.exe, git.exe, destinations random
+//   (IPv6 in 2001:db8::/32). report: filtered + hits per rule
+// - --rules: tagging rules (rule_engine.h). loadgen images have no directory, so
+//   "\\powershell.exe" style suffixes never match them. report: tags + automaton size;
+//   cost should not grow with the rule count (one pass per field)
+// - report: one JSON object (stdout or --json), summary on stderr
+//   throughput, bytes/event, p50/p99/p999 latency pipeline entry -> serialized
+//   (ring wait included: saturating runs measure queueing, use --rate to pace),
+//   ns/event per stage. stages need -DPIPELINE_TIMING=1; without it latency is
+//   sampled (1 of COLLECTOR_STATS_SAMPLE events)
+// - heap allocations (glibc: malloc/calloc/realloc counted in this binary):
+//   steady = after the first loop (warm-up: table growth, dictionaries) until
+//   the source returns, all threads. expected 0 (decode temporaries: scratch.h;
+//   tables sized at init: config.h). non-zero -> "ok":false, exit 1
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "config.h"
+#include "guid.h"
+#include "jsonl_writer.h"
+#include "lat_hist.h"
+#include "loadgen.h"
+#include "pipeline.h"
+#include "plat.h"
+#include "replay.h"
+
+// ============================================================
+// heap allocation counter
+// ============================================================
+#if defined(__GLIBC__)
+#define ALLOC_COUNTING 1
+extern void* __libc_malloc(size_t n);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* p, size_t n);
+
+static volatile uint64_t g_allocs;
+
+void* malloc(size_t n)
+{
+    plat_atomic_add_u64(&g_allocs, 1);
+    return __libc_malloc(n);
+}
+
+void* calloc(size_t n, size_t size)
+{
+    plat_atomic_add_u64(&g_allocs, 1);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* p, size_t n)
+{
+    plat_atomic_add_u64(&g_allocs, 1);
+    return __libc_realloc(p, n);
+}
+#else
+#define ALLOC_COUNTING 0
+static volatile uint64_t g_allocs;
+#endif
+
+// src->run wrapper: allocation count at the end of warm-up and when the source returns
+typedef struct ALLOC_WINDOW {
+    int (*run)(EVENT_SOURCE* src, RAW_EVENT_SINK sink, void* ctx);
+    RAW_EVENT_SINK sink;
+    void* ctx;
+    uint64_t events;
+    uint64_t warm;              // events before the window opens
+    uint64_t at_warm;
+    uint64_t at_end;
+} ALLOC_WINDOW;
+
+static ALLOC_WINDOW g_win;
+
+static void counted_sink(const RAW_EVENT* ev, void* ctx)
+{
+    (void)ctx;
+    if (g_win.events++ == g_win.warm) g_win.at_warm = plat_load_acquire_u64(&g_allocs);
+    g_win.sink(ev, g_win.ctx);
+}
+
+static int counted_run(EVENT_SOURCE* src, RAW_EVENT_SINK sink, void* ctx)
+{
+    g_win.sink = sink;
+    g_win.ctx = ctx;
+    int ok = g_win.run(src, counted_sink, NULL);
+    g_win.at_end = plat_load_acquire_u64(&g_allocs);
+    if (g_win.events <= g_win.warm) g_win.at_warm = g_win.at_end;
+    return ok;
+}
+
+static void to_wide(const char* s, wchar_t* out, size_t cap)
+{
+    size_t n = mbstowcs(out, s, cap - 1);
+    if (n == (size_t)-1) n = 0;
+    out[n] = L'\0';
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "bench_pipeline [--replay rec.msyr] [--loops N] [--rate EV/S] [--workers N] [--out PATH]\n"
+            "               [--format text|binary] [--mode line|buffered] [--policy block|drop]\n"
+            "               [--flow-window SEC] [--filter PATH]\n"
+            "               [--rules PATH] [--save rec.msyr] [--json PATH]\n");
+    loadgen_usage(stderr);
+}
+
+int main(int argc, char** argv)
+{
+    LOADGEN_CONFIG lg;
+    loadgen_default_config(&lg);
+    const char* replay_arg = NULL;
+    const char* out_arg = "/dev/null";
+    const char* save_arg = NULL;
+    const char* json_arg = NULL;
+    const char* filter_arg = NULL;
+    const char* rules_arg = NULL;
+    uint32_t loops = 5;
+    uint64_t rate = 0;
+    uint32_t workers = PIPELINE_WORKERS;
+    int binary = 0;
+    JSONL_MODE mode = JSONL_MODE_BUFFERED;
+    RING_FULL_POLICY policy = RING_FULL_BLOCK;
+    uint32_t flow_window = NET_FLOW_WINDOW_SEC;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (loadgen_parse_arg(&lg, argc, argv, &i)) continue;
+        if (!v) {
+            usage();
+            return 2;
+        }
+        if (strcmp(a, "--replay") == 0) replay_arg = v;
+        else if (strcmp(a, "--loops") == 0) loops = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(a, "--rate") == 0) rate = strtoull(v, NULL, 10);
+        else if (strcmp(a, "--workers") == 0) workers = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(a, "--out") == 0) out_arg = v;
+        else if (strcmp(a, "--save") == 0) save_arg = v;
+        else if (strcmp(a, "--json") == 0) json_arg = v;
+        else if (strcmp(a, "--format") == 0) binary = strcmp(v, "binary") == 0;
+        else if (strcmp(a, "--mode") == 0) mode = strcmp(v, "line") == 0 ? JSONL_MODE_LINE : JSONL_MODE_BUFFERED;
+        else if (strcmp(a, "--filter") == 0) filter_arg = v;
+        else if (strcmp(a, "--rules") == 0) rules_arg = v;
+        else if (strcmp(a, "--flow-window") == 0) flow_window = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(a, "--policy") == 0) policy = strcmp(v, "drop") == 0 ? RING_FULL_DROP_NEWEST : RING_FULL_BLOCK;
+        else {
+            usage();
+            return 2;
+        }
+        i++;
+    }
+
+    wchar_t path[1024];
+    EVENT_SOURCE src;
+    if (replay_arg) {
+        to_wide(replay_arg, path, 1024);
+        if (!replay_source_open(&src, path, loops)) {
+            fprintf(stderr, "replay open failed: %s\n", replay_arg);
+            return 1;
+        }
+    } else if (!loadgen_source_open(&src, &lg, loops, rate)) {
+        fprintf(stderr, "load generation failed\n");
+        return 1;
+    }
+    if (save_arg && !replay_arg) {
+        to_wide(save_arg, path, 1024);
+        if (!loadgen_save(&src, path)) fprintf(stderr, "save failed: %s\n", save_arg);
+    }
+
+    JSONL_OPTIONS jo;
+    jsonl_default_options(&jo);
+    jo.format = binary ? JSONL_FORMAT_BINARY : JSONL_FORMAT_TEXT;
+    jo.mode = mode;
+    jo.rotate_bytes = 0;
+    jo.rotate_interval_sec = 0;
+    jsonl_configure(&jo);
+    to_wide(out_arg, path, 1024);
+    if (!jsonl_open(path)) {
+        fprintf(stderr, "output open failed: %s\n", out_arg);
+        return 1;
+    }
+
+    guid_init_boot_id();
+    PIPELINE_CONFIG pcfg;
+    memset(&pcfg, 0, sizeof(pcfg));
+    pcfg.workers = workers;
+    wchar_t filter_path[1024];
+    if (filter_arg) {
+        to_wide(filter_arg, filter_path, 1024);
+        pcfg.filter_path = filter_path;
+    }
+    wchar_t rules_path[1024];
+    if (rules_arg) {
+        to_wide(rules_arg, rules_path, 1024);
+        pcfg.rules_path = rules_path;
+    }
+    if (!pipeline_init(&pcfg)) return 1;
+
+    EVENT_WRITER_CONFIG wcfg;
+    memset(&wcfg, 0, sizeof(wcfg));
+    wcfg.ring_cap = EVENT_RING_CAPACITY;
+    wcfg.policy = policy;
+    wcfg.sample_n = EVENT_RING_SAMPLE_N;
+    wcfg.host = L"BENCH";
+    wcfg.net_inline_process = NET_INLINE_PROCESS;
+    wcfg.flow_window_sec = flow_window;
+    wcfg.flow_max = NET_FLOW_MAX_FLOWS;
+
+    // 첫 loop는 warm-up (loops 1: 전체가 window)
+    if (loops > 1) {
+        if (replay_arg) {
+            REPLAY_STATS rs;
+            replay_source_get_stats(&src, &rs);
+            g_win.warm = rs.records;
+        } else {
+            g_win.warm = lg.events;
+        }
+    }
+    g_win.run = src.run;
+    src.run = counted_run;
+
+    uint64_t t0 = plat_now_ns();
+    int ok = pipeline_run(&src, &wcfg);
+    uint64_t total_ns = plat_now_ns() - t0;
+    jsonl_close();
+
+    uint64_t src_ns = 0;
+    if (replay_arg) {
+        REPLAY_STATS rs;
+        replay_source_get_stats(&src, &rs);
+        src_ns = rs.run_ns;
+    } else {
+        loadgen_source_get_stats(&src, NULL, &src_ns);
+    }
+    PIPELINE_STATS ps;
+    pipeline_get_stats(&ps);
+    JSONL_STATS js;
+    jsonl_get_stats(&js);
+    RING_STATS ring;
+    event_writer_get_stats(&ring);
+    EVENT_WRITER_MERGE_STATS ms;
+    event_writer_get_merge_stats(&ms);
+    FLOW_AGG_STATS fs;
+    event_writer_get_flow_stats(&fs);
+    static LAT_HIST lat;
+    event_writer_get_latency(&lat);
+
+    double sec = (double)total_ns / 1e9;
+    double ev_n = ps.events ? (double)ps.events : 1.0;
+
+    // warm-up 뒤 allocation이 있으면 실패 (PID_MAP_INITIAL_CAP / PROC_TABLE_INITIAL_RECORDS, scratch.h)
+    uint64_t steady = g_win.at_end - g_win.at_warm;
+    uint64_t steady_events = g_win.events > g_win.warm ? g_win.events - g_win.warm : 0;
+    int allocs_ok = !ALLOC_COUNTING || !steady_events || !steady;
+    if (!allocs_ok) ok = 0;
+
+    // ---- machine-readable report
+    FILE* jf = json_arg ? fopen(json_arg, "w") : stdout;
+    if (!jf) {
+        fprintf(stderr, "json open failed: %s\n", json_arg);
+        jf = stdout;
+    }
+    fprintf(jf, "{\"bench\":\"pipeline\",\"source\":\"%s\",\"timing\":%s,\"ok\":%s,",
+            src.name, PIPELINE_TIMING ? "true" : "false", ok ? "true" : "false");
+    fprintf(jf, "\"events\":%llu,\"routed\":%llu,\"filtered\":%llu,\"tags\":%llu,\"written\":%llu,\"dropped\":%llu,\"decode_fallbacks\":%llu,",
+            (unsigned long long)ps.events, (unsigned long long)ps.routed, (unsigned long long)ps.filtered,
+            (unsigned long long)ps.tags,
+            (unsigned long long)js.lines,
+            (unsigned long long)(ring.dropped_full + ring.dropped_sampled),
+            (unsigned long long)ps.decode_fallbacks);
+    fprintf(jf, "\"seconds\":%.6f,\"events_per_sec\":%.0f,\"source_events_per_sec\":%.0f,"
+                "\"bytes\":%llu,\"bytes_per_event\":%.2f,\"writes\":%llu,\"writes_per_line\":%.4f,\"block_waits\":%llu,",
+            sec, (double)ps.events / sec, src_ns ? (double)ps.events / ((double)src_ns / 1e9) : 0.0,
+            (unsigned long long)js.bytes, js.lines ? (double)js.bytes / (double)js.lines : 0.0,
+            (unsigned long long)js.writes, js.lines ? (double)js.writes / (double)js.lines : 0.0,
+            (unsigned long long)ring.block_waits);
+    fprintf(jf, "\"latency_ns\":{\"count\":%llu,\"mean\":%.0f,\"p50\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu},",
+            (unsigned long long)lat.count, lat.count ? (double)lat.sum / (double)lat.count : 0.0,
+            (unsigned long long)lat_hist_quantile(&lat, 0.5), (unsigned long long)lat_hist_quantile(&lat, 0.99),
+            (unsigned long long)lat_hist_quantile(&lat, 0.999), (unsigned long long)lat.max);
+    static const char* names[PIPE_STAGE_COUNT] = { "route", "decode", "state", "emit" };
+    fprintf(jf, "\"stage_ns_per_event\":{");
+    for (int i = 0; i < PIPE_STAGE_COUNT; i++) {
+        fprintf(jf, "\"%s\":%.1f,", names[i], (double)ps.stage_ns[i] / ev_n);
+    }
+    fprintf(jf, "\"write\":%.1f},", ps.written ? (double)ps.write_ns / (double)ps.written : 0.0);
+    fprintf(jf, "\"merge\":{\"records\":%llu,\"waits\":%llu,\"timeouts\":%llu,\"out_of_order\":%llu},",
+            (unsigned long long)ms.merged, (unsigned long long)ms.waits,
+            (unsigned long long)ms.timeouts, (unsigned long long)ms.out_of_order);
+    fprintf(jf, "\"flows\":{\"connects\":%llu,\"first_seen\":%llu,\"folded\":%llu,\"summaries\":%llu,"
+                "\"expired\":%llu,\"evicted\":%llu,\"passthrough\":%llu,\"high_water\":%llu},",
+            (unsigned long long)fs.connects, (unsigned long long)fs.first_seen, (unsigned long long)fs.folded,
+            (unsigned long long)fs.summaries, (unsigned long long)fs.expired, (unsigned long long)fs.evicted, (unsigned long long)fs.passthrough,
+            (unsigned long long)fs.high_water);
+    const EVENT_FILTER* ef = pipeline_get_filter();
+    fprintf(jf, "\"filter\":[");
+    for (uint32_t i = 0; ef && i < ef->nrules; i++) {
+        const FILTER_RULE* r = &ef->rules[i];
+        fprintf(jf, "%s{\"line\":%u,\"kind\":\"%s\",\"hits\":%llu,\"followed\":%llu}", i ? "," : "", r->line,
+                r->kind == FILTER_IMAGE ? "image" : "dst", (unsigned long long)r->hits, (unsigned long long)r->followed);
+    }
+    fprintf(jf, "],");
+    const RULE_ENGINE* re = pipeline_get_rules();
+    fprintf(jf, "\"rules\":{\"rules\":%u,\"parent_conds\":%u,\"states\":%u,\"classes\":%u},",
+            re ? re->nrules : 0, re ? re->nparent : 0, re ? re->nstates : 0, re ? re->nclass : 0);
+    fprintf(jf, "\"allocs\":{\"counted\":%s,\"steady\":%llu,\"steady_events\":%llu,\"per_event\":%.6f,"
+                "\"scratch_spills\":%llu,\"scratch_high_water\":%llu},",
+            ALLOC_COUNTING ? "true" : "false", (unsigned long long)steady, (unsigned long long)steady_events,
+            steady_events ? (double)steady / (double)steady_events : 0.0,
+            (unsigned long long)ps.scratch_spills, (unsigned long long)ps.scratch_high_water);
+    fprintf(jf, "\"config\":{\"loops\":%u,\"rate\":%llu,\"workers\":%u,\"flow_window\":%u,\"filter\":\"%s\",\"rules\":\"%s\",\"format\":\"%s\",\"mode\":\"%s\",\"policy\":\"%s\",\"ring_cap\":%u,",
+            loops, (unsigned long long)rate, workers, flow_window, filter_arg ? filter_arg : "", rules_arg ? rules_arg : "", binary ? "binary" : "text",
+            mode == JSONL_MODE_LINE ? "line" : "buffered", policy == RING_FULL_BLOCK ? "block" : "drop", (unsigned)EVENT_RING_CAPACITY);
+    if (replay_arg) fprintf(jf, "\"replay\":\"%s\"", replay_arg);
+    else loadgen_config_json(&lg, jf);
+    fprintf(jf, "}}\n");
+    if (jf != stdout) fclose(jf);
+
+    // ---- human summary
+    fprintf(stderr, "%s: events=%llu written=%llu %.3fs %.0f events/s %.1f bytes/event\n",
+            src.name, (unsigned long long)ps.events, (unsigned long long)js.lines, sec,
+            (double)ps.events / sec, js.lines ? (double)js.bytes / (double)js.lines : 0.0);
+    fprintf(stderr, "writer %s: writes=%llu %.4f writes/line\n", mode == JSONL_MODE_LINE ? "line" : "buffered",
+            (unsigned long long)js.writes, js.lines ? (double)js.writes / (double)js.lines : 0.0);
+    fprintf(stderr, "latency%s p50=%lluns p99=%lluns p999=%lluns max=%lluns\n", PIPELINE_TIMING ? "" : " (sampled)",
+            (unsigned long long)lat_hist_quantile(&lat, 0.5), (unsigned long long)lat_hist_quantile(&lat, 0.99),
+            (unsigned long long)lat_hist_quantile(&lat, 0.999), (unsigned long long)lat.max);
+    if (ALLOC_COUNTING) {
+        fprintf(stderr, "heap allocations: %llu in %llu steady-state events (warm-up %llu), scratch spills=%llu\n",
+                (unsigned long long)steady, (unsigned long long)steady_events,
+                (unsigned long long)(g_win.events - steady_events), (unsigned long long)ps.scratch_spills);
+        if (!allocs_ok) fprintf(stderr, "FAIL: heap allocations after warm-up (expected 0)\n");
+    }
+#if !PIPELINE_TIMING
+    fprintf(stderr, "(build with -DPIPELINE_TIMING=1 for per-stage ns/event)\n");
+#endif
+
+    pipeline_shutdown();
+    src.close(&src);
+    return ok ? 0 : 1;
+}
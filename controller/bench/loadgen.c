@@ -0,0 +1,375 @@
+#include "loadgen.h"
+#include "event_rec.h"
+#include "mof_decode.h"
+#include "plat.h"
+#include "replay.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static void put_u32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+
+// Process_TypeGroup1 v4, 64-bit header, NULL SID
+static uint32_t mof_process(uint8_t* b, uint32_t pid, uint32_t ppid, const char* image, const char* cmd, size_t cmd_len)
+{
+    uint32_t off = 0;
+    memset(b, 0, 8 + 16 + 8 + 4 + 4);
+    off += 8;                                   // UniqueProcessKey
+    put_u32(b + off, pid);
+    put_u32(b + off + 4, ppid);
+    off += 16;
+    off += 8 + 4;                               // DirectoryTableBase, Flags
+    off += 4;                                   // UserSID: NULL
+    size_t n = strlen(image) + 1;
+    memcpy(b + off, image, n);
+    off += (uint32_t)n;
+    for (size_t i = 0; i < cmd_len; i++) {      // UTF-16LE, NUL terminated
+        b[off++] = (uint8_t)cmd[i];
+        b[off++] = 0;
+    }
+    b[off++] = 0;
+    b[off++] = 0;
+    return off;
+}
+
+// TcpIp_TypeGroup1 (IPv4) v2
+static uint32_t mof_tcp4(uint8_t* b, uint32_t pid, uint32_t daddr, uint32_t saddr, uint16_t dport, uint16_t sport)
+{
+    memset(b, 0, 44);
+    put_u32(b, pid);
+    memcpy(b + 8, &daddr, 4);
+    memcpy(b + 12, &saddr, 4);
+    b[16] = (uint8_t)(dport >> 8);
+    b[17] = (uint8_t)dport;
+    b[18] = (uint8_t)(sport >> 8);
+    b[19] = (uint8_t)sport;
+    return 44;                                  // + startime, seqnum, connid (unused)
+}
+
+// TcpIp6_TypeGroup2 (IPv6) v2
+static uint32_t mof_tcp6(uint8_t* b, uint32_t pid, uint64_t r, uint16_t dport, uint16_t sport)
+{
+    memset(b, 0, 68);
+    put_u32(b, pid);
+    b[8] = 0x20;                                // daddr 2001:db8::/32 + random
+    b[9] = 0x01;
+    b[10] = 0x0d;
+    b[11] = 0xb8;
+    memcpy(b + 16, &r, 8);
+    b[24] = 0xfe;                               // saddr fe80::/64
+    b[25] = 0x80;
+    b[39] = 1;
+    b[40] = (uint8_t)(dport >> 8);
+    b[41] = (uint8_t)dport;
+    b[42] = (uint8_t)(sport >> 8);
+    b[43] = (uint8_t)sport;
+    return 68;
+}
+
+// ============================================================
+// config
+// ============================================================
+void loadgen_default_config(LOADGEN_CONFIG* cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->events = 1000000;
+    cfg->live = 2048;
+    cfg->churn = 10;
+    cfg->connect = 90;
+    cfg->lost_end_pct = 50;
+    cfg->v6_pct = 10;
+    cfg->cmd_min = 24;
+    cfg->cmd_max = 64;
+    cfg->cmd_long_pct = 6;
+    cfg->cmd_long_max = 760;
+    cfg->seed = 0x9E3779B97F4A7C15ULL;
+}
+
+static int parse_pair(const char* s, uint32_t* a, uint32_t* b)
+{
+    char* end;
+    unsigned long x = strtoul(s, &end, 10);
+    if (*end != ':') return 0;
+    unsigned long y = strtoul(end + 1, &end, 10);
+    if (*end) return 0;
+    *a = (uint32_t)x;
+    *b = (uint32_t)y;
+    return 1;
+}
+
+int loadgen_parse_arg(LOADGEN_CONFIG* cfg, int argc, char** argv, int* i)
+{
+    const char* opt = argv[*i];
+    if (*i + 1 >= argc) return 0;
+    const char* v = argv[*i + 1];
+
+    if (strcmp(opt, "--events") == 0) cfg->events = strtoull(v, NULL, 10);
+    else if (strcmp(opt, "--live") == 0) cfg->live = (uint32_t)strtoul(v, NULL, 10);
+    else if (strcmp(opt, "--churn") == 0) cfg->churn = (uint32_t)strtoul(v, NULL, 10);
+    else if (strcmp(opt, "--connect") == 0) cfg->connect = (uint32_t)strtoul(v, NULL, 10);
+    else if (strcmp(opt, "--lost-end") == 0) cfg->lost_end_pct = (uint32_t)strtoul(v, NULL, 10);
+    else if (strcmp(opt, "--v6") == 0) cfg->v6_pct = (uint32_t)strtoul(v, NULL, 10);
+    else if (strcmp(opt, "--dests") == 0) cfg->dests = (uint32_t)strtoul(v, NULL, 10);
+    else if (strcmp(opt, "--seed") == 0) cfg->seed = strtoull(v, NULL, 0);
+    else if (strcmp(opt, "--cmd") == 0) {
+        if (!parse_pair(v, &cfg->cmd_min, &cfg->cmd_max)) return 0;
+    } else if (strcmp(opt, "--cmd-long") == 0) {
+        if (!parse_pair(v, &cfg->cmd_long_pct, &cfg->cmd_long_max)) return 0;
+    } else {
+        return 0;
+    }
+    *i += 1;
+    return 1;
+}
+
+void loadgen_usage(FILE* fp)
+{
+    fprintf(fp,
+            "  load: --events N --live N --churn W --connect W --lost-end PCT --v6 PCT --dests N\n"
+            "        --cmd MIN:MAX --cmd-long PCT:MAX --seed N\n");
+}
+
+void loadgen_config_json(const LOADGEN_CONFIG* cfg, FILE* fp)
+{
+    fprintf(fp, "\"events\":%llu,\"live\":%u,\"churn\":%u,\"connect\":%u,\"lost_end_pct\":%u,\"v6_pct\":%u,\"dests\":%u,"
+                "\"cmd_min\":%u,\"cmd_max\":%u,\"cmd_long_pct\":%u,\"cmd_long_max\":%u,\"seed\":%llu",
+            (unsigned long long)cfg->events, cfg->live, cfg->churn, cfg->connect, cfg->lost_end_pct,
+            cfg->v6_pct, cfg->dests, cfg->cmd_min, cfg->cmd_max, cfg->cmd_long_pct, cfg->cmd_long_max,
+            (unsigned long long)cfg->seed);
+}
+
+// ============================================================
+// generation
+// ============================================================
+typedef struct LOADGEN_SOURCE {
+    uint8_t* data;              // payload arena
+    size_t data_len, data_cap;
+    RAW_EVENT* events;          // user_data: offset into data until generation ends
+    size_t count;
+    uint32_t loops;
+    uint64_t rate;
+    uint64_t span;
+    uint64_t rng;
+    volatile int32_t stop;
+    uint64_t emitted;
+    uint64_t run_ns;
+} LOADGEN_SOURCE;
+
+static uint64_t next_rng(LOADGEN_SOURCE* s)
+{
+    uint64_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return s->rng = x;
+}
+
+static uint32_t uniform(LOADGEN_SOURCE* s, uint32_t lo, uint32_t hi)
+{
+    if (hi <= lo) return lo;
+    return lo + (uint32_t)(next_rng(s) % (uint64_t)(hi - lo + 1));
+}
+
+// payload 공간 확보 (max bytes), 실패: NULL
+static uint8_t* reserve(LOADGEN_SOURCE* s, size_t max)
+{
+    if (s->data_len + max > s->data_cap) {
+        size_t cap = s->data_cap ? s->data_cap : (1 << 20);
+        while (cap < s->data_len + max) cap *= 2;
+        uint8_t* nd = (uint8_t*)realloc(s->data, cap);
+        if (!nd) return NULL;
+        s->data = nd;
+        s->data_cap = cap;
+    }
+    return s->data + s->data_len;
+}
+
+static void push(LOADGEN_SOURCE* s, const RAW_EVENT* tmpl, uint8_t opcode, uint8_t version, uint32_t len)
+{
+    RAW_EVENT* ev = &s->events[s->count++];
+    *ev = *tmpl;
+    ev->opcode = opcode;
+    ev->version = version;
+    ev->user_data = (const void*)(uintptr_t)s->data_len;
+    ev->user_data_len = len;
+    s->data_len += len;
+}
+
+static int generate(LOADGEN_SOURCE* s, const LOADGEN_CONFIG* cfg)
+{
+    static const char* images[] = { "svchost.exe", "chrome.exe", "cl.exe", "link.exe", "powershell.exe", "git.exe" };
+    uint32_t live_n = cfg->live ? cfg->live : 1;
+    uint32_t weight = cfg->churn + cfg->connect;
+    if (!weight) return 0;
+
+    uint32_t* live = (uint32_t*)calloc(live_n, sizeof(uint32_t));
+    // start 앞의 end 때문에 최대 2배
+    s->events = (RAW_EVENT*)malloc((size_t)(cfg->events + 1) * sizeof(RAW_EVENT));
+    char* cmd = (char*)malloc(EVREC_CMDLINE_CAP);
+    if (!live || !s->events || !cmd) {
+        free(live);
+        free(cmd);
+        return 0;
+    }
+
+    RAW_EVENT tmpl;
+    memset(&tmpl, 0, sizeof(tmpl));
+    tmpl.ptr_size = 8;
+    tmpl.ts_100ns = 134000000000000000ULL;
+    uint32_t next_pid = 1000;
+    int ok = 1;
+
+    while (s->count < cfg->events) {
+        tmpl.ts_100ns += 1 + next_rng(s) % 20000;
+        uint32_t slot = (uint32_t)(next_rng(s) % live_n);
+        uint32_t r = (uint32_t)(next_rng(s) % weight);
+
+        if (!live[slot] || r < cfg->churn) {
+            // 이 slot의 process를 새 process로 교체 (end는 lost_end_pct만큼 누락)
+            memcpy(tmpl.provider, MOF_GUID_PROCESS, 16);
+            if (live[slot] && s->count + 1 < cfg->events && next_rng(s) % 100 >= cfg->lost_end_pct) {
+                uint8_t* b = reserve(s, 64);
+                if (!b) { ok = 0; break; }
+                tmpl.pid = live[slot];
+                push(s, &tmpl, MOF_PROCESS_OPCODE_END, 4, mof_process(b, live[slot], 4, images[0], "", 0));
+            }
+
+            uint32_t pid = next_pid;
+            next_pid = next_pid >= 60000 ? 1000 : next_pid + 4;     // PID reuse
+            uint32_t ppid = live[(slot + 1) % live_n] ? live[(slot + 1) % live_n] : 4;
+            const char* img = images[next_rng(s) % 6];
+
+            uint32_t want = (next_rng(s) % 100 < cfg->cmd_long_pct)
+                                ? uniform(s, cfg->cmd_max, cfg->cmd_long_max)
+                                : uniform(s, cfg->cmd_min, cfg->cmd_max);
+            if (want > EVREC_CMDLINE_CAP - 1) want = EVREC_CMDLINE_CAP - 1;
+            int len = snprintf(cmd, EVREC_CMDLINE_CAP, "%s --task %llu ", img, (unsigned long long)next_rng(s));
+            if (len > (int)want) len = (int)want;
+            for (int k = len; k < (int)want; k++) cmd[k] = (char)('a' + k % 26);
+
+            uint8_t* b = reserve(s, 64 + strlen(img) + 2 * (size_t)want + 2);
+            if (!b) { ok = 0; break; }
+            tmpl.pid = pid;
+            push(s, &tmpl, MOF_PROCESS_OPCODE_START, 4, mof_process(b, pid, ppid, img, cmd, want));
+            live[slot] = pid;
+            continue;
+        }
+
+        uint16_t dport = (uint16_t)(next_rng(s) % 100 < 60 ? 443 : 80);
+        uint16_t sport = (uint16_t)(49152 + next_rng(s) % 16384);
+        uint8_t* b = reserve(s, 68);
+        if (!b) { ok = 0; break; }
+        memcpy(tmpl.provider, MOF_GUID_TCPIP, 16);
+        tmpl.pid = live[slot];
+        int v6 = next_rng(s) % 100 < cfg->v6_pct;
+        // dests: process마다 고정된 목적지 몇 개 (chatty process, flow aggregation)
+        uint64_t daddr = next_rng(s);
+        if (cfg->dests) daddr = (live[slot] * 0x9E3779B97F4A7C15ULL) ^ ((daddr % cfg->dests + 1) * 0xBF58476D1CE4E5B9ULL);
+        if (v6) {
+            push(s, &tmpl, MOF_TCPIP_OPCODE_CONNECT_V6, 2, mof_tcp6(b, live[slot], daddr, dport, sport));
+        } else {
+            push(s, &tmpl, MOF_TCPIP_OPCODE_CONNECT_V4, 2,
+                 mof_tcp4(b, live[slot], (uint32_t)daddr, 0x0100000A, dport, sport));
+        }
+    }
+
+    // arena가 더 이상 안 움직임 -> offset을 pointer로
+    for (size_t i = 0; i < s->count; i++) {
+        s->events[i].user_data = s->data + (uintptr_t)s->events[i].user_data;
+    }
+    if (s->count) s->span = s->events[s->count - 1].ts_100ns - s->events[0].ts_100ns + 1;
+
+    free(live);
+    free(cmd);
+    return ok;
+}
+
+// ============================================================
+// source
+// ============================================================
+static int loadgen_run(EVENT_SOURCE* src, RAW_EVENT_SINK sink, void* ctx)
+{
+    LOADGEN_SOURCE* s = (LOADGEN_SOURCE*)src->impl;
+    uint64_t t0 = plat_now_ns();
+
+    for (uint32_t loop = 0; loop < s->loops; loop++) {
+        uint64_t shift = s->span * loop;
+        for (size_t i = 0; i < s->count; i++) {
+            if ((i & 63) == 0) {
+                if (plat_load_i32(&s->stop)) goto done;
+                // pacing: 앞서 있으면 기다림 (1ms 이상은 sleep, 이하는 yield)
+                while (s->rate) {
+                    uint64_t due = t0 + (uint64_t)((double)s->emitted * 1e9 / (double)s->rate);
+                    uint64_t now = plat_now_ns();
+                    if (now >= due) break;
+                    if (due - now > 1000000) plat_sleep_ms(1);
+                    else plat_yield();
+                }
+            }
+            RAW_EVENT ev = s->events[i];
+            ev.ts_100ns += shift;
+            sink(&ev, ctx);
+            s->emitted++;
+        }
+    }
+done:
+    s->run_ns = plat_now_ns() - t0;
+    return 1;
+}
+
+static void loadgen_request_stop(EVENT_SOURCE* src)
+{
+    LOADGEN_SOURCE* s = (LOADGEN_SOURCE*)src->impl;
+    plat_store_i32(&s->stop, 1);
+}
+
+static void loadgen_close(EVENT_SOURCE* src)
+{
+    LOADGEN_SOURCE* s = (LOADGEN_SOURCE*)src->impl;
+    if (!s) return;
+    free(s->events);
+    free(s->data);
+    free(s);
+    src->impl = NULL;
+}
+
+int loadgen_source_open(EVENT_SOURCE* src, const LOADGEN_CONFIG* cfg, uint32_t loops, uint64_t rate)
+{
+    memset(src, 0, sizeof(*src));
+
+    LOADGEN_SOURCE* s = (LOADGEN_SOURCE*)calloc(1, sizeof(LOADGEN_SOURCE));
+    if (!s) return 0;
+    s->loops = loops ? loops : 1;
+    s->rate = rate;
+    s->rng = cfg->seed ? cfg->seed : 1;
+
+    src->name = "loadgen";
+    src->run = loadgen_run;
+    src->request_stop = loadgen_request_stop;
+    src->close = loadgen_close;
+    src->impl = s;
+
+    if (!generate(s, cfg)) {
+        loadgen_close(src);
+        return 0;
+    }
+    return 1;
+}
+
+int loadgen_save(EVENT_SOURCE* src, const wchar_t* path)
+{
+    LOADGEN_SOURCE* s = (LOADGEN_SOURCE*)src->impl;
+    REPLAY_RECORDER rec;
+    if (!s || !replay_recorder_open(&rec, path)) return 0;
+    for (size_t i = 0; i < s->count; i++) replay_record(&rec, &s->events[i]);
+    int ok = !ferror(rec.fp);
+    replay_recorder_close(&rec);
+    return ok;
+}
+
+void loadgen_source_get_stats(EVENT_SOURCE* src, uint64_t* emitted, uint64_t* run_ns)
+{
+    LOADGEN_SOURCE* s = src ? (LOADGEN_SOURCE*)src->impl : NULL;
+    if (emitted) *emitted = s ? s->emitted : 0;
+    if (run_ns) *run_ns = s ? s->run_ns : 0;
+}
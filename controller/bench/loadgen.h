@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <wchar.h>
+
+#include "event_source.h"
+
+// ============================================================
+// Synthetic load generator (bench only)
+// - kernel MOF Process start/end + TcpIp connect payloads, same bytes the
+//   ETW session delivers -> drives the real pipeline (route/decode/state/write)
+// - all events are generated in memory at open; run() only pushes them
+//   (optionally paced to a target rate, for latency under non-saturating load)
+// ============================================================
+
+typedef struct LOADGEN_CONFIG {
+    uint64_t events;            // per loop
+    uint32_t live;              // concurrently live processes (slots)
+    uint32_t churn;             // weight: process start (replaces a slot's process)
+    uint32_t connect;           // weight: tcp connect from a live process
+    uint32_t lost_end_pct;      // replaced processes without an end event
+    uint32_t v6_pct;            // connects over IPv6
+    uint32_t dests;             // destinations per process (0: random address per connect)
+    uint32_t cmd_min, cmd_max;  // cmdline length (chars), uniform
+    uint32_t cmd_long_pct;      // ... except this % drawn from [cmd_max, cmd_long_max]
+    uint32_t cmd_long_max;
+    uint64_t seed;
+} LOADGEN_CONFIG;
+
+void loadgen_default_config(LOADGEN_CONFIG* cfg);
+
+// argv[*i]가 loadgen option이면 소비하고 1 (value 포함, *i 전진). 아니면 0
+//   --events N --live N --churn W --connect W --lost-end PCT --v6 PCT --dests N
+//   --cmd MIN:MAX --cmd-long PCT:MAX --seed N
+int loadgen_parse_arg(LOADGEN_CONFIG* cfg, int argc, char** argv, int* i);
+void loadgen_usage(FILE* fp);
+
+// "config" object body (no braces), for the bench JSON report
+void loadgen_config_json(const LOADGEN_CONFIG* cfg, FILE* fp);
+
+// rate: events/s (0: as fast as possible). loops 0 -> 1. 성공: 1, 실패: 0
+int loadgen_source_open(EVENT_SOURCE* src, const LOADGEN_CONFIG* cfg, uint32_t loops, uint64_t rate);
+
+// generated events -> replay file (replay.h), one loop
+int loadgen_save(EVENT_SOURCE* src, const wchar_t* path);
+
+// run() wall time, events pushed, pacing sleeps
+void loadgen_source_get_stats(EVENT_SOURCE* src, uint64_t* emitted, uint64_t* run_ns);
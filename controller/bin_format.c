@@ -0,0 +1,721 @@
+#include "bin_format.h"
+#include "json_out.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// PCLMULQDQ: compile time, like cmd_scan / json_out (MSVC /arch:AVX2 CPUs all have it)
+#if !defined(BIN_CRC_NO_CLMUL)
+#if (defined(__PCLMUL__) && defined(__SSE4_1__)) || (defined(_MSC_VER) && defined(__AVX2__))
+#define BIN_HAVE_CLMUL 1
+#include <immintrin.h>
+#endif
+#endif
+
+// ============================================================
+// CRC-32 (IEEE, zlib compatible)
+// - x86 crc32 instruction (SSE4.2) is CRC-32C (다른 다항식) -> zlib / binlog.py와 안 맞음
+// - PCLMULQDQ: 64 byte씩 carry-less multiply로 fold (Intel "Fast CRC Computation
+//   Using PCLMULQDQ", zlib / Chromium과 같은 상수), 나머지는 slicing-by-8
+// ============================================================
+static uint32_t g_crc_table[8][256];
+static int g_crc_ready = 0;
+
+static void crc_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        g_crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = g_crc_table[0][i];
+        for (int t = 1; t < 8; t++) {
+            c = g_crc_table[0][c & 0xFF] ^ (c >> 8);
+            g_crc_table[t][i] = c;
+        }
+    }
+    g_crc_ready = 1;
+}
+
+#if defined(BIN_HAVE_CLMUL)
+// n >= 64, multiple of 16. c: inverted crc in, inverted crc out
+static uint32_t crc_clmul(uint32_t c, const uint8_t* p, size_t n)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(-1, 0, -1, 0);
+
+    __m128i x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)p), _mm_cvtsi32_si128((int)c));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(p + 16));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(p + 32));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(p + 48));
+    p += 64;
+    n -= 64;
+
+    // 4 lane 병렬 fold
+    while (n >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)p));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(p + 16)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(p + 32)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(p + 48)));
+        p += 64;
+        n -= 64;
+    }
+
+    // 4 -> 1
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+    while (n >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11),
+                                         _mm_loadu_si128((const __m128i*)p)), x5);
+        p += 16;
+        n -= 16;
+    }
+
+    // 128 -> 64 -> 32 (Barrett)
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00), x2);
+
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+uint32_t bin_crc32(uint32_t crc, const void* data, size_t n)
+{
+    if (!g_crc_ready) crc_init();
+
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t c = ~crc;
+
+#if defined(BIN_HAVE_CLMUL)
+    if (n >= 64) {
+        size_t k = n & ~(size_t)15;
+        c = crc_clmul(c, p, k);
+        p += k;
+        n -= k;
+    }
+#endif
+
+    // 8 byte씩: table lookup 8개가 서로 독립 (byte 단위는 lookup마다 앞 결과를 기다림)
+    while (n >= 8) {
+        uint32_t lo = c ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+        uint32_t hi = (uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+        c = g_crc_table[7][lo & 0xFF] ^ g_crc_table[6][(lo >> 8) & 0xFF] ^
+            g_crc_table[5][(lo >> 16) & 0xFF] ^ g_crc_table[4][lo >> 24] ^
+            g_crc_table[3][hi & 0xFF] ^ g_crc_table[2][(hi >> 8) & 0xFF] ^
+            g_crc_table[1][(hi >> 16) & 0xFF] ^ g_crc_table[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) c = g_crc_table[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    return ~c;
+}
+
+// ============================================================
+// encoder
+// ============================================================
+char* bin_put_header(char* d, uint8_t flags)
+{
+    memcpy(d, BIN_MAGIC, 4);
+    d[4] = (char)BIN_VERSION;
+    d[5] = (char)flags;
+    d[6] = 0;
+    d[7] = 0;
+    return d + BIN_HEADER_SIZE;
+}
+
+char* bin_put_varint(char* d, uint64_t v)
+{
+    while (v >= 0x80) {
+        *d++ = (char)(0x80 | (v & 0x7F));
+        v >>= 7;
+    }
+    *d++ = (char)v;
+    return d;
+}
+
+char* bin_put_str(char* d, const char* s, size_t n)
+{
+    d = bin_put_varint(d, n);
+    if (n) memcpy(d, s, n);
+    return d + n;
+}
+
+static size_t varint_size(uint64_t v)
+{
+    size_t k = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        k++;
+    }
+    return k;
+}
+
+char* bin_put_wstr(char* d, const wchar_t* s, size_t n)
+{
+    // UTF-8 길이는 써 봐야 앎: ASCII(len == n)로 보고 varint 자리를 잡고, 틀렸을 때만 당김/밈
+    size_t k = varint_size(n);
+    char* body = d + k;
+    char* end = json_put_wstr_utf8(body, s, n);
+    size_t len = (size_t)(end - body);
+
+    char tmp[BIN_VARINT_MAX];
+    size_t kl = (size_t)(bin_put_varint(tmp, len) - tmp);
+    if (kl != k) memmove(d + kl, body, len);
+    memcpy(d, tmp, kl);
+    return d + kl + len;
+}
+
+static int hexval(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// "p-" + 16 lowercase hex -> 8 bytes
+char* bin_put_guid(char* d, const char* s, size_t n)
+{
+    if (!n) return bin_put_varint(d, 0);
+
+    if (n == 18 && s[0] == 'p' && s[1] == '-') {
+        uint64_t v = 0;
+        size_t i = 2;
+        for (; i < 18; i++) {
+            int h = hexval(s[i]);
+            if (h < 0) break;
+            v = (v << 4) | (uint64_t)h;
+        }
+        if (i == 18) {
+            *d++ = 1;
+            for (int b = 0; b < 8; b++) *d++ = (char)(v >> (8 * b));
+            return d;
+        }
+    }
+
+    d = bin_put_varint(d, (uint64_t)n + 2);
+    memcpy(d, s, n);
+    return d + n;
+}
+
+// canonical dotted quad only (round-trips byte for byte)
+static int parse_ipv4(const char* s, size_t n, uint8_t out[4])
+{
+    size_t i = 0;
+    for (int part = 0; part < 4; part++) {
+        if (part) {
+            if (i >= n || s[i] != '.') return 0;
+            i++;
+        }
+        size_t start = i;
+        unsigned v = 0;
+        while (i < n && s[i] >= '0' && s[i] <= '9' && i - start < 3) v = v * 10 + (unsigned)(s[i++] - '0');
+        if (i == start || v > 255) return 0;
+        if (i - start > 1 && s[start] == '0') return 0;
+        out[part] = (uint8_t)v;
+    }
+    return i == n;
+}
+
+char* bin_put_ip(char* d, const char* s, size_t n)
+{
+    if (!n) return bin_put_varint(d, 0);
+
+    uint8_t a[4];
+    if (parse_ipv4(s, n, a)) {
+        *d++ = 1;
+        memcpy(d, a, 4);
+        return d + 4;
+    }
+
+    d = bin_put_varint(d, (uint64_t)n + 2);
+    memcpy(d, s, n);
+    return d + n;
+}
+
+char* bin_put_ts(char* d, uint64_t ts, uint64_t base)
+{
+    int64_t delta = (int64_t)(ts - base);
+    return bin_put_varint(d, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+}
+
+char* bin_record_begin(char* rec)
+{
+    return rec + BIN_LEN_RESERVE;
+}
+
+char* bin_record_end(char* rec, char* body_end)
+{
+    char* body = rec + BIN_LEN_RESERVE;
+    size_t len = (size_t)(body_end - body);
+    uint32_t crc = bin_crc32(0, body, len);
+
+    char tmp[BIN_VARINT_MAX];
+    size_t k = (size_t)(bin_put_varint(tmp, len) - tmp);
+    if (k != BIN_LEN_RESERVE) memmove(rec + k, body, len);
+    memcpy(rec, tmp, k);
+
+    char* d = rec + k + len;
+    d[0] = (char)crc;
+    d[1] = (char)(crc >> 8);
+    d[2] = (char)(crc >> 16);
+    d[3] = (char)(crc >> 24);
+    return d + BIN_CRC_SIZE;
+}
+
+// ============================================================
+// dictionary
+// ============================================================
+// 8 byte씩 섞음 (unit마다 곱셈 하나씩 기다리던 FNV 대신), 끝에서 한 번 더 섞어 하위 bit도 고르게
+static uint64_t hash_wunits(const wchar_t* s, size_t n)
+{
+    const uint8_t* p = (const uint8_t*)s;
+    size_t bytes = n * sizeof(wchar_t);
+    uint64_t h = 0xcbf29ce484222325ULL ^ bytes;
+    uint64_t w;
+
+    while (bytes >= 8) {
+        memcpy(&w, p, 8);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+        p += 8;
+        bytes -= 8;
+    }
+    if (bytes) {
+        w = 0;
+        memcpy(&w, p, bytes);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+    }
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ULL;
+    h ^= h >> 32;
+    return h ? h : 1;
+}
+
+int bin_dict_init(BIN_DICT* d, uint32_t max_ids)
+{
+    memset(d, 0, sizeof(*d));
+    d->max_ids = max_ids ? max_ids : 4096;
+
+    d->cap = 16;
+    while (d->cap < (size_t)d->max_ids * 2) d->cap <<= 1;
+    d->slots = (BIN_DICT_SLOT*)calloc(d->cap, sizeof(BIN_DICT_SLOT));
+    return d->slots != NULL;
+}
+
+void bin_dict_free(BIN_DICT* d)
+{
+    if (!d) return;
+    free(d->slots);
+    free(d->pool);
+    memset(d, 0, sizeof(*d));
+}
+
+void bin_dict_reset(BIN_DICT* d)
+{
+    if (d->slots) memset(d->slots, 0, d->cap * sizeof(BIN_DICT_SLOT));
+    d->count = 0;
+    d->pool_used = 0;
+}
+
+uint32_t bin_dict_intern(BIN_DICT* d, const wchar_t* s, size_t n, int* is_new)
+{
+    *is_new = 0;
+    if (!n || !d->slots) return 0;
+
+    uint64_t h = hash_wunits(s, n);
+    size_t mask = d->cap - 1;
+    size_t j = (size_t)h & mask;
+
+    while (d->slots[j].hash) {
+        BIN_DICT_SLOT* e = &d->slots[j];
+        if (e->hash == h && e->len == n && memcmp(d->pool + e->off, s, n * sizeof(wchar_t)) == 0) {
+            return e->id;
+        }
+        j = (j + 1) & mask;
+    }
+
+    if (d->count >= d->max_ids) return 0;
+
+    if (d->pool_used + n > d->pool_cap) {
+        size_t nc = d->pool_cap ? d->pool_cap : 16384;
+        while (nc < d->pool_used + n) nc *= 2;
+        wchar_t* np = (wchar_t*)realloc(d->pool, nc * sizeof(wchar_t));
+        if (!np) return 0;
+        d->pool = np;
+        d->pool_cap = nc;
+    }
+    memcpy(d->pool + d->pool_used, s, n * sizeof(wchar_t));
+
+    BIN_DICT_SLOT* e = &d->slots[j];
+    e->hash = h;
+    e->id = ++d->count;
+    e->off = (uint32_t)d->pool_used;
+    e->len = (uint32_t)n;
+    d->pool_used += n;
+
+    *is_new = 1;
+    return e->id;
+}
+
+// ============================================================
+// decoder
+// ============================================================
+typedef struct CURSOR {
+    const uint8_t* p;
+    const uint8_t* end;
+    int ok;
+} CURSOR;
+
+static uint64_t cur_varint(CURSOR* c)
+{
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (c->p >= c->end) break;
+        uint8_t b = *c->p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    c->ok = 0;
+    return 0;
+}
+
+static const uint8_t* cur_take(CURSOR* c, size_t n)
+{
+    if ((size_t)(c->end - c->p) < n) {
+        c->ok = 0;
+        return NULL;
+    }
+    const uint8_t* p = c->p;
+    c->p += n;
+    return p;
+}
+
+static BIN_STR cur_str(CURSOR* c)
+{
+    BIN_STR s = { "", 0 };
+    size_t n = (size_t)cur_varint(c);
+    const uint8_t* p = cur_take(c, n);
+    if (p) {
+        s.p = (const char*)p;
+        s.n = n;
+    }
+    return s;
+}
+
+static const char k_hex[] = "0123456789abcdef";
+
+static BIN_STR cur_guid(CURSOR* c, char txt[24])
+{
+    BIN_STR s = { "", 0 };
+    uint64_t tag = cur_varint(c);
+    if (tag == 0) return s;
+
+    if (tag == 1) {
+        const uint8_t* p = cur_take(c, 8);
+        if (!p) return s;
+        uint64_t v = 0;
+        for (int b = 7; b >= 0; b--) v = (v << 8) | p[b];
+        txt[0] = 'p';
+        txt[1] = '-';
+        for (int i = 15; i >= 0; i--) {
+            txt[2 + i] = k_hex[v & 0xF];
+            v >>= 4;
+        }
+        txt[18] = '\0';
+        s.p = txt;
+        s.n = 18;
+        return s;
+    }
+
+    const uint8_t* p = cur_take(c, (size_t)(tag - 2));
+    if (p) {
+        s.p = (const char*)p;
+        s.n = (size_t)(tag - 2);
+    }
+    return s;
+}
+
+static BIN_STR cur_ip(CURSOR* c, char txt[16])
+{
+    BIN_STR s = { "", 0 };
+    uint64_t tag = cur_varint(c);
+    if (tag == 0) return s;
+
+    if (tag == 1) {
+        const uint8_t* p = cur_take(c, 4);
+        if (!p) return s;
+        char* d = txt;
+        for (int i = 0; i < 4; i++) {
+            if (i) *d++ = '.';
+            d = json_put_u32(d, p[i]);
+        }
+        *d = '\0';
+        s.p = txt;
+        s.n = (size_t)(d - txt);
+        return s;
+    }
+
+    const uint8_t* p = cur_take(c, (size_t)(tag - 2));
+    if (p) {
+        s.p = (const char*)p;
+        s.n = (size_t)(tag - 2);
+    }
+    return s;
+}
+
+static uint64_t cur_ts(CURSOR* c, uint64_t base)
+{
+    uint64_t z = cur_varint(c);
+    return base + ((z >> 1) ^ (0 - (z & 1)));
+}
+
+static BIN_STR dict_get(BIN_READER* r, uint64_t id, CURSOR* c)
+{
+    BIN_STR s = { "", 0 };
+    if (id == 0) return s;
+    if (id >= r->dict_cap || !r->dict[id].p) {
+        c->ok = 0;   // id used before its DICT record
+        return s;
+    }
+    return r->dict[id];
+}
+
+static void dict_clear(BIN_READER* r)
+{
+    for (size_t i = 0; i < r->dict_cap; i++) {
+        free((void*)r->dict[i].p);
+        r->dict[i].p = NULL;
+        r->dict[i].n = 0;
+    }
+}
+
+static int dict_set(BIN_READER* r, uint64_t id, BIN_STR v)
+{
+    if (id == 0 || id > 0xFFFFFFu) return 0;
+    if (id >= r->dict_cap) {
+        size_t nc = r->dict_cap ? r->dict_cap : 256;
+        while (nc <= id) nc *= 2;
+        BIN_STR* nd = (BIN_STR*)realloc(r->dict, nc * sizeof(BIN_STR));
+        if (!nd) return 0;
+        memset(nd + r->dict_cap, 0, (nc - r->dict_cap) * sizeof(BIN_STR));
+        r->dict = nd;
+        r->dict_cap = nc;
+    }
+
+    char* copy = (char*)malloc(v.n + 1);
+    if (!copy) return 0;
+    memcpy(copy, v.p, v.n);
+    copy[v.n] = '\0';
+
+    free((void*)r->dict[id].p);
+    r->dict[id].p = copy;
+    r->dict[id].n = v.n;
+    return 1;
+}
+
+int bin_reader_open(BIN_READER* r, FILE* fp)
+{
+    memset(r, 0, sizeof(*r));
+    uint8_t h[BIN_HEADER_SIZE];
+    if (fread(h, 1, sizeof(h), fp) != sizeof(h)) return 0;
+    if (memcmp(h, BIN_MAGIC, 4) != 0 || h[4] != BIN_VERSION) return 0;
+    r->fp = fp;
+    r->ts_digits = (h[5] & BIN_FLAG_TS_US) ? 6 : 3;
+    return 1;
+}
+
+void bin_reader_close(BIN_READER* r)
+{
+    if (!r) return;
+    dict_clear(r);
+    free(r->dict);
+    free(r->rec);
+    memset(r, 0, sizeof(*r));
+}
+
+// record 하나를 body buffer로 읽음. 1: ok, 0: EOF, -1: truncated
+static int read_record(BIN_READER* r, size_t* out_len, uint32_t* out_crc)
+{
+    uint64_t len = 0;
+    int shift = 0;
+    for (;;) {
+        int ch = fgetc(r->fp);
+        if (ch == EOF) return shift == 0 ? 0 : -1;
+        len |= (uint64_t)(ch & 0x7F) << shift;
+        if (!(ch & 0x80)) break;
+        shift += 7;
+        if (shift >= 35) return -1;
+    }
+
+    size_t need = (size_t)len + BIN_CRC_SIZE;
+    if (need > r->rec_cap) {
+        size_t nc = r->rec_cap ? r->rec_cap : 4096;
+        while (nc < need) nc *= 2;
+        uint8_t* nb = (uint8_t*)realloc(r->rec, nc);
+        if (!nb) return -1;
+        r->rec = nb;
+        r->rec_cap = nc;
+    }
+    if (fread(r->rec, 1, need, r->fp) != need) return -1;
+
+    const uint8_t* c = r->rec + len;
+    *out_crc = (uint32_t)c[0] | ((uint32_t)c[1] << 8) | ((uint32_t)c[2] << 16) | ((uint32_t)c[3] << 24);
+    *out_len = (size_t)len;
+    return 1;
+}
+
+int bin_reader_next(BIN_READER* r, BIN_EVENT* ev)
+{
+    for (;;) {
+        size_t len;
+        uint32_t crc;
+        int rc = read_record(r, &len, &crc);
+        if (rc <= 0) return rc;
+        r->st.records++;
+
+        if (bin_crc32(0, r->rec, len) != crc) {
+            r->st.crc_errors++;
+            continue;
+        }
+        if (!len) {
+            r->st.bad_records++;
+            continue;
+        }
+
+        CURSOR c = { r->rec + 1, r->rec + len, 1 };
+        uint8_t type = r->rec[0];
+
+        memset(ev, 0, sizeof(*ev));
+        ev->type = type;
+        ev->image = ev->cmdline = ev->host = ev->guid = ev->parent_guid = (BIN_STR){ "", 0 };
+        ev->src_ip = ev->dst_ip = ev->fields = (BIN_STR){ "", 0 };
+
+        switch (type) {
+        case BIN_REC_DICT_RESET:
+            dict_clear(r);
+            continue;
+
+        case BIN_REC_TS_BASE: {
+            uint64_t base = cur_varint(&c);
+            if (c.ok) r->ts_base = base;
+            else r->st.bad_records++;
+            continue;
+        }
+
+        case BIN_REC_DICT: {
+            uint64_t id = cur_varint(&c);
+            BIN_STR v = cur_str(&c);
+            if (!c.ok || !dict_set(r, id, v)) r->st.bad_records++;
+            continue;
+        }
+
+        case BIN_REC_PROC_START:
+            ev->ts_100ns = cur_ts(&c, r->ts_base);
+            ev->pid = (uint32_t)cur_varint(&c);
+            ev->ppid = (uint32_t)cur_varint(&c);
+            ev->image = dict_get(r, cur_varint(&c), &c);
+            ev->cmdline = cur_str(&c);
+            ev->host = dict_get(r, cur_varint(&c), &c);
+            ev->guid = cur_guid(&c, r->guid_txt);
+            ev->parent_guid = cur_guid(&c, r->parent_txt);
+            if (c.ok && c.p < c.end) {
+                ev->has_scan = 1;
+                ev->cmd_flags = (uint32_t)cur_varint(&c);
+                uint64_t v = cur_varint(&c);
+                ev->risk_path_tier = (uint32_t)(v & 3);
+                ev->base64_sus = (uint32_t)((v >> 2) & 1);
+            }
+            break;
+
+        case BIN_REC_PROC_END:
+            ev->ts_100ns = cur_ts(&c, r->ts_base);
+            ev->pid = (uint32_t)cur_varint(&c);
+            ev->guid = cur_guid(&c, r->guid_txt);
+            break;
+
+        case BIN_REC_NET_CONNECT: {
+            ev->ts_100ns = cur_ts(&c, r->ts_base);
+            ev->pid = (uint32_t)cur_varint(&c);
+            ev->guid = cur_guid(&c, r->guid_txt);
+            ev->src_ip = cur_ip(&c, r->src_txt);
+            ev->src_port = (uint16_t)cur_varint(&c);
+            ev->dst_ip = cur_ip(&c, r->dst_txt);
+            ev->dst_port = (uint16_t)cur_varint(&c);
+            const uint8_t* f = cur_take(&c, 1);
+            uint8_t flags = f ? *f : 0;
+            if (flags & BIN_NET_HAS_IMAGE) {
+                ev->has_image = 1;
+                ev->image = dict_get(r, cur_varint(&c), &c);
+            }
+            if (flags & BIN_NET_HAS_PARENT) {
+                ev->has_parent = 1;
+                ev->parent_guid = cur_guid(&c, r->parent_txt);
+            }
+            break;
+        }
+
+        case BIN_REC_NET_FLOW:
+            ev->ts_100ns = cur_ts(&c, r->ts_base);
+            ev->pid = (uint32_t)cur_varint(&c);
+            ev->guid = cur_guid(&c, r->guid_txt);
+            ev->dst_ip = cur_ip(&c, r->dst_txt);
+            ev->dst_port = (uint16_t)cur_varint(&c);
+            ev->proto = (uint32_t)cur_varint(&c);
+            ev->count = cur_varint(&c);
+            ev->first_ts = ev->ts_100ns - cur_varint(&c);
+            ev->last_ts = ev->ts_100ns - cur_varint(&c);
+            break;
+
+        case BIN_REC_TAG: {
+            ev->ts_100ns = cur_ts(&c, r->ts_base);
+            ev->guid = cur_guid(&c, r->guid_txt);
+            ev->rule_id = cur_str(&c);
+            ev->technique = cur_str(&c);
+            uint64_t z = cur_varint(&c);
+            ev->severity = (int32_t)(int64_t)((z >> 1) ^ (0 - (z & 1)));
+            ev->evidence = cur_str(&c);
+            break;
+        }
+
+        case BIN_REC_STATS:
+            ev->ts_100ns = cur_ts(&c, r->ts_base);
+            ev->host = dict_get(r, cur_varint(&c), &c);
+            ev->fields = cur_str(&c);
+            break;
+
+        default:
+            // unknown record type (newer writer): skip
+            continue;
+        }
+
+        if (!c.ok) {
+            r->st.bad_records++;
+            continue;
+        }
+        r->st.events++;
+        return 1;
+    }
+}
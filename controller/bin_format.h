@@ -0,0 +1,182 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <wchar.h>
+
+// ============================================================
+// Compact binary telemetry format (alternative to JSONL)
+//
+// file:    header "MSYB" u8 version u8 flags u16 reserved, then records
+//          flags: BIN_FLAG_TS_US - text timestamps have 6 fractional digits (TS_FRACTION_DIGITS)
+// record:  varint body_len | body | u32 crc32(body), little endian
+// body:    u8 type, fields (all integers LEB128 varint)
+//
+//   DICT_RESET   (no fields)     - string ids below this point start over
+//   DICT         id, str         - defines a host/image string id (1..)
+//   TS_BASE      ts              - base for the following events' ts
+//   PROC_START   ts, pid, ppid, image_id, str cmdline, host_id, guid, guid parent
+//                [cmd_flags, tier | base64_sus << 2]  - cmd_scan.h, absent from older writers
+//   PROC_END     ts, pid, guid
+//   NET_CONNECT  ts, pid, guid, ip src, sport, ip dst, dport, u8 flags
+//                [flags & 1: image_id] [flags & 2: guid parent]
+//   NET_FLOW     ts, pid, guid, ip dst, dport, proto, count, ts - first_ts, ts - last_ts
+//                - net_flow_summary (flow_agg.h), first/last as plain varint back from ts
+//   TAG          ts, guid, str rule_id, str technique, zigzag severity, str evidence
+//                - rule fired at a process start (rule_engine.h), after its PROC_START
+//   STATS        ts, host_id, str fields   - collector_stats (JSON object members)
+//
+//   ts:   zigzag varint of (FILETIME 100ns - TS_BASE), |delta| < BIN_TS_DELTA_MAX
+//         (a lost event record does not shift the timestamps after it)
+//   str:  varint len, UTF-8 bytes
+//   id:   0 = empty string
+//   guid: varint 0 = "", 1 = u64 LE ("p-%016llx"), n >= 2 = str of n-2 bytes
+//   ip:   varint 0 = "", 1 = 4 bytes IPv4, n >= 2 = str of n-2 bytes
+//
+// - portable, one dictionary per file (segment)
+// ============================================================
+
+#define BIN_MAGIC        "MSYB"
+#define BIN_VERSION      1
+#define BIN_HEADER_SIZE  8
+
+#define BIN_FLAG_TS_US   0x01   // header flags: writer's ts_digits == 6 (else 3)
+
+#define BIN_VARINT_MAX   10
+#define BIN_LEN_RESERVE  5      // body_len varint (< 4GB)
+#define BIN_CRC_SIZE     4
+#define BIN_RECORD_OVERHEAD (BIN_LEN_RESERVE + BIN_CRC_SIZE)
+
+typedef enum BIN_REC_TYPE {
+    BIN_REC_DICT_RESET  = 0x01,
+    BIN_REC_DICT        = 0x02,
+    BIN_REC_TS_BASE     = 0x03,
+    BIN_REC_PROC_START  = 0x10,
+    BIN_REC_PROC_END    = 0x11,
+    BIN_REC_NET_CONNECT = 0x12,
+    BIN_REC_NET_FLOW    = 0x13,
+    BIN_REC_TAG         = 0x14,
+    BIN_REC_STATS       = 0x20,
+} BIN_REC_TYPE;
+
+#define BIN_TS_DELTA_MAX   (1LL << 27)   // ~13s in 100ns -> ts field <= 4 bytes
+
+#define BIN_NET_HAS_IMAGE  0x01
+#define BIN_NET_HAS_PARENT 0x02
+
+uint32_t bin_crc32(uint32_t crc, const void* data, size_t n);
+
+// ============================================================
+// encoder helpers (caller reserves the bound)
+// ============================================================
+#define BIN_STR_BOUND(n)   (BIN_VARINT_MAX + (n))
+#define BIN_WSTR_BOUND(n)  (BIN_VARINT_MAX + (n) * 3)
+
+char* bin_put_header(char* d, uint8_t flags);
+char* bin_put_varint(char* d, uint64_t v);
+char* bin_put_str(char* d, const char* s, size_t n);
+char* bin_put_wstr(char* d, const wchar_t* s, size_t n);    // -> UTF-8
+char* bin_put_guid(char* d, const char* s, size_t n);
+char* bin_put_ip(char* d, const char* s, size_t n);
+char* bin_put_ts(char* d, uint64_t ts, uint64_t base);
+
+// record framing: begin returns the body pointer, end writes len + crc
+// and returns the record end (body is moved down to close the length gap)
+char* bin_record_begin(char* rec);
+char* bin_record_end(char* rec, char* body_end);
+
+// ============================================================
+// per-segment string dictionary (host, image)
+// ============================================================
+typedef struct BIN_DICT_SLOT {
+    uint64_t hash;      // 0: empty
+    uint32_t id;
+    uint32_t off;       // pool offset (wchar_t units)
+    uint32_t len;
+} BIN_DICT_SLOT;
+
+typedef struct BIN_DICT {
+    BIN_DICT_SLOT* slots;
+    size_t cap;         // power of 2
+    uint32_t count;
+    uint32_t max_ids;
+    wchar_t* pool;
+    size_t pool_cap;
+    size_t pool_used;
+} BIN_DICT;
+
+int bin_dict_init(BIN_DICT* d, uint32_t max_ids);
+void bin_dict_free(BIN_DICT* d);
+void bin_dict_reset(BIN_DICT* d);
+
+// id (>0) of s. *is_new=1: caller must emit a DICT record before using it.
+// 0: dictionary full (caller resets and emits DICT_RESET)
+uint32_t bin_dict_intern(BIN_DICT* d, const wchar_t* s, size_t n, int* is_new);
+
+// ============================================================
+// streaming decoder
+// ============================================================
+typedef struct BIN_STR {
+    const char* p;
+    size_t n;
+} BIN_STR;
+
+typedef struct BIN_EVENT {
+    uint32_t type;          // BIN_REC_PROC_START / PROC_END / NET_CONNECT / NET_FLOW / TAG / STATS
+    uint64_t ts_100ns;
+    uint32_t pid;
+    uint32_t ppid;
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint32_t proto;         // NET_FLOW
+    uint64_t count;
+    uint64_t first_ts;
+    uint64_t last_ts;
+    int32_t severity;       // TAG
+    int has_image;          // NET_CONNECT: image/parent present
+    int has_parent;
+    int has_scan;           // PROC_START: cmd_flags / risk_path_tier / base64_sus present
+    uint32_t cmd_flags;     // CMD_FLAG_*
+    uint32_t risk_path_tier;
+    uint32_t base64_sus;
+    BIN_STR image;
+    BIN_STR cmdline;
+    BIN_STR host;
+    BIN_STR guid;
+    BIN_STR parent_guid;
+    BIN_STR src_ip;
+    BIN_STR dst_ip;
+    BIN_STR fields;         // STATS: JSON object members (no braces)
+    BIN_STR rule_id;        // TAG
+    BIN_STR technique;
+    BIN_STR evidence;
+} BIN_EVENT;
+
+typedef struct BIN_READER_STATS {
+    uint64_t records;
+    uint64_t events;
+    uint64_t crc_errors;    // skipped
+    uint64_t bad_records;   // skipped (malformed body)
+} BIN_READER_STATS;
+
+typedef struct BIN_READER {
+    FILE* fp;
+    uint8_t* rec;           // current record body
+    size_t rec_cap;
+    char guid_txt[24];      // packed guid/ip -> text
+    char parent_txt[24];
+    char src_txt[16];
+    char dst_txt[16];
+    BIN_STR* dict;          // id -> string (owned copies)
+    size_t dict_cap;
+    uint64_t ts_base;
+    int ts_digits;          // 3 / 6: header BIN_FLAG_TS_US
+    BIN_READER_STATS st;
+} BIN_READER;
+
+// 성공: 1, 실패(header 불일치 등): 0
+int bin_reader_open(BIN_READER* r, FILE* fp);
+void bin_reader_close(BIN_READER* r);
+
+// 1: event filled (valid until the next call), 0: end of stream, -1: truncated/corrupt stream
+int bin_reader_next(BIN_READER* r, BIN_EVENT* ev);
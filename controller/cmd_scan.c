@@ -0,0 +1,457 @@
+#include "cmd_scan.h"
+
+#include <string.h>
+
+#if !defined(CMD_SCAN_NO_SIMD)
+#if defined(__AVX2__)
+#define CMD_HAVE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CMD_HAVE_SSE2 1
+#endif
+#endif
+
+#if defined(CMD_HAVE_AVX2)
+#include <immintrin.h>
+#elif defined(CMD_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+static __inline unsigned ctz32(uint32_t v)
+{
+    unsigned long i;
+    _BitScanForward(&i, v);
+    return (unsigned)i;
+}
+#else
+#define ctz32(v) ((unsigned)__builtin_ctz(v))
+#endif
+
+#define WCHAR_IS_16BIT (WCHAR_MAX <= 0xFFFF)
+
+// units per SIMD block, several blocks per 32-unit mask
+#if defined(CMD_HAVE_AVX2)
+#define BLOCK (WCHAR_IS_16BIT ? 16 : 8)
+#elif defined(CMD_HAVE_SSE2)
+#define BLOCK (WCHAR_IS_16BIT ? 8 : 4)
+#endif
+
+const char* cmd_scan_simd_name(void)
+{
+#if defined(CMD_HAVE_AVX2)
+    return "avx2";
+#elif defined(CMD_HAVE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+static const char* const k_keywords[CMD_FLAG_COUNT] = {
+    "-enc", "frombase64string", "iex", "invoke-", "downloadstring", "bypass", "hidden", "nop",
+};
+
+size_t cmd_scan_flags_text(uint32_t flags, char out[CMD_FLAGS_TEXT_MAX])
+{
+    size_t n = 0;
+    for (int i = 0; i < CMD_FLAG_COUNT; i++) {
+        if (!(flags & (1u << i))) continue;
+        if (n) out[n++] = ',';
+        size_t k = strlen(k_keywords[i]);
+        memcpy(out + n, k_keywords[i], k);
+        n += k;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// ============================================================
+// risk_path_tier (image, scalar: short and once per process)
+// ============================================================
+// keywords: str.lower() in enrich.py. KELVIN SIGN is the one non-ASCII unit it maps to
+// a single ASCII letter (U+0130 becomes "i" + U+0307, never a keyword)
+static uint32_t fold(uint32_t c)
+{
+    if (c >= 'A' && c <= 'Z') return c + 32;
+    return c == 0x212A ? 'k' : c;
+}
+
+// path hints: re.IGNORECASE also matches LONG S / DOTLESS I / DOTTED CAPITAL I
+static uint32_t fold_ci(uint32_t c)
+{
+    switch (c) {
+    case 0x017F: return 's';
+    case 0x0131: case 0x0130: return 'i';
+    default: return fold(c);
+    }
+}
+
+// s[i..]가 lit (소문자 ASCII)로 시작하면 1
+static int starts_with(const wchar_t* s, size_t i, size_t n, const char* lit)
+{
+    for (; *lit; lit++, i++) {
+        if (i >= n || fold((uint32_t)s[i]) != (uint32_t)(uint8_t)*lit) return 0;
+    }
+    return 1;
+}
+
+static int path_starts_with(const wchar_t* s, size_t i, size_t n, const char* lit)
+{
+    for (; *lit; lit++, i++) {
+        if (i >= n || fold_ci((uint32_t)s[i]) != (uint32_t)(uint8_t)*lit) return 0;
+    }
+    return 1;
+}
+
+// \Users\[^\\]+\<rest> at s[i] = '\'
+static int users_subdir(const wchar_t* s, size_t i, size_t n)
+{
+    if (!path_starts_with(s, i, n, "\\users\\")) return 0;
+    size_t j = i + 7, k = j;
+    while (k < n && s[k] != L'\\') k++;
+    if (k == j || k == n) return 0;
+    k++;
+    return path_starts_with(s, k, n, "appdata\\local\\temp\\") || path_starts_with(s, k, n, "downloads\\") ||
+           path_starts_with(s, k, n, "desktop\\");
+}
+
+// hints all start with '\': only those positions are checked
+int cmd_scan_tier(const wchar_t* image)
+{
+    if (!image || !image[0]) return 0;
+    size_t n = wcslen(image);
+    int low = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (image[i] != L'\\') continue;
+        if (users_subdir(image, i, n) || path_starts_with(image, i, n, "\\appdata\\roaming\\")) return 2;
+        low |= path_starts_with(image, i, n, "\\windows\\system32\\") ||
+               path_starts_with(image, i, n, "\\program files\\") ||
+               path_starts_with(image, i, n, "\\program files (x86)\\");
+    }
+    return low ? 0 : 1;
+}
+
+// ============================================================
+// cmdline: per-unit class masks
+//   c:    base64 alphabet [A-Za-z0-9+/]
+//   cand: (unit, next unit) is the first two units of a keyword
+//         (-e fr ie in do by hi no), ASCII case-folded by | 0x20
+// - word chars (\b) only matter inside a run of 120+, rescanned by long_run
+// ============================================================
+static int is_b64(uint32_t c)
+{
+    uint32_t l = c | 0x20;
+    return (l >= 'a' && l <= 'z') || (c >= '0' && c <= '9') || c == '+' || c == '/';
+}
+
+// ASCII only: callers treat units >= 0x80 as unknown (word_at)
+static int is_word(uint32_t c)
+{
+    uint32_t l = c | 0x20;
+    return (l >= 'a' && l <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static int is_cand(uint32_t c0, uint32_t c1)
+{
+    c0 |= 0x20;
+    c1 |= 0x20;
+    switch (c0) {
+    case '-': return c1 == 'e';
+    case 'f': return c1 == 'r';
+    case 'i': return c1 == 'e' || c1 == 'n';
+    case 'd': case 'n': return c1 == 'o';
+    case 'b': return c1 == 'y';
+    case 'h': return c1 == 'i';
+    default: return 0;
+    }
+}
+
+// units [i, i + m), m <= 32
+static void masks_scalar(const wchar_t* s, size_t n, size_t i, unsigned m, uint32_t* c, uint32_t* cand)
+{
+    uint32_t mc = 0, mk = 0;
+    for (unsigned k = 0; k < m; k++) {
+        uint32_t u = (uint32_t)s[i + k];
+        uint32_t nx = i + k + 1 < n ? (uint32_t)s[i + k + 1] : 0;
+        mc |= (uint32_t)is_b64(u) << k;
+        mk |= (uint32_t)is_cand(u, nx) << k;
+    }
+    *c = mc;
+    *cand = mk;
+}
+
+// SIMD blocks: reads s[0, BLOCK] (one past the block for the keyword pair)
+#if WCHAR_IS_16BIT
+
+#if defined(CMD_HAVE_AVX2)
+static void masks_block(const wchar_t* s, uint32_t* c, uint32_t* cand)
+{
+#define SET(x) _mm256_set1_epi16((short)(x))
+#define EQ(a, x) _mm256_cmpeq_epi16((a), SET(x))
+#define IN(a, lo, hi) _mm256_and_si256(_mm256_cmpgt_epi16((a), SET((lo) - 1)), _mm256_cmpgt_epi16(SET((hi) + 1), (a)))
+    __m256i v = _mm256_loadu_si256((const __m256i*)s);
+    __m256i l = _mm256_or_si256(v, SET(0x20));
+    __m256i l1 = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(s + 1)), SET(0x20));
+
+    __m256i mc = _mm256_or_si256(_mm256_or_si256(IN(l, 'a', 'z'), IN(v, '0', '9')),
+                                 _mm256_or_si256(EQ(v, '+'), EQ(v, '/')));
+    __m256i mk = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(EQ(l, '-'), EQ(l1, 'e')), _mm256_and_si256(EQ(l, 'f'), EQ(l1, 'r'))),
+        _mm256_or_si256(_mm256_and_si256(EQ(l, 'i'), _mm256_or_si256(EQ(l1, 'e'), EQ(l1, 'n'))),
+                        _mm256_and_si256(_mm256_or_si256(EQ(l, 'd'), EQ(l, 'n')), EQ(l1, 'o'))));
+    mk = _mm256_or_si256(mk, _mm256_or_si256(_mm256_and_si256(EQ(l, 'b'), EQ(l1, 'y')),
+                                             _mm256_and_si256(EQ(l, 'h'), EQ(l1, 'i'))));
+
+    // pack per 128-bit lane, qwords 0 2 1 3 -> [c 0..15][cand 0..15]
+    uint32_t ck = (uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(_mm256_packs_epi16(mc, mk), 0xD8));
+    *c = ck & 0xFFFF;
+    *cand = ck >> 16;
+#undef SET
+#undef EQ
+#undef IN
+}
+#elif defined(CMD_HAVE_SSE2)
+static void masks_block(const wchar_t* s, uint32_t* c, uint32_t* cand)
+{
+#define SET(x) _mm_set1_epi16((short)(x))
+#define EQ(a, x) _mm_cmpeq_epi16((a), SET(x))
+#define IN(a, lo, hi) _mm_and_si128(_mm_cmpgt_epi16((a), SET((lo) - 1)), _mm_cmplt_epi16((a), SET((hi) + 1)))
+    __m128i v = _mm_loadu_si128((const __m128i*)s);
+    __m128i l = _mm_or_si128(v, SET(0x20));
+    __m128i l1 = _mm_or_si128(_mm_loadu_si128((const __m128i*)(s + 1)), SET(0x20));
+
+    __m128i mc = _mm_or_si128(_mm_or_si128(IN(l, 'a', 'z'), IN(v, '0', '9')), _mm_or_si128(EQ(v, '+'), EQ(v, '/')));
+    __m128i mk = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(EQ(l, '-'), EQ(l1, 'e')), _mm_and_si128(EQ(l, 'f'), EQ(l1, 'r'))),
+        _mm_or_si128(_mm_and_si128(EQ(l, 'i'), _mm_or_si128(EQ(l1, 'e'), EQ(l1, 'n'))),
+                     _mm_and_si128(_mm_or_si128(EQ(l, 'd'), EQ(l, 'n')), EQ(l1, 'o'))));
+    mk = _mm_or_si128(mk, _mm_or_si128(_mm_and_si128(EQ(l, 'b'), EQ(l1, 'y')),
+                                       _mm_and_si128(EQ(l, 'h'), EQ(l1, 'i'))));
+
+    uint32_t ck = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(mc, mk));  // [c 0..7][cand 0..7]
+    *c = ck & 0xFF;
+    *cand = ck >> 8;
+#undef SET
+#undef EQ
+#undef IN
+}
+#endif
+
+#else // 32-bit wchar_t
+
+#if defined(CMD_HAVE_AVX2)
+static void masks_block(const wchar_t* s, uint32_t* c, uint32_t* cand)
+{
+#define SET(x) _mm256_set1_epi32((int)(x))
+#define EQ(a, x) _mm256_cmpeq_epi32((a), SET(x))
+#define IN(a, lo, hi) _mm256_and_si256(_mm256_cmpgt_epi32((a), SET((lo) - 1)), _mm256_cmpgt_epi32(SET((hi) + 1), (a)))
+    __m256i v = _mm256_loadu_si256((const __m256i*)s);
+    __m256i l = _mm256_or_si256(v, SET(0x20));
+    __m256i l1 = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(s + 1)), SET(0x20));
+
+    __m256i mc = _mm256_or_si256(_mm256_or_si256(IN(l, 'a', 'z'), IN(v, '0', '9')),
+                                 _mm256_or_si256(EQ(v, '+'), EQ(v, '/')));
+    __m256i mk = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(EQ(l, '-'), EQ(l1, 'e')), _mm256_and_si256(EQ(l, 'f'), EQ(l1, 'r'))),
+        _mm256_or_si256(_mm256_and_si256(EQ(l, 'i'), _mm256_or_si256(EQ(l1, 'e'), EQ(l1, 'n'))),
+                        _mm256_and_si256(_mm256_or_si256(EQ(l, 'd'), EQ(l, 'n')), EQ(l1, 'o'))));
+    mk = _mm256_or_si256(mk, _mm256_or_si256(_mm256_and_si256(EQ(l, 'b'), EQ(l1, 'y')),
+                                             _mm256_and_si256(EQ(l, 'h'), EQ(l1, 'i'))));
+
+    // 32 -> 16 -> 8 bit (signed saturation keeps -1 / 0): bytes [c 0..7][c][cand 0..7][cand]
+    __m256i ck = _mm256_permute4x64_epi64(_mm256_packs_epi32(mc, mk), 0xD8);
+    uint32_t bits = (uint32_t)_mm256_movemask_epi8(_mm256_packs_epi16(ck, ck));
+    *c = bits & 0xFF;
+    *cand = (bits >> 16) & 0xFF;
+#undef SET
+#undef EQ
+#undef IN
+}
+#elif defined(CMD_HAVE_SSE2)
+static void masks_block(const wchar_t* s, uint32_t* c, uint32_t* cand)
+{
+#define SET(x) _mm_set1_epi32((int)(x))
+#define EQ(a, x) _mm_cmpeq_epi32((a), SET(x))
+#define IN(a, lo, hi) _mm_and_si128(_mm_cmpgt_epi32((a), SET((lo) - 1)), _mm_cmplt_epi32((a), SET((hi) + 1)))
+    __m128i v = _mm_loadu_si128((const __m128i*)s);
+    __m128i l = _mm_or_si128(v, SET(0x20));
+    __m128i l1 = _mm_or_si128(_mm_loadu_si128((const __m128i*)(s + 1)), SET(0x20));
+
+    __m128i mc = _mm_or_si128(_mm_or_si128(IN(l, 'a', 'z'), IN(v, '0', '9')), _mm_or_si128(EQ(v, '+'), EQ(v, '/')));
+    __m128i mk = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(EQ(l, '-'), EQ(l1, 'e')), _mm_and_si128(EQ(l, 'f'), EQ(l1, 'r'))),
+        _mm_or_si128(_mm_and_si128(EQ(l, 'i'), _mm_or_si128(EQ(l1, 'e'), EQ(l1, 'n'))),
+                     _mm_and_si128(_mm_or_si128(EQ(l, 'd'), EQ(l, 'n')), EQ(l1, 'o'))));
+    mk = _mm_or_si128(mk, _mm_or_si128(_mm_and_si128(EQ(l, 'b'), EQ(l1, 'y')),
+                                       _mm_and_si128(EQ(l, 'h'), EQ(l1, 'i'))));
+
+    __m128i ck = _mm_packs_epi32(mc, mk);   // [c 0..3][cand 0..3] as 16-bit
+    uint32_t bits = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(ck, ck));
+    *c = bits & 0xF;
+    *cand = (bits >> 4) & 0xF;
+#undef SET
+#undef EQ
+#undef IN
+}
+#endif
+
+#endif
+
+// ============================================================
+// cmdline scan
+// - base64 runs: only run start / end bits (c ^ c << 1) are visited;
+//   a run of CMD_BASE64_MIN_RUN+ is rescanned once for \b (each unit read at most twice)
+// - keywords: cand bits -> the one or two keywords starting with that pair
+// ============================================================
+typedef struct SCAN_STATE {
+    uint32_t prev_c;            // previous unit in the base64 alphabet
+    size_t run;                 // current run start
+    uint32_t flags;
+    int b64;
+    int undecided;              // a long run whose \b depends on a non-ASCII unit
+} SCAN_STATE;
+
+// 1 / 0, -1: unit >= 0x80 (Unicode \w class unknown here). end of text: 0
+static int word_at(const wchar_t* s, size_t n, size_t i)
+{
+    if (i >= n) return 0;
+    return (uint32_t)s[i] >= 0x80 ? -1 : is_word((uint32_t)s[i]);
+}
+
+// [a, b): maximal run of the base64 alphabet (ASCII), b - a >= CMD_BASE64_MIN_RUN
+// \b[...]{120,}={0,2}\b inside it: earliest \b start .. latest \b end >= 120 apart
+// - both found by walking in from the run's ends (usually a few units: '+' '/' are rare)
+// - a non-ASCII neighbour (before a, at b / after '=' '==') may be word or not:
+//   start / end bounds for both, -1 if the answer differs
+static int long_run(const wchar_t* s, size_t n, size_t a, size_t b)
+{
+    // start: a if \b there, else the first word / non-word change inside the run
+    int wa = is_word((uint32_t)s[a]);
+    size_t inner = a + 1;
+    while (inner < b && is_word((uint32_t)s[inner]) == wa) inner++;
+    int pw = a > 0 ? word_at(s, n, a - 1) : 0;
+    size_t start_lo = pw == wa ? inner : a;
+    size_t start_hi = pw < 0 || pw == wa ? inner : a;
+
+    // end: b if \b there or after '=' / '==' (not a word char) followed by a word char,
+    // else the last change inside the run
+    int wl = is_word((uint32_t)s[b - 1]);
+    int at_b = word_at(s, n, b);
+    if (at_b >= 0) {
+        at_b = wl != at_b;
+        if (!at_b && b < n && s[b] == L'=') {
+            at_b = word_at(s, n, b + 1);
+            if (!at_b && b + 1 < n && s[b + 1] == L'=') at_b = word_at(s, n, b + 2);
+        }
+    }
+    size_t end_in = b - 1;
+    while (end_in > a && is_word((uint32_t)s[end_in - 1]) == wl) end_in--;
+    size_t end_lo = at_b > 0 ? b : end_in;
+    size_t end_hi = at_b != 0 ? b : end_in;
+
+    if (end_lo >= start_hi + CMD_BASE64_MIN_RUN) return 1;
+    if (end_hi < start_lo + CMD_BASE64_MIN_RUN) return 0;
+    return -1;
+}
+
+#define KW(bit, lit)                                                            \
+    do {                                                                        \
+        if (!(st->flags & (bit)) && starts_with(s, p, n, (lit))) st->flags |= (bit); \
+    } while (0)
+
+// s[p], s[p + 1]: a cand pair
+static void keyword_at(SCAN_STATE* st, const wchar_t* s, size_t n, size_t p)
+{
+    switch ((uint32_t)s[p] | 0x20) {
+    case '-': KW(CMD_FLAG_ENC, "-enc"); break;
+    case 'f': KW(CMD_FLAG_FROMBASE64STRING, "frombase64string"); break;
+    case 'i':
+        if (((uint32_t)s[p + 1] | 0x20) == 'e') KW(CMD_FLAG_IEX, "iex");
+        else KW(CMD_FLAG_INVOKE, "invoke-");
+        break;
+    case 'd': KW(CMD_FLAG_DOWNLOADSTRING, "downloadstring"); break;
+    case 'b': KW(CMD_FLAG_BYPASS, "bypass"); break;
+    case 'h': KW(CMD_FLAG_HIDDEN, "hidden"); break;
+    case 'n': KW(CMD_FLAG_NOP, "nop"); break;
+    default: break;
+    }
+}
+
+#undef KW
+
+// units [i, i + m) with their masks
+static void scan_block(SCAN_STATE* st, const wchar_t* s, size_t n, size_t i, unsigned m, uint32_t c, uint32_t cand)
+{
+    uint32_t all = m == 32 ? 0xFFFFFFFFu : (1u << m) - 1;
+    uint32_t edge = st->b64 ? 0 : (c ^ ((c << 1) | st->prev_c)) & all;
+    while (edge) {
+        unsigned p = ctz32(edge);
+        edge &= edge - 1;
+        size_t q = i + p;
+        if ((c >> p) & 1) {
+            st->run = q;
+        } else if (q - st->run >= CMD_BASE64_MIN_RUN) {
+            int r = long_run(s, n, st->run, q);
+            if (r > 0) st->b64 = 1;
+            else if (r < 0) st->undecided = 1;
+        }
+    }
+
+    if (st->flags == (1u << CMD_FLAG_COUNT) - 1) cand = 0;
+    while (cand) {
+        unsigned p = ctz32(cand);
+        cand &= cand - 1;
+        keyword_at(st, s, n, i + p);
+    }
+
+    st->prev_c = (c >> (m - 1)) & 1;
+}
+
+uint32_t cmd_scan_cmdline(const wchar_t* s, size_t n, int* base64_sus)
+{
+    SCAN_STATE st;
+    memset(&st, 0, sizeof(st));
+
+    // 32 units per scan_block: SIMD blocks while one unit past the block is readable, then scalar
+    for (size_t i = 0; i < n;) {
+        unsigned m = 0;
+        uint32_t c = 0, cand = 0, bc, bk;
+#if defined(CMD_HAVE_AVX2) || defined(CMD_HAVE_SSE2)
+        for (; m + BLOCK <= 32 && i + m + BLOCK + 1 <= n; m += BLOCK) {
+            masks_block(s + i + m, &bc, &bk);
+            c |= bc << m;
+            cand |= bk << m;
+        }
+#endif
+        if (m < 32 && i + m < n) {
+            unsigned k = n - i - m < 32 - m ? (unsigned)(n - i - m) : 32 - m;
+            masks_scalar(s, n, i + m, k, &bc, &bk);
+            c |= bc << m;
+            cand |= bk << m;
+            m += k;
+        }
+        scan_block(&st, s, n, i, m, c, cand);
+        i += m;
+        if (st.b64 && st.flags == (1u << CMD_FLAG_COUNT) - 1) break;
+    }
+    // end of text closes a run
+    if (st.prev_c && !st.b64 && n - st.run >= CMD_BASE64_MIN_RUN) {
+        int r = long_run(s, n, st.run, n);
+        if (r > 0) st.b64 = 1;
+        else if (r < 0) st.undecided = 1;
+    }
+
+    if (base64_sus) *base64_sus = st.b64 ? 1 : st.undecided ? -1 : 0;
+    return st.flags;
+}
+
+void cmd_scan(const wchar_t* image, const wchar_t* cmdline, CMD_SCAN* out)
+{
+    int b64 = 0;
+    out->tier = (uint8_t)cmd_scan_tier(image);
+    out->flags = (uint16_t)(cmdline ? cmd_scan_cmdline(cmdline, wcslen(cmdline), &b64) : 0);
+    out->base64_sus = (uint8_t)(b64 > 0);
+    out->undecided = (uint8_t)(b64 < 0);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// ============================================================
+// Command-line heuristics at proc_start (was analyzer enrich.py, per process in Python)
+// - risk_path_tier: image path hints (HIGH_RISK_PATH_HINTS / LOW_RISK_PATH_HINTS)
+// - cmd_flags: CMD_FLAG_KEYWORDS found anywhere in the cmdline (ASCII case-folded)
+// - base64_sus: BASE64_LIKE, \b[A-Za-z0-9+/]{120,}={0,2}\b
+//   word chars: ASCII alnum and '_'. Python's \w is Unicode (letters / digits of every
+//   script, not NBSP / U+2028 / emoji): when a unit >= 0x80 next to a run of 120+ decides
+//   the match, the scan is left undecided and the analyzer (enrich.py) checks the row
+// - one pass over the cmdline: SSE2/AVX2 blocks give per-unit class masks
+//   (base64 alphabet, keyword first two units); only run starts / ends and keyword
+//   candidates are visited, a run of 120+ is checked for \b from its two ends -> linear
+// - build with CMD_SCAN_NO_SIMD for the scalar masks (same results)
+// - scans the decoded cmdline (EVREC_CMDLINE_CAP): the same text the analyzer sees
+// ============================================================
+
+// bit i = CMD_FLAG_KEYWORDS[i] in enrich.py (order matters: binary output carries the bits)
+#define CMD_FLAG_ENC              0x01      // -enc
+#define CMD_FLAG_FROMBASE64STRING 0x02
+#define CMD_FLAG_IEX              0x04
+#define CMD_FLAG_INVOKE           0x08      // invoke-
+#define CMD_FLAG_DOWNLOADSTRING   0x10
+#define CMD_FLAG_BYPASS           0x20
+#define CMD_FLAG_HIDDEN           0x40
+#define CMD_FLAG_NOP              0x80
+#define CMD_FLAG_COUNT            8
+
+#define CMD_BASE64_MIN_RUN        120
+#define CMD_FLAGS_TEXT_MAX        96        // "-enc,frombase64string,..." all flags + NUL
+
+typedef struct CMD_SCAN {
+    uint16_t flags;             // CMD_FLAG_*
+    uint8_t tier;               // 0: low (system paths / no image), 1: unknown, 2: high (user-writable)
+    uint8_t base64_sus;
+    uint8_t undecided;          // 1: base64_sus depends on Unicode \w -> fields omitted, enrich.py scans
+} CMD_SCAN;
+
+// image: NUL-terminated, may be NULL
+int cmd_scan_tier(const wchar_t* image);
+
+// cmdline units [0, n). *base64_sus: 1, 0, or -1 (undecided: non-ASCII unit at a run boundary)
+uint32_t cmd_scan_cmdline(const wchar_t* s, size_t n, int* base64_sus);
+
+void cmd_scan(const wchar_t* image, const wchar_t* cmdline, CMD_SCAN* out);
+
+// flags -> "kw1,kw2" in keyword order (enrich.py cmd_flags). returns length
+size_t cmd_scan_flags_text(uint32_t flags, char out[CMD_FLAGS_TEXT_MAX]);
+
+// which block scanner was compiled in ("avx2", "sse2", "scalar")
+const char* cmd_scan_simd_name(void);
@@ -0,0 +1,126 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "collector_stats.h"
+#include "config.h"
+#include "jsonl_writer.h"
+#include "plat.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static STATS_SOURCE_THREAD g_source;
+static STATS_SOURCE_THREAD g_workers[COLLECTOR_STATS_WORKERS_MAX];
+static uint32_t g_nworkers = 0;
+static STATS_WRITER_THREAD g_writer;
+static EVENT_SOURCE* g_src = NULL;
+
+// writer thread only: 이전 interval 끝의 snapshot
+static uint64_t g_interval_start_ns = 0;
+static LAT_HIST g_prev_decode, g_prev_serialize, g_prev_write, g_prev_latency;
+static LAT_HIST g_cur, g_delta, g_part;
+
+void collector_stats_reset(uint32_t workers)
+{
+    memset(&g_source, 0, sizeof(g_source));
+    memset(g_workers, 0, sizeof(g_workers));
+    g_nworkers = workers < COLLECTOR_STATS_WORKERS_MAX ? workers : COLLECTOR_STATS_WORKERS_MAX;
+    memset(&g_writer, 0, sizeof(g_writer));
+    lat_hist_reset(&g_prev_decode);
+    lat_hist_reset(&g_prev_serialize);
+    lat_hist_reset(&g_prev_write);
+    lat_hist_reset(&g_prev_latency);
+    g_interval_start_ns = plat_now_ns();
+    g_src = NULL;
+}
+
+STATS_SOURCE_THREAD* collector_stats_source(void) { return &g_source; }
+STATS_SOURCE_THREAD* collector_stats_worker(uint32_t i) { return i < g_nworkers ? &g_workers[i] : NULL; }
+STATS_WRITER_THREAD* collector_stats_writer(void) { return &g_writer; }
+
+void collector_stats_attach(EVENT_SOURCE* src) { g_src = src; }
+
+int collector_stats_due(uint64_t now_ns)
+{
+    return COLLECTOR_STATS_INTERVAL_SEC &&
+           now_ns - g_interval_start_ns >= (uint64_t)COLLECTOR_STATS_INTERVAL_SEC * 1000000000ULL;
+}
+
+// "name":{"n":..,"p50":..,"p99":..,"p999":..} for cur - prev, prev <- cur
+static int put_hist(char* out, size_t cap, const char* name, LAT_HIST* prev)
+{
+    lat_hist_sub(&g_delta, &g_cur, prev);
+    *prev = g_cur;
+    return snprintf(out, cap, ",\"%s\":{\"n\":%llu,\"p50\":%llu,\"p99\":%llu,\"p999\":%llu}", name,
+                    (unsigned long long)g_delta.count,
+                    (unsigned long long)lat_hist_quantile(&g_delta, 0.5),
+                    (unsigned long long)lat_hist_quantile(&g_delta, 0.99),
+                    (unsigned long long)lat_hist_quantile(&g_delta, 0.999));
+}
+
+// source thread + decode workers
+static uint64_t source_sum(size_t field_off)
+{
+    uint64_t v = plat_counter_load((const volatile uint64_t*)((const uint8_t*)&g_source + field_off));
+    for (uint32_t i = 0; i < g_nworkers; i++) {
+        v += plat_counter_load((const volatile uint64_t*)((const uint8_t*)&g_workers[i] + field_off));
+    }
+    return v;
+}
+#define SOURCE_SUM(f) source_sum(offsetof(STATS_SOURCE_THREAD, f))
+
+static void decode_snapshot(LAT_HIST* out)
+{
+    lat_hist_snapshot(out, &g_source.decode_ns);
+    for (uint32_t i = 0; i < g_nworkers; i++) {
+        lat_hist_snapshot(&g_part, &g_workers[i].decode_ns);
+        lat_hist_merge(out, &g_part);
+    }
+}
+
+static void serialize_snapshot(LAT_HIST* out) { lat_hist_snapshot(out, &g_writer.serialize_ns); }
+static void latency_snapshot(LAT_HIST* out) { lat_hist_snapshot(out, &g_writer.latency_ns); }
+
+size_t collector_stats_format(char* out, size_t cap, uint64_t now_ns)
+{
+    uint64_t lost_events = 0, lost_buffers = 0;
+    if (g_src && g_src->get_loss) g_src->get_loss(g_src, &lost_events, &lost_buffers);
+
+    JSONL_STATS js;
+    jsonl_get_stats(&js);
+
+    size_t n = 0;
+    int k = snprintf(out, cap,
+                     "\"interval_ms\":%llu,\"source\":\"%s\",\"events\":%llu,\"routed\":%llu,\"filtered\":%llu,\"dropped\":%llu,\"tags\":%llu,"
+                     "\"decode_fallbacks\":%llu,\"decode_failures\":%llu,\"events_lost\":%llu,\"buffers_lost\":%llu,"
+                     "\"written\":%llu,\"bytes\":%llu,\"segments\":%llu,\"write_lost\":%llu",
+                     (unsigned long long)((now_ns - g_interval_start_ns) / 1000000ULL),
+                     g_src && g_src->name ? g_src->name : "",
+                     (unsigned long long)SOURCE_SUM(events),
+                     (unsigned long long)SOURCE_SUM(routed),
+                     (unsigned long long)SOURCE_SUM(filtered),
+                     (unsigned long long)SOURCE_SUM(dropped),
+                     (unsigned long long)SOURCE_SUM(tags),
+                     (unsigned long long)SOURCE_SUM(decode_fallbacks),
+                     (unsigned long long)SOURCE_SUM(decode_failures),
+                     (unsigned long long)lost_events, (unsigned long long)lost_buffers,
+                     (unsigned long long)g_writer.written, (unsigned long long)js.bytes,
+                     (unsigned long long)js.segments, (unsigned long long)js.lost);
+    if (k < 0 || (size_t)k >= cap) return 0;
+    n += (size_t)k;
+
+    struct { const char* name; void (*snapshot)(LAT_HIST* out); LAT_HIST* prev; } hists[] = {
+        { "decode_ns", decode_snapshot, &g_prev_decode },
+        { "serialize_ns", serialize_snapshot, &g_prev_serialize },
+        { "write_ns", jsonl_get_write_latency, &g_prev_write },
+        { "latency_ns", latency_snapshot, &g_prev_latency },
+    };
+    for (size_t i = 0; i < sizeof(hists) / sizeof(hists[0]); i++) {
+        hists[i].snapshot(&g_cur);
+        k = put_hist(out + n, cap - n, hists[i].name, hists[i].prev);
+        if (k < 0 || (size_t)k >= cap - n) return 0;
+        n += (size_t)k;
+    }
+
+    g_interval_start_ns = now_ns;
+    return n;
+}
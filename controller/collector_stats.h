@@ -0,0 +1,61 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_source.h"
+#include "lat_hist.h"
+
+// ============================================================
+// Collector self-stats
+// - one block per thread, every field has exactly one writer
+//   (plat_counter_add: no lock prefix, no shared cache line between threads)
+// - latency histograms are sampled: 1 of COLLECTOR_STATS_SAMPLE events
+//   (all of them when PIPELINE_TIMING)
+// - decode workers (pipeline.h) get their own source-side block, the
+//   record sums them (decode_ns histograms merged)
+// - the writer thread emits a collector_stats record every
+//   COLLECTOR_STATS_INTERVAL_SEC (jsonl_write_collector_stats):
+//   counters are cumulative since start, percentiles are per interval
+// ============================================================
+
+typedef struct STATS_SOURCE_THREAD {     // pipeline_on_event (source thread) / decode worker
+    uint64_t events;            // sink calls
+    uint64_t routed;            // reached a handler
+    uint64_t filtered;          // dropped by the drop filter (source thread only)
+    uint64_t decode_fallbacks;  // fixed layout failed (TDH / source decoder)
+    uint64_t decode_failures;   // no decoder produced the fields
+    uint64_t dropped;           // no ring slot / worker queue full (RING_FULL_DROP_NEWEST / SAMPLE)
+    uint64_t tags;              // rules fired at process start (rule_engine.h)
+    LAT_HIST decode_ns;         // sampled: route + decode + process state + ring slot
+    uint8_t pad_[64];
+} STATS_SOURCE_THREAD;
+
+typedef struct STATS_WRITER_THREAD {     // event_writer thread
+    uint64_t written;           // records serialized
+    LAT_HIST serialize_ns;      // sampled: jsonl_write_* (format + buffer)
+    LAT_HIST latency_ns;        // sampled: pipeline entry -> serialized (ring wait included)
+    uint8_t pad_[64];
+} STATS_WRITER_THREAD;
+
+#define COLLECTOR_STATS_WORKERS_MAX 16
+
+// pipeline_init에서 호출. workers: decode worker 수 (0: source thread가 decode)
+void collector_stats_reset(uint32_t workers);
+STATS_SOURCE_THREAD* collector_stats_source(void);
+STATS_SOURCE_THREAD* collector_stats_worker(uint32_t i);     // i < workers
+STATS_WRITER_THREAD* collector_stats_writer(void);
+
+// loss counters (ETW EventsLost/BuffersLost, netlink overruns) from src->get_loss
+// src must outlive the writer thread. NULL: none
+void collector_stats_attach(EVENT_SOURCE* src);
+
+// ============================================================
+// writer thread
+// ============================================================
+// interval 경과: 1 (COLLECTOR_STATS_INTERVAL_SEC 0: never)
+int collector_stats_due(uint64_t now_ns);
+
+// record fields (JSON object members, no braces) for the elapsed interval,
+// starts the next interval. returns length (0: cap too small)
+#define COLLECTOR_STATS_FIELDS_MAX 1024
+size_t collector_stats_format(char* out, size_t cap, uint64_t now_ns);
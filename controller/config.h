@@ -2,10 +2,77 @@
 
 // output
 #define DEFAULT_OUTPUT_PATH L"telemetry-raw.jsonl"
+#define DEFAULT_BINARY_OUTPUT_PATH L"telemetry-raw.msb"
+
+// output writer (jsonl_writer.h)
+#define JSONL_WRITE_MODE        JSONL_MODE_BUFFERED   // LINE: fflush per event
+#define JSONL_BUFFER_BYTES      (256 * 1024)          // flush by size
+#define JSONL_FLUSH_AGE_MS      50                    // flush by age
+#define JSONL_FSYNC_INTERVAL_MS 0                     // 0: no fsync
+#define JSONL_OUTPUT_FORMAT     JSONL_FORMAT_TEXT     // BINARY: bin_format.h (bin2jsonl to convert)
+#define JSONL_BINARY_DICT_MAX   65536                 // host/image ids per file before DICT_RESET
+
+// output segments (segment.h): <stem>.000001<ext>, <path>.index
+#define JSONL_ROTATE_BYTES        (64ULL * 1024 * 1024)  // 0: no size rotation
+#define JSONL_ROTATE_INTERVAL_SEC 3600                   // 0: no time rotation
+#define JSONL_COMPRESS_SEGMENTS   1                      // closed segment -> .gz (background thread)
+#define JSONL_COMPRESS_QUEUE      16                     // pending segments before skipping compression
+#define JSONL_REOPEN_RETRY_MS     1000                   // next segment failed to open: retry from jsonl_tick
 
 // kernel flags
 #define KERNEL_FLAGS (EVENT_TRACE_FLAG_PROCESS | EVENT_TRACE_FLAG_NETWORK_TCPIP)
 
+// decoding
+// 1: kernel Process/TcpIp UserData를 고정 layout으로 직접 파싱 (unknown version만 TDH)
+#define DECODE_FIXED_LAYOUT 1
+
+// timestamps: EventHeader.TimeStamp, fraction digits 3 (ms) or 6 (us) (TEXT output)
+#define TS_FRACTION_DIGITS 3
+
+// callback -> writer thread ring (event_ring.h)
+#define EVENT_RING_CAPACITY    1024                    // slots (power of 2), ~6KB each
+#define EVENT_RING_FULL_POLICY RING_FULL_DROP_NEWEST   // BLOCK / DROP_NEWEST / SAMPLE
+#define EVENT_RING_SAMPLE_N    8
+
+// decode workers (pipeline.h): source thread routes + copies, N threads decode (PID-sharded)
+#define PIPELINE_WORKERS            4                  // 0: decode on the source thread
+#define PIPELINE_WORKER_QUEUE_BYTES (1024 * 1024)      // raw event queue per worker (power of 2)
+#define PIPELINE_REORDER_MS         20                 // writer merge: max wait for a worker with pending input
+#define PIPELINE_SCRATCH_BYTES      (64 * 1024)        // decode scratch arena per decoding thread (scratch.h)
+
+// drop filter (event_filter.h): config path from the collector's command line
+#define FILTER_PID_SLOTS 8192                   // processes dropped at start, followed by pid (power of 2)
+
+// pid -> process guid table (pid_map.h)
+#define PID_MAP_INITIAL_CAP   0                  // slots (power of 2), grows to fit MAX_ENTRIES; 0: MAX_ENTRIES at start
+#define PID_MAP_MAX_ENTRIES   131072             // 0: unbounded
+#define PID_MAP_MAX_AGE_SEC   (72 * 3600)        // no event for this long -> evict (lost end event)
+#define PID_MAP_SWEEP_BUDGET  8                  // slots inspected per event
+
+// process table (proc_table.h): image / parent per process guid
+#define PROC_TABLE_MAX_RECORDS 65536              // oldest last_seen evicted beyond this
+#define PROC_TABLE_INITIAL_RECORDS 0              // grows to MAX_RECORDS; 0: MAX_RECORDS at start (~4 MB, no growth after warm-up)
+#define PROC_TABLE_POOL_BYTES  (8 * 1024 * 1024)  // interned image paths
+#define NET_INLINE_PROCESS     1                  // net_connect: + image, parent_process_guid
+#define PROC_CMD_SCAN          1                  // proc_start: + risk_path_tier, cmd_flags, base64_sus (cmd_scan.h)
+
+// net_connect aggregation on the writer thread (flow_agg.h)
+#define NET_FLOW_WINDOW_SEC    0                  // 0: off, N: first connect + net_flow_summary every N s per flow
+#define NET_FLOW_MAX_FLOWS     16384              // flows tracked at once, beyond: oldest flow closed early
+
+// Linux source (linux_consumer.h)
+#define LINUX_PROC_CACHE_SLOTS 4096               // pid-indexed (power of 2): fork ppid / exec state
+#define LINUX_NETLINK_RCVBUF   (4 * 1024 * 1024)  // proc connector socket buffer (ENOBUFS -> lost events)
+
+// collector self-stats (collector_stats.h)
+#define COLLECTOR_STATS_INTERVAL_SEC 60          // collector_stats record period, 0: off
+#define COLLECTOR_STATS_SAMPLE       64          // 1 of N events timed (power of 2)
+
+// per-stage timing (pipeline.h): 2 clock reads per stage -> bench builds (-DPIPELINE_TIMING=1)
+#ifndef PIPELINE_TIMING
+#define PIPELINE_TIMING 0
+#endif
+
 // buffer
 #define JSON_BUFFER_SIZE 4096
 
@@ -3,5 +3,23 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
+#include "event_dispatch.h"
+
 int etw_consume(const wchar_t* session_name);
 void etw_consumer_request_stop(void);
+
+// routing을 통과한 raw event를 path에 기록 (replay.h, Linux에서 재생). NULL: off
+// etw_consume 전에 호출, path는 etw_consume이 끝날 때까지 유효해야 함
+void etw_consumer_set_record_path(const wchar_t* path);
+
+// drop filter config (event_filter.h), loaded at etw_consume. NULL: off. 못 읽으면 etw_consume 실패
+void etw_consumer_set_filter_path(const wchar_t* path);
+
+// tagging rules (rule_engine.h, rules/mitre_rules.yaml), loaded at etw_consume. NULL: off. 못 읽으면 etw_consume 실패
+void etw_consumer_set_rules_path(const wchar_t* path);
+
+// 추가 이벤트 타입 handler 등록 (etw_consume 전에 호출). 성공: 1, 실패: 0
+// kernel MOF events use id 0 and route on opcode
+// handler의 ev는 const RAW_EVENT* (PEVENT_RECORD는 ev->native)
+int etw_consumer_register(const GUID* provider, USHORT id, UCHAR opcode,
+                          EVENT_HANDLER handler, void* ctx);
@@ -0,0 +1,69 @@
+#include "event_dispatch.h"
+
+#include <string.h>
+
+static uint64_t key_hash(const uint8_t provider[16], uint16_t id, uint8_t opcode)
+{
+    uint64_t a, b;
+    memcpy(&a, provider, 8);
+    memcpy(&b, provider + 8, 8);
+    uint64_t h = a ^ (b * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t)id << 8) ^ opcode;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+void dispatch_init(EVENT_DISPATCH* d)
+{
+    memset(d, 0, sizeof(*d));
+}
+
+int dispatch_register(EVENT_DISPATCH* d, const void* provider, uint16_t id, uint8_t opcode,
+                      EVENT_HANDLER handler, void* ctx)
+{
+    if (!d || !provider || !handler) return 0;
+
+    uint64_t h = key_hash((const uint8_t*)provider, id, opcode);
+    size_t idx = (size_t)(h & (DISPATCH_CAP - 1));
+
+    for (size_t probe = 0; probe < DISPATCH_CAP; probe++) {
+        DISPATCH_ENTRY* e = &d->slots[idx];
+        if (e->used && e->id == id && e->opcode == opcode && memcmp(e->provider, provider, 16) == 0) {
+            e->handler = handler;
+            e->ctx = ctx;
+            return 1;
+        }
+        if (!e->used) {
+            // keep load factor <= 0.5 so misses stop early
+            if ((d->size + 1) * 2 > DISPATCH_CAP) return 0;
+            memcpy(e->provider, provider, 16);
+            e->id = id;
+            e->opcode = opcode;
+            e->handler = handler;
+            e->ctx = ctx;
+            e->used = 1;
+            d->size++;
+            d->bloom |= 1ULL << (h >> 58);
+            return 1;
+        }
+        idx = (idx + 1) & (DISPATCH_CAP - 1);
+    }
+    return 0;
+}
+
+const DISPATCH_ENTRY* dispatch_lookup(const EVENT_DISPATCH* d, const void* provider,
+                                      uint16_t id, uint8_t opcode)
+{
+    uint64_t h = key_hash((const uint8_t*)provider, id, opcode);
+    if (!(d->bloom & (1ULL << (h >> 58)))) return NULL;
+
+    size_t idx = (size_t)(h & (DISPATCH_CAP - 1));
+    for (size_t probe = 0; probe < DISPATCH_CAP; probe++) {
+        const DISPATCH_ENTRY* e = &d->slots[idx];
+        if (!e->used) return NULL;
+        if (e->id == id && e->opcode == opcode && memcmp(e->provider, provider, 16) == 0) return e;
+        idx = (idx + 1) & (DISPATCH_CAP - 1);
+    }
+    return NULL;
+}
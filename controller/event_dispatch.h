@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// Integer-keyed event dispatch
+// - key: provider GUID (16 bytes, in-memory layout) + EventDescriptor.Id/Opcode
+//   (kernel MOF events: Id == 0, routing by Opcode)
+// - portable: the event pointer is opaque (RAW_EVENT, event_source.h)
+// ============================================================
+
+typedef void (*EVENT_HANDLER)(void* ev, void* ctx);
+
+typedef struct DISPATCH_ENTRY {
+    uint8_t provider[16];
+    uint16_t id;
+    uint8_t opcode;
+    uint8_t used;
+    EVENT_HANDLER handler;
+    void* ctx;
+} DISPATCH_ENTRY;
+
+#define DISPATCH_CAP 64   // power of 2, handlers are few
+
+typedef struct EVENT_DISPATCH {
+    DISPATCH_ENTRY slots[DISPATCH_CAP];
+    size_t size;
+    uint64_t bloom;       // 1 bit per registered key hash: cheap reject before probing
+} EVENT_DISPATCH;
+
+void dispatch_init(EVENT_DISPATCH* d);
+
+// 성공: 1, table full: 0. 같은 key면 handler 교체
+int dispatch_register(EVENT_DISPATCH* d, const void* provider, uint16_t id, uint8_t opcode,
+                      EVENT_HANDLER handler, void* ctx);
+
+// NULL -> 관심 없는 이벤트 (TDH 호출 없이 drop)
+const DISPATCH_ENTRY* dispatch_lookup(const EVENT_DISPATCH* d, const void* provider,
+                                      uint16_t id, uint8_t opcode);
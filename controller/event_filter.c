@@ -0,0 +1,464 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "event_filter.h"
+#include "plat.h"
+#include "segment.h"   // seg_fopen (wide path)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// image suffix trie
+// - patterns inserted reversed: matching walks the image from its last byte
+// ============================================================
+static uint8_t fold(uint8_t c)
+{
+    if (c >= 'A' && c <= 'Z') return (uint8_t)(c + 32);
+    return c == '/' ? '\\' : c;
+}
+
+static int is_sep(uint8_t c) { return c == '\\' || c == '/'; }
+
+static uint32_t trie_new(EVENT_FILTER* f, uint8_t c)
+{
+    if (f->trie_count == f->trie_cap) {
+        uint32_t cap = f->trie_cap ? f->trie_cap * 2 : 256;
+        FILTER_TRIE_NODE* t = (FILTER_TRIE_NODE*)realloc(f->trie, cap * sizeof(FILTER_TRIE_NODE));
+        if (!t) return 0;
+        f->trie = t;
+        f->trie_cap = cap;
+        if (f->trie_count == 0) f->trie_count = 1;     // node 0: "none"
+    }
+    uint32_t k = f->trie_count++;
+    FILTER_TRIE_NODE* n = &f->trie[k];
+    n->child = 0;
+    n->sibling = 0;
+    n->rule = -1;
+    n->c = c;
+    n->boundary = 0;
+    return k;
+}
+
+static int trie_insert(EVENT_FILTER* f, const char* s, size_t len, uint32_t rule)
+{
+    uint32_t cur = 0;     // 0: root (root[] table)
+    for (size_t i = len; i-- > 0; ) {
+        uint8_t c = fold((uint8_t)s[i]);
+        uint32_t k = cur ? f->trie[cur].child : f->root[c];
+        if (cur) {
+            while (k && f->trie[k].c != c) k = f->trie[k].sibling;
+        }
+        if (!k) {
+            k = trie_new(f, c);
+            if (!k) return 0;
+            if (cur) {
+                f->trie[k].sibling = f->trie[cur].child;
+                f->trie[cur].child = k;
+            } else {
+                f->root[c] = k;
+            }
+        }
+        cur = k;
+    }
+    // 같은 pattern이 두 번: 앞의 rule
+    if (f->trie[cur].rule < 0) {
+        f->trie[cur].rule = (int32_t)rule;
+        f->trie[cur].boundary = (uint8_t)is_sep((uint8_t)s[0]);
+    }
+    return 1;
+}
+
+int event_filter_image(const EVENT_FILTER* f, const char* image, size_t len)
+{
+    if (!f->image_rules) return -1;
+    const uint8_t* s = (const uint8_t*)image;
+    while (len && s[len - 1] == 0) len--;
+    if (!len) return -1;
+
+    size_t i = len - 1;
+    uint32_t k = f->root[fold(s[i])];
+    while (k) {
+        const FILTER_TRIE_NODE* n = &f->trie[k];
+        // suffix는 경로 경계에서만: "cl.exe"는 "\cl.exe"에 맞고 "ntcl.exe"에는 안 맞음
+        if (n->rule >= 0 && (n->boundary || i == 0 || is_sep(s[i - 1]))) return n->rule;
+        if (i == 0) break;
+        uint8_t c = fold(s[--i]);
+        for (k = n->child; k && f->trie[k].c != c; k = f->trie[k].sibling) {}
+    }
+    return -1;
+}
+
+// ============================================================
+// destination prefix tables
+// - address as 128-bit (hi, lo), IPv4 in the top 32 bits of hi
+// - one sorted run per prefix length: mask + binary search, longest first
+// ============================================================
+static uint64_t be64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+static void addr_key(uint8_t family, const uint8_t* addr, uint64_t* hi, uint64_t* lo)
+{
+    if (family == 4) {
+        *hi = (uint64_t)(((uint32_t)addr[0] << 24) | ((uint32_t)addr[1] << 16) |
+                         ((uint32_t)addr[2] << 8) | addr[3]) << 32;
+        *lo = 0;
+    } else {
+        *hi = be64(addr);
+        *lo = be64(addr + 8);
+    }
+}
+
+static void prefix_mask(uint32_t len, uint64_t* hi, uint64_t* lo)
+{
+    *hi = len >= 64 ? ~0ULL : len ? ~0ULL << (64 - len) : 0;
+    *lo = len >= 128 ? ~0ULL : len > 64 ? ~0ULL << (128 - len) : 0;
+}
+
+static int prefix_cmp(const void* a, const void* b)
+{
+    const FILTER_PREFIX* x = (const FILTER_PREFIX*)a;
+    const FILTER_PREFIX* y = (const FILTER_PREFIX*)b;
+    if (x->len != y->len) return x->len > y->len ? -1 : 1;
+    if (x->hi != y->hi) return x->hi < y->hi ? -1 : 1;
+    if (x->lo != y->lo) return x->lo < y->lo ? -1 : 1;
+    return x->rule < y->rule ? -1 : x->rule > y->rule;
+}
+
+static int prefix_add(FILTER_PREFIX_TABLE* t, const uint8_t* addr, uint8_t family, uint32_t len, uint32_t rule)
+{
+    FILTER_PREFIX* p = (FILTER_PREFIX*)realloc(t->prefixes, (t->count + 1) * sizeof(FILTER_PREFIX));
+    if (!p) return 0;
+    t->prefixes = p;
+
+    uint64_t mh, ml;
+    FILTER_PREFIX* e = &p[t->count++];
+    addr_key(family, addr, &e->hi, &e->lo);
+    prefix_mask(len, &mh, &ml);
+    e->hi &= mh;
+    e->lo &= ml;
+    e->len = (uint8_t)len;
+    e->rule = rule;
+    return 1;
+}
+
+static void prefix_compile(FILTER_PREFIX_TABLE* t)
+{
+    if (!t->count) return;
+    qsort(t->prefixes, t->count, sizeof(FILTER_PREFIX), prefix_cmp);
+
+    // 중복 prefix: 앞의 rule만 남김
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < t->count; i++) {
+        const FILTER_PREFIX* e = &t->prefixes[i];
+        if (n && t->prefixes[n - 1].len == e->len && t->prefixes[n - 1].hi == e->hi &&
+            t->prefixes[n - 1].lo == e->lo) continue;
+        t->prefixes[n++] = *e;
+    }
+    t->count = n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (t->ngroups && t->prefixes[i].len == t->prefixes[t->groups[t->ngroups - 1].first].len) {
+            t->groups[t->ngroups - 1].count++;
+            continue;
+        }
+        FILTER_PREFIX_GROUP* g = &t->groups[t->ngroups++];
+        g->first = i;
+        g->count = 1;
+        prefix_mask(t->prefixes[i].len, &g->mask_hi, &g->mask_lo);
+    }
+}
+
+static int prefix_find(const FILTER_PREFIX_TABLE* t, uint64_t hi, uint64_t lo)
+{
+    for (uint32_t gi = 0; gi < t->ngroups; gi++) {
+        const FILTER_PREFIX_GROUP* g = &t->groups[gi];
+        uint64_t kh = hi & g->mask_hi, kl = lo & g->mask_lo;
+        const FILTER_PREFIX* p = t->prefixes + g->first;
+        uint32_t lo_i = 0, hi_i = g->count;
+        while (lo_i < hi_i) {
+            uint32_t m = (lo_i + hi_i) / 2;
+            if (p[m].hi < kh || (p[m].hi == kh && p[m].lo < kl)) lo_i = m + 1;
+            else hi_i = m;
+        }
+        if (lo_i < g->count && p[lo_i].hi == kh && p[lo_i].lo == kl) return (int)p[lo_i].rule;
+    }
+    return -1;
+}
+
+int event_filter_dst(const EVENT_FILTER* f, uint8_t family, const uint8_t* addr)
+{
+    if (!f->dst_rules || !addr) return -1;
+    const FILTER_PREFIX_TABLE* t = family == 4 ? &f->v4 : family == 6 ? &f->v6 : NULL;
+    if (!t || !t->ngroups) return -1;
+
+    uint64_t hi, lo;
+    addr_key(family, addr, &hi, &lo);
+    return prefix_find(t, hi, lo);
+}
+
+// ============================================================
+// config parsing
+// ============================================================
+static int hex_val(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static int parse_v4(const char* s, uint8_t out[4])
+{
+    for (int i = 0; i < 4; i++) {
+        unsigned v = 0;
+        int d = 0;
+        while (*s >= '0' && *s <= '9') {
+            v = v * 10 + (unsigned)(*s++ - '0');
+            if (++d > 3 || v > 255) return 0;
+        }
+        if (!d) return 0;
+        out[i] = (uint8_t)v;
+        if (i < 3 && *s++ != '.') return 0;
+    }
+    return *s == '\0';
+}
+
+// x:x:x:x:x:x:x:x, "::" 한 번까지 (embedded IPv4 표기는 없음)
+static int parse_v6(const char* s, uint8_t out[16])
+{
+    uint16_t head[8], tail[8];
+    int nh = 0, nt = 0, gap = 0;
+
+    if (s[0] == ':') {
+        if (s[1] != ':') return 0;
+        gap = 1;
+        s += 2;
+    }
+    while (*s) {
+        unsigned v = 0;
+        int d = 0;
+        for (int h; (h = hex_val(*s)) >= 0; s++) {
+            v = v * 16 + (unsigned)h;
+            if (++d > 4) return 0;
+        }
+        if (!d || nh + nt == 8) return 0;
+        if (gap) tail[nt++] = (uint16_t)v;
+        else head[nh++] = (uint16_t)v;
+
+        if (!*s) break;
+        if (*s++ != ':') return 0;
+        if (*s == ':') {
+            if (gap) return 0;
+            gap = 1;
+            s++;
+        } else if (!*s) {
+            return 0;
+        }
+    }
+    if (gap ? nh + nt > 7 : nh != 8) return 0;
+
+    memset(out, 0, 16);
+    for (int i = 0; i < nh; i++) {
+        out[i * 2] = (uint8_t)(head[i] >> 8);
+        out[i * 2 + 1] = (uint8_t)head[i];
+    }
+    for (int i = 0; i < nt; i++) {
+        int o = (8 - nt + i) * 2;
+        out[o] = (uint8_t)(tail[i] >> 8);
+        out[o + 1] = (uint8_t)tail[i];
+    }
+    return 1;
+}
+
+static int add_dst(EVENT_FILTER* f, const char* cidr, uint32_t rule)
+{
+    char buf[FILTER_TEXT_MAX];
+    strcpy(buf, cidr);
+
+    char* slash = strchr(buf, '/');
+    uint8_t addr[16];
+    uint8_t family = strchr(buf, ':') ? 6 : 4;
+    uint32_t max = family == 4 ? 32 : 128;
+    uint32_t len = max;
+    if (slash) {
+        *slash = '\0';
+        char* end = NULL;
+        unsigned long n = strtoul(slash + 1, &end, 10);
+        if (end == slash + 1 || *end || n > max) return 0;
+        len = (uint32_t)n;
+    }
+    if (family == 4 ? !parse_v4(buf, addr) : !parse_v6(buf, addr)) return 0;
+    return prefix_add(family == 4 ? &f->v4 : &f->v6, addr, family, len, rule);
+}
+
+static char* trim(char* s)
+{
+    while (*s == ' ' || *s == '\t') s++;
+    size_t n = strlen(s);
+    while (n && (s[n - 1] == ' ' || s[n - 1] == '\t' || s[n - 1] == '\r' || s[n - 1] == '\n')) s[--n] = '\0';
+    return s;
+}
+
+static int parse_line(EVENT_FILTER* f, char* line, uint32_t lineno)
+{
+    char* s = trim(line);
+    if (!*s || *s == '#') return 1;
+
+    char* val = s;
+    while (*val && *val != ' ' && *val != '\t') val++;
+    if (*val) *val++ = '\0';
+    val = trim(val);
+
+    uint32_t kind = strcmp(s, "image") == 0 ? FILTER_IMAGE : strcmp(s, "dst") == 0 ? FILTER_DST : 0;
+    const char* err = NULL;
+    if (!kind) err = "unknown rule (image / dst)";
+    else if (!*val) err = "missing pattern";
+    else if (strlen(val) >= FILTER_TEXT_MAX) err = "pattern too long";
+    else if (f->nrules == FILTER_RULES_MAX) err = "too many rules";
+    if (err) {
+        fprintf(stderr, "filter: line %u: %s\n", lineno, err);
+        return 0;
+    }
+
+    uint32_t idx = f->nrules;
+    FILTER_RULE* r = &f->rules[idx];
+    memset(r, 0, sizeof(*r));
+    r->kind = kind;
+    r->line = lineno;
+    strcpy(r->text, val);
+
+    int ok = kind == FILTER_IMAGE ? trie_insert(f, val, strlen(val), idx) : add_dst(f, val, idx);
+    if (!ok) {
+        fprintf(stderr, "filter: line %u: bad %s pattern: %s\n", lineno, s, val);
+        return 0;
+    }
+    f->nrules++;
+    if (kind == FILTER_IMAGE) f->image_rules++;
+    else f->dst_rules++;
+    return 1;
+}
+
+int event_filter_load(EVENT_FILTER* f, const wchar_t* path, uint32_t pid_slots)
+{
+    memset(f, 0, sizeof(*f));
+    if (!path || pid_slots < 16 || (pid_slots & (pid_slots - 1))) return 0;
+
+    FILE* fp = seg_fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "filter: config open failed\n");
+        return 0;
+    }
+
+    f->rules = (FILTER_RULE*)calloc(FILTER_RULES_MAX, sizeof(FILTER_RULE));
+    f->pids = (FILTER_PID*)calloc(pid_slots, sizeof(FILTER_PID));
+    f->pid_cap = pid_slots;
+    int ok = f->rules && f->pids;
+
+    char line[512];
+    uint32_t lineno = 0;
+    while (ok && fgets(line, sizeof(line), fp)) {
+        lineno++;
+        if (!strchr(line, '\n') && !feof(fp)) {
+            fprintf(stderr, "filter: line %u: too long\n", lineno);
+            ok = 0;
+            break;
+        }
+        ok = parse_line(f, line, lineno);
+    }
+    fclose(fp);
+
+    if (!ok) {
+        event_filter_free(f);
+        return 0;
+    }
+    prefix_compile(&f->v4);
+    prefix_compile(&f->v6);
+    return 1;
+}
+
+void event_filter_free(EVENT_FILTER* f)
+{
+    if (!f) return;
+    free(f->rules);
+    free(f->trie);
+    free(f->v4.prefixes);
+    free(f->v6.prefixes);
+    free(f->pids);
+    memset(f, 0, sizeof(*f));
+}
+
+// ============================================================
+// processes dropped at start (pid -> rule)
+// ============================================================
+static uint32_t pid_home(const EVENT_FILTER* f, uint32_t pid)
+{
+    return (uint32_t)(((uint64_t)pid * 0x9E3779B97F4A7C15ULL) >> 32) & (f->pid_cap - 1);
+}
+
+void event_filter_pid_put(EVENT_FILTER* f, uint32_t pid, int rule)
+{
+    if (!pid || !f->pids) return;
+    uint32_t mask = f->pid_cap - 1;
+    uint32_t i = pid_home(f, pid);
+    for (; f->pids[i].pid; i = (i + 1) & mask) {
+        if (f->pids[i].pid == pid) {
+            f->pids[i].rule = (uint32_t)rule;
+            return;
+        }
+    }
+    // 반까지만 채움: 못 넣으면 그 process의 end / connect는 통과
+    if (f->pid_count + 1 > f->pid_cap / 2) {
+        f->st.pid_overflow++;
+        return;
+    }
+    f->pids[i].pid = pid;
+    f->pids[i].rule = (uint32_t)rule;
+    f->pid_count++;
+}
+
+int event_filter_pid_get(const EVENT_FILTER* f, uint32_t pid)
+{
+    if (!f->pid_count || !pid) return -1;
+    uint32_t mask = f->pid_cap - 1;
+    for (uint32_t i = pid_home(f, pid); f->pids[i].pid; i = (i + 1) & mask) {
+        if (f->pids[i].pid == pid) return (int)f->pids[i].rule;
+    }
+    return -1;
+}
+
+void event_filter_pid_del(EVENT_FILTER* f, uint32_t pid)
+{
+    if (!f->pid_count || !pid) return;
+    uint32_t mask = f->pid_cap - 1;
+    uint32_t i = pid_home(f, pid);
+    while (f->pids[i].pid != pid) {
+        if (!f->pids[i].pid) return;
+        i = (i + 1) & mask;
+    }
+
+    // backward shift: home이 (i, j] 밖인 entry를 빈 칸으로 당김
+    for (uint32_t j = i;;) {
+        j = (j + 1) & mask;
+        if (!f->pids[j].pid) break;
+        uint32_t home = pid_home(f, f->pids[j].pid);
+        int between = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+        if (!between) {
+            f->pids[i] = f->pids[j];
+            i = j;
+        }
+    }
+    f->pids[i].pid = 0;
+    f->pid_count--;
+}
+
+void event_filter_hit(EVENT_FILTER* f, int rule, int followed)
+{
+    FILTER_RULE* r = &f->rules[rule];
+    plat_counter_add(&r->hits, 1);
+    if (followed) plat_counter_add(&r->followed, 1);
+    plat_counter_add(&f->st.dropped, 1);
+}
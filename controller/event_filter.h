@@ -0,0 +1,105 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// ============================================================
+// Pre-decode drop filters (source thread, pipeline_on_event)
+// - config file, one rule per line ('#' comment):
+//     image <suffix>   process image ends with suffix at a path boundary
+//                      (ASCII case-insensitive, '/' == '\\')
+//     dst   <cidr>     net_connect destination in prefix (a.b.c.d/n, x:x::x/n)
+// - compiled at load: image rules -> reversed suffix trie, dst rules ->
+//   per prefix length sorted tables (longest prefix first)
+// - matched on raw UserData bytes (ANSI / UTF-8 image, network order address),
+//   before any string conversion
+// - a process dropped at start is followed by pid: its end and connects are
+//   dropped too (children keep their ppid, parent_process_guid is "")
+// - single-threaded (source thread). hit counters: plat_counter_add
+// ============================================================
+
+#define FILTER_RULES_MAX   1024
+#define FILTER_TEXT_MAX    128
+
+typedef enum FILTER_KIND {
+    FILTER_IMAGE = 1,
+    FILTER_DST,
+} FILTER_KIND;
+
+typedef struct FILTER_RULE {
+    uint32_t kind;              // FILTER_KIND
+    uint32_t line;              // config line
+    char text[FILTER_TEXT_MAX]; // pattern as written
+    uint64_t hits;              // events dropped by this rule
+    uint64_t followed;          // ... of which end / connect of a process dropped at start
+} FILTER_RULE;
+
+typedef struct FILTER_TRIE_NODE {
+    uint32_t child;             // first child (0: none, node 0 is the root)
+    uint32_t sibling;
+    int32_t rule;               // pattern ends here: rule index, else -1
+    uint8_t c;
+    uint8_t boundary;           // pattern starts with a separator: no boundary check
+} FILTER_TRIE_NODE;
+
+typedef struct FILTER_PREFIX {
+    uint64_t hi, lo;            // masked address (IPv4: top 32 bits of hi)
+    uint32_t rule;
+    uint8_t len;
+} FILTER_PREFIX;
+
+typedef struct FILTER_PREFIX_GROUP {
+    uint32_t first, count;      // FILTER_PREFIX range, sorted by (hi, lo)
+    uint64_t mask_hi, mask_lo;
+} FILTER_PREFIX_GROUP;
+
+typedef struct FILTER_PREFIX_TABLE {
+    FILTER_PREFIX* prefixes;
+    uint32_t count;
+    FILTER_PREFIX_GROUP groups[129];    // one per distinct length, longest first
+    uint32_t ngroups;
+} FILTER_PREFIX_TABLE;
+
+typedef struct FILTER_PID {
+    uint32_t pid;               // 0: empty
+    uint32_t rule;
+} FILTER_PID;
+
+typedef struct FILTER_STATS {
+    uint64_t dropped;           // all rules
+    uint64_t pid_overflow;      // pid set full: end / connects of a dropped process passed
+} FILTER_STATS;
+
+typedef struct EVENT_FILTER {
+    FILTER_RULE* rules;
+    uint32_t nrules;
+    uint32_t image_rules;
+    uint32_t dst_rules;
+
+    FILTER_TRIE_NODE* trie;
+    uint32_t trie_count, trie_cap;
+    uint32_t root[256];         // root children by first (last) byte
+
+    FILTER_PREFIX_TABLE v4, v6;
+
+    FILTER_PID* pids;           // open addressing, backward-shift delete
+    uint32_t pid_cap;           // power of 2, filled to half at most
+    uint32_t pid_count;
+
+    FILTER_STATS st;
+} EVENT_FILTER;
+
+// 성공: 1, 실패: 0 (open / parse error -> stderr with the line). pid_slots: power of 2
+int event_filter_load(EVENT_FILTER* f, const wchar_t* path, uint32_t pid_slots);
+void event_filter_free(EVENT_FILTER* f);
+
+// rule index or -1
+int event_filter_image(const EVENT_FILTER* f, const char* image, size_t len);
+int event_filter_dst(const EVENT_FILTER* f, uint8_t family, const uint8_t* addr);    // family 4 / 6
+
+// processes dropped at start
+void event_filter_pid_put(EVENT_FILTER* f, uint32_t pid, int rule);
+int event_filter_pid_get(const EVENT_FILTER* f, uint32_t pid);      // rule or -1
+void event_filter_pid_del(EVENT_FILTER* f, uint32_t pid);
+
+void event_filter_hit(EVENT_FILTER* f, int rule, int followed);
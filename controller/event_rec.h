@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <wchar.h>
+
+#include "cmd_scan.h"
+
+// ============================================================
+// Decoded event record (fixed size, one ring slot)
+// - filled by the ETW callback, serialized by the writer thread
+// ============================================================
+
+#define EVREC_IMAGE_CAP   1024   // wchar_t
+#define EVREC_CMDLINE_CAP 2048   // wchar_t
+#define EVREC_TAGS_MAX    8      // rules fired at one proc_start (rule_engine.h), beyond: dropped
+
+typedef enum EVREC_TYPE {
+    EVREC_NONE = 0,
+    EVREC_PROC_START,
+    EVREC_PROC_END,
+    EVREC_NET_CONNECT,
+} EVREC_TYPE;
+
+typedef struct EVENT_REC {
+    uint32_t type;                  // EVREC_TYPE
+    uint32_t pid;
+    uint32_t ppid;
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint16_t ntags;                 // PROC_START: tags[] used
+    uint16_t tags[EVREC_TAGS_MAX];  // rule indices (RULE_ENGINE.rules), rules file order
+    CMD_SCAN scan;                  // PROC_START: image / cmdline heuristics (PROC_CMD_SCAN)
+
+    uint64_t ts_100ns;              // EventHeader.TimeStamp (FILETIME, UTC)
+    uint64_t origin_ns;             // sampled: plat_now_ns() at pipeline entry (latency), else 0
+    char process_guid[64];
+    char parent_guid[64];           // "" if unknown (pid_map lookup of ppid)
+    char src_ip[64];                // IPv6 text max 45, decoders write up to 64
+    char dst_ip[64];
+
+    wchar_t image[EVREC_IMAGE_CAP];  // NET_CONNECT: inlined from process table
+    wchar_t cmdline[EVREC_CMDLINE_CAP];
+} EVENT_REC;
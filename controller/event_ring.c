@@ -0,0 +1,123 @@
+#include "event_ring.h"
+#include "plat.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int ring_init(EVENT_RING* r, size_t slot_size, size_t cap_pow2, RING_FULL_POLICY policy, uint32_t sample_n)
+{
+    memset(r, 0, sizeof(*r));
+    if (!slot_size || cap_pow2 < 2 || (cap_pow2 & (cap_pow2 - 1))) return 0;
+
+    // slot은 cache line 단위로 맞춤 (false sharing 방지)
+    slot_size = (slot_size + 63) & ~(size_t)63;
+    r->slots = (uint8_t*)calloc(cap_pow2, slot_size);
+    if (!r->slots) return 0;
+
+    r->slot_size = slot_size;
+    r->cap = cap_pow2;
+    r->mask = cap_pow2 - 1;
+    r->policy = policy;
+    r->sample_n = sample_n ? sample_n : 1;
+    return 1;
+}
+
+void ring_free(EVENT_RING* r)
+{
+    if (!r) return;
+    free(r->slots);
+    memset(r, 0, sizeof(*r));
+}
+
+void ring_close(EVENT_RING* r)
+{
+    plat_store_i32(&r->closed, 1);
+}
+
+// ============================================================
+// producer
+// ============================================================
+static uint64_t refresh_used(EVENT_RING* r, uint64_t head)
+{
+    r->cached_tail = plat_load_acquire_u64(&r->tail);
+    return head - r->cached_tail;
+}
+
+void* ring_reserve(EVENT_RING* r)
+{
+    uint64_t head = r->head;
+    uint64_t used = head - r->cached_tail;
+
+    if (used >= r->cap) used = refresh_used(r, head);
+
+    if (r->policy == RING_FULL_SAMPLE && used >= r->cap - r->cap / 4) {
+        // high watermark(75%): 최신 값으로 다시 보고 그래도 높으면 sampling
+        used = refresh_used(r, head);
+        if (used >= r->cap - r->cap / 4 && (r->sample_ctr++ % r->sample_n) != 0) {
+            r->pstats.dropped_sampled++;
+            return NULL;
+        }
+    }
+
+    if (used >= r->cap) {
+        if (r->policy != RING_FULL_BLOCK) {
+            r->pstats.dropped_full++;
+            return NULL;
+        }
+
+        // spin -> yield -> sleep backoff
+        for (uint32_t spins = 0; used >= r->cap; spins++) {
+            if (plat_load_i32(&r->closed)) {
+                r->pstats.dropped_full++;
+                return NULL;
+            }
+            r->pstats.block_waits++;
+            if (spins < 64) {
+                // busy
+            } else if (spins < 128) {
+                plat_yield();
+            } else {
+                plat_sleep_ms(1);
+            }
+            used = refresh_used(r, head);
+        }
+    }
+
+    if (used + 1 > r->pstats.high_water) r->pstats.high_water = used + 1;
+    return r->slots + (size_t)(head & r->mask) * r->slot_size;
+}
+
+void ring_commit(EVENT_RING* r)
+{
+    r->pstats.pushed++;
+    plat_store_release_u64(&r->head, r->head + 1);
+}
+
+// ============================================================
+// consumer
+// ============================================================
+void* ring_peek(EVENT_RING* r)
+{
+    uint64_t tail = r->tail;
+    if (tail == r->cached_head) {
+        r->cached_head = plat_load_acquire_u64(&r->head);
+        if (tail == r->cached_head) return NULL;
+    }
+    return r->slots + (size_t)(tail & r->mask) * r->slot_size;
+}
+
+void ring_release(EVENT_RING* r)
+{
+    plat_store_release_u64(&r->tail, r->tail + 1);
+}
+
+int ring_is_empty(EVENT_RING* r)
+{
+    return plat_load_acquire_u64(&r->head) == plat_load_acquire_u64(&r->tail);
+}
+
+void ring_get_stats(EVENT_RING* r, RING_STATS* out)
+{
+    *out = r->pstats;
+    out->popped = plat_load_acquire_u64(&r->tail);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// Bounded single-producer / single-consumer ring of fixed-size slots
+// - producer: ETW callback thread, consumer: writer thread
+// - lock-free (head/tail acquire/release), portable via plat.h
+// ============================================================
+
+typedef enum RING_FULL_POLICY {
+    RING_FULL_BLOCK = 0,     // producer waits for space (backpressure into ETW)
+    RING_FULL_DROP_NEWEST,   // new event dropped when full
+    RING_FULL_SAMPLE,        // above high watermark keep 1 of sample_n, drop when full
+} RING_FULL_POLICY;
+
+typedef struct RING_STATS {
+    uint64_t pushed;
+    uint64_t popped;
+    uint64_t dropped_full;
+    uint64_t dropped_sampled;
+    uint64_t block_waits;    // producer backoff rounds (BLOCK policy)
+    uint64_t high_water;     // max occupancy seen by producer
+} RING_STATS;
+
+typedef struct EVENT_RING {
+    uint8_t* slots;
+    size_t slot_size;
+    uint64_t cap;            // power of 2
+    uint64_t mask;
+    RING_FULL_POLICY policy;
+    uint32_t sample_n;
+
+    // producer side
+    char pad0[64];
+    volatile uint64_t head;
+    uint64_t cached_tail;
+    uint64_t sample_ctr;
+    RING_STATS pstats;       // written by producer only
+
+    // consumer side
+    char pad1[64];
+    volatile uint64_t tail;
+    uint64_t cached_head;
+
+    char pad2[64];
+    volatile int32_t closed; // consumer gone -> producer never blocks
+} EVENT_RING;
+
+// 성공: 1, 실패: 0
+int ring_init(EVENT_RING* r, size_t slot_size, size_t cap_pow2, RING_FULL_POLICY policy, uint32_t sample_n);
+void ring_free(EVENT_RING* r);
+
+// producer: slot to fill, or NULL if the event is dropped by policy
+void* ring_reserve(EVENT_RING* r);
+void ring_commit(EVENT_RING* r);
+
+// consumer: next filled slot or NULL if empty
+void* ring_peek(EVENT_RING* r);
+void ring_release(EVENT_RING* r);
+
+void ring_close(EVENT_RING* r);
+int ring_is_empty(EVENT_RING* r);
+
+// snapshot (counters are monotonic; cross-thread reads are approximate)
+void ring_get_stats(EVENT_RING* r, RING_STATS* out);
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================
+// Event source abstraction
+// - a source produces RAW_EVENTs (header fields + UserData) and pushes
+//   them into a sink (pipeline_on_event) on its own thread
+// - ETW real-time session (etw_consumer.c), replay file (replay.h), ...
+// - portable: Windows-only details stay behind RAW_EVENT.native
+// ============================================================
+
+typedef struct RAW_EVENT {
+    uint8_t provider[16];       // GUID, in-memory layout
+    uint16_t id;                // EventDescriptor.Id (kernel MOF: 0)
+    uint8_t opcode;
+    uint8_t version;
+    uint16_t flags;             // EventHeader.Flags
+    uint8_t ptr_size;           // 4 or 8 (UserData pointer fields)
+    uint32_t pid;               // EventHeader.ProcessId / ThreadId
+    uint32_t tid;
+    uint64_t ts_100ns;          // FILETIME (UTC)
+    const void* user_data;
+    uint32_t user_data_len;
+    void* native;               // PEVENT_RECORD (ETW) or NULL: TDH fallback needs it
+} RAW_EVENT;
+
+typedef void (*RAW_EVENT_SINK)(const RAW_EVENT* ev, void* ctx);
+
+typedef struct EVENT_SOURCE EVENT_SOURCE;
+
+struct EVENT_SOURCE {
+    const char* name;
+
+    // 입력 끝 또는 stop까지 block, sink는 이 thread에서 호출. 성공: 1, 실패: 0
+    int (*run)(EVENT_SOURCE* src, RAW_EVENT_SINK sink, void* ctx);
+
+    // any thread (Ctrl+C handler 등)
+    void (*request_stop)(EVENT_SOURCE* src);
+
+    void (*close)(EVENT_SOURCE* src);
+
+    // cumulative loss reported by the source (ETW EventsLost/BuffersLost, netlink overruns)
+    // any thread (writer thread, collector_stats). NULL: source cannot lose events. 성공: 1
+    int (*get_loss)(EVENT_SOURCE* src, uint64_t* events_lost, uint64_t* buffers_lost);
+    void* impl;
+};
@@ -0,0 +1,355 @@
+#include "event_writer.h"
+#include "collector_stats.h"
+#include "config.h"
+#include "jsonl_writer.h"
+#include "lat_hist.h"
+#include "plat.h"
+
+#include <string.h>
+
+static EVENT_RING g_rings[EVENT_WRITER_LANES_MAX];
+static uint32_t g_lanes = 0;
+static PLAT_TLS uint32_t t_lane = 0;    // producer thread's ring (event_writer_set_lane)
+static PLAT_THREAD g_thread;
+static volatile int32_t g_running = 0;
+static volatile int32_t g_stop_req = 0;
+static wchar_t g_host[256] = L"";
+
+static int g_net_inline = 0;
+static const RULE_ENGINE* g_rules;  // EVENT_REC.tags -> rule text
+
+// net_connect aggregation (writer thread only, g_flows.flows NULL: off)
+static FLOW_AGG g_flows;
+static FLOW_AGG_STATS g_flow_final;
+
+// writer thread only
+static STATS_WRITER_THREAD* g_ws;   // collector_stats.h
+static uint64_t g_write_ns = 0;     // PIPELINE_TIMING
+
+// lane merge (writer thread only)
+static int (*g_lane_pending)(uint32_t lane);
+static uint64_t g_reorder_ns = 0;
+static uint64_t g_wait_start = 0;   // 0: not holding
+static uint64_t g_last_ts = 0;
+static EVENT_WRITER_MERGE_STATS g_merge;
+static RING_STATS g_final;          // ring stats at stop (rings are freed)
+
+// timestamp 문자열(TEXT) / varint(BINARY)는 jsonl_writer가 writer thread에서 만듦
+static void write_rec(const EVENT_REC* r)
+{
+    uint64_t ts = r->ts_100ns;
+
+    switch (r->type) {
+    case EVREC_PROC_START:
+        jsonl_write_proc_start(ts, r->pid, r->ppid, r->image, r->cmdline, r->process_guid, r->parent_guid, g_host,
+                               PROC_CMD_SCAN && !r->scan.undecided ? &r->scan : NULL);
+        for (uint32_t i = 0; g_rules && i < r->ntags; i++) {
+            const RULE* rl = &g_rules->rules[r->tags[i]];
+            jsonl_write_tag(ts, r->process_guid, rl->id, rl->technique, rl->severity, rl->evidence);
+        }
+        break;
+    case EVREC_PROC_END:
+        jsonl_write_proc_end(ts, r->pid, r->process_guid);
+        break;
+    case EVREC_NET_CONNECT:
+        if (g_flows.flows && !flow_agg_connect(&g_flows, r)) break;
+        jsonl_write_net_connect(ts, r->pid, r->process_guid,
+                                r->src_ip, r->src_port, r->dst_ip, r->dst_port,
+                                g_net_inline ? r->image : NULL,
+                                g_net_inline ? r->parent_guid : NULL);
+        break;
+    default:
+        break;
+    }
+}
+
+static void write_flow_summary(uint64_t ts, const FLOW_ENTRY* f)
+{
+    jsonl_write_net_flow_summary(ts, f->pid, f->process_guid, f->dst_ip, f->dst_port, f->proto,
+                                 f->count, f->first_ts, f->last_ts);
+}
+
+// collector_stats record: source/writer thread counters + write latency
+static void write_stats(uint64_t now)
+{
+    char fields[COLLECTOR_STATS_FIELDS_MAX];
+    size_t n = collector_stats_format(fields, sizeof(fields), now);
+    if (n) jsonl_write_collector_stats(plat_filetime_now(), g_host, fields, n);
+}
+
+static void writer_tick(void)
+{
+    jsonl_tick();
+    uint64_t now = plat_now_ns();
+    if (collector_stats_due(now)) write_stats(now);
+}
+
+static void write_one(const EVENT_REC* r)
+{
+    if (r->ts_100ns < g_last_ts) g_merge.out_of_order++;
+    else g_last_ts = r->ts_100ns;
+    if (g_flows.flows) flow_agg_advance(&g_flows, g_last_ts);
+
+    // origin_ns: pipeline이 sample한 record만 (PIPELINE_TIMING: 전부)
+    if (r->origin_ns) {
+        uint64_t t0 = plat_now_ns();
+        write_rec(r);
+        uint64_t t1 = plat_now_ns();
+        lat_hist_add(&g_ws->serialize_ns, t1 - t0);
+        lat_hist_add(&g_ws->latency_ns, t1 - r->origin_ns);
+#if PIPELINE_TIMING
+        g_write_ns += t1 - t0;
+#endif
+    } else {
+        write_rec(r);
+    }
+    plat_counter_add(&g_ws->written, 1);
+}
+
+// lanes > 1: oldest head among the lanes. lane 하나가 비어 있는데 그 worker에
+// 아직 input이 있으면 더 오래된 record가 나올 수 있으니 reorder_ms까지 기다림
+static EVENT_RING* merge_next(EVENT_REC** out)
+{
+    EVENT_RING* best_ring = NULL;
+    EVENT_REC* best = NULL;
+    int pending = 0;
+
+    for (uint32_t i = 0; i < g_lanes; i++) {
+        // pending을 먼저 봄: input이 비었으면 그 worker의 record는 이미 commit됨
+        int p = g_lane_pending && g_lane_pending(i);
+        EVENT_REC* r = (EVENT_REC*)ring_peek(&g_rings[i]);
+        if (!r) {
+            pending |= p;
+            continue;
+        }
+        if (!best || r->ts_100ns < best->ts_100ns) {
+            best = r;
+            best_ring = &g_rings[i];
+        }
+    }
+    if (!best) {
+        g_wait_start = 0;
+        return NULL;
+    }
+
+    if (pending) {
+        uint64_t now = plat_now_ns();
+        if (!g_wait_start) {
+            g_wait_start = now;
+            g_merge.waits++;
+        }
+        if (now - g_wait_start < g_reorder_ns) return NULL;
+        g_merge.timeouts++;
+    }
+    g_wait_start = 0;
+    g_merge.merged++;
+    *out = best;
+    return best_ring;
+}
+
+static int rings_empty(void)
+{
+    for (uint32_t i = 0; i < g_lanes; i++) {
+        if (!ring_is_empty(&g_rings[i])) return 0;
+    }
+    return 1;
+}
+
+static void writer_main(void* arg)
+{
+    (void)arg;
+    uint32_t idle = 0;
+    uint32_t since_tick = 0;
+
+    for (;;) {
+        EVENT_REC* r = NULL;
+        EVENT_RING* ring = &g_rings[0];
+        if (g_lanes == 1) r = (EVENT_REC*)ring_peek(ring);
+        else ring = merge_next(&r);
+
+        if (r) {
+            write_one(r);
+            ring_release(ring);
+            idle = 0;
+
+            // 계속 바쁜 경우에도 age 기반 flush / stats가 돌도록
+            if (++since_tick >= 256) {
+                since_tick = 0;
+                writer_tick();
+            }
+            continue;
+        }
+
+        writer_tick();
+        since_tick = 0;
+
+        // stop 요청이 와도 ring이 빌 때까지는 계속 drain
+        // (peek가 NULL을 본 뒤 마지막 commit이 들어왔을 수 있으니 한 번 더 확인)
+        if (plat_load_i32(&g_stop_req)) {
+            if (rings_empty()) break;
+            continue;
+        }
+
+        // spin -> yield -> sleep backoff
+        if (idle < 64) {
+            idle++;
+        } else if (idle < 128) {
+            idle++;
+            plat_yield();
+        } else {
+            plat_sleep_ms(1);
+        }
+    }
+
+    // 아직 안 나간 flow count
+    if (g_flows.flows) flow_agg_flush(&g_flows, g_last_ts);
+
+    // 마지막 interval도 남김
+    if (COLLECTOR_STATS_INTERVAL_SEC) write_stats(plat_now_ns());
+
+    // 남은 buffer를 파일로
+    jsonl_flush();
+}
+
+static void free_rings(void)
+{
+    for (uint32_t i = 0; i < g_lanes; i++) {
+        ring_close(&g_rings[i]);
+        ring_free(&g_rings[i]);
+    }
+    g_lanes = 0;
+}
+
+static void sum_ring_stats(RING_STATS* out)
+{
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = 0; i < g_lanes; i++) {
+        RING_STATS rs;
+        ring_get_stats(&g_rings[i], &rs);
+        out->pushed += rs.pushed;
+        out->popped += rs.popped;
+        out->dropped_full += rs.dropped_full;
+        out->dropped_sampled += rs.dropped_sampled;
+        out->block_waits += rs.block_waits;
+        if (rs.high_water > out->high_water) out->high_water = rs.high_water;
+    }
+}
+
+int event_writer_start(const EVENT_WRITER_CONFIG* cfg)
+{
+    if (!cfg || plat_load_i32(&g_running)) return 0;
+
+    // lane마다 ring 하나. 전체 slot 수(메모리)는 lane 수와 관계없이 ring_cap 근처로
+    uint32_t lanes = cfg->lanes ? cfg->lanes : 1;
+    if (lanes > EVENT_WRITER_LANES_MAX) lanes = EVENT_WRITER_LANES_MAX;
+    size_t cap = cfg->ring_cap;
+    if (lanes > 1) {
+        while (cap > 128 && cap / 2 * lanes >= cfg->ring_cap) cap /= 2;
+    }
+    for (g_lanes = 0; g_lanes < lanes; g_lanes++) {
+        if (!ring_init(&g_rings[g_lanes], sizeof(EVENT_REC), cap, cfg->policy, cfg->sample_n)) {
+            free_rings();
+            return 0;
+        }
+    }
+
+    g_host[0] = L'\0';
+    if (cfg->host) {
+        wcsncpy(g_host, cfg->host, 255);
+        g_host[255] = L'\0';
+    }
+
+    g_net_inline = cfg->net_inline_process;
+    g_rules = cfg->rules;
+    memset(&g_flow_final, 0, sizeof(g_flow_final));
+    if (cfg->flow_window_sec &&
+        !flow_agg_init(&g_flows, cfg->flow_max ? cfg->flow_max : NET_FLOW_MAX_FLOWS,
+                       cfg->flow_window_sec, write_flow_summary)) {
+        free_rings();
+        return 0;
+    }
+    g_ws = collector_stats_writer();
+    g_write_ns = 0;
+    g_lane_pending = cfg->lane_pending;
+    g_reorder_ns = (uint64_t)cfg->reorder_ms * 1000000ULL;
+    g_wait_start = 0;
+    g_last_ts = 0;
+    memset(&g_merge, 0, sizeof(g_merge));
+    memset(&g_final, 0, sizeof(g_final));
+
+    plat_store_i32(&g_stop_req, 0);
+    if (!plat_thread_start(&g_thread, writer_main, NULL)) {
+        flow_agg_free(&g_flows);
+        free_rings();
+        return 0;
+    }
+    plat_store_i32(&g_running, 1);
+    return 1;
+}
+
+void event_writer_set_lane(uint32_t lane)
+{
+    t_lane = lane < EVENT_WRITER_LANES_MAX ? lane : 0;
+}
+
+EVENT_REC* event_writer_begin(void)
+{
+    if (!plat_load_i32(&g_running)) return NULL;
+
+    EVENT_REC* r = (EVENT_REC*)ring_reserve(&g_rings[t_lane]);
+    if (r) r->type = EVREC_NONE;
+    return r;
+}
+
+void event_writer_commit(void)
+{
+    ring_commit(&g_rings[t_lane]);
+}
+
+void event_writer_stop(void)
+{
+    if (!plat_load_i32(&g_running)) return;
+
+    plat_store_i32(&g_running, 0);
+    plat_store_i32(&g_stop_req, 1);
+
+    // producer 쪽은 이미 멈춘 상태 (ProcessTrace 반환 후, decode worker join 후)
+    // writer_main은 ring을 비운 다음 빠져나옴
+    plat_thread_join(g_thread);
+    sum_ring_stats(&g_final);
+    free_rings();
+    if (g_flows.flows) flow_agg_get_stats(&g_flows, &g_flow_final);
+    flow_agg_free(&g_flows);
+}
+
+void event_writer_get_stats(RING_STATS* out)
+{
+    if (!out) return;
+    if (g_lanes) sum_ring_stats(out);
+    else *out = g_final;
+}
+
+void event_writer_get_merge_stats(EVENT_WRITER_MERGE_STATS* out)
+{
+    if (out) *out = g_merge;
+}
+
+void event_writer_get_flow_stats(FLOW_AGG_STATS* out)
+{
+    if (!out) return;
+    if (g_flows.flows) flow_agg_get_stats(&g_flows, out);
+    else *out = g_flow_final;
+}
+
+void event_writer_get_timing(uint64_t* written, uint64_t* write_ns)
+{
+    if (written) *written = g_ws ? plat_counter_load(&g_ws->written) : 0;
+    if (write_ns) *write_ns = g_write_ns;
+}
+
+void event_writer_get_latency(LAT_HIST* out)
+{
+    if (!out) return;
+    if (g_ws) lat_hist_snapshot(out, &g_ws->latency_ns);
+    else lat_hist_reset(out);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+#include "event_rec.h"
+#include "event_ring.h"
+#include "flow_agg.h"
+#include "lat_hist.h"
+#include "rule_engine.h"
+
+// ============================================================
+// Writer thread: drains EVENT_REC ring(s) -> jsonl_writer
+// - ETW callback never touches the output file
+// - lanes > 1 (decode workers, pipeline.h): one SPSC ring per worker,
+//   merged by event timestamp. a lane whose worker still has input
+//   (lane_pending) holds the merge for at most reorder_ms
+// - flow_window_sec: net_connect aggregated per flow (flow_agg.h), records
+//   arrive here in timestamp order so windows run on event time
+// - rules: proc_start's EVENT_REC.tags -> one tag record each, right after it
+// ============================================================
+
+#define EVENT_WRITER_LANES_MAX 16
+
+typedef struct EVENT_WRITER_CONFIG {
+    size_t ring_cap;            // slots, power of 2
+    RING_FULL_POLICY policy;
+    uint32_t sample_n;          // RING_FULL_SAMPLE: keep 1 of N above watermark
+    const wchar_t* host;        // copied
+    int net_inline_process;     // net_connect: emit image / parent_process_guid
+
+    uint32_t lanes;             // producers, 0/1: single ring (no merge)
+    uint32_t reorder_ms;        // max merge wait for a pending lane
+    int (*lane_pending)(uint32_t lane);     // any thread: lane's producer has unprocessed input
+
+    uint32_t flow_window_sec;   // net_flow_summary period, 0: every connect is written
+    uint32_t flow_max;          // flows tracked at once (0: NET_FLOW_MAX_FLOWS)
+
+    const RULE_ENGINE* rules;   // tags[] -> rule text, NULL: no tags (must outlive the writer)
+} EVENT_WRITER_CONFIG;
+
+typedef struct EVENT_WRITER_MERGE_STATS {
+    uint64_t merged;            // records taken by timestamp merge (lanes > 1)
+    uint64_t waits;             // merge held for a pending lane
+    uint64_t timeouts;          // ... and gave up after reorder_ms
+    uint64_t out_of_order;      // written with ts older than the previous record
+} EVENT_WRITER_MERGE_STATS;
+
+// jsonl_open 이후에 호출. 성공: 1, 실패: 0
+int event_writer_start(const EVENT_WRITER_CONFIG* cfg);
+
+// producer (single thread per lane). NULL: dropped by policy or writer not running
+EVENT_REC* event_writer_begin(void);
+void event_writer_commit(void);
+
+// calling thread's lane for begin/commit (default 0). decode worker i -> lane i
+void event_writer_set_lane(uint32_t lane);
+
+// drain remaining records, join thread (jsonl_close 전에 호출)
+void event_writer_stop(void);
+
+// all lanes summed (high_water: max)
+void event_writer_get_stats(RING_STATS* out);
+void event_writer_get_merge_stats(EVENT_WRITER_MERGE_STATS* out);
+// flow_window_sec 0: all zero. stop 이후에 읽을 것
+void event_writer_get_flow_stats(FLOW_AGG_STATS* out);
+
+// records serialized, time spent in jsonl_write_* (PIPELINE_TIMING only, else 0)
+// stop 이후에 읽으면 정확
+void event_writer_get_timing(uint64_t* written, uint64_t* write_ns);
+
+// per-record latency: pipeline entry (source thread) -> jsonl_write_* 완료 (writer thread)
+// ring 대기 포함. sampled 1/COLLECTOR_STATS_SAMPLE (PIPELINE_TIMING: every record)
+void event_writer_get_latency(LAT_HIST* out);
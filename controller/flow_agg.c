@@ -0,0 +1,190 @@
+#include "flow_agg.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FLOW_SWEEP_100NS 10000000ULL    // 1s of event time between sweeps
+
+static uint64_t flow_hash(const char* guid, size_t guid_n, const char* ip, size_t ip_n,
+                          uint16_t port, uint8_t proto)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < guid_n; i++) {
+        h ^= (uint8_t)guid[i];
+        h *= 0x100000001b3ULL;
+    }
+    h ^= 0xff;      // guid / ip 경계
+    h *= 0x100000001b3ULL;
+    for (size_t i = 0; i < ip_n; i++) {
+        h ^= (uint8_t)ip[i];
+        h *= 0x100000001b3ULL;
+    }
+    h ^= ((uint64_t)port << 8) | proto;
+    h *= 0x100000001b3ULL;
+    return h ^ (h >> 29);
+}
+
+int flow_agg_init(FLOW_AGG* a, uint32_t max_flows, uint32_t window_sec, FLOW_SUMMARY_FN emit)
+{
+    memset(a, 0, sizeof(*a));
+    if (!max_flows || !window_sec || !emit) return 0;
+
+    a->index_cap = 16;
+    while (a->index_cap < (size_t)max_flows * 2) a->index_cap <<= 1;
+    a->flows = (FLOW_ENTRY*)calloc(max_flows, sizeof(FLOW_ENTRY));
+    a->free_list = (uint32_t*)malloc(max_flows * sizeof(uint32_t));
+    a->index = (uint32_t*)calloc(a->index_cap, sizeof(uint32_t));
+    a->fifo = (uint32_t*)malloc(max_flows * sizeof(uint32_t));
+    if (!a->flows || !a->free_list || !a->index || !a->fifo) {
+        flow_agg_free(a);
+        return 0;
+    }
+
+    // 작은 index부터 꺼내도록 역순으로 쌓음
+    for (uint32_t i = 0; i < max_flows; i++) a->free_list[i] = max_flows - 1 - i;
+    a->free_count = max_flows;
+    a->max_flows = max_flows;
+    a->window = (uint64_t)window_sec * 10000000ULL;
+    a->emit = emit;
+    return 1;
+}
+
+void flow_agg_free(FLOW_AGG* a)
+{
+    if (!a) return;
+    free(a->flows);
+    free(a->free_list);
+    free(a->index);
+    free(a->fifo);
+    memset(a, 0, sizeof(*a));
+}
+
+static void fifo_push(FLOW_AGG* a, uint32_t fi)
+{
+    a->fifo[(a->fifo_head + a->count) % a->max_flows] = fi;
+    a->count++;
+}
+
+// index에서 fi를 지우고 뒤의 entry를 당겨서 빈 칸을 메움 (tombstone 없음)
+static void index_remove(FLOW_AGG* a, uint32_t fi)
+{
+    size_t mask = a->index_cap - 1;
+    size_t i = (size_t)a->flows[fi].hash & mask;
+    while (a->index[i] != fi + 1) i = (i + 1) & mask;
+
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!a->index[j]) break;
+        size_t home = (size_t)a->flows[a->index[j] - 1].hash & mask;
+        // home이 (i, j] 사이(원형)가 아니면 i로 옮겨도 찾을 수 있음
+        int between = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+        if (!between) {
+            a->index[i] = a->index[j];
+            i = j;
+        }
+    }
+    a->index[i] = 0;
+}
+
+static void emit_summary(FLOW_AGG* a, FLOW_ENTRY* f, uint64_t now)
+{
+    // merge가 늦은 record를 낼 수 있음: summary ts는 last_ts보다 앞서지 않게
+    a->emit(now > f->last_ts ? now : f->last_ts, f);
+    a->st.summaries++;
+    f->count = 0;
+}
+
+// FIFO 맨 앞 flow를 닫음. 1: flow 제거됨, 0: 연결이 있어 다음 window로 (뒤로)
+static int close_front(FLOW_AGG* a, uint64_t now, int renew)
+{
+    uint32_t fi = a->fifo[a->fifo_head];
+    FLOW_ENTRY* f = &a->flows[fi];
+    a->fifo_head = (a->fifo_head + 1) % a->max_flows;
+    a->count--;
+
+    int had = f->count != 0;
+    if (had) emit_summary(a, f, now);
+    if (had && renew) {
+        f->window_end = now + a->window;
+        fifo_push(a, fi);
+        return 0;
+    }
+    index_remove(a, fi);
+    a->free_list[a->free_count++] = fi;
+    return 1;
+}
+
+int flow_agg_connect(FLOW_AGG* a, const EVENT_REC* r)
+{
+    a->st.connects++;
+
+    size_t guid_n = strlen(r->process_guid);
+    size_t ip_n = strlen(r->dst_ip);
+    if (guid_n >= FLOW_GUID_CAP || ip_n >= FLOW_IP_CAP) {
+        a->st.passthrough++;
+        return 1;
+    }
+
+    uint64_t h = flow_hash(r->process_guid, guid_n, r->dst_ip, ip_n, r->dst_port, FLOW_PROTO_TCP);
+    size_t mask = a->index_cap - 1;
+    for (size_t j = (size_t)h & mask; a->index[j]; j = (j + 1) & mask) {
+        FLOW_ENTRY* f = &a->flows[a->index[j] - 1];
+        if (f->hash == h && f->dst_port == r->dst_port && f->proto == FLOW_PROTO_TCP &&
+            strcmp(f->process_guid, r->process_guid) == 0 && strcmp(f->dst_ip, r->dst_ip) == 0) {
+            if (!f->count) f->first_ts = r->ts_100ns;
+            f->last_ts = r->ts_100ns;
+            f->count++;
+            a->st.folded++;
+            return 0;
+        }
+    }
+
+    // 가득 참: window가 제일 오래된 flow를 일찍 닫음 (count는 summary로 나감)
+    if (!a->free_count) {
+        close_front(a, r->ts_100ns, 0);
+        a->st.evicted++;
+    }
+
+    uint32_t fi = a->free_list[--a->free_count];
+    FLOW_ENTRY* f = &a->flows[fi];
+    memset(f, 0, sizeof(*f));
+    f->hash = h;
+    f->window_end = r->ts_100ns + a->window;
+    f->pid = r->pid;
+    f->dst_port = r->dst_port;
+    f->proto = FLOW_PROTO_TCP;
+    memcpy(f->process_guid, r->process_guid, guid_n + 1);
+    memcpy(f->dst_ip, r->dst_ip, ip_n + 1);
+
+    size_t j = (size_t)h & mask;
+    while (a->index[j]) j = (j + 1) & mask;
+    a->index[j] = fi + 1;
+    fifo_push(a, fi);
+
+    if (a->count > a->st.high_water) a->st.high_water = a->count;
+    a->st.first_seen++;
+    return 1;
+}
+
+void flow_agg_advance(FLOW_AGG* a, uint64_t now_100ns)
+{
+    if (now_100ns < a->next_sweep) return;
+    a->next_sweep = now_100ns + FLOW_SWEEP_100NS;
+
+    // window_end는 FIFO 순서: 앞에서부터 끝난 것만
+    while (a->count && a->flows[a->fifo[a->fifo_head]].window_end <= now_100ns) {
+        if (close_front(a, now_100ns, 1)) a->st.expired++;
+    }
+}
+
+void flow_agg_flush(FLOW_AGG* a, uint64_t now_100ns)
+{
+    if (!a->flows) return;
+    while (a->count) close_front(a, now_100ns, 0);
+}
+
+void flow_agg_get_stats(const FLOW_AGG* a, FLOW_AGG_STATS* out)
+{
+    *out = a->st;
+}
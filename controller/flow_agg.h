@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_rec.h"
+
+// ============================================================
+// net_connect aggregation (writer thread, single-threaded)
+// - flow key: (process_guid, dst_ip, dst_port, proto)
+// - first connection of a flow: written as net_connect right away
+// - later ones are only counted; once per window (event time) a flow with
+//   connections emits one net_flow_summary (count, first/last ts) and starts
+//   the next window. a window with none drops the flow (next one is first-seen)
+// - bounded: max_flows tracked. full -> the flow with the oldest window is
+//   closed early (summary if it has connections) to make room
+// - windows end in FIFO order (event time only moves forward): a sweep pops
+//   expired flows off the front, no table scan
+// - total connections = net_connect records + sum of summary counts
+// ============================================================
+
+#define FLOW_PROTO_TCP 6            // IANA protocol number (TcpIp provider: TCP only)
+
+#define FLOW_GUID_CAP 32
+#define FLOW_IP_CAP   48
+
+typedef struct FLOW_ENTRY {
+    uint64_t hash;
+    uint64_t window_end;            // 100ns, event time
+    uint64_t first_ts;              // connections counted in this window (count > 0)
+    uint64_t last_ts;
+    uint32_t count;
+    uint32_t pid;
+    uint16_t dst_port;
+    uint8_t proto;
+    char process_guid[FLOW_GUID_CAP];
+    char dst_ip[FLOW_IP_CAP];
+} FLOW_ENTRY;
+
+typedef struct FLOW_AGG_STATS {
+    uint64_t connects;              // net_connect records seen
+    uint64_t first_seen;            // written as net_connect (new flow)
+    uint64_t folded;                // counted into a flow (not written)
+    uint64_t summaries;             // net_flow_summary records
+    uint64_t expired;               // flows dropped after an idle window
+    uint64_t evicted;               // table full: oldest flow closed early
+    uint64_t passthrough;           // key too long: written unaggregated
+    uint64_t high_water;            // max flows tracked
+} FLOW_AGG_STATS;
+
+// summary sink: ts = emission time (>= f->last_ts)
+typedef void (*FLOW_SUMMARY_FN)(uint64_t ts_100ns, const FLOW_ENTRY* f);
+
+typedef struct FLOW_AGG {
+    FLOW_ENTRY* flows;              // max_flows, entries never move
+    uint32_t* free_list;            // unused flow indices (stack)
+    uint32_t free_count;
+    uint32_t* index;                // key hash -> flow index + 1 (0: empty), linear probing
+    size_t index_cap;               // power of 2, >= 2 * max_flows
+    uint32_t* fifo;                 // live flow indices by window_end (ring of max_flows)
+    uint32_t fifo_head;
+    uint32_t count;                 // live flows (= fifo length)
+    uint32_t max_flows;
+    uint64_t window;                // 100ns
+    uint64_t next_sweep;            // 100ns, event time
+    FLOW_SUMMARY_FN emit;
+    FLOW_AGG_STATS st;
+} FLOW_AGG;
+
+// 성공: 1, 실패: 0
+int flow_agg_init(FLOW_AGG* a, uint32_t max_flows, uint32_t window_sec, FLOW_SUMMARY_FN emit);
+void flow_agg_free(FLOW_AGG* a);
+
+// r: EVREC_NET_CONNECT. 1: write r as net_connect, 0: counted into its flow
+int flow_agg_connect(FLOW_AGG* a, const EVENT_REC* r);
+
+// event time reached now (every record): windows that ended -> summary / drop
+void flow_agg_advance(FLOW_AGG* a, uint64_t now_100ns);
+
+// shutdown: summaries for every flow with pending connections, table emptied
+void flow_agg_flush(FLOW_AGG* a, uint64_t now_100ns);
+
+void flow_agg_get_stats(const FLOW_AGG* a, FLOW_AGG_STATS* out);
@@ -1,24 +1,202 @@
+#define _CRT_SECURE_NO_WARNINGS
 #include "guid.h"
-#include <windows.h>
+#include "plat.h"
+
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
-// 단순: boot_id는 collector 시작 시 한 번만
+// boot_id: 같은 boot 안에서는 collector를 다시 시작해도 같은 값 (guid_init_boot_id)
 static uint64_t g_boot_id = 0;
+static const char* g_boot_src = "none";
+
+// ============================================================
+// 64-bit hash: XXH64 (Yann Collet's xxHash, 64-bit variant)
+// - 32 bytes per round in 4 independent lanes: no per-character dependency chain
+// ============================================================
+#define P1 0x9E3779B185EBCA87ULL
+#define P2 0xC2B2AE3D27D4EB4FULL
+#define P3 0x165667B19E3779F9ULL
+#define P4 0x85EBCA77C2B2AE63ULL
+#define P5 0x27D4EB2F165667C5ULL
+
+static uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// little endian, unaligned
+static uint64_t read64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static uint32_t read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static uint64_t xxh_round(uint64_t acc, uint64_t in)
+{
+    acc += in * P2;
+    acc = rotl64(acc, 31);
+    return acc * P1;
+}
+
+static uint64_t xxh_merge(uint64_t acc, uint64_t v)
+{
+    acc ^= xxh_round(0, v);
+    return acc * P1 + P4;
+}
+
+static uint64_t xxh_avalanche(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+// 8 / 4 byte word after the input (XXH64 tail step)
+static uint64_t xxh_tail64(uint64_t h, uint64_t v) { return rotl64(h ^ xxh_round(0, v), 27) * P1 + P4; }
+static uint64_t xxh_tail32(uint64_t h, uint32_t v) { return rotl64(h ^ ((uint64_t)v * P1), 23) * P2 + P3; }
+
+// everything but the final avalanche
+static uint64_t xxh64_body(const void* data, size_t len, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    } else {
+        h = seed + P5;
+    }
+    h += (uint64_t)len;
+
+    for (; p + 8 <= end; p += 8) h = xxh_tail64(h, read64(p));
+    if (p + 4 <= end) {
+        h = xxh_tail32(h, read32(p));
+        p += 4;
+    }
+    for (; p < end; p++) h = rotl64(h ^ ((uint64_t)*p * P5), 11) * P1;
+    return h;
+}
+
+uint64_t guid_hash64(const void* data, size_t len, uint64_t seed)
+{
+    return xxh_avalanche(xxh64_body(data, len, seed));
+}
+
+// ============================================================
+// boot identity
+// - Windows: kernel boot time (SystemTimeOfDayInformation) + computer name
+// - Linux:   /proc/sys/kernel/random/boot_id (random per boot), else btime + hostname
+// - 실패 시 예전처럼 시작 시각 (restart마다 바뀜)
+// ============================================================
+#ifdef _WIN32
+typedef LONG (WINAPI* NT_QUERY_SYSTEM_INFORMATION)(ULONG, PVOID, ULONG, PULONG);
+
+static int boot_identity(uint64_t* out)
+{
+    HMODULE nt = GetModuleHandleW(L"ntdll.dll");
+    NT_QUERY_SYSTEM_INFORMATION q =
+        nt ? (NT_QUERY_SYSTEM_INFORMATION)(void*)GetProcAddress(nt, "NtQuerySystemInformation") : NULL;
+    uint64_t tod[6];    // SYSTEM_TIMEOFDAY_INFORMATION (48 bytes), BootTime first
+    if (!q || q(3 /* SystemTimeOfDayInformation */, tod, sizeof(tod), NULL) < 0 || !tod[0]) return 0;
+
+    wchar_t name[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD n = MAX_COMPUTERNAME_LENGTH + 1;
+    if (!GetComputerNameW(name, &n)) n = 0;
+    *out = guid_hash64(name, n * sizeof(wchar_t), tod[0]);
+    g_boot_src = "boot_time";
+    return 1;
+}
+#else
+static int boot_identity(uint64_t* out)
+{
+    char buf[256];
+    FILE* fp = fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (fp) {
+        size_t n = fread(buf, 1, sizeof(buf), fp);
+        fclose(fp);
+        while (n && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) n--;
+        if (n) {
+            *out = guid_hash64(buf, n, 0);
+            g_boot_src = "boot_id";
+            return 1;
+        }
+    }
+
+    unsigned long long btime = 0;
+    fp = fopen("/proc/stat", "r");
+    if (fp) {
+        while (fgets(buf, sizeof(buf), fp)) {
+            if (sscanf(buf, "btime %llu", &btime) == 1) break;
+        }
+        fclose(fp);
+    }
+    if (!btime) return 0;
+    if (gethostname(buf, sizeof(buf)) != 0) buf[0] = '\0';
+    buf[sizeof(buf) - 1] = '\0';
+    *out = guid_hash64(buf, strlen(buf), btime);
+    g_boot_src = "btime";
+    return 1;
+}
+#endif
 
 void guid_init_boot_id(void)
 {
-    LARGE_INTEGER qpc;
-    QueryPerformanceCounter(&qpc);
-    g_boot_id = (uint64_t)qpc.QuadPart ^ GetTickCount64();
+    if (boot_identity(&g_boot_id)) return;
+    g_boot_id = plat_now_ns() ^ ((uint64_t)time(NULL) << 20);
+    g_boot_src = "clock";
+}
+
+uint64_t guid_boot_id(void) { return g_boot_id; }
+const char* guid_boot_id_source(void) { return g_boot_src; }
+
+// image bytes in bulk (XXH64, seed boot_id), then start_ts / pid as trailing words
+uint64_t process_guid_hash(uint32_t pid, uint64_t start_ts, const wchar_t* image)
+{
+    size_t n = image ? wcslen(image) : 0;
+    uint64_t h = xxh64_body(image, n * sizeof(wchar_t), g_boot_id);
+    h = xxh_tail64(h, start_ts);
+    h = xxh_tail32(h, pid);
+    return xxh_avalanche(h);
 }
 
-// 매우 단순한 hash (나중에 xxhash64 교체 가능)
-static uint64_t simple_hash64(uint64_t x)
+void process_guid_format(uint64_t h, char out_guid[64])
 {
-    x ^= x >> 33;
-    x *= 0xff51afd7ed558ccdULL;
-    x ^= x >> 33;
-    return x;
+    static const char hex[] = "0123456789abcdef";
+
+    out_guid[0] = 'p';
+    out_guid[1] = '-';
+    for (int i = 15; i >= 0; i--) {
+        out_guid[2 + i] = hex[h & 0xF];
+        h >>= 4;
+    }
+    out_guid[18] = '\0';
 }
 
 void make_process_guid(
@@ -27,18 +205,5 @@ void make_process_guid(
     const wchar_t* image,
     char out_guid[64]
 ){
-    uint64_t h = g_boot_id;
-    h ^= pid;
-    h ^= start_ts;
-
-    if (image) {
-        const wchar_t* p = image;
-        while (*p) {
-            h ^= (uint64_t)(*p++);
-            h = simple_hash64(h);
-        }
-    }
-
-    h = simple_hash64(h);
-    sprintf(out_guid, "p-%016llx", (unsigned long long)h);
+    process_guid_format(process_guid_hash(pid, start_ts, image), out_guid);
 }
@@ -1,7 +1,23 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
+#include <wchar.h>
 
+// boot identity, same value for every collector start within one OS boot
+// -> a process keeps its guid across collector restarts (replayed / re-read events)
 void guid_init_boot_id(void);
+uint64_t guid_boot_id(void);
+const char* guid_boot_id_source(void);  // "boot_id", "btime", "boot_time", "clock" (per start)
+
+// XXH64 of data[0, len)
+uint64_t guid_hash64(const void* data, size_t len, uint64_t seed);
+
+// 64bit process identity (boot_id, pid, start_ts, image)
+uint64_t process_guid_hash(uint32_t pid, uint64_t start_ts, const wchar_t* image);
+
+// "p-%016llx" without printf
+void process_guid_format(uint64_t h, char out_guid[64]);
+
 void make_process_guid(
     uint32_t pid,
     uint64_t start_ts,
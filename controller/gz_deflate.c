@@ -0,0 +1,312 @@
+#include "gz_deflate.h"
+#include "bin_format.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// LZ77 window (zlib layout): win[2*WSIZE], slide down by WSIZE when the
+// current position gets close to the end. head/prev hold absolute window
+// positions (-1: none) and are rebased on every slide.
+// ============================================================
+#define GZ_WSIZE        32768
+#define GZ_WMASK        (GZ_WSIZE - 1)
+#define GZ_MIN_MATCH    3
+#define GZ_MAX_MATCH    258
+#define GZ_MIN_LOOKAHEAD (GZ_MAX_MATCH + GZ_MIN_MATCH + 1)
+#define GZ_MAX_DIST     (GZ_WSIZE - GZ_MIN_LOOKAHEAD)
+#define GZ_HASH_BITS    15
+#define GZ_HASH_SIZE    (1u << GZ_HASH_BITS)
+#define GZ_MAX_CHAIN    32      // chain steps per position (speed vs ratio)
+#define GZ_GOOD_MATCH   32      // stop searching once a match this long is found
+#define GZ_OUT_SIZE     (64 * 1024)
+
+typedef struct GZ_STATE {
+    uint8_t win[2 * GZ_WSIZE];
+    int32_t head[GZ_HASH_SIZE];
+    int32_t prev[GZ_WSIZE];
+    uint32_t strstart;
+    uint32_t lookahead;
+    int eof;
+    int error;
+
+    FILE* in;
+    FILE* out;
+    uint32_t crc;
+    uint64_t in_bytes;
+    uint64_t out_bytes;
+
+    uint64_t bitbuf;
+    uint32_t bitcnt;
+    uint8_t obuf[GZ_OUT_SIZE];
+    size_t olen;
+} GZ_STATE;
+
+// ============================================================
+// fixed Huffman tables (RFC 1951 3.2.6), codes stored bit-reversed
+// ============================================================
+static const uint16_t g_len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t g_len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t g_dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t g_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static uint16_t g_lit_code[288];
+static uint8_t g_lit_bits[288];
+static uint8_t g_dist_rev[30];
+static uint8_t g_len_code[GZ_MAX_MATCH + 1];   // match length -> 0..28
+static uint8_t g_dist_code[512];               // zlib d_code() layout
+static int g_tables_ready = 0;
+
+static uint32_t bit_reverse(uint32_t v, int n)
+{
+    uint32_t r = 0;
+    while (n--) {
+        r = (r << 1) | (v & 1);
+        v >>= 1;
+    }
+    return r;
+}
+
+static void tables_init(void)
+{
+    for (int i = 0; i < 288; i++) {
+        uint32_t code;
+        int bits;
+        if (i < 144)      { code = 0x30 + i;         bits = 8; }
+        else if (i < 256) { code = 0x190 + (i - 144); bits = 9; }
+        else if (i < 280) { code = i - 256;           bits = 7; }
+        else              { code = 0xC0 + (i - 280);  bits = 8; }
+        g_lit_code[i] = (uint16_t)bit_reverse(code, bits);
+        g_lit_bits[i] = (uint8_t)bits;
+    }
+    for (int i = 0; i < 30; i++) g_dist_rev[i] = (uint8_t)bit_reverse((uint32_t)i, 5);
+
+    for (int c = 0; c < 29; c++) {
+        int hi = c == 28 ? GZ_MAX_MATCH : g_len_base[c] + (1 << g_len_extra[c]) - 1;
+        for (int l = g_len_base[c]; l <= hi; l++) g_len_code[l] = (uint8_t)c;
+    }
+    // distance 1..256 -> [d-1], 257..32768 -> [256 + ((d-1) >> 7)]
+    for (int c = 0; c < 30; c++) {
+        int lo = g_dist_base[c], hi = g_dist_base[c] + (1 << g_dist_extra[c]) - 1;
+        for (int d = lo; d <= hi; d++) {
+            if (d <= 256) g_dist_code[d - 1] = (uint8_t)c;
+            else g_dist_code[256 + ((d - 1) >> 7)] = (uint8_t)c;
+        }
+    }
+    g_tables_ready = 1;
+}
+
+// ============================================================
+// output
+// ============================================================
+static void out_flush(GZ_STATE* s)
+{
+    if (!s->olen) return;
+    if (fwrite(s->obuf, 1, s->olen, s->out) != s->olen) s->error = 1;
+    s->out_bytes += s->olen;
+    s->olen = 0;
+}
+
+static void out_byte(GZ_STATE* s, uint8_t b)
+{
+    if (s->olen == GZ_OUT_SIZE) out_flush(s);
+    s->obuf[s->olen++] = b;
+}
+
+static void out_u32le(GZ_STATE* s, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) out_byte(s, (uint8_t)(v >> (8 * i)));
+}
+
+// deflate bit order: LSB first
+static void put_bits(GZ_STATE* s, uint32_t v, uint32_t n)
+{
+    s->bitbuf |= (uint64_t)v << s->bitcnt;
+    s->bitcnt += n;
+    while (s->bitcnt >= 8) {
+        out_byte(s, (uint8_t)s->bitbuf);
+        s->bitbuf >>= 8;
+        s->bitcnt -= 8;
+    }
+}
+
+static void put_bits_align(GZ_STATE* s)
+{
+    if (s->bitcnt) out_byte(s, (uint8_t)s->bitbuf);
+    s->bitbuf = 0;
+    s->bitcnt = 0;
+}
+
+static void emit_literal(GZ_STATE* s, uint8_t c)
+{
+    put_bits(s, g_lit_code[c], g_lit_bits[c]);
+}
+
+static void emit_match(GZ_STATE* s, uint32_t len, uint32_t dist)
+{
+    int lc = g_len_code[len];
+    put_bits(s, g_lit_code[257 + lc], g_lit_bits[257 + lc]);
+    if (g_len_extra[lc]) put_bits(s, len - g_len_base[lc], g_len_extra[lc]);
+
+    int dc = dist <= 256 ? g_dist_code[dist - 1] : g_dist_code[256 + ((dist - 1) >> 7)];
+    put_bits(s, g_dist_rev[dc], 5);
+    if (g_dist_extra[dc]) put_bits(s, dist - g_dist_base[dc], g_dist_extra[dc]);
+}
+
+// ============================================================
+// window
+// ============================================================
+static void fill_window(GZ_STATE* s)
+{
+    if (s->strstart >= 2 * GZ_WSIZE - GZ_MIN_LOOKAHEAD) {
+        memmove(s->win, s->win + GZ_WSIZE, GZ_WSIZE);
+        s->strstart -= GZ_WSIZE;
+        for (uint32_t i = 0; i < GZ_HASH_SIZE; i++) {
+            int32_t v = s->head[i];
+            s->head[i] = v >= GZ_WSIZE ? v - GZ_WSIZE : -1;
+        }
+        for (uint32_t i = 0; i < GZ_WSIZE; i++) {
+            int32_t v = s->prev[i];
+            s->prev[i] = v >= GZ_WSIZE ? v - GZ_WSIZE : -1;
+        }
+    }
+
+    while (!s->eof && s->lookahead < GZ_MIN_LOOKAHEAD) {
+        uint32_t at = s->strstart + s->lookahead;
+        size_t n = fread(s->win + at, 1, 2 * GZ_WSIZE - at, s->in);
+        if (n == 0) {
+            if (ferror(s->in)) s->error = 1;
+            s->eof = 1;
+            break;
+        }
+        s->crc = bin_crc32(s->crc, s->win + at, n);
+        s->in_bytes += n;
+        s->lookahead += (uint32_t)n;
+    }
+}
+
+static uint32_t hash3(const uint8_t* p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (v * 2654435761u) >> (32 - GZ_HASH_BITS);
+}
+
+static void insert_pos(GZ_STATE* s, uint32_t pos)
+{
+    uint32_t h = hash3(s->win + pos);
+    s->prev[pos & GZ_WMASK] = s->head[h];
+    s->head[h] = (int32_t)pos;
+}
+
+// longest match for strstart among the chain starting at cur
+static uint32_t longest_match(GZ_STATE* s, int32_t cur, uint32_t* dist)
+{
+    const uint8_t* scan = s->win + s->strstart;
+    uint32_t max_len = s->lookahead < GZ_MAX_MATCH ? s->lookahead : GZ_MAX_MATCH;
+    int32_t limit = s->strstart > GZ_MAX_DIST ? (int32_t)(s->strstart - GZ_MAX_DIST) : 0;
+    uint32_t best = GZ_MIN_MATCH - 1;
+    int chain = GZ_MAX_CHAIN;
+
+    while (cur >= limit && chain-- > 0) {
+        const uint8_t* m = s->win + cur;
+        if (m[best] == scan[best] && m[0] == scan[0] && m[1] == scan[1]) {
+            uint32_t len = 2;
+            while (len < max_len && m[len] == scan[len]) len++;
+            if (len > best) {
+                best = len;
+                *dist = s->strstart - (uint32_t)cur;
+                if (len >= GZ_GOOD_MATCH || len == max_len) break;
+            }
+        }
+        cur = s->prev[cur & GZ_WMASK];
+    }
+    return best >= GZ_MIN_MATCH ? best : 0;
+}
+
+static void deflate_fixed(GZ_STATE* s)
+{
+    // block 1 (BFINAL=0, fixed): 전체 입력. 끝에 빈 final block
+    put_bits(s, 0, 1);
+    put_bits(s, 1, 2);
+
+    for (;;) {
+        if (s->lookahead < GZ_MIN_LOOKAHEAD) {
+            fill_window(s);
+            if (s->lookahead == 0) break;
+        }
+
+        uint32_t len = 0, dist = 0;
+        if (s->lookahead >= GZ_MIN_MATCH) {
+            uint32_t h = hash3(s->win + s->strstart);
+            int32_t cur = s->head[h];
+            s->prev[s->strstart & GZ_WMASK] = cur;
+            s->head[h] = (int32_t)s->strstart;
+            if (cur >= 0) len = longest_match(s, cur, &dist);
+        }
+
+        if (len) {
+            emit_match(s, len, dist);
+            // match 안쪽 위치도 chain에 넣음 (3 byte가 남아 있는 동안)
+            uint32_t end = s->strstart + len;
+            uint32_t last = s->strstart + s->lookahead - (GZ_MIN_MATCH - 1);
+            for (uint32_t p = s->strstart + 1; p < end && p < last; p++) insert_pos(s, p);
+            s->strstart = end;
+            s->lookahead -= len;
+        } else {
+            emit_literal(s, s->win[s->strstart]);
+            s->strstart++;
+            s->lookahead--;
+        }
+    }
+
+    put_bits(s, g_lit_code[256], g_lit_bits[256]);
+    put_bits(s, 1, 1);
+    put_bits(s, 1, 2);
+    put_bits(s, g_lit_code[256], g_lit_bits[256]);
+    put_bits_align(s);
+}
+
+int gz_compress_stream(FILE* in, FILE* out, GZ_RESULT* res)
+{
+    if (!in || !out) return 0;
+    if (!g_tables_ready) tables_init();
+
+    GZ_STATE* s = (GZ_STATE*)malloc(sizeof(GZ_STATE));
+    if (!s) return 0;
+    memset(s, 0, offsetof(GZ_STATE, obuf));
+    for (uint32_t i = 0; i < GZ_HASH_SIZE; i++) s->head[i] = -1;
+    for (uint32_t i = 0; i < GZ_WSIZE; i++) s->prev[i] = -1;
+    s->in = in;
+    s->out = out;
+
+    // header: magic, CM=deflate, no flags, mtime 0, XFL 0, OS unknown
+    static const uint8_t hdr[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+    for (int i = 0; i < 10; i++) out_byte(s, hdr[i]);
+
+    deflate_fixed(s);
+
+    out_u32le(s, s->crc);
+    out_u32le(s, (uint32_t)s->in_bytes);
+    out_flush(s);
+
+    int ok = !s->error && fflush(out) == 0;
+    if (res) {
+        res->in_bytes = s->in_bytes;
+        res->out_bytes = s->out_bytes;
+    }
+    free(s);
+    return ok;
+}
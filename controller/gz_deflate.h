@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+// ============================================================
+// Minimal gzip (RFC 1952) compressor for closed output segments
+// - deflate (RFC 1951): LZ77 hash chains over a 32KB window + fixed Huffman
+//   codes. No dynamic trees -> simpler; ~5x on collector JSONL
+//   (zlib -6 gets ~7x, most of the gap is random guid hex)
+// - streaming: constant memory (~200KB) regardless of file size
+// - output readable by gzip / zlib / Python gzip module
+// - portable
+// ============================================================
+
+typedef struct GZ_RESULT {
+    uint64_t in_bytes;
+    uint64_t out_bytes;
+} GZ_RESULT;
+
+// in -> out (gzip member). 성공: 1, 실패(read/write error, out of memory): 0
+int gz_compress_stream(FILE* in, FILE* out, GZ_RESULT* res);
@@ -0,0 +1,305 @@
+#include "json_out.h"
+
+#include <string.h>
+
+#if defined(__AVX2__)
+#define JSON_HAVE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_HAVE_SSE2 1
+#endif
+
+#if defined(JSON_HAVE_AVX2)
+#include <immintrin.h>
+#elif defined(JSON_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#define WCHAR_IS_16BIT (WCHAR_MAX <= 0xFFFF)
+
+static const char k_hex[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+const char* json_out_simd_name(void)
+{
+#if defined(JSON_HAVE_AVX2) && WCHAR_IS_16BIT
+    return "avx2";
+#elif defined(JSON_HAVE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+char* json_put_raw(char* d, const char* s, size_t n)
+{
+    memcpy(d, s, n);
+    return d + n;
+}
+
+char* json_put_u64(char* d, uint64_t v)
+{
+    char tmp[JSON_U64_BOUND];
+    size_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v);
+    while (n) *d++ = tmp[--n];
+    return d;
+}
+
+char* json_put_u32(char* d, uint32_t v)
+{
+    return json_put_u64(d, v);
+}
+
+// ============================================================
+// escaping
+// ============================================================
+static char* put_escaped_ascii(char* d, unsigned c)
+{
+    *d++ = '\\';
+    switch (c) {
+    case '"':  *d++ = '"'; break;
+    case '\\': *d++ = '\\'; break;
+    case '\b': *d++ = 'b'; break;
+    case '\f': *d++ = 'f'; break;
+    case '\n': *d++ = 'n'; break;
+    case '\r': *d++ = 'r'; break;
+    case '\t': *d++ = 't'; break;
+    default:
+        *d++ = 'u';
+        *d++ = '0';
+        *d++ = '0';
+        *d++ = k_hex[(c >> 4) & 0xF];
+        *d++ = k_hex[c & 0xF];
+        break;
+    }
+    return d;
+}
+
+static int needs_escape(unsigned c)
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+char* json_put_str(char* d, const char* s, size_t n)
+{
+    const unsigned char* p = (const unsigned char*)s;
+    for (size_t i = 0; i < n; i++) {
+        unsigned c = p[i];
+        if (needs_escape(c)) d = put_escaped_ascii(d, c);
+        else *d++ = (char)c;
+    }
+    return d;
+}
+
+static char* put_utf8(char* d, uint32_t cp)
+{
+    if (cp < 0x80) {
+        *d++ = (char)cp;
+    } else if (cp < 0x800) {
+        *d++ = (char)(0xC0 | (cp >> 6));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *d++ = (char)(0xE0 | (cp >> 12));
+        *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *d++ = (char)(0xF0 | (cp >> 18));
+        *d++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    }
+    return d;
+}
+
+// one non-ASCII unit (may consume a surrogate pair). returns units consumed
+static size_t put_wide_cp(char** pd, const wchar_t* s, size_t i, size_t n)
+{
+    uint32_t c = (uint32_t)s[i];
+    char* d = *pd;
+    size_t used = 1;
+
+    if (c >= 0xD800 && c <= 0xDFFF) {
+        // surrogate: pair만 유효, 나머지는 U+FFFD
+        uint32_t cp = 0xFFFD;
+        if (c <= 0xDBFF && i + 1 < n) {
+            uint32_t lo = (uint32_t)s[i + 1];
+            if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                cp = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+                used = 2;
+            }
+        }
+        d = put_utf8(d, cp);
+    } else if (c > 0x10FFFF) {
+        d = put_utf8(d, 0xFFFD);
+    } else {
+        d = put_utf8(d, c);
+    }
+
+    *pd = d;
+    return used;
+}
+
+// one non-fast-path unit (escaping + UTF-8). returns units consumed
+static size_t put_wide_slow(char** pd, const wchar_t* s, size_t i, size_t n)
+{
+    uint32_t c = (uint32_t)s[i];
+    if (c < 0x80) {
+        char* d = *pd;
+        if (needs_escape(c)) d = put_escaped_ascii(d, c);
+        else *d++ = (char)c;
+        *pd = d;
+        return 1;
+    }
+    return put_wide_cp(pd, s, i, n);
+}
+
+// ============================================================
+// SIMD: plain ASCII run check + narrow
+//   safe unit: 0x20 <= c <= 0x7F, c != '"', c != '\\'   (raw: any c <= 0x7F, no escaping)
+// returns number of leading safe units copied (multiple of the block size)
+// ============================================================
+#if WCHAR_IS_16BIT
+
+#if defined(JSON_HAVE_AVX2)
+static size_t ascii_run_avx2(char* d, const wchar_t* s, size_t n, int raw)
+{
+    const __m256i lo = _mm256_set1_epi16(raw ? 0 : 0x20);
+    const __m256i hi = _mm256_set1_epi16(0x7F);
+    const __m256i q = _mm256_set1_epi16(raw ? 0x80 : '"');     // 0x80: already > hi
+    const __m256i bs = _mm256_set1_epi16(raw ? 0x80 : '\\');
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        // signed compare: >= 0x8000 is negative -> also caught by "< 0x20"
+        __m256i bad = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi16(lo, v), _mm256_cmpgt_epi16(v, hi)),
+            _mm256_or_si256(_mm256_cmpeq_epi16(v, q), _mm256_cmpeq_epi16(v, bs)));
+        if (_mm256_movemask_epi8(bad)) break;
+
+        __m256i packed = _mm256_packus_epi16(v, v);                 // per 128-bit lane
+        packed = _mm256_permute4x64_epi64(packed, 0x08);            // lanes 0,2 -> low 128
+        _mm_storeu_si128((__m128i*)(d + i), _mm256_castsi256_si128(packed));
+    }
+    return i;
+}
+#endif
+
+#if defined(JSON_HAVE_SSE2)
+static size_t ascii_run_sse2(char* d, const wchar_t* s, size_t n, int raw)
+{
+    const __m128i lo = _mm_set1_epi16(raw ? 0 : 0x20);
+    const __m128i hi = _mm_set1_epi16(0x7F);
+    const __m128i q = _mm_set1_epi16(raw ? 0x80 : '"');
+    const __m128i bs = _mm_set1_epi16(raw ? 0x80 : '\\');
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i bad = _mm_or_si128(
+            _mm_or_si128(_mm_cmplt_epi16(v, lo), _mm_cmpgt_epi16(v, hi)),
+            _mm_or_si128(_mm_cmpeq_epi16(v, q), _mm_cmpeq_epi16(v, bs)));
+        if (_mm_movemask_epi8(bad)) break;
+
+        _mm_storel_epi64((__m128i*)(d + i), _mm_packus_epi16(v, v));
+    }
+    return i;
+}
+#endif
+
+#else // 32-bit wchar_t
+
+#if defined(JSON_HAVE_SSE2)
+static size_t ascii_run_sse2(char* d, const wchar_t* s, size_t n, int raw)
+{
+    const __m128i lo = _mm_set1_epi32(raw ? 0 : 0x20);
+    const __m128i hi = _mm_set1_epi32(0x7F);
+    const __m128i q = _mm_set1_epi32(raw ? 0x80 : '"');
+    const __m128i bs = _mm_set1_epi32(raw ? 0x80 : '\\');
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i bad = _mm_or_si128(
+            _mm_or_si128(_mm_cmplt_epi32(v, lo), _mm_cmpgt_epi32(v, hi)),
+            _mm_or_si128(_mm_cmpeq_epi32(v, q), _mm_cmpeq_epi32(v, bs)));
+        if (_mm_movemask_epi8(bad)) break;
+
+        __m128i w = _mm_packs_epi32(v, v);
+        int32_t b4 = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+        memcpy(d + i, &b4, 4);
+    }
+    return i;
+}
+#endif
+
+#endif
+
+char* json_put_wstr(char* d, const wchar_t* s, size_t n)
+{
+    size_t i = 0;
+
+    while (i < n) {
+#if defined(JSON_HAVE_AVX2) && WCHAR_IS_16BIT
+        size_t run = ascii_run_avx2(d, s + i, n - i, 0);
+        d += run;
+        i += run;
+#endif
+#if defined(JSON_HAVE_SSE2)
+        {
+            size_t run2 = ascii_run_sse2(d, s + i, n - i, 0);
+            d += run2;
+            i += run2;
+        }
+#endif
+        // scalar: 다음 블록 경계까지 또는 특수 문자 처리
+        size_t stop = i + 16;
+        if (stop > n) stop = n;
+        while (i < stop) {
+            uint32_t c = (uint32_t)s[i];
+            if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+                *d++ = (char)c;
+                i++;
+            } else {
+                i += put_wide_slow(&d, s, i, n);
+            }
+        }
+    }
+    return d;
+}
+
+char* json_put_wstr_utf8(char* d, const wchar_t* s, size_t n)
+{
+    size_t i = 0;
+    while (i < n) {
+#if defined(JSON_HAVE_AVX2) && WCHAR_IS_16BIT
+        size_t run = ascii_run_avx2(d, s + i, n - i, 1);
+        d += run;
+        i += run;
+#endif
+#if defined(JSON_HAVE_SSE2)
+        {
+            size_t run2 = ascii_run_sse2(d, s + i, n - i, 1);
+            d += run2;
+            i += run2;
+        }
+#endif
+        size_t stop = i + 16;
+        if (stop > n) stop = n;
+        while (i < stop) {
+            uint32_t c = (uint32_t)s[i];
+            if (c < 0x80) {
+                *d++ = (char)c;
+                i++;
+            } else {
+                i += put_wide_cp(&d, s, i, n);
+            }
+        }
+    }
+    return d;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// ============================================================
+// Allocation-free JSON fragments written straight into an output buffer
+// - caller reserves the bound, each function returns the new end pointer
+// - wide strings: UTF-16 (Windows) / UTF-32 (Linux wchar_t) -> UTF-8
+// - JSON escaping: \" \\ and control chars; lone surrogates -> U+FFFD
+// - SSE2/AVX2 fast path for runs of plain ASCII, scalar otherwise
+// ============================================================
+
+// worst case: every unit becomes "\u00XX" (6 bytes); UTF-8 is at most 3 bytes/unit
+#define JSON_STR_BOUND(n)  ((n) * 6)
+#define JSON_WSTR_BOUND(n) ((n) * 6)
+#define JSON_U64_BOUND     20
+
+// literal (no escaping)
+#define JSON_LIT(d, lit) json_put_raw((d), (lit), sizeof(lit) - 1)
+
+char* json_put_raw(char* d, const char* s, size_t n);
+char* json_put_u32(char* d, uint32_t v);
+char* json_put_u64(char* d, uint64_t v);
+
+// escaped string body (no surrounding quotes)
+char* json_put_str(char* d, const char* s, size_t n);        // UTF-8/ASCII input
+char* json_put_wstr(char* d, const wchar_t* s, size_t n);    // wide input
+
+// plain UTF-8 conversion, no escaping (binary sink). bound: 3 bytes/unit
+char* json_put_wstr_utf8(char* d, const wchar_t* s, size_t n);
+
+// which fast path was compiled in ("avx2", "sse2", "scalar")
+const char* json_out_simd_name(void);
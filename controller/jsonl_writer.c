@@ -1,89 +1,819 @@
+#define _CRT_SECURE_NO_WARNINGS
 #include "jsonl_writer.h"
+#include "config.h"
+#include "bin_format.h"
+#include "json_out.h"
+#include "plat.h"
+#include "segment.h"
+#include "ts_format.h"
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 static FILE* g_fp = NULL;
 
-int jsonl_open(const wchar_t* path)
+// group commit buffer (LINE mode에서도 line 조립용으로 씀)
+static JSONL_OPTIONS g_opt;
+static int g_opt_set = 0;
+static char* g_buf = NULL;
+static size_t g_cap = 0;
+static size_t g_len = 0;
+static uint64_t g_first_pending_ns = 0;
+static uint64_t g_last_fsync_ns = 0;
+static uint64_t g_unsynced = 0;
+static JSONL_STATS g_stats;
+static LAT_HIST g_write_ns;     // fwrite per flush
+
+// timestamp 문자열은 여기서만 만듦 (초 단위 prefix cache)
+static TS_CACHE g_ts_cache;
+
+// BINARY: host/image string ids (file마다 새로 시작)
+static BIN_DICT g_dict;
+static uint64_t g_ts_base;
+static int g_ts_base_set;
+
+// rotation: g_base는 segment 이름의 기준 (segment.h)
+static int g_rotating = 0;
+static wchar_t g_base[SEG_PATH_MAX];
+static wchar_t g_seg_path[SEG_PATH_MAX];
+static SEG_INFO g_seg;
+static uint64_t g_seg_open_ns = 0;
+static uint64_t g_reopen_ns = 0;    // next segment failed to open: jsonl_tick retries from here
+
+void jsonl_default_options(JSONL_OPTIONS* opt)
 {
-    if (!path) return 0;
-    if (g_fp) {
+    opt->mode = JSONL_WRITE_MODE;
+    opt->format = JSONL_OUTPUT_FORMAT;
+    opt->buffer_size = JSONL_BUFFER_BYTES;
+    opt->flush_bytes = JSONL_BUFFER_BYTES;
+    opt->flush_age_ms = JSONL_FLUSH_AGE_MS;
+    opt->fsync_interval_ms = JSONL_FSYNC_INTERVAL_MS;
+    opt->ts_digits = TS_FRACTION_DIGITS;
+    opt->rotate_bytes = JSONL_ROTATE_BYTES;
+    opt->rotate_interval_sec = JSONL_ROTATE_INTERVAL_SEC;
+    opt->compress_segments = JSONL_COMPRESS_SEGMENTS;
+}
+
+void jsonl_configure(const JSONL_OPTIONS* opt)
+{
+    if (!opt) return;
+    g_opt = *opt;
+    if (g_opt.buffer_size < 4096) g_opt.buffer_size = 4096;
+    if (!g_opt.flush_bytes || g_opt.flush_bytes > g_opt.buffer_size) g_opt.flush_bytes = g_opt.buffer_size;
+    g_opt.ts_digits = g_opt.ts_digits >= 6 ? 6 : 3;
+    g_opt_set = 1;
+}
+
+static void sync_file(void)
+{
+    if (!g_fp) return;
+#ifdef _WIN32
+    _commit(_fileno(g_fp));
+#else
+    fsync(fileno(g_fp));
+#endif
+    g_stats.fsyncs++;
+    g_unsynced = 0;
+}
+
+static int bin_begin_file(void);
+
+// 현재 g_fp에 쓰기 시작 (BINARY: header 또는 DICT_RESET)
+static int open_file(const wchar_t* path)
+{
+    g_fp = seg_fopen(path, "ab");
+    if (!g_fp) return 0;
+
+    // 우리가 직접 모아서 쓰므로 CRT buffer는 끔 -> flush 1번 = write 1번
+    setvbuf(g_fp, NULL, _IONBF, 0);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY && !bin_begin_file()) {
         fclose(g_fp);
         g_fp = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+static void close_file(void)
+{
+    if (!g_fp) return;
+    jsonl_flush();
+    fflush(g_fp);
+    if (g_opt.fsync_interval_ms && g_unsynced) sync_file();
+    fclose(g_fp);
+    g_fp = NULL;
+}
+
+// ============================================================
+// segments
+// ============================================================
+static int seg_open_next(void)
+{
+    memset(&g_seg, 0, sizeof(g_seg));
+    g_seg.seq = seg_next_seq(g_base);
+    if (!seg_path(g_seg_path, SEG_PATH_MAX, g_base, g_seg.seq)) return 0;
+
+    g_len = 0;
+    g_first_pending_ns = 0;
+    g_seg_open_ns = plat_now_ns();
+    return open_file(g_seg_path);
+}
+
+// 닫고 index에 기록 -> 압축은 background. 빈 segment는 지움
+static void seg_close_current(void)
+{
+    if (!g_fp) return;
+    close_file();
+
+    if (!g_seg.records) {
+        seg_remove(g_seg_path);
+        return;
+    }
+
+    int queued = g_opt.compress_segments && seg_compress_async(g_seg_path);
+    seg_index_append(g_base, g_seg_path, &g_seg,
+                     g_opt.format == JSONL_FORMAT_BINARY ? "binary" : "text",
+                     queued, g_opt.ts_digits);
+    g_stats.segments++;
+}
+
+static int seg_due(void)
+{
+    if (!g_seg.records) return 0;
+    if (g_opt.rotate_bytes && g_seg.bytes >= g_opt.rotate_bytes) return 1;
+    return g_opt.rotate_interval_sec &&
+           plat_now_ns() - g_seg_open_ns >= (uint64_t)g_opt.rotate_interval_sec * 1000000000ULL;
+}
+
+// 실패하면 g_fp == NULL: 다시 열릴 때까지 event는 lost로 셈 (jsonl_tick이 재시도)
+static int seg_reopen(void)
+{
+    if (seg_open_next()) return 1;
+    g_reopen_ns = plat_now_ns() + (uint64_t)JSONL_REOPEN_RETRY_MS * 1000000ULL;
+    return 0;
+}
+
+static void seg_rotate(void)
+{
+    seg_close_current();
+    seg_reopen();
+}
+
+// 모든 public writer의 입구: rotation + segment time range
+static int event_begin(uint64_t ts_100ns)
+{
+    if (g_rotating && seg_due()) seg_rotate();
+    if (!g_fp) {
+        g_stats.lost++;
+        return 0;
+    }
+
+    if (!g_seg.records || ts_100ns < g_seg.first_ts) g_seg.first_ts = ts_100ns;
+    if (ts_100ns > g_seg.last_ts) g_seg.last_ts = ts_100ns;
+    g_seg.records++;
+    return 1;
+}
+
+int jsonl_open(const wchar_t* path)
+{
+    if (!path) return 0;
+    // 이전 open 정리: rotation 실패로 g_fp가 NULL이어도 g_buf / 압축 thread는 남아 있음
+    jsonl_close();
+
+    if (!g_opt_set) {
+        jsonl_default_options(&g_opt);
+        g_opt_set = 1;
+    }
+
+    g_len = 0;
+    g_first_pending_ns = 0;
+    g_last_fsync_ns = plat_now_ns();
+    g_unsynced = 0;
+
+    g_cap = g_opt.buffer_size;
+    g_buf = (char*)malloc(g_cap);
+    if (!g_buf) {
+        g_cap = 0;
+        return 0;
+    }
+
+    ts_cache_init(&g_ts_cache);
+    memset(&g_seg, 0, sizeof(g_seg));
+
+    g_rotating = g_opt.rotate_bytes || g_opt.rotate_interval_sec;
+    int ok;
+    if (g_rotating) {
+        ok = wcslen(path) < SEG_PATH_MAX;
+        if (ok) {
+            wcscpy(g_base, path);
+            // 압축 thread가 안 떠도 rotation은 계속 (segment가 압축 안 된 채로 남을 뿐)
+            if (g_opt.compress_segments) seg_compressor_start(JSONL_COMPRESS_QUEUE);
+            ok = seg_open_next();
+        }
+    } else {
+        ok = open_file(path);
+    }
+
+    if (!ok) {
+        jsonl_close();
+        return 0;
+    }
+    return 1;
+}
+
+void jsonl_flush(void)
+{
+    if (!g_fp) return;
+
+    if (g_len) {
+        uint64_t t0 = plat_now_ns();
+        fwrite(g_buf, 1, g_len, g_fp);
+        lat_hist_add(&g_write_ns, plat_now_ns() - t0);
+        g_stats.writes++;
+        g_unsynced += g_len;
+        g_len = 0;
+        g_first_pending_ns = 0;
+    }
+}
+
+void jsonl_tick(void)
+{
+    if (!g_fp) {
+        if (!g_rotating || plat_now_ns() < g_reopen_ns || !seg_reopen()) return;
+    }
+
+    // event가 끊겨도 interval rotation은 제때
+    if (g_rotating && seg_due()) {
+        seg_rotate();
+        if (!g_fp) return;
+    }
+
+    uint64_t now = plat_now_ns();
+    if (g_len && now - g_first_pending_ns >= (uint64_t)g_opt.flush_age_ms * 1000000ULL) {
+        jsonl_flush();
+    }
+    if (g_opt.fsync_interval_ms && g_unsynced &&
+        now - g_last_fsync_ns >= (uint64_t)g_opt.fsync_interval_ms * 1000000ULL) {
+        sync_file();
+        g_last_fsync_ns = now;
     }
-    g_fp = _wfopen(path, L"ab");
-    return g_fp != NULL;
 }
 
 void jsonl_close(void)
 {
-    if (g_fp) fclose(g_fp);
+    if (g_rotating) {
+        seg_close_current();
+        seg_compressor_stop();
+        g_rotating = 0;
+    } else {
+        close_file();
+    }
     g_fp = NULL;
+    bin_dict_free(&g_dict);
+    free(g_buf);
+    g_buf = NULL;
+    g_cap = 0;
+    g_len = 0;
+}
+
+void jsonl_get_stats(JSONL_STATS* out)
+{
+    if (out) *out = g_stats;
+}
+
+void jsonl_get_write_latency(LAT_HIST* out)
+{
+    if (out) *out = g_write_ns;
+}
+
+// ============================================================
+// line emission: bound 만큼 reserve -> json_out으로 직접 조립 -> commit
+// ============================================================
+static char* line_begin(size_t bound)
+{
+    if (g_len + bound > g_cap) {
+        jsonl_flush();
+
+        // buffer보다 긴 line (아주 긴 cmdline 등): buffer를 키움
+        if (bound > g_cap) {
+            char* nb = (char*)realloc(g_buf, bound);
+            if (!nb) return NULL;
+            g_buf = nb;
+            g_cap = bound;
+        }
+    }
+    return g_buf + g_len;
 }
 
+static void buf_commit(char* end)
+{
+    size_t n = (size_t)(end - (g_buf + g_len));
+    if (g_len == 0) g_first_pending_ns = plat_now_ns();
+    g_len += n;
+    g_stats.bytes += n;
+    g_seg.bytes += n;
+}
+
+static void line_commit(char* end)
+{
+    buf_commit(end);
+    g_stats.lines++;
+
+    if (g_opt.mode == JSONL_MODE_LINE || g_len >= g_opt.flush_bytes) jsonl_flush();
+}
+
+static size_t wlen(const wchar_t* s) { return s ? wcslen(s) : 0; }
+static size_t alen(const char* s) { return s ? strlen(s) : 0; }
+
+// "key":"<escaped>"
+#define PUT_STR(d, s, n)  do { *(d)++ = '"'; (d) = json_put_str((d), (s), (n)); *(d)++ = '"'; } while (0)
+#define PUT_WSTR(d, s, n) do { *(d)++ = '"'; (d) = json_put_wstr((d), (s), (n)); *(d)++ = '"'; } while (0)
+
+// fixed key text + quotes + numbers
+#define LINE_OVERHEAD 256
+
+// ============================================================
+// BINARY records (bin_format.h)
+// ============================================================
+
+// 새 file: header, 이어쓰기(append): DICT_RESET (이전 run의 id 무효화)
+static int bin_begin_file(void)
+{
+    if (!g_dict.slots && !bin_dict_init(&g_dict, JSONL_BINARY_DICT_MAX)) return 0;
+    bin_dict_reset(&g_dict);
+    g_ts_base_set = 0;
+
+    fseek(g_fp, 0, SEEK_END);
+    long pos = ftell(g_fp);
+
+    char* d = line_begin(BIN_HEADER_SIZE + BIN_RECORD_OVERHEAD + 1);
+    if (!d) return 0;
+    if (pos <= 0) {
+        d = bin_put_header(d, g_opt.ts_digits == 6 ? BIN_FLAG_TS_US : 0);
+    } else {
+        char* rec = d;
+        d = bin_record_begin(rec);
+        *d++ = (char)BIN_REC_DICT_RESET;
+        d = bin_record_end(rec, d);
+    }
+    buf_commit(d);
+    return 1;
+}
+
+static void bin_emit_dict(uint32_t id, const wchar_t* s, size_t n)
+{
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + BIN_VARINT_MAX + BIN_WSTR_BOUND(n));
+    if (!rec) return;
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_DICT;
+    d = bin_put_varint(d, id);
+    d = bin_put_wstr(d, s, n);
+    buf_commit(bin_record_end(rec, d));
+}
+
+static void bin_emit_reset(void)
+{
+    bin_dict_reset(&g_dict);
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1);
+    if (!rec) return;
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_DICT_RESET;
+    buf_commit(bin_record_end(rec, d));
+}
+
+// event ts가 base에서 너무 멀면 새 TS_BASE
+static void bin_ts_base(uint64_t ts)
+{
+    int64_t delta = (int64_t)(ts - g_ts_base);
+    if (g_ts_base_set && delta < BIN_TS_DELTA_MAX && delta > -BIN_TS_DELTA_MAX) return;
+
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + BIN_VARINT_MAX);
+    if (!rec) return;
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_TS_BASE;
+    d = bin_put_varint(d, ts);
+    buf_commit(bin_record_end(rec, d));
+
+    g_ts_base = ts;
+    g_ts_base_set = 1;
+}
+
+// event 하나가 쓰는 string ids. 중간에 dictionary가 차면 reset 후 전부 다시
+static void bin_ids(const wchar_t* const* s, const size_t* n, uint32_t* ids, int k)
+{
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int full = 0;
+        for (int i = 0; i < k; i++) {
+            int is_new = 0;
+            ids[i] = bin_dict_intern(&g_dict, s[i], n[i], &is_new);
+            if (is_new) bin_emit_dict(ids[i], s[i], n[i]);
+            if (!ids[i] && n[i]) full = 1;
+        }
+        if (!full) return;
+        bin_emit_reset();
+    }
+}
+
+static void bin_write_proc_start(uint64_t ts, uint32_t pid, uint32_t ppid,
+                                 const wchar_t* image, size_t image_n,
+                                 const wchar_t* cmdline, size_t cmd_n,
+                                 const char* guid, size_t guid_n,
+                                 const char* parent, size_t parent_n,
+                                 const wchar_t* host, size_t host_n,
+                                 const CMD_SCAN* scan)
+{
+    const wchar_t* s[2] = { image, host };
+    size_t n[2] = { image_n, host_n };
+    uint32_t ids[2];
+    bin_ids(s, n, ids, 2);
+    bin_ts_base(ts);
+
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + 7 * BIN_VARINT_MAX
+                           + BIN_WSTR_BOUND(cmd_n) + BIN_STR_BOUND(guid_n + parent_n));
+    if (!rec) return;
+
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_PROC_START;
+    d = bin_put_ts(d, ts, g_ts_base);
+    d = bin_put_varint(d, pid);
+    d = bin_put_varint(d, ppid);
+    d = bin_put_varint(d, ids[0]);
+    d = bin_put_wstr(d, cmdline, cmd_n);
+    d = bin_put_varint(d, ids[1]);
+    d = bin_put_guid(d, guid, guid_n);
+    d = bin_put_guid(d, parent, parent_n);
+    if (scan) {
+        d = bin_put_varint(d, scan->flags);
+        d = bin_put_varint(d, (uint64_t)scan->tier | ((uint64_t)scan->base64_sus << 2));
+    }
+    line_commit(bin_record_end(rec, d));
+}
+
+static void bin_write_proc_end(uint64_t ts, uint32_t pid, const char* guid, size_t guid_n)
+{
+    bin_ts_base(ts);
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + 2 * BIN_VARINT_MAX + BIN_STR_BOUND(guid_n));
+    if (!rec) return;
+
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_PROC_END;
+    d = bin_put_ts(d, ts, g_ts_base);
+    d = bin_put_varint(d, pid);
+    d = bin_put_guid(d, guid, guid_n);
+    line_commit(bin_record_end(rec, d));
+}
+
+static void bin_write_net_connect(uint64_t ts, uint32_t pid, const char* guid, size_t guid_n,
+                                  const char* src_ip, size_t src_n, uint16_t src_port,
+                                  const char* dst_ip, size_t dst_n, uint16_t dst_port,
+                                  const wchar_t* image, size_t image_n,
+                                  const char* parent, size_t parent_n)
+{
+    uint32_t image_id = 0;
+    if (image) bin_ids(&image, &image_n, &image_id, 1);
+    bin_ts_base(ts);
+
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 2 + 5 * BIN_VARINT_MAX
+                           + BIN_STR_BOUND(guid_n + src_n + dst_n + parent_n));
+    if (!rec) return;
+
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_NET_CONNECT;
+    d = bin_put_ts(d, ts, g_ts_base);
+    d = bin_put_varint(d, pid);
+    d = bin_put_guid(d, guid, guid_n);
+    d = bin_put_ip(d, src_ip, src_n);
+    d = bin_put_varint(d, src_port);
+    d = bin_put_ip(d, dst_ip, dst_n);
+    d = bin_put_varint(d, dst_port);
+    *d++ = (char)((image ? BIN_NET_HAS_IMAGE : 0) | (parent ? BIN_NET_HAS_PARENT : 0));
+    if (image) d = bin_put_varint(d, image_id);
+    if (parent) d = bin_put_guid(d, parent, parent_n);
+    line_commit(bin_record_end(rec, d));
+}
+
+static void bin_write_net_flow(uint64_t ts, uint32_t pid, const char* guid, size_t guid_n,
+                               const char* dst_ip, size_t dst_n, uint16_t dst_port, uint32_t proto,
+                               uint64_t count, uint64_t first_ts, uint64_t last_ts)
+{
+    bin_ts_base(ts);
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + 8 * BIN_VARINT_MAX + BIN_STR_BOUND(guid_n + dst_n));
+    if (!rec) return;
+
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_NET_FLOW;
+    d = bin_put_ts(d, ts, g_ts_base);
+    d = bin_put_varint(d, pid);
+    d = bin_put_guid(d, guid, guid_n);
+    d = bin_put_ip(d, dst_ip, dst_n);
+    d = bin_put_varint(d, dst_port);
+    d = bin_put_varint(d, proto);
+    d = bin_put_varint(d, count);
+    d = bin_put_varint(d, ts - first_ts);
+    d = bin_put_varint(d, ts - last_ts);
+    line_commit(bin_record_end(rec, d));
+}
+
+static void bin_write_tag(uint64_t ts, const char* guid, size_t guid_n,
+                          const char* rule_id, size_t rule_n, const char* technique, size_t tech_n,
+                          int32_t severity, const char* evidence, size_t evidence_n)
+{
+    bin_ts_base(ts);
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + 2 * BIN_VARINT_MAX +
+                           BIN_STR_BOUND(guid_n) + BIN_STR_BOUND(rule_n) + BIN_STR_BOUND(tech_n) +
+                           BIN_STR_BOUND(evidence_n));
+    if (!rec) return;
+
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_TAG;
+    d = bin_put_ts(d, ts, g_ts_base);
+    d = bin_put_guid(d, guid, guid_n);
+    d = bin_put_str(d, rule_id, rule_n);
+    d = bin_put_str(d, technique, tech_n);
+    d = bin_put_varint(d, ((uint64_t)(int64_t)severity << 1) ^ (uint64_t)((int64_t)severity >> 63));
+    d = bin_put_str(d, evidence, evidence_n);
+    line_commit(bin_record_end(rec, d));
+}
+
+static void bin_write_collector_stats(uint64_t ts, const wchar_t* host, size_t host_n,
+                                      const char* fields, size_t fields_n)
+{
+    uint32_t host_id = 0;
+    bin_ids(&host, &host_n, &host_id, 1);
+    bin_ts_base(ts);
+
+    char* rec = line_begin(BIN_RECORD_OVERHEAD + 1 + 2 * BIN_VARINT_MAX + BIN_STR_BOUND(fields_n));
+    if (!rec) return;
+
+    char* d = bin_record_begin(rec);
+    *d++ = (char)BIN_REC_STATS;
+    d = bin_put_ts(d, ts, g_ts_base);
+    d = bin_put_varint(d, host_id);
+    d = bin_put_str(d, fields, fields_n);
+    line_commit(bin_record_end(rec, d));
+}
+
+// ============================================================
+// public writers
+// ============================================================
+#define PUT_TS(d, ts_100ns)                                                         \
+    do {                                                                            \
+        *(d)++ = '"';                                                               \
+        (d) += ts_format_filetime(&g_ts_cache, (ts_100ns), g_opt.ts_digits, (d));  \
+        *(d)++ = '"';                                                               \
+    } while (0)
+
 void jsonl_write_proc_start(
-    const char* ts,
+    uint64_t ts_100ns,
     uint32_t pid,
     uint32_t ppid,
     const wchar_t* image,
     const wchar_t* cmdline,
     const char* process_guid,
-    const wchar_t* host
+    const char* parent_guid,
+    const wchar_t* host,
+    const CMD_SCAN* scan
 ){
-    if (!g_fp) return;
-    const char* ts_safe = ts ? ts : "";
-    const wchar_t* image_safe = image ? image : L"";
-    const wchar_t* cmdline_safe = cmdline ? cmdline : L"";
-    const char* guid_safe = process_guid ? process_guid : "";
-    const wchar_t* host_safe = host ? host : L"";
-
-    fprintf(g_fp,
-        "{\"ts\":\"%s\",\"event_type\":\"proc_start\","
-        "\"pid\":%u,\"ppid\":%u,"
-        "\"image\":\"%S\",\"cmdline\":\"%S\","
-        "\"host\":\"%S\",\"process_guid\":\"%s\"}\n",
-        ts_safe, pid, ppid, image_safe, cmdline_safe, host_safe, guid_safe
-    );
-    fflush(g_fp);
+    if (!event_begin(ts_100ns)) return;
+    size_t guid_n = alen(process_guid), parent_n = alen(parent_guid);
+    size_t image_n = wlen(image), cmd_n = wlen(cmdline), host_n = wlen(host);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY) {
+        bin_write_proc_start(ts_100ns, pid, ppid, image, image_n, cmdline, cmd_n,
+                             process_guid, guid_n, parent_guid, parent_n, host, host_n, scan);
+        return;
+    }
+
+    char* d = line_begin(LINE_OVERHEAD + TS_ISO_MAX + JSON_STR_BOUND(guid_n + parent_n)
+                         + JSON_WSTR_BOUND(image_n + cmd_n + host_n) + 64 + CMD_FLAGS_TEXT_MAX);
+    if (!d) return;
+
+    d = JSON_LIT(d, "{\"ts\":");
+    PUT_TS(d, ts_100ns);
+    d = JSON_LIT(d, ",\"event_type\":\"proc_start\",\"pid\":");
+    d = json_put_u32(d, pid);
+    d = JSON_LIT(d, ",\"ppid\":");
+    d = json_put_u32(d, ppid);
+    d = JSON_LIT(d, ",\"image\":");
+    PUT_WSTR(d, image, image_n);
+    d = JSON_LIT(d, ",\"cmdline\":");
+    PUT_WSTR(d, cmdline, cmd_n);
+    d = JSON_LIT(d, ",\"host\":");
+    PUT_WSTR(d, host, host_n);
+    d = JSON_LIT(d, ",\"process_guid\":");
+    PUT_STR(d, process_guid, guid_n);
+    d = JSON_LIT(d, ",\"parent_process_guid\":");
+    PUT_STR(d, parent_guid, parent_n);
+    if (scan) {
+        d = JSON_LIT(d, ",\"risk_path_tier\":");
+        d = json_put_u32(d, scan->tier);
+        d = JSON_LIT(d, ",\"cmd_flags\":\"");
+        d += cmd_scan_flags_text(scan->flags, d);
+        d = JSON_LIT(d, "\",\"base64_sus\":");
+        d = json_put_u32(d, scan->base64_sus);
+    }
+    d = JSON_LIT(d, "}\n");
+
+    line_commit(d);
 }
 
 void jsonl_write_proc_end(
-    const char* ts,
+    uint64_t ts_100ns,
     uint32_t pid,
     const char* process_guid
 ){
-    if (!g_fp) return;
-    const char* ts_safe = ts ? ts : "";
-    const char* guid_safe = process_guid ? process_guid : "";
-
-    fprintf(g_fp,
-        "{\"ts\":\"%s\",\"event_type\":\"proc_end\","
-        "\"pid\":%u,\"process_guid\":\"%s\"}\n",
-        ts_safe, pid, guid_safe
-    );
-    fflush(g_fp);
+    if (!event_begin(ts_100ns)) return;
+    size_t guid_n = alen(process_guid);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY) {
+        bin_write_proc_end(ts_100ns, pid, process_guid, guid_n);
+        return;
+    }
+
+    char* d = line_begin(LINE_OVERHEAD + TS_ISO_MAX + JSON_STR_BOUND(guid_n));
+    if (!d) return;
+
+    d = JSON_LIT(d, "{\"ts\":");
+    PUT_TS(d, ts_100ns);
+    d = JSON_LIT(d, ",\"event_type\":\"proc_end\",\"pid\":");
+    d = json_put_u32(d, pid);
+    d = JSON_LIT(d, ",\"process_guid\":");
+    PUT_STR(d, process_guid, guid_n);
+    d = JSON_LIT(d, "}\n");
+
+    line_commit(d);
 }
 
 void jsonl_write_net_connect(
-    const char* ts,
+    uint64_t ts_100ns,
     uint32_t pid,
     const char* process_guid,
     const char* src_ip,
     uint16_t src_port,
     const char* dst_ip,
-    uint16_t dst_port
+    uint16_t dst_port,
+    const wchar_t* image,
+    const char* parent_guid
 ){
-    if (!g_fp) return;
-    const char* ts_safe = ts ? ts : "";
-    const char* guid_safe = process_guid ? process_guid : "";
-    const char* src_ip_safe = src_ip ? src_ip : "";
-    const char* dst_ip_safe = dst_ip ? dst_ip : "";
-
-    fprintf(g_fp,
-        "{\"ts\":\"%s\",\"event_type\":\"net_connect\","
-        "\"pid\":%u,\"process_guid\":\"%s\","
-        "\"src_ip\":\"%s\",\"src_port\":%u,"
-        "\"dst_ip\":\"%s\",\"dst_port\":%u}\n",
-        ts_safe, pid, guid_safe, src_ip_safe, src_port, dst_ip_safe, dst_port
-    );
-    fflush(g_fp);
-}
\ No newline at end of file
+    if (!event_begin(ts_100ns)) return;
+    size_t guid_n = alen(process_guid);
+    size_t src_n = alen(src_ip), dst_n = alen(dst_ip);
+    size_t image_n = wlen(image), parent_n = alen(parent_guid);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY) {
+        bin_write_net_connect(ts_100ns, pid, process_guid, guid_n, src_ip, src_n, src_port,
+                              dst_ip, dst_n, dst_port, image, image_n, parent_guid, parent_n);
+        return;
+    }
+
+    char* d = line_begin(LINE_OVERHEAD + TS_ISO_MAX + JSON_STR_BOUND(guid_n + src_n + dst_n + parent_n)
+                         + JSON_WSTR_BOUND(image_n));
+    if (!d) return;
+
+    d = JSON_LIT(d, "{\"ts\":");
+    PUT_TS(d, ts_100ns);
+    d = JSON_LIT(d, ",\"event_type\":\"net_connect\",\"pid\":");
+    d = json_put_u32(d, pid);
+    d = JSON_LIT(d, ",\"process_guid\":");
+    PUT_STR(d, process_guid, guid_n);
+    d = JSON_LIT(d, ",\"src_ip\":");
+    PUT_STR(d, src_ip, src_n);
+    d = JSON_LIT(d, ",\"src_port\":");
+    d = json_put_u32(d, src_port);
+    d = JSON_LIT(d, ",\"dst_ip\":");
+    PUT_STR(d, dst_ip, dst_n);
+    d = JSON_LIT(d, ",\"dst_port\":");
+    d = json_put_u32(d, dst_port);
+    if (image) {
+        d = JSON_LIT(d, ",\"image\":");
+        PUT_WSTR(d, image, image_n);
+    }
+    if (parent_guid) {
+        d = JSON_LIT(d, ",\"parent_process_guid\":");
+        PUT_STR(d, parent_guid, parent_n);
+    }
+    d = JSON_LIT(d, "}\n");
+
+    line_commit(d);
+}
+
+void jsonl_write_net_flow_summary(
+    uint64_t ts_100ns,
+    uint32_t pid,
+    const char* process_guid,
+    const char* dst_ip,
+    uint16_t dst_port,
+    uint32_t proto,
+    uint64_t count,
+    uint64_t first_ts_100ns,
+    uint64_t last_ts_100ns
+){
+    if (!event_begin(ts_100ns)) return;
+    size_t guid_n = alen(process_guid), dst_n = alen(dst_ip);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY) {
+        bin_write_net_flow(ts_100ns, pid, process_guid, guid_n, dst_ip, dst_n, dst_port, proto,
+                           count, first_ts_100ns, last_ts_100ns);
+        return;
+    }
+
+    char* d = line_begin(LINE_OVERHEAD + 3 * TS_ISO_MAX + JSON_STR_BOUND(guid_n + dst_n));
+    if (!d) return;
+
+    d = JSON_LIT(d, "{\"ts\":");
+    PUT_TS(d, ts_100ns);
+    d = JSON_LIT(d, ",\"event_type\":\"net_flow_summary\",\"pid\":");
+    d = json_put_u32(d, pid);
+    d = JSON_LIT(d, ",\"process_guid\":");
+    PUT_STR(d, process_guid, guid_n);
+    d = JSON_LIT(d, ",\"dst_ip\":");
+    PUT_STR(d, dst_ip, dst_n);
+    d = JSON_LIT(d, ",\"dst_port\":");
+    d = json_put_u32(d, dst_port);
+    d = JSON_LIT(d, ",\"proto\":");
+    d = json_put_u32(d, proto);
+    d = JSON_LIT(d, ",\"count\":");
+    d = json_put_u64(d, count);
+    d = JSON_LIT(d, ",\"first_ts\":");
+    PUT_TS(d, first_ts_100ns);
+    d = JSON_LIT(d, ",\"last_ts\":");
+    PUT_TS(d, last_ts_100ns);
+    d = JSON_LIT(d, "}\n");
+
+    line_commit(d);
+}
+
+void jsonl_write_tag(
+    uint64_t ts_100ns,
+    const char* process_guid,
+    const char* rule_id,
+    const char* technique,
+    int32_t severity,
+    const char* evidence
+){
+    if (!event_begin(ts_100ns)) return;
+    size_t guid_n = alen(process_guid), rule_n = alen(rule_id);
+    size_t tech_n = alen(technique), evidence_n = alen(evidence);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY) {
+        bin_write_tag(ts_100ns, process_guid, guid_n, rule_id, rule_n, technique, tech_n,
+                      severity, evidence, evidence_n);
+        return;
+    }
+
+    char* d = line_begin(LINE_OVERHEAD + TS_ISO_MAX + JSON_STR_BOUND(guid_n + rule_n + tech_n + evidence_n));
+    if (!d) return;
+
+    d = JSON_LIT(d, "{\"ts\":");
+    PUT_TS(d, ts_100ns);
+    d = JSON_LIT(d, ",\"event_type\":\"tag\",\"process_guid\":");
+    PUT_STR(d, process_guid, guid_n);
+    d = JSON_LIT(d, ",\"rule_id\":");
+    PUT_STR(d, rule_id, rule_n);
+    d = JSON_LIT(d, ",\"technique\":");
+    PUT_STR(d, technique, tech_n);
+    d = JSON_LIT(d, ",\"severity\":");
+    if (severity < 0) *d++ = '-';
+    d = json_put_u32(d, severity < 0 ? 0u - (uint32_t)severity : (uint32_t)severity);
+    d = JSON_LIT(d, ",\"evidence\":");
+    PUT_STR(d, evidence, evidence_n);
+    d = JSON_LIT(d, "}\n");
+
+    line_commit(d);
+}
+
+void jsonl_write_collector_stats(
+    uint64_t ts_100ns,
+    const wchar_t* host,
+    const char* fields,
+    size_t fields_n
+){
+    if (!event_begin(ts_100ns)) return;
+    size_t host_n = wlen(host);
+
+    if (g_opt.format == JSONL_FORMAT_BINARY) {
+        bin_write_collector_stats(ts_100ns, host, host_n, fields, fields_n);
+        return;
+    }
+
+    char* d = line_begin(LINE_OVERHEAD + TS_ISO_MAX + JSON_WSTR_BOUND(host_n) + fields_n);
+    if (!d) return;
+
+    d = JSON_LIT(d, "{\"ts\":");
+    PUT_TS(d, ts_100ns);
+    d = JSON_LIT(d, ",\"event_type\":\"collector_stats\",\"host\":");
+    PUT_WSTR(d, host, host_n);
+    *d++ = ',';
+    d = json_put_raw(d, fields, fields_n);
+    d = JSON_LIT(d, "}\n");
+
+    line_commit(d);
+}
@@ -1,31 +1,130 @@
 #pragma once
-#include <windows.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
 
+#include "cmd_scan.h"
+#include "lat_hist.h"
+
+// ============================================================
+// Output modes
+// - LINE:     fflush after every line (old behavior, 1 write per event)
+// - BUFFERED: user-space buffer, flushed by size or age (group commit)
+// ============================================================
+typedef enum JSONL_MODE {
+    JSONL_MODE_LINE = 0,
+    JSONL_MODE_BUFFERED,
+} JSONL_MODE;
+
+// ============================================================
+// Output formats
+// - TEXT:   one JSON object per line
+// - BINARY: length-prefixed varint records + per-file string dictionary
+//           + per-record CRC32 (bin_format.h), decode with bin2jsonl
+// ============================================================
+typedef enum JSONL_FORMAT {
+    JSONL_FORMAT_TEXT = 0,
+    JSONL_FORMAT_BINARY,
+} JSONL_FORMAT;
+
+typedef struct JSONL_OPTIONS {
+    JSONL_MODE mode;
+    JSONL_FORMAT format;
+    size_t buffer_size;          // bytes
+    size_t flush_bytes;          // flush when pending >= this
+    uint32_t flush_age_ms;       // flush when oldest pending line is older
+    uint32_t fsync_interval_ms;  // 0: never fsync
+    int ts_digits;               // TEXT: fraction digits 3 (ms) or 6 (us)
+    uint64_t rotate_bytes;       // 0: no size rotation
+    uint32_t rotate_interval_sec; // 0: no time rotation
+    int compress_segments;       // closed segments -> .gz on a background thread
+} JSONL_OPTIONS;
+
+typedef struct JSONL_STATS {
+    uint64_t lines;              // events
+    uint64_t bytes;
+    uint64_t writes;             // write syscalls (flushes)
+    uint64_t fsyncs;
+    uint64_t segments;           // closed segments (rotation)
+    uint64_t lost;               // events dropped with no open file (next segment failed to open)
+} JSONL_STATS;
+
+// jsonl_open 전에 호출 (없으면 config.h 기본값)
+void jsonl_configure(const JSONL_OPTIONS* opt);
+void jsonl_default_options(JSONL_OPTIONS* opt);
+
+// rotation off: append to path
+// rotation on:  path is the base name of numbered segments + index (segment.h)
 int jsonl_open(const wchar_t* path);
-void jsonl_close(void);
+void jsonl_close(void);   // flush (+fsync) then close (rotation: close segment, finish compression)
+
+// writer thread에서 주기적으로 호출: age 기반 flush / fsync / interval rotation
+void jsonl_tick(void);
+void jsonl_flush(void);
+void jsonl_get_stats(JSONL_STATS* out);
+
+// write syscall (flush) 시간 분포, writer thread에서 읽을 것
+void jsonl_get_write_latency(LAT_HIST* out);
 
 void jsonl_write_proc_start(
-    const char* ts,
+    uint64_t ts_100ns,          // FILETIME (UTC)
     uint32_t pid,
     uint32_t ppid,
     const wchar_t* image,
     const wchar_t* cmdline,
     const char* process_guid,
-    const wchar_t* host
+    const char* parent_guid,    // "" if the parent was not seen starting
+    const wchar_t* host,
+    const CMD_SCAN* scan        // NULL: risk_path_tier / cmd_flags / base64_sus omitted
 );
 
 void jsonl_write_proc_end(
-    const char* ts,
+    uint64_t ts_100ns,          // FILETIME (UTC)
     uint32_t pid,
     const char* process_guid
 );
 
 void jsonl_write_net_connect(
-    const char* ts,
+    uint64_t ts_100ns,          // FILETIME (UTC)
     uint32_t pid,
     const char* process_guid,
     const char* src_ip,
     uint16_t src_port,
     const char* dst_ip,
-    uint16_t dst_port
+    uint16_t dst_port,
+    const wchar_t* image,       // NULL: field omitted
+    const char* parent_guid     // NULL: field omitted
+);
+
+// flow_agg.h: connections folded into one flow since its last record
+void jsonl_write_net_flow_summary(
+    uint64_t ts_100ns,          // FILETIME (UTC), >= last_ts
+    uint32_t pid,
+    const char* process_guid,
+    const char* dst_ip,
+    uint16_t dst_port,
+    uint32_t proto,             // IANA protocol number
+    uint64_t count,
+    uint64_t first_ts_100ns,
+    uint64_t last_ts_100ns
+);
+
+// rule_engine.h: a rule fired at this process's start (same row as tagger.apply_rules)
+// strings are UTF-8 from the rules file
+void jsonl_write_tag(
+    uint64_t ts_100ns,          // FILETIME (UTC), the proc_start's ts
+    const char* process_guid,
+    const char* rule_id,
+    const char* technique,      // "": rule has none
+    int32_t severity,
+    const char* evidence
+);
+
+// collector self-stats (collector_stats.h): fields = JSON object members without braces
+// TEXT: {"ts":..,"event_type":"collector_stats","host":..,<fields>}
+void jsonl_write_collector_stats(
+    uint64_t ts_100ns,          // wall clock (FILETIME, UTC)
+    const wchar_t* host,
+    const char* fields,
+    size_t fields_n
 );
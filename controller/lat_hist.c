@@ -0,0 +1,100 @@
+#include "lat_hist.h"
+#include "plat.h"
+
+#include <string.h>
+
+#define SUB (1u << LAT_HIST_SUB_BITS)
+
+static int msb64(uint64_t v)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return (int)i;
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+// v < 16: exact. else: (exponent, top 4 bits below the msb)
+static uint32_t bucket_of(uint64_t v)
+{
+    if (v < SUB) return (uint32_t)v;
+    int e = msb64(v);
+    uint32_t sub = (uint32_t)(v >> (e - LAT_HIST_SUB_BITS)) & (SUB - 1);
+    return (uint32_t)(e - LAT_HIST_SUB_BITS + 1) * SUB + sub;
+}
+
+static uint64_t bucket_low(uint32_t b)
+{
+    if (b < SUB) return b;
+    int e = (int)(b / SUB) + LAT_HIST_SUB_BITS - 1;
+    return (uint64_t)(SUB + b % SUB) << (e - LAT_HIST_SUB_BITS);
+}
+
+void lat_hist_reset(LAT_HIST* h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+void lat_hist_add(LAT_HIST* h, uint64_t v)
+{
+    plat_counter_add(&h->buckets[bucket_of(v)], 1);
+    plat_counter_add(&h->count, 1);
+    plat_counter_add(&h->sum, v);
+    if (v > h->max) plat_counter_add(&h->max, v - h->max);
+}
+
+void lat_hist_merge(LAT_HIST* dst, const LAT_HIST* src)
+{
+    for (uint32_t i = 0; i < LAT_HIST_BUCKETS; i++) dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+// bucket마다 읽는 시점이 조금씩 다름 -> count는 bucket 합 (quantile rank와 일치)
+void lat_hist_snapshot(LAT_HIST* dst, const LAT_HIST* src)
+{
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < LAT_HIST_BUCKETS; i++) {
+        dst->buckets[i] = plat_counter_load(&src->buckets[i]);
+        count += dst->buckets[i];
+    }
+    dst->count = count;
+    dst->sum = plat_counter_load(&src->sum);
+    dst->max = plat_counter_load(&src->max);
+}
+
+void lat_hist_sub(LAT_HIST* dst, const LAT_HIST* cur, const LAT_HIST* prev)
+{
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < LAT_HIST_BUCKETS; i++) {
+        uint64_t d = cur->buckets[i] >= prev->buckets[i] ? cur->buckets[i] - prev->buckets[i] : 0;
+        dst->buckets[i] = d;
+        count += d;
+    }
+    dst->count = count;
+    dst->sum = cur->sum >= prev->sum ? cur->sum - prev->sum : 0;
+    dst->max = cur->max;
+}
+
+uint64_t lat_hist_quantile(const LAT_HIST* h, double q)
+{
+    if (!h->count) return 0;
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+
+    uint64_t rank = (uint64_t)(q * (double)(h->count - 1)) + 1;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < LAT_HIST_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen < rank) continue;
+        if (b < SUB) return b;
+        uint64_t lo = bucket_low(b);
+        uint64_t hi = b + 1 < LAT_HIST_BUCKETS ? bucket_low(b + 1) : h->max;
+        uint64_t mid = lo + (hi - lo) / 2;
+        return mid > h->max ? h->max : mid;
+    }
+    return h->max;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================
+// Latency histogram (ns), log-linear buckets
+// - 16 sub-buckets per power of two: quantiles within ~6%
+// - fixed size (8KB), no allocation, add is a few instructions
+// - single writer (relaxed counters, plat.h): other threads take a snapshot
+// - portable
+// ============================================================
+
+#define LAT_HIST_SUB_BITS 4
+#define LAT_HIST_BUCKETS  (61 << LAT_HIST_SUB_BITS)
+
+typedef struct LAT_HIST {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[LAT_HIST_BUCKETS];
+} LAT_HIST;
+
+void lat_hist_reset(LAT_HIST* h);
+void lat_hist_add(LAT_HIST* h, uint64_t v);
+void lat_hist_merge(LAT_HIST* dst, const LAT_HIST* src);
+
+// any thread: copy of a histogram another thread is still adding to
+void lat_hist_snapshot(LAT_HIST* dst, const LAT_HIST* src);
+
+// interval = cur - prev (snapshots of the same histogram). max는 cur의 누적 max
+void lat_hist_sub(LAT_HIST* dst, const LAT_HIST* cur, const LAT_HIST* prev);
+
+// q: 0..1 (0.5, 0.99, 0.999). bucket 중간값, 비어 있으면 0
+uint64_t lat_hist_quantile(const LAT_HIST* h, double q);
@@ -0,0 +1,547 @@
+#ifdef __linux__
+#include "linux_consumer.h"
+#include "config.h"
+#include "event_rec.h"
+#include "mof_decode.h"
+#include "pipeline.h"
+#include "plat.h"
+#include "ts_format.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+
+static volatile int32_t g_stop = 0;
+void linux_consumer_request_stop(void) { plat_store_i32(&g_stop, 1); }
+
+static const wchar_t* g_record_path = NULL;
+void linux_consumer_set_record_path(const wchar_t* path) { g_record_path = path; }
+static const wchar_t* g_filter_path = NULL;
+void linux_consumer_set_filter_path(const wchar_t* path) { g_filter_path = path; }
+static const wchar_t* g_rules_path = NULL;
+void linux_consumer_set_rules_path(const wchar_t* path) { g_rules_path = path; }
+
+// ============================================================
+// RAW_EVENT payload (source-private)
+// - provider/opcode: kernel MOF Process start/end -> pipeline의 기존 handler로 route
+// - version 0: fixed layout(mof_decode)이 거절 -> linux_decode_process (fallback)
+//   so guid / pid map / process table are exactly the ETW path
+// - u32 pid, u32 ppid, u16 exe_len, u16 cmd_len, exe (UTF-8), cmdline (UTF-8)
+//   host byte order (recordings replay on the same arch)
+// ============================================================
+#define LNX_PROC_VERSION    0
+#define LNX_PROC_HDR        12
+#define LNX_EXE_MAX         4096
+#define LNX_CMD_MAX         (EVREC_CMDLINE_CAP * 4)   // UTF-8 bytes
+
+typedef struct LNX_PROC_HEADER {
+    uint32_t pid;
+    uint32_t ppid;
+    uint16_t exe_len;
+    uint16_t cmd_len;
+} LNX_PROC_HEADER;
+
+// UTF-8 -> wchar_t (UTF-32 on Linux), invalid sequence -> U+FFFD, always terminates
+static void utf8_to_wstr(const uint8_t* s, size_t n, wchar_t* out, size_t cap)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < n && o + 1 < cap; ) {
+        uint32_t c = s[i];
+        size_t k = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (k == 0 || i + k > n) {
+            out[o++] = (wchar_t)0xFFFD;
+            i++;
+            continue;
+        }
+        if (k > 1) {
+            c &= 0x7F >> k;
+            for (size_t j = 1; j < k; j++) {
+                if ((s[i + j] & 0xC0) != 0x80) {
+                    k = 0;
+                    break;
+                }
+                c = (c << 6) | (s[i + j] & 0x3F);
+            }
+            if (k == 0) {
+                out[o++] = (wchar_t)0xFFFD;
+                i++;
+                continue;
+            }
+        }
+        out[o++] = (wchar_t)c;
+        i += k;
+    }
+    out[o] = L'\0';
+}
+
+static int linux_decode_process(const RAW_EVENT* ev, uint32_t* pid, uint32_t* ppid,
+                                wchar_t* image, size_t image_cap, wchar_t* cmd, size_t cmd_cap)
+{
+    if (ev->version != LNX_PROC_VERSION || ev->user_data_len < LNX_PROC_HDR) return 0;
+
+    LNX_PROC_HEADER h;
+    memcpy(&h, ev->user_data, sizeof(h));
+    if ((size_t)LNX_PROC_HDR + h.exe_len + h.cmd_len > ev->user_data_len) return 0;
+
+    const uint8_t* p = (const uint8_t*)ev->user_data + LNX_PROC_HDR;
+    if (pid) *pid = h.pid;
+    if (ppid) *ppid = h.ppid;
+    if (image && image_cap) utf8_to_wstr(p, h.exe_len, image, image_cap);
+    if (cmd && cmd_cap) utf8_to_wstr(p + h.exe_len, h.cmd_len, cmd, cmd_cap);
+    return 1;
+}
+
+static int linux_event_pid(const RAW_EVENT* ev, uint32_t* pid)
+{
+    if (ev->version != LNX_PROC_VERSION || ev->user_data_len < LNX_PROC_HDR) return 0;
+    memcpy(pid, ev->user_data, sizeof(*pid));   // LNX_PROC_HEADER.pid
+    return 1;
+}
+
+// drop filter: exe bytes as they are in the payload (UTF-8)
+static int linux_event_image(const RAW_EVENT* ev, uint32_t* pid, const char** image, size_t* len)
+{
+    if (ev->version != LNX_PROC_VERSION || ev->user_data_len < LNX_PROC_HDR) return 0;
+
+    LNX_PROC_HEADER h;
+    memcpy(&h, ev->user_data, sizeof(h));
+    if ((size_t)LNX_PROC_HDR + h.exe_len > ev->user_data_len) return 0;
+    *pid = h.pid;
+    *image = (const char*)ev->user_data + LNX_PROC_HDR;
+    *len = h.exe_len;
+    return 1;
+}
+
+static const PIPELINE_FALLBACK g_linux_decode = {
+    linux_decode_process, NULL, linux_event_pid, 0, NULL, linux_event_image
+};
+
+// ============================================================
+// pid cache (direct mapped, LINUX_PROC_CACHE_SLOTS)
+// - FORK: ppid (kernel pushes it, no /proc/<pid>/stat read at exec)
+// - EXEC: marks the thread group as reported -> its EXIT becomes proc_end
+// - miss (collision / started before us): exec reads stat, exit is reported
+// ============================================================
+enum { LNX_FORKED = 1, LNX_EXECED = 2 };
+
+typedef struct LNX_PID_SLOT {
+    uint32_t pid;
+    uint32_t ppid;
+    uint32_t state;     // 0: empty
+} LNX_PID_SLOT;
+
+typedef struct LINUX_SOURCE {
+    int fd;
+    uint64_t mono_to_filetime;      // CLOCK_MONOTONIC ns -> FILETIME ns offset
+    volatile int32_t stop;
+    RAW_EVENT_SINK sink;
+    void* sink_ctx;
+    LNX_PID_SLOT cache[LINUX_PROC_CACHE_SLOTS];
+    uint8_t payload[LNX_PROC_HDR + LNX_EXE_MAX + LNX_CMD_MAX];
+    LINUX_SOURCE_STATS st;
+} LINUX_SOURCE;
+
+static LNX_PID_SLOT* cache_slot(LINUX_SOURCE* s, uint32_t pid)
+{
+    return &s->cache[pid & (LINUX_PROC_CACHE_SLOTS - 1)];
+}
+
+// ============================================================
+// /proc readers (exec only)
+// ============================================================
+static size_t read_small(const char* path, char* buf, size_t cap)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    size_t n = 0;
+    while (n < cap) {
+        ssize_t k = read(fd, buf + n, cap - n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) break;
+        n += (size_t)k;
+    }
+    close(fd);
+    return n;
+}
+
+// /proc/<pid>/stat: "pid (comm) S ppid ..." (comm may contain ')' -> last one)
+static int read_ppid(uint32_t pid, uint32_t* ppid)
+{
+    char path[64], buf[512];
+    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+    size_t n = read_small(path, buf, sizeof(buf) - 1);
+    if (!n) return 0;
+    buf[n] = '\0';
+
+    const char* p = strrchr(buf, ')');
+    if (!p || p[1] != ' ' || !p[2] || p[3] != ' ') return 0;
+    *ppid = (uint32_t)strtoul(p + 4, NULL, 10);
+    return 1;
+}
+
+// exe + cmdline (argv joined by ' ') into s->payload. 성공: payload length, 실패: 0
+static uint32_t build_exec_payload(LINUX_SOURCE* s, uint32_t pid, uint32_t ppid)
+{
+    char path[64];
+    uint8_t* exe = s->payload + LNX_PROC_HDR;
+
+    snprintf(path, sizeof(path), "/proc/%u/exe", pid);
+    ssize_t exe_len = readlink(path, (char*)exe, LNX_EXE_MAX);
+    if (exe_len < 0) exe_len = 0;
+
+    uint8_t* cmd = exe + exe_len;
+    snprintf(path, sizeof(path), "/proc/%u/cmdline", pid);
+    size_t cmd_len = read_small(path, (char*)cmd, LNX_CMD_MAX);
+    while (cmd_len && cmd[cmd_len - 1] == '\0') cmd_len--;
+    for (size_t i = 0; i < cmd_len; i++) {
+        if (cmd[i] == '\0') cmd[i] = ' ';
+    }
+
+    // exe와 cmdline 둘 다 없음: 이미 종료됨 (short-lived) -> image 없이 보냄
+    if (!exe_len && !cmd_len) s->st.proc_misses++;
+
+    LNX_PROC_HEADER h;
+    h.pid = pid;
+    h.ppid = ppid;
+    h.exe_len = (uint16_t)exe_len;
+    h.cmd_len = (uint16_t)cmd_len;
+    memcpy(s->payload, &h, sizeof(h));
+    return (uint32_t)(LNX_PROC_HDR + exe_len + cmd_len);
+}
+
+// ============================================================
+// netlink proc connector
+// ============================================================
+static void emit(LINUX_SOURCE* s, uint8_t opcode, uint32_t pid, uint64_t ts_ns, uint32_t len)
+{
+    RAW_EVENT ev;
+    memset(&ev, 0, sizeof(ev));
+    memcpy(ev.provider, MOF_GUID_PROCESS, 16);
+    ev.opcode = opcode;
+    ev.version = LNX_PROC_VERSION;
+    ev.ptr_size = (uint8_t)sizeof(void*);
+    ev.pid = pid;
+    ev.tid = pid;
+    ev.ts_100ns = (ts_ns + s->mono_to_filetime) / 100;
+    ev.user_data = s->payload;
+    ev.user_data_len = len;
+
+    uint64_t t0 = plat_now_ns();
+    s->sink(&ev, s->sink_ctx);
+    s->st.sink_ns += plat_now_ns() - t0;
+}
+
+static void on_proc_event(LINUX_SOURCE* s, const struct proc_event* pe)
+{
+    switch (pe->what) {
+    case PROC_EVENT_FORK: {
+        uint32_t child = (uint32_t)pe->event_data.fork.child_tgid;
+        if ((uint32_t)pe->event_data.fork.child_pid != child) {
+            s->st.skipped++;    // new thread
+            return;
+        }
+        LNX_PID_SLOT* c = cache_slot(s, child);
+        c->pid = child;
+        c->ppid = (uint32_t)pe->event_data.fork.parent_tgid;
+        c->state = LNX_FORKED;
+        s->st.forks++;
+        return;
+    }
+    case PROC_EVENT_EXEC: {
+        uint32_t pid = (uint32_t)pe->event_data.exec.process_tgid;
+        LNX_PID_SLOT* c = cache_slot(s, pid);
+        uint32_t ppid = 0;
+
+        uint64_t t0 = plat_now_ns();
+        if (c->state && c->pid == pid) {
+            ppid = c->ppid;
+            s->st.cache_hits++;
+        } else {
+            read_ppid(pid, &ppid);
+            c->pid = pid;
+            c->ppid = ppid;
+        }
+        c->state = LNX_EXECED;
+        uint32_t len = build_exec_payload(s, pid, ppid);
+        s->st.proc_read_ns += plat_now_ns() - t0;
+
+        s->st.execs++;
+        emit(s, MOF_PROCESS_OPCODE_START, pid, pe->timestamp_ns, len);
+        return;
+    }
+    case PROC_EVENT_EXIT: {
+        uint32_t pid = (uint32_t)pe->event_data.exit.process_tgid;
+        if ((uint32_t)pe->event_data.exit.process_pid != pid) {
+            s->st.skipped++;    // thread exit
+            return;
+        }
+        LNX_PID_SLOT* c = cache_slot(s, pid);
+        if (c->state && c->pid == pid) {
+            uint32_t state = c->state;
+            c->state = 0;
+            if (state == LNX_FORKED) {
+                s->st.skipped++;    // never exec'd: no proc_start either
+                return;
+            }
+        }
+
+        LNX_PROC_HEADER h;
+        memset(&h, 0, sizeof(h));
+        h.pid = pid;
+        memcpy(s->payload, &h, sizeof(h));
+
+        s->st.exits++;
+        emit(s, MOF_PROCESS_OPCODE_END, pid, pe->timestamp_ns, LNX_PROC_HDR);
+        return;
+    }
+    default:
+        s->st.skipped++;
+        return;
+    }
+}
+
+// 한 datagram에 nlmsghdr 여러 개가 올 수 있음
+static void on_datagram(LINUX_SOURCE* s, const uint8_t* buf, size_t n)
+{
+    for (const struct nlmsghdr* nh = (const struct nlmsghdr*)buf; NLMSG_OK(nh, n); nh = NLMSG_NEXT(nh, n)) {
+        if (nh->nlmsg_type == NLMSG_NOOP) continue;
+        if (nh->nlmsg_type == NLMSG_ERROR || nh->nlmsg_type == NLMSG_OVERRUN) {
+            plat_counter_add(&s->st.overruns, 1);
+            continue;
+        }
+        if (nh->nlmsg_len < NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(struct proc_event))) continue;
+
+        const struct cn_msg* cn = (const struct cn_msg*)NLMSG_DATA(nh);
+        if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC) continue;
+
+        s->st.messages++;
+        on_proc_event(s, (const struct proc_event*)cn->data);
+        if (nh->nlmsg_type == NLMSG_DONE) break;
+    }
+}
+
+static int subscribe(int fd, enum proc_cn_mcast_op op)
+{
+    struct {
+        struct nlmsghdr nh;
+        struct cn_msg cn;
+        enum proc_cn_mcast_op op;
+    } __attribute__((packed)) msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.nh.nlmsg_len = sizeof(msg);
+    msg.nh.nlmsg_type = NLMSG_DONE;
+    msg.nh.nlmsg_pid = (uint32_t)getpid();
+    msg.cn.id.idx = CN_IDX_PROC;
+    msg.cn.id.val = CN_VAL_PROC;
+    msg.cn.len = sizeof(enum proc_cn_mcast_op);
+    msg.op = op;
+    return send(fd, &msg, sizeof(msg), 0) == (ssize_t)sizeof(msg);
+}
+
+static int linux_source_run(EVENT_SOURCE* src, RAW_EVENT_SINK sink, void* ctx)
+{
+    LINUX_SOURCE* s = (LINUX_SOURCE*)src->impl;
+    s->sink = sink;
+    s->sink_ctx = ctx;
+
+    if (!subscribe(s->fd, PROC_CN_MCAST_LISTEN)) {
+        fprintf(stderr, "proc connector: subscribe failed: %s\n", strerror(errno));
+        return 0;
+    }
+
+    // kernel이 push, poll timeout은 stop 확인용
+    static uint8_t buf[64 * 1024] __attribute__((aligned(NLMSG_ALIGNTO)));
+    int ok = 1;
+    while (!plat_load_i32(&s->stop) && !plat_load_i32(&g_stop)) {
+        struct pollfd pfd = { s->fd, POLLIN, 0 };
+        int r = poll(&pfd, 1, 250);
+        if (r < 0 && errno != EINTR) {
+            ok = 0;
+            break;
+        }
+        if (r <= 0) continue;
+
+        ssize_t n = recv(s->fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == ENOBUFS) {
+                plat_counter_add(&s->st.overruns, 1);   // socket buffer overflow: events lost, keep going
+                continue;
+            }
+            if (errno == EINTR || errno == EAGAIN) continue;
+            fprintf(stderr, "proc connector: recv failed: %s\n", strerror(errno));
+            ok = 0;
+            break;
+        }
+
+        uint64_t t0 = plat_now_ns();
+        uint64_t sink0 = s->st.sink_ns;
+        on_datagram(s, buf, (size_t)n);
+        s->st.source_ns += (plat_now_ns() - t0) - (s->st.sink_ns - sink0);
+    }
+
+    subscribe(s->fd, PROC_CN_MCAST_IGNORE);
+    return ok;
+}
+
+static void linux_source_request_stop(EVENT_SOURCE* src)
+{
+    LINUX_SOURCE* s = (LINUX_SOURCE*)src->impl;
+    plat_store_i32(&s->stop, 1);
+}
+
+// 커널이 socket buffer에서 버린 묶음 수만 알 수 있음 (event 수는 모름)
+static int linux_source_get_loss(EVENT_SOURCE* src, uint64_t* events_lost, uint64_t* buffers_lost)
+{
+    LINUX_SOURCE* s = (LINUX_SOURCE*)src->impl;
+    *events_lost = 0;
+    *buffers_lost = plat_counter_load(&s->st.overruns);
+    return 1;
+}
+
+static void linux_source_close(EVENT_SOURCE* src)
+{
+    LINUX_SOURCE* s = (LINUX_SOURCE*)src->impl;
+    if (!s) return;
+    if (s->fd >= 0) close(s->fd);
+    free(s);
+    src->impl = NULL;
+}
+
+int linux_source_open(EVENT_SOURCE* src)
+{
+    memset(src, 0, sizeof(*src));
+
+    LINUX_SOURCE* s = (LINUX_SOURCE*)calloc(1, sizeof(LINUX_SOURCE));
+    if (!s) return 0;
+
+    s->fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (s->fd < 0) {
+        fprintf(stderr, "proc connector: socket failed: %s\n", strerror(errno));
+        free(s);
+        return 0;
+    }
+
+    // burst(fork bomb, build) 대비. FORCE는 CAP_NET_ADMIN, 실패하면 rmem_max까지
+    int rcv = LINUX_NETLINK_RCVBUF;
+    if (setsockopt(s->fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcv, sizeof(rcv)) != 0) {
+        setsockopt(s->fd, SOL_SOCKET, SO_RCVBUF, &rcv, sizeof(rcv));
+    }
+
+    struct sockaddr_nl sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = CN_IDX_PROC;
+    sa.nl_pid = (uint32_t)getpid();
+    if (bind(s->fd, (struct sockaddr*)&sa, sizeof(sa)) != 0) {
+        fprintf(stderr, "proc connector: bind failed: %s (needs CAP_NET_ADMIN)\n", strerror(errno));
+        close(s->fd);
+        free(s);
+        return 0;
+    }
+
+    // proc_event.timestamp_ns: CLOCK_MONOTONIC -> FILETIME (ETW와 같은 ts 기준)
+    struct timespec rt, mono;
+    clock_gettime(CLOCK_REALTIME, &rt);
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    uint64_t rt_ns = (uint64_t)rt.tv_sec * 1000000000ULL + (uint64_t)rt.tv_nsec;
+    uint64_t mono_ns = (uint64_t)mono.tv_sec * 1000000000ULL + (uint64_t)mono.tv_nsec;
+    s->mono_to_filetime = TS_FILETIME_UNIX_EPOCH * 100 + rt_ns - mono_ns;
+
+    src->name = "proc_connector";
+    src->run = linux_source_run;
+    src->request_stop = linux_source_request_stop;
+    src->close = linux_source_close;
+    src->get_loss = linux_source_get_loss;
+    src->impl = s;
+    return 1;
+}
+
+void linux_source_get_stats(EVENT_SOURCE* src, LINUX_SOURCE_STATS* out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (src && src->impl) *out = ((LINUX_SOURCE*)src->impl)->st;
+}
+
+// ============================================================
+// Linux consumption: proc connector -> pipeline -> writer thread
+// ============================================================
+static wchar_t g_host[256] = L"";
+static void ensure_host_cached(void)
+{
+    if (g_host[0]) return;
+    char h[256];
+    if (gethostname(h, sizeof(h)) != 0) strcpy(h, "UNKNOWN");
+    h[sizeof(h) - 1] = '\0';
+    size_t n = mbstowcs(g_host, h, 255);
+    if (n == (size_t)-1) n = 0;
+    g_host[n] = L'\0';
+}
+
+static void print_stats(const LINUX_SOURCE_STATS* st)
+{
+    uint64_t ev = st->execs + st->exits;
+    double per = ev ? (double)ev : 1.0;
+    fprintf(stderr, "proc connector: messages=%llu forks=%llu execs=%llu exits=%llu skipped=%llu overruns=%llu "
+                    "proc_misses=%llu cache_hits=%llu\n",
+            (unsigned long long)st->messages, (unsigned long long)st->forks,
+            (unsigned long long)st->execs, (unsigned long long)st->exits,
+            (unsigned long long)st->skipped, (unsigned long long)st->overruns,
+            (unsigned long long)st->proc_misses, (unsigned long long)st->cache_hits);
+    fprintf(stderr, "proc connector: per event source=%.0fns (/proc %.0fns per exec) pipeline=%.0fns\n",
+            (double)st->source_ns / per,
+            st->execs ? (double)st->proc_read_ns / (double)st->execs : 0.0,
+            (double)st->sink_ns / per);
+}
+
+int linux_consume(void)
+{
+    ensure_host_cached();
+
+    EVENT_SOURCE src;
+    if (!linux_source_open(&src)) return 0;
+
+    PIPELINE_CONFIG pcfg;
+    memset(&pcfg, 0, sizeof(pcfg));
+    pcfg.fallback = &g_linux_decode;
+    pcfg.record_path = g_record_path;
+    pcfg.filter_path = g_filter_path;
+    pcfg.rules_path = g_rules_path;
+    pcfg.workers = PIPELINE_WORKERS;
+    if (!pipeline_init(&pcfg)) {
+        src.close(&src);
+        return 0;
+    }
+
+    EVENT_WRITER_CONFIG wcfg;
+    memset(&wcfg, 0, sizeof(wcfg));
+    wcfg.ring_cap = EVENT_RING_CAPACITY;
+    wcfg.policy = EVENT_RING_FULL_POLICY;
+    wcfg.sample_n = EVENT_RING_SAMPLE_N;
+    wcfg.host = g_host;
+    wcfg.net_inline_process = NET_INLINE_PROCESS;
+    wcfg.flow_window_sec = NET_FLOW_WINDOW_SEC;
+    wcfg.flow_max = NET_FLOW_MAX_FLOWS;
+
+    int ok = pipeline_run(&src, &wcfg);
+
+    LINUX_SOURCE_STATS st;
+    linux_source_get_stats(&src, &st);
+    print_stats(&st);
+
+    src.close(&src);
+    pipeline_shutdown();
+    return ok;
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <wchar.h>
+
+#include "event_source.h"
+
+// ============================================================
+// Linux backend: netlink process connector -> same pipeline as ETW
+// - PROC_EVENT_EXEC -> proc_start, PROC_EVENT_EXIT (thread group leader) -> proc_end
+// - pushed by the kernel; /proc/<pid>/exe, cmdline are read once per exec
+//   (ppid comes from the FORK event via a small pid cache, /proc/<pid>/stat on miss)
+// - fork without exec: no proc_start (and its exit is not reported either)
+// - needs CAP_NET_ADMIN (root)
+// ============================================================
+
+typedef struct LINUX_SOURCE_STATS {
+    uint64_t messages;          // netlink messages received
+    uint64_t forks;             // new thread groups seen
+    uint64_t execs;             // -> proc_start
+    uint64_t exits;             // -> proc_end
+    uint64_t skipped;           // thread exits, fork-only processes, other events
+    uint64_t overruns;          // ENOBUFS: kernel dropped events (socket buffer full) -> buffers_lost
+    uint64_t proc_misses;       // exe/cmdline unreadable (process already gone)
+    uint64_t cache_hits;        // exec ppid from the fork cache (no /proc/<pid>/stat read)
+    uint64_t proc_read_ns;      // /proc reads (exec)
+    uint64_t source_ns;         // message parse + /proc reads, excluding the sink
+    uint64_t sink_ns;           // pipeline (decode, state, ring)
+} LINUX_SOURCE_STATS;
+
+// 성공: 1, 실패(socket/bind/subscribe, 권한 없음 등): 0
+int linux_source_open(EVENT_SOURCE* src);
+void linux_source_get_stats(EVENT_SOURCE* src, LINUX_SOURCE_STATS* out);
+
+// jsonl_open 이후 호출, stop까지 block. 성공: 1, 실패: 0
+int linux_consume(void);
+void linux_consumer_request_stop(void);   // signal handler safe
+
+// routing을 통과한 raw event를 path에 기록 (replay.h). NULL: off
+void linux_consumer_set_record_path(const wchar_t* path);
+
+// drop filter config (event_filter.h), loaded at linux_consume. NULL: off
+void linux_consumer_set_filter_path(const wchar_t* path);
+
+// tagging rules (rule_engine.h), loaded at linux_consume. NULL: off
+void linux_consumer_set_rules_path(const wchar_t* path);
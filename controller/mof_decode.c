@@ -0,0 +1,217 @@
+#include "mof_decode.h"
+
+#include <stdio.h>
+#include <string.h>
+
+const uint8_t MOF_GUID_PROCESS[16] = {
+    0xd0, 0xa8, 0x6f, 0x3d, 0x05, 0xfe, 0xd0, 0x11,
+    0x9d, 0xda, 0x00, 0xc0, 0x4f, 0xd7, 0xba, 0x7c,
+};
+
+const uint8_t MOF_GUID_TCPIP[16] = {
+    0xc0, 0x0a, 0x28, 0x9a, 0xe0, 0xc8, 0xd1, 0x11,
+    0x84, 0xe2, 0x00, 0xc0, 0x4f, 0xb9, 0x98, 0xa2,
+};
+
+// ============================================================
+// little-endian readers (UserData는 정렬 보장 없음)
+// ============================================================
+static uint16_t rd_u16le(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint16_t rd_u16be(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+static uint32_t rd_u32le(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ============================================================
+// Process_TypeGroup1
+//   UniqueProcessKey    ptr
+//   ProcessId           u32
+//   ParentId            u32
+//   SessionId           u32
+//   ExitStatus          s32
+//   DirectoryTableBase  ptr   (v3+)
+//   Flags               u32   (v4+)
+//   UserSID             TOKEN_USER + SID, or 4 zero bytes
+//   ImageFileName       ANSI, NUL terminated
+//   CommandLine         UTF-16, NUL terminated
+//   (v4: PackageFullName, ApplicationId follow; not needed)
+// ============================================================
+static int skip_sid(const uint8_t* p, size_t len, size_t off, int ptr_size, size_t* out_off)
+{
+    if (off + 4 > len) return 0;
+
+    // NULL token -> 4 bytes
+    if (rd_u32le(p + off) == 0) {
+        *out_off = off + 4;
+        return 1;
+    }
+
+    // TOKEN_USER (2 pointers) + SID header(8) + 4 * SubAuthorityCount
+    size_t token = (size_t)ptr_size * 2;
+    if (off + token + 8 > len) return 0;
+    uint8_t sub_count = p[off + token + 1];
+    size_t end = off + token + 8 + 4 * (size_t)sub_count;
+    if (end > len) return 0;
+
+    *out_off = end;
+    return 1;
+}
+
+int mof_decode_process(const void* data, size_t len, uint8_t version, int ptr_size, MOF_PROCESS* out)
+{
+    if (!data || !out) return 0;
+    if (ptr_size != 4 && ptr_size != 8) return 0;
+    if (version < 2 || version > 4) return 0;
+
+    const uint8_t* p = (const uint8_t*)data;
+    size_t P = (size_t)ptr_size;
+
+    size_t off = P;                         // skip UniqueProcessKey
+    if (off + 16 > len) return 0;
+    out->pid = rd_u32le(p + off);
+    out->ppid = rd_u32le(p + off + 4);
+    out->session_id = rd_u32le(p + off + 8);
+    out->exit_status = (int32_t)rd_u32le(p + off + 12);
+    off += 16;
+
+    if (version >= 3) off += P;             // DirectoryTableBase
+    if (version >= 4) off += 4;             // Flags
+    if (off > len) return 0;
+
+    if (!skip_sid(p, len, off, ptr_size, &off)) return 0;
+
+    // ImageFileName (ANSI)
+    const uint8_t* nul = (const uint8_t*)memchr(p + off, 0, len - off);
+    if (!nul) return 0;
+    out->image = (const char*)(p + off);
+    out->image_len = (size_t)(nul - (p + off));
+    off = (size_t)(nul - p) + 1;
+
+    // CommandLine (UTF-16). 끝에 NUL이 없으면 payload 끝까지
+    out->cmdline = p + off;
+    out->cmdline_len = 0;
+    while (off + 1 < len && (p[off] | p[off + 1])) {
+        off += 2;
+        out->cmdline_len++;
+    }
+    return 1;
+}
+
+// ============================================================
+// TcpIp_TypeGroup1/2 (IPv4), TcpIp6_TypeGroup1/2 (IPv6), version 2
+//   PID u32, size u32, daddr, saddr, dport u16(BE), sport u16(BE), ...
+// ============================================================
+int mof_decode_tcpip(const void* data, size_t len, uint8_t opcode, uint8_t version, MOF_TCP* out)
+{
+    if (!data || !out) return 0;
+    if (version != 2) return 0;
+
+    const uint8_t* p = (const uint8_t*)data;
+    size_t alen;
+
+    switch (opcode) {
+    case MOF_TCPIP_OPCODE_CONNECT_V4: out->family = 4; alen = 4; break;
+    case MOF_TCPIP_OPCODE_CONNECT_V6: out->family = 6; alen = 16; break;
+    default: return 0;
+    }
+
+    if (len < 8 + alen * 2 + 4) return 0;
+
+    out->pid = rd_u32le(p);
+    out->size = rd_u32le(p + 4);
+    out->daddr = p + 8;
+    out->saddr = p + 8 + alen;
+    out->dport = rd_u16be(p + 8 + alen * 2);
+    out->sport = rd_u16be(p + 8 + alen * 2 + 2);
+    return 1;
+}
+
+// ============================================================
+// ProcessId peek: same offsets as above, nothing else parsed
+// ============================================================
+int mof_process_pid(const void* data, size_t len, uint8_t version, int ptr_size, uint32_t* pid)
+{
+    if (!data || (ptr_size != 4 && ptr_size != 8)) return 0;
+    if (version < 2 || version > 4 || (size_t)ptr_size + 4 > len) return 0;
+    *pid = rd_u32le((const uint8_t*)data + ptr_size);
+    return 1;
+}
+
+int mof_tcpip_pid(const void* data, size_t len, uint8_t opcode, uint8_t version, uint32_t* pid)
+{
+    if (!data || version != 2 || len < 4) return 0;
+    if (opcode != MOF_TCPIP_OPCODE_CONNECT_V4 && opcode != MOF_TCPIP_OPCODE_CONNECT_V6) return 0;
+    *pid = rd_u32le((const uint8_t*)data);
+    return 1;
+}
+
+// ============================================================
+// output helpers
+// ============================================================
+void mof_ip_to_string(uint8_t family, const uint8_t* a, char out[64])
+{
+    out[0] = '\0';
+    if (!a) return;
+
+    if (family == 4) {
+        snprintf(out, 64, "%u.%u.%u.%u", a[0], a[1], a[2], a[3]);
+        return;
+    }
+    if (family != 6) return;
+
+    // RFC 5952: lowercase, longest zero run (>=2 groups) -> "::"
+    uint16_t g[8];
+    for (int i = 0; i < 8; i++) g[i] = rd_u16be(a + i * 2);
+
+    int best = -1, best_len = 0;
+    for (int i = 0; i < 8;) {
+        if (g[i] != 0) { i++; continue; }
+        int j = i;
+        while (j < 8 && g[j] == 0) j++;
+        if (j - i > best_len) { best = i; best_len = j - i; }
+        i = j;
+    }
+    if (best_len < 2) best = -1;
+
+    size_t n = 0;
+    for (int i = 0; i < 8; i++) {
+        if (i == best) {
+            n += (size_t)snprintf(out + n, 64 - n, "::");
+            i += best_len - 1;
+            continue;
+        }
+        if (n && out[n - 1] != ':') out[n++] = ':';
+        n += (size_t)snprintf(out + n, 64 - n, "%x", g[i]);
+    }
+    out[n] = '\0';
+}
+
+size_t mof_ansi_to_wstr(const char* s, size_t len, wchar_t* out, size_t out_wcap)
+{
+    if (!out || out_wcap == 0) return 0;
+    size_t n = 0;
+    if (s) {
+        for (; n < len && n + 1 < out_wcap; n++) out[n] = (wchar_t)(uint8_t)s[n];
+    }
+    out[n] = L'\0';
+    return n;
+}
+
+size_t mof_utf16_to_wstr(const uint8_t* s, size_t units, wchar_t* out, size_t out_wcap)
+{
+    if (!out || out_wcap == 0) return 0;
+    size_t n = units < out_wcap - 1 ? units : out_wcap - 1;
+    if (s) {
+        if (sizeof(wchar_t) == 2) {
+            memcpy(out, s, n * 2);
+        } else {
+            for (size_t i = 0; i < n; i++) out[i] = (wchar_t)rd_u16le(s + i * 2);
+        }
+    } else {
+        n = 0;
+    }
+    out[n] = L'\0';
+    return n;
+}
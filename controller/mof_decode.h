@@ -0,0 +1,60 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// ============================================================
+// Fixed-layout decoders for kernel MOF UserData
+// - portable (raw byte buffers only), no TDH
+// - 성공: 1, 알 수 없는 version/opcode 또는 잘린 payload: 0 (-> TDH fallback)
+// - string fields point into the caller's buffer (no copy)
+// ============================================================
+
+// kernel provider GUIDs (in-memory GUID layout)
+//   ProcessGuid {3d6fa8d0-fe05-11d0-9dda-00c04fd7ba7c}
+//   TcpIpGuid   {9a280ac0-c8e0-11d1-84e2-00c04fb998a2}
+extern const uint8_t MOF_GUID_PROCESS[16];
+extern const uint8_t MOF_GUID_TCPIP[16];
+
+// kernel opcodes (EventDescriptor.Opcode)
+#define MOF_PROCESS_OPCODE_START      1
+#define MOF_PROCESS_OPCODE_END        2
+#define MOF_TCPIP_OPCODE_CONNECT_V4   12
+#define MOF_TCPIP_OPCODE_CONNECT_V6   28
+
+// Process_TypeGroup1 (v2..v4)
+typedef struct MOF_PROCESS {
+    uint32_t pid;
+    uint32_t ppid;
+    uint32_t session_id;
+    int32_t exit_status;
+
+    const char* image;          // ANSI ImageFileName (not NUL terminated)
+    size_t image_len;           // bytes
+    const uint8_t* cmdline;     // UTF-16LE CommandLine, may be unaligned
+    size_t cmdline_len;         // UTF-16 code units
+} MOF_PROCESS;
+
+// TcpIp_TypeGroup1/2 (v4) and TcpIp6_TypeGroup1/2 (v6), version 2
+typedef struct MOF_TCP {
+    uint32_t pid;
+    uint32_t size;
+    uint8_t family;             // 4 or 6
+    const uint8_t* daddr;       // 4 or 16 bytes, network order
+    const uint8_t* saddr;
+    uint16_t dport;             // host order
+    uint16_t sport;
+} MOF_TCP;
+
+// ptr_size: 4 or 8 (EVENT_HEADER_FLAG_32_BIT_HEADER / 64_BIT_HEADER)
+int mof_decode_process(const void* data, size_t len, uint8_t version, int ptr_size, MOF_PROCESS* out);
+int mof_decode_tcpip(const void* data, size_t len, uint8_t opcode, uint8_t version, MOF_TCP* out);
+
+// ProcessId only (decode worker shard key, pipeline.h). 성공: 1
+int mof_process_pid(const void* data, size_t len, uint8_t version, int ptr_size, uint32_t* pid);
+int mof_tcpip_pid(const void* data, size_t len, uint8_t opcode, uint8_t version, uint32_t* pid);
+
+// output helpers (writer는 아직 wchar_t/char를 받으므로 마지막 한 번만 복사)
+void mof_ip_to_string(uint8_t family, const uint8_t* addr, char out[64]);
+size_t mof_ansi_to_wstr(const char* s, size_t len, wchar_t* out, size_t out_wcap);
+size_t mof_utf16_to_wstr(const uint8_t* s, size_t units, wchar_t* out, size_t out_wcap);
@@ -0,0 +1,244 @@
+#include "pid_map.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t hash_u32(uint32_t x)
+{
+    uint64_t h = x;
+    h ^= h >> 16;
+    h *= 0x7feb352dULL;
+    h ^= h >> 15;
+    h *= 0x846ca68bULL;
+    h ^= h >> 16;
+    return h;
+}
+
+static size_t home_of(const PID_MAP* m, uint32_t pid)
+{
+    return (size_t)(hash_u32(pid) & m->mask);
+}
+
+static void note_probes(PID_MAP* m, uint64_t n)
+{
+    m->st.probes += n;
+    if (n > m->st.probe_max) m->st.probe_max = n;
+}
+
+// index of pid's slot, or of the empty slot where it would be inserted
+static size_t find_slot(PID_MAP* m, uint32_t pid)
+{
+    size_t idx = home_of(m, pid);
+    uint64_t n = 1;
+    while (m->slots[idx].gen && m->slots[idx].pid != pid) {
+        idx = (idx + 1) & m->mask;
+        n++;
+    }
+    note_probes(m, n);
+    return idx;
+}
+
+static size_t cap_limit(const PID_MAP* m)
+{
+    if (!m->max_entries) return (size_t)-1;
+    // load factor 0.7 at max_entries
+    size_t need = m->max_entries * 10 / 7 + 1;
+    size_t c = 16;
+    while (c < need) c <<= 1;
+    return c;
+}
+
+int pid_map_init(PID_MAP* m, size_t initial_cap_pow2, size_t max_entries, uint64_t max_age_100ns)
+{
+    memset(m, 0, sizeof(*m));
+    m->max_entries = max_entries;
+    m->max_age_100ns = max_age_100ns;
+
+    // 0: max_entries 전부 처음에 (실행 중 grow 없음)
+    if (!initial_cap_pow2 && max_entries) initial_cap_pow2 = cap_limit(m);
+    if (initial_cap_pow2 < 16) initial_cap_pow2 = 16;
+    if (initial_cap_pow2 & (initial_cap_pow2 - 1)) return 0;
+    if (initial_cap_pow2 > cap_limit(m)) initial_cap_pow2 = cap_limit(m);
+
+    m->slots = (PID_ENTRY*)calloc(initial_cap_pow2, sizeof(PID_ENTRY));
+    if (!m->slots) return 0;
+    m->cap = initial_cap_pow2;
+    m->mask = initial_cap_pow2 - 1;
+    m->next_gen = 1;
+    return 1;
+}
+
+void pid_map_free(PID_MAP* m)
+{
+    if (!m) return;
+    free(m->slots);
+    memset(m, 0, sizeof(*m));
+}
+
+// ============================================================
+// backward-shift deletion: pull following cluster members back so that
+// lookups never need tombstones
+// ============================================================
+static void delete_at(PID_MAP* m, size_t i)
+{
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & m->mask;
+        if (!m->slots[j].gen) break;
+
+        size_t k = home_of(m, m->slots[j].pid);
+        // slot j의 home k가 (i, j] 구간 밖이면 i로 옮길 수 있음 (wrap 고려)
+        int movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            m->slots[i] = m->slots[j];
+            i = j;
+        }
+    }
+    memset(&m->slots[i], 0, sizeof(PID_ENTRY));
+    m->size--;
+}
+
+static int grow(PID_MAP* m)
+{
+    size_t new_cap = m->cap * 2;
+    PID_ENTRY* old = m->slots;
+    size_t old_cap = m->cap;
+
+    PID_ENTRY* slots = (PID_ENTRY*)calloc(new_cap, sizeof(PID_ENTRY));
+    if (!slots) return 0; // keep old (best effort)
+
+    m->slots = slots;
+    m->cap = new_cap;
+    m->mask = new_cap - 1;
+
+    for (size_t i = 0; i < old_cap; i++) {
+        if (!old[i].gen) continue;
+        size_t idx = home_of(m, old[i].pid);
+        while (m->slots[idx].gen) idx = (idx + 1) & m->mask;
+        m->slots[idx] = old[i];
+    }
+    free(old);
+    m->st.grows++;
+    return 1;
+}
+
+void pid_map_sweep(PID_MAP* m, uint64_t now_ts, size_t budget)
+{
+    if (!m->slots || !m->max_age_100ns || now_ts < m->max_age_100ns) return;
+    uint64_t cutoff = now_ts - m->max_age_100ns;
+
+    while (budget--) {
+        size_t pos = m->sweep_pos & m->mask;
+        PID_ENTRY* e = &m->slots[pos];
+        if (e->gen && e->last_seen < cutoff) {
+            // 뒤 entry가 pos로 당겨질 수 있으니 pos는 그대로 다시 봄
+            delete_at(m, pos);
+            m->st.evict_age++;
+            continue;
+        }
+        m->sweep_pos++;
+    }
+}
+
+// cap에 걸렸을 때: 오래된 것부터 (근사 LRU, 32개 sample 중 last_seen 최소)
+static void evict_for_room(PID_MAP* m, uint64_t now_ts)
+{
+    pid_map_sweep(m, now_ts, 64);
+    if (m->size < m->max_entries) return;
+
+    size_t victim = (size_t)-1;
+    uint64_t oldest = UINT64_MAX;
+    size_t seen = 0;
+    for (size_t n = 0; n < m->cap && seen < 32; n++) {
+        size_t pos = (m->sweep_pos + n) & m->mask;
+        if (!m->slots[pos].gen) continue;
+        seen++;
+        if (m->slots[pos].last_seen < oldest) {
+            oldest = m->slots[pos].last_seen;
+            victim = pos;
+        }
+    }
+    if (victim == (size_t)-1) return;
+
+    m->sweep_pos = victim + 1;
+    delete_at(m, victim);
+    m->st.evict_cap++;
+}
+
+uint32_t pid_map_put(PID_MAP* m, uint32_t pid, uint64_t start_ts, uint64_t guid)
+{
+    if (!m->slots) return 0;
+
+    size_t idx = find_slot(m, pid);
+    int exists = m->slots[idx].gen != 0;
+
+    if (!exists) {
+        if (m->max_entries && m->size >= m->max_entries) {
+            evict_for_room(m, start_ts);
+            idx = find_slot(m, pid); // eviction이 cluster를 옮겼을 수 있음
+        }
+        if ((m->size + 1) * 10 > m->cap * 7 && m->cap < cap_limit(m) && grow(m)) {
+            idx = find_slot(m, pid);
+        }
+        // 그래도 가득이면(grow 실패) 실패 처리
+        if (m->size + 1 >= m->cap) return 0;
+        m->size++;
+    } else {
+        m->st.replaced++;
+    }
+
+    uint32_t gen = m->next_gen++;
+    if (!m->next_gen) m->next_gen = 1;
+
+    PID_ENTRY* e = &m->slots[idx];
+    e->pid = pid;
+    e->gen = gen;
+    e->guid = guid;
+    e->start_ts = start_ts;
+    e->last_seen = start_ts;
+    m->st.inserts++;
+    return gen;
+}
+
+int pid_map_get(PID_MAP* m, uint32_t pid, uint64_t ts, PID_ENTRY* out)
+{
+    if (!m->slots) return 0;
+    m->st.lookups++;
+
+    size_t idx = find_slot(m, pid);
+    PID_ENTRY* e = &m->slots[idx];
+    if (!e->gen) return 0;
+
+    // 이벤트가 이 프로세스 시작보다 이전이면 같은 PID의 다른(이전) 프로세스
+    if (ts && ts < e->start_ts) {
+        m->st.stale_rejects++;
+        return 0;
+    }
+
+    if (ts > e->last_seen) e->last_seen = ts;
+    m->st.hits++;
+    if (out) *out = *e;
+    return 1;
+}
+
+int pid_map_del(PID_MAP* m, uint32_t pid, uint32_t gen)
+{
+    if (!m->slots) return 0;
+
+    size_t idx = find_slot(m, pid);
+    PID_ENTRY* e = &m->slots[idx];
+    if (!e->gen) return 0;
+    if (gen && e->gen != gen) return 0;
+
+    delete_at(m, idx);
+    m->st.deletes++;
+    return 1;
+}
+
+void pid_map_get_stats(const PID_MAP* m, PID_MAP_STATS* out)
+{
+    *out = m->st;
+    out->size = m->size;
+    out->cap = m->cap;
+    out->bytes = (uint64_t)m->cap * sizeof(PID_ENTRY);
+}
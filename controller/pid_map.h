@@ -0,0 +1,67 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// PID -> process identity table
+// - open addressing, linear probing, backward-shift deletion (no tombstones)
+// - generation tag per insert: a reused PID never inherits a stale GUID
+// - bounded: max_entries cap + age-based eviction (last_seen)
+// - portable
+// ============================================================
+
+typedef struct PID_ENTRY {
+    uint32_t pid;
+    uint32_t gen;           // 0: empty slot
+    uint64_t guid;          // process guid hash (guid.h)
+    uint64_t start_ts;      // 100ns, process start event time
+    uint64_t last_seen;     // 100ns, last event that touched this pid
+} PID_ENTRY;
+
+typedef struct PID_MAP_STATS {
+    uint64_t size;
+    uint64_t cap;
+    uint64_t bytes;
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t stale_rejects;  // entry started after the event (PID reuse)
+    uint64_t inserts;
+    uint64_t replaced;       // put over a live pid (end event lost)
+    uint64_t deletes;
+    uint64_t evict_age;
+    uint64_t evict_cap;
+    uint64_t grows;
+    uint64_t probes;         // total probe steps (lookups + inserts)
+    uint64_t probe_max;
+} PID_MAP_STATS;
+
+typedef struct PID_MAP {
+    PID_ENTRY* slots;
+    size_t cap;              // power of 2
+    size_t mask;
+    size_t size;
+    size_t max_entries;      // 0: unbounded
+    uint64_t max_age_100ns;  // 0: no age eviction
+    uint32_t next_gen;
+    size_t sweep_pos;
+    PID_MAP_STATS st;
+} PID_MAP;
+
+// initial_cap_pow2: 0 -> sized for max_entries up front (no rehash while running)
+// 성공: 1, 실패: 0
+int pid_map_init(PID_MAP* m, size_t initial_cap_pow2, size_t max_entries, uint64_t max_age_100ns);
+void pid_map_free(PID_MAP* m);
+
+// insert or replace. returns generation (0 on failure)
+uint32_t pid_map_put(PID_MAP* m, uint32_t pid, uint64_t start_ts, uint64_t guid);
+
+// ts: event time (0: no staleness check). 성공: 1 (out filled), 없음/stale: 0
+int pid_map_get(PID_MAP* m, uint32_t pid, uint64_t ts, PID_ENTRY* out);
+
+// gen 0: any generation. 삭제됨: 1
+int pid_map_del(PID_MAP* m, uint32_t pid, uint32_t gen);
+
+// incremental age eviction: inspect up to budget slots
+void pid_map_sweep(PID_MAP* m, uint64_t now_ts, size_t budget);
+
+void pid_map_get_stats(const PID_MAP* m, PID_MAP_STATS* out);
@@ -0,0 +1,887 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "pipeline.h"
+#include "cmd_scan.h"
+#include "collector_stats.h"
+#include "config.h"
+#include "guid.h"
+#include "mof_decode.h"
+#include "pid_map.h"
+#include "plat.h"
+#include "proc_table.h"
+#include "raw_queue.h"
+#include "replay.h"
+#include "rule_engine.h"
+#include "scratch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static PIPELINE_CONFIG g_cfg;
+static PIPELINE_STATS g_stats;          // stage_ns[ROUTE] only (shards: PIPE_SHARD.stage_ns, counters: stats blocks)
+static STATS_SOURCE_THREAD* g_src_st;   // source thread's counters (collector_stats.h)
+static REPLAY_RECORDER g_rec;
+static SCRATCH g_src_scratch;           // workers: source thread (fallback->pid)
+static EVENT_FILTER g_filter;           // source thread only, rules NULL: off
+static RULE_ENGINE g_rules;             // read-only after init, rules NULL: off
+
+// ============================================================
+// per-stage timing (PIPELINE_TIMING, config.h)
+// - off: macros compile to nothing, event path has no clock reads
+// ============================================================
+#if PIPELINE_TIMING
+#define T_MARK(t)       uint64_t t = plat_now_ns()
+#define T_STAGE(ns, s, t)                               \
+    do {                                                \
+        uint64_t now_ = plat_now_ns();                  \
+        (ns)[(s)] += now_ - (t);                        \
+        (t) = now_;                                     \
+    } while (0)
+#else
+#define T_MARK(t)       ((void)0)
+#define T_STAGE(ns, s, t) ((void)0)
+#endif
+
+// ============================================================
+// Shards: PID -> process identity (pid_map.h) + process table (proc_table.h)
+// - generation tag per start: a reused PID never inherits a stale GUID
+// - bounded by PID_MAP_* / PROC_TABLE_* (split across shards)
+// - workers 0: one shard, no locking. workers N: shard i is decoded by
+//   worker i, lock held for every map access (parent lookups cross shards)
+// ============================================================
+typedef struct PIPE_SHARD {
+    PID_MAP pids;
+    PROC_TABLE procs;           // process guid -> image / parent (net_connect inline)
+    PLAT_MUTEX lock;
+
+    // decoding thread's context (worker i, or the source thread when workers 0)
+    STATS_SOURCE_THREAD* st;
+    uint64_t origin_ns;         // current event: sampled pipeline entry -> EVENT_REC.origin_ns
+    uint64_t stage_ns[PIPE_STAGE_COUNT];
+    SCRATCH scratch;            // decode temporaries, reset after every event
+    RULE_MATCH rm;              // rule_engine.h per-thread state (g_rules loaded)
+
+    // decode worker
+    uint32_t index;
+    RAW_QUEUE q;
+    RAW_QUEUE_STATS qstats;     // saved at stop
+    PLAT_THREAD thread;
+} PIPE_SHARD;
+
+static PIPE_SHARD* g_shards;
+static uint32_t g_nshards = 0;
+static uint32_t g_nworkers = 0;
+static volatile int32_t g_workers_stop = 0;
+static PLAT_MUTEX g_fallback_lock;      // workers: PIPELINE_FALLBACK calls
+
+// handler가 도는 thread의 shard (worker i / source thread)
+static PLAT_TLS PIPE_SHARD* t_shard;
+
+#define T_ORIGIN(r)     ((r)->origin_ns = t_shard->origin_ns)
+
+static PIPE_SHARD* shard_of(uint32_t pid)
+{
+    if (g_nshards == 1) return &g_shards[0];
+    // Windows PID는 4의 배수: hash 후 multiply-shift로 [0, n)
+    return &g_shards[((uint64_t)(pid * 0x9E3779B1u) * g_nshards) >> 32];
+}
+
+static void shard_lock(PIPE_SHARD* s)
+{
+    if (g_nworkers) plat_mutex_lock(&s->lock);
+}
+
+static void shard_unlock(PIPE_SHARD* s)
+{
+    if (g_nworkers) plat_mutex_unlock(&s->lock);
+}
+
+// event time 기준으로 pid의 guid 조회. 없으면 "" (stale/unknown). shard lock 안에서
+static int lookup_process(PIPE_SHARD* sh, uint32_t pid, uint64_t ts, char out_guid[64], PID_ENTRY* out)
+{
+    PID_ENTRY e;
+    if (!pid_map_get(&sh->pids, pid, ts, &e)) {
+        out_guid[0] = '\0';
+        return 0;
+    }
+    process_guid_format(e.guid, out_guid);
+    if (out) *out = e;
+    return 1;
+}
+
+// ============================================================
+// Fixed-layout fast path: parse UserData in one pass for known kernel
+// MOF versions. 0 이면 fallback (TDH, source가 제공할 때만)
+// ============================================================
+static int decode_process(const RAW_EVENT* ev, uint32_t* pid, uint32_t* ppid,
+                          wchar_t* image, size_t imageCap, wchar_t* cmd, size_t cmdCap)
+{
+#if DECODE_FIXED_LAYOUT
+    MOF_PROCESS p;
+    if (mof_decode_process(ev->user_data, ev->user_data_len, ev->version, ev->ptr_size, &p)) {
+        if (pid) *pid = p.pid;
+        if (ppid) *ppid = p.ppid;
+        if (image && imageCap) mof_ansi_to_wstr(p.image, p.image_len, image, imageCap);
+        if (cmd && cmdCap) mof_utf16_to_wstr(p.cmdline, p.cmdline_len, cmd, cmdCap);
+        return 1;
+    }
+#endif
+    if (image && imageCap) image[0] = L'\0';
+    if (cmd && cmdCap) cmd[0] = L'\0';
+
+    STATS_SOURCE_THREAD* st = t_shard->st;
+    plat_counter_add(&st->decode_fallbacks, 1);
+    int ok = 0;
+    if (g_cfg.fallback && g_cfg.fallback->process) {
+        if (g_nworkers) plat_mutex_lock(&g_fallback_lock);
+        ok = g_cfg.fallback->process(ev, pid, ppid, image, imageCap, cmd, cmdCap);
+        if (g_nworkers) plat_mutex_unlock(&g_fallback_lock);
+    }
+    if (!ok) plat_counter_add(&st->decode_failures, 1);
+    return ok;
+}
+
+static int decode_tcp(const RAW_EVENT* ev, uint32_t* pid,
+                      char src_ip[64], uint16_t* src_port,
+                      char dst_ip[64], uint16_t* dst_port)
+{
+#if DECODE_FIXED_LAYOUT
+    MOF_TCP t;
+    if (mof_decode_tcpip(ev->user_data, ev->user_data_len, ev->opcode, ev->version, &t)) {
+        *pid = t.pid;
+        mof_ip_to_string(t.family, t.saddr, src_ip);
+        mof_ip_to_string(t.family, t.daddr, dst_ip);
+        *src_port = t.sport;
+        *dst_port = t.dport;
+        return 1;
+    }
+#endif
+    src_ip[0] = '\0';
+    dst_ip[0] = '\0';
+
+    STATS_SOURCE_THREAD* st = t_shard->st;
+    plat_counter_add(&st->decode_fallbacks, 1);
+    int ok = 0;
+    if (g_cfg.fallback && g_cfg.fallback->tcp) {
+        if (g_nworkers) plat_mutex_lock(&g_fallback_lock);
+        ok = g_cfg.fallback->tcp(ev, pid, src_ip, src_port, dst_ip, dst_port);
+        if (g_nworkers) plat_mutex_unlock(&g_fallback_lock);
+    }
+    if (!ok) plat_counter_add(&st->decode_failures, 1);
+    return ok;
+}
+
+// ============================================================
+// Event handlers: decode into a ring slot (EVENT_REC)
+// - serialization/file I/O happens on the writer thread
+// ============================================================
+static void handle_process_start(void* raw, void* ctx)
+{
+    (void)ctx;
+    const RAW_EVENT* ev = (const RAW_EVENT*)raw;
+    PIPE_SHARD* self = t_shard;
+    T_MARK(t);
+
+    // slot이 없으면(drop policy) 그래도 pid->guid map은 갱신해야 하므로 scratch에 decode
+    EVENT_REC* r = event_writer_begin();
+    int queued = (r != NULL);
+    if (!r) {
+        plat_counter_add(&self->st->dropped, 1);
+        r = (EVENT_REC*)scratch_alloc(&self->scratch, sizeof(EVENT_REC));
+        if (!r) return;
+    }
+    T_STAGE(self->stage_ns, PIPE_STAGE_EMIT, t);
+
+    r->type = EVREC_PROC_START;
+    r->ts_100ns = ev->ts_100ns;
+    T_ORIGIN(r);
+
+    r->pid = 0;
+    r->ppid = 0;
+    decode_process(ev, &r->pid, &r->ppid, r->image, EVREC_IMAGE_CAP, r->cmdline, EVREC_CMDLINE_CAP);
+
+    uint64_t h = process_guid_hash(r->pid, r->ts_100ns, r->image);
+    process_guid_format(h, r->process_guid);
+    // rules: 자기 image / cmdline은 lock 밖에서 (self_bits는 아래 proc_table_put에)
+    if (g_rules.rules) rule_scan(&g_rules, &self->rm, r->image, r->cmdline);
+    if (queued && PROC_CMD_SCAN) cmd_scan(r->image, r->cmdline, &r->scan);
+    T_STAGE(self->stage_ns, PIPE_STAGE_DECODE, t);
+
+    // parent: 이 시점에 살아있는 ppid의 guid (pid_map put 전에 조회)
+    // -> proc_start에 parent_process_guid로 나감 (analyzer correlate 불필요)
+    // workers: parent는 다른 shard일 수 있음. 그 shard가 parent start를 아직
+    // 처리하지 않았으면 "" (analyzer가 ppid로 다시 연결)
+    PIPE_SHARD* ps = shard_of(r->ppid);
+    PIPE_SHARD* sh = shard_of(r->pid);
+    PID_ENTRY parent;
+    uint64_t parent_h = 0;
+    uint64_t parent_bits = 0;   // parent conditions the parent matched at its start
+    shard_lock(ps);
+    if (lookup_process(ps, r->ppid, r->ts_100ns, r->parent_guid, &parent)) {
+        parent_h = parent.guid;
+        if (g_rules.rules && g_rules.nparent) {
+            const PROC_REC* pr = proc_table_get(&ps->procs, parent_h, r->ts_100ns);
+            if (pr) parent_bits = pr->rule_bits;
+        }
+    }
+    if (ps != sh) {
+        shard_unlock(ps);
+        shard_lock(sh);
+    }
+
+    // update pid->guid map (이전 generation은 replace)
+    pid_map_put(&sh->pids, r->pid, r->ts_100ns, h);
+    proc_table_put(&sh->procs, h, parent_h, r->pid, r->ppid, r->ts_100ns, r->image, r->cmdline,
+                   g_rules.rules ? self->rm.self_bits : 0);
+    shard_unlock(sh);
+    T_STAGE(self->stage_ns, PIPE_STAGE_STATE, t);
+
+    r->ntags = 0;
+    if (g_rules.rules) {
+        r->ntags = (uint16_t)rule_eval(&g_rules, &self->rm, parent_bits, r->tags, EVREC_TAGS_MAX);
+        if (queued) plat_counter_add(&self->st->tags, r->ntags);
+    }
+
+    if (queued) event_writer_commit();
+    T_STAGE(self->stage_ns, PIPE_STAGE_EMIT, t);
+}
+
+static void handle_process_end(void* raw, void* ctx)
+{
+    (void)ctx;
+    const RAW_EVENT* ev = (const RAW_EVENT*)raw;
+    PIPE_SHARD* self = t_shard;
+    T_MARK(t);
+
+    uint32_t pid = 0;
+    decode_process(ev, &pid, NULL, NULL, 0, NULL, 0);
+    uint64_t ts = ev->ts_100ns;
+    T_STAGE(self->stage_ns, PIPE_STAGE_DECODE, t);
+
+    // best-effort: if we never saw start, still emit with empty guid
+    PIPE_SHARD* sh = shard_of(pid);
+    char pguid[64];
+    PID_ENTRY e;
+    shard_lock(sh);
+    if (lookup_process(sh, pid, ts, pguid, &e)) {
+        // remove mapping now (PID reuse 대비), 이 generation만
+        pid_map_del(&sh->pids, pid, e.gen);
+        proc_table_del(&sh->procs, e.guid);
+    }
+    shard_unlock(sh);
+    T_STAGE(self->stage_ns, PIPE_STAGE_STATE, t);
+
+    EVENT_REC* r = event_writer_begin();
+    if (!r) {
+        plat_counter_add(&self->st->dropped, 1);
+        return;
+    }
+
+    r->type = EVREC_PROC_END;
+    r->ts_100ns = ts;
+    T_ORIGIN(r);
+    r->pid = pid;
+    memcpy(r->process_guid, pguid, sizeof(r->process_guid));
+    event_writer_commit();
+    T_STAGE(self->stage_ns, PIPE_STAGE_EMIT, t);
+}
+
+// net_connect에 image / parent guid를 붙여서 analyzer가 JOIN 없이 읽도록 (shard lock 안에서)
+static void inline_process(PIPE_SHARD* sh, EVENT_REC* r, uint64_t guid)
+{
+    const PROC_REC* pr = proc_table_get(&sh->procs, guid, r->ts_100ns);
+    if (!pr) return;
+
+    size_t n = 0;
+    const wchar_t* img = proc_table_image(&sh->procs, pr, &n);
+    if (img) {
+        if (n > EVREC_IMAGE_CAP - 1) n = EVREC_IMAGE_CAP - 1;
+        memcpy(r->image, img, n * sizeof(wchar_t));
+        r->image[n] = L'\0';
+    }
+    if (pr->parent_guid) process_guid_format(pr->parent_guid, r->parent_guid);
+}
+
+static void handle_tcp_connect(void* raw, void* ctx)
+{
+    (void)ctx;
+    const RAW_EVENT* ev = (const RAW_EVENT*)raw;
+    PIPE_SHARD* self = t_shard;
+    T_MARK(t);
+
+    // stateless: drop이면 decode도 안 함
+    EVENT_REC* r = event_writer_begin();
+    if (!r) {
+        plat_counter_add(&self->st->dropped, 1);
+        return;
+    }
+    T_STAGE(self->stage_ns, PIPE_STAGE_EMIT, t);
+
+    r->type = EVREC_NET_CONNECT;
+    r->ts_100ns = ev->ts_100ns;
+    T_ORIGIN(r);
+
+    r->pid = 0;
+    r->src_port = 0;
+    r->dst_port = 0;
+    decode_tcp(ev, &r->pid, r->src_ip, &r->src_port, r->dst_ip, &r->dst_port);
+    T_STAGE(self->stage_ns, PIPE_STAGE_DECODE, t);
+
+    // may be empty if unknown
+    r->image[0] = L'\0';
+    r->parent_guid[0] = '\0';
+    PIPE_SHARD* sh = shard_of(r->pid);
+    PID_ENTRY e;
+    shard_lock(sh);
+    if (lookup_process(sh, r->pid, r->ts_100ns, r->process_guid, &e) && NET_INLINE_PROCESS) {
+        inline_process(sh, r, e.guid);
+    }
+    shard_unlock(sh);
+    T_STAGE(self->stage_ns, PIPE_STAGE_STATE, t);
+
+    // If tuple is missing, still allow emission (schema 확장은 나중)
+    event_writer_commit();
+    T_STAGE(self->stage_ns, PIPE_STAGE_EMIT, t);
+}
+
+// ============================================================
+// Event routing: provider GUID + Id/Opcode -> handler
+// - 관심 없는 이벤트는 decode 없이 여기서 바로 drop
+// ============================================================
+static EVENT_DISPATCH g_dispatch;
+static int g_dispatch_ready = 0;
+
+int pipeline_register(const void* provider, uint16_t id, uint8_t opcode,
+                      EVENT_HANDLER handler, void* ctx)
+{
+    if (!g_dispatch_ready) {
+        dispatch_init(&g_dispatch);
+        g_dispatch_ready = 1;
+    }
+    return dispatch_register(&g_dispatch, provider, id, opcode, handler, ctx);
+}
+
+static void register_default_handlers(void)
+{
+    // kernel MOF events: Id == 0, type is in Opcode
+    pipeline_register(MOF_GUID_PROCESS, 0, MOF_PROCESS_OPCODE_START, handle_process_start, NULL);
+    pipeline_register(MOF_GUID_PROCESS, 0, MOF_PROCESS_OPCODE_END, handle_process_end, NULL);
+    pipeline_register(MOF_GUID_TCPIP, 0, MOF_TCPIP_OPCODE_CONNECT_V4, handle_tcp_connect, NULL);
+    pipeline_register(MOF_GUID_TCPIP, 0, MOF_TCPIP_OPCODE_CONNECT_V6, handle_tcp_connect, NULL);
+}
+
+// handler + age eviction on the decoding thread. t0: decode_ns start (0: not sampled)
+static void run_handler(PIPE_SHARD* self, const DISPATCH_ENTRY* h, const RAW_EVENT* ev, uint64_t t0)
+{
+    h->handler((void*)ev, h->ctx);
+    if (t0) lat_hist_add(&self->st->decode_ns, plat_now_ns() - t0);
+    scratch_reset(&self->scratch);
+
+    // lost end event 대비: 조금씩 age eviction (자기 shard만)
+    T_MARK(s);
+    shard_lock(self);
+    pid_map_sweep(&self->pids, ev->ts_100ns, PID_MAP_SWEEP_BUDGET);
+    shard_unlock(self);
+    T_STAGE(self->stage_ns, PIPE_STAGE_STATE, s);
+}
+
+// shard key: the process the event is about (payload), not EventHeader.ProcessId
+static uint32_t event_pid(const RAW_EVENT* ev)
+{
+    uint32_t pid;
+    if (memcmp(ev->provider, MOF_GUID_PROCESS, 16) == 0) {
+        if (mof_process_pid(ev->user_data, ev->user_data_len, ev->version, ev->ptr_size, &pid)) return pid;
+    } else if (memcmp(ev->provider, MOF_GUID_TCPIP, 16) == 0) {
+        if (mof_tcpip_pid(ev->user_data, ev->user_data_len, ev->opcode, ev->version, &pid)) return pid;
+    } else {
+        return ev->pid;     // pipeline_register handlers
+    }
+
+    if (g_cfg.fallback && g_cfg.fallback->pid) {
+        plat_mutex_lock(&g_fallback_lock);
+        int ok = g_cfg.fallback->pid(ev, &pid);
+        plat_mutex_unlock(&g_fallback_lock);
+        scratch_reset(&g_src_scratch);
+        if (ok) return pid;
+    }
+    return ev->pid;
+}
+
+// ============================================================
+// Drop filter (event_filter.h): right after routing, on the raw payload
+// - proc_start: image rule -> drop, pid followed until its end
+// - net_connect: dst rule or a followed pid -> drop
+// - *pid: shard key (= event_pid) for the worker queue
+// ============================================================
+static int filter_drop(const RAW_EVENT* ev, uint32_t* pid)
+{
+    EVENT_FILTER* f = &g_filter;
+    int rule;
+
+    if (memcmp(ev->provider, MOF_GUID_PROCESS, 16) == 0 && ev->opcode == MOF_PROCESS_OPCODE_START) {
+        MOF_PROCESS p;
+        const char* img = NULL;
+        size_t n = 0;
+        if (mof_decode_process(ev->user_data, ev->user_data_len, ev->version, ev->ptr_size, &p)) {
+            *pid = p.pid;
+            img = p.image;
+            n = p.image_len;
+        } else if (!(g_cfg.fallback && g_cfg.fallback->image && g_cfg.fallback->image(ev, pid, &img, &n))) {
+            *pid = event_pid(ev);
+            event_filter_pid_del(f, *pid);
+            return 0;
+        }
+
+        rule = event_filter_image(f, img, n);
+        if (rule < 0) {
+            event_filter_pid_del(f, *pid);      // PID 재사용: 이전 process는 끝남
+            return 0;
+        }
+        event_filter_pid_put(f, *pid, rule);
+        event_filter_hit(f, rule, 0);
+        return 1;
+    }
+
+    if (memcmp(ev->provider, MOF_GUID_TCPIP, 16) == 0) {
+        MOF_TCP t;
+        if (mof_decode_tcpip(ev->user_data, ev->user_data_len, ev->opcode, ev->version, &t)) {
+            *pid = t.pid;
+            rule = event_filter_dst(f, t.family, t.daddr);
+            if (rule >= 0) {
+                event_filter_hit(f, rule, 0);
+                return 1;
+            }
+        } else {
+            *pid = event_pid(ev);
+        }
+        rule = event_filter_pid_get(f, *pid);
+        if (rule < 0) return 0;
+        event_filter_hit(f, rule, 1);
+        return 1;
+    }
+
+    *pid = event_pid(ev);
+    if (memcmp(ev->provider, MOF_GUID_PROCESS, 16) == 0 && ev->opcode == MOF_PROCESS_OPCODE_END) {
+        rule = event_filter_pid_get(f, *pid);
+        if (rule < 0) return 0;
+        event_filter_pid_del(f, *pid);
+        event_filter_hit(f, rule, 1);
+        return 1;
+    }
+    return 0;
+}
+
+void pipeline_on_event(const RAW_EVENT* ev, void* ctx)
+{
+    (void)ctx;
+    T_MARK(t);
+
+    // 1/COLLECTOR_STATS_SAMPLE만 시각을 잼 (PIPELINE_TIMING: 전부)
+    uint64_t seq = g_src_st->events;
+    plat_counter_add(&g_src_st->events, 1);
+    uint64_t origin = (PIPELINE_TIMING || (seq & (COLLECTOR_STATS_SAMPLE - 1)) == 0) ? plat_now_ns() : 0;
+
+    const DISPATCH_ENTRY* h = dispatch_lookup(&g_dispatch, ev->provider, ev->id, ev->opcode);
+    if (!h) {
+        T_STAGE(g_stats.stage_ns, PIPE_STAGE_ROUTE, t);
+        return; // other events ignored (minimal spec)
+    }
+    plat_counter_add(&g_src_st->routed, 1);
+    if (g_rec.fp) replay_record(&g_rec, ev);
+
+    // 녹화는 filter 전 (replay에 같은 filter를 다시 적용할 수 있게)
+    uint32_t pid = 0;
+    int have_pid = 0;
+    if (g_filter.rules) {
+        if (filter_drop(ev, &pid)) {
+            plat_counter_add(&g_src_st->filtered, 1);
+            T_STAGE(g_stats.stage_ns, PIPE_STAGE_ROUTE, t);
+            return;
+        }
+        have_pid = 1;
+    }
+
+    if (!g_nworkers) {
+        T_STAGE(g_stats.stage_ns, PIPE_STAGE_ROUTE, t);
+        PIPE_SHARD* self = &g_shards[0];
+        t_shard = self;
+        self->origin_ns = origin;
+        run_handler(self, h, ev, origin);
+        return;
+    }
+
+    // workers: raw record copy -> 그 process의 shard queue. decode는 worker에서
+    PIPE_SHARD* sh = shard_of(have_pid ? pid : event_pid(ev));
+    uint32_t native_len = ev->native && g_cfg.fallback ? g_cfg.fallback->native_size : 0;
+    if (!raw_queue_push(&sh->q, ev, native_len, h, origin)) plat_counter_add(&g_src_st->dropped, 1);
+    T_STAGE(g_stats.stage_ns, PIPE_STAGE_ROUTE, t);
+}
+
+// ============================================================
+// decode workers
+// ============================================================
+static void worker_main(void* arg)
+{
+    PIPE_SHARD* self = (PIPE_SHARD*)arg;
+    t_shard = self;
+    scratch_bind(&self->scratch);
+    event_writer_set_lane(self->index);
+    uint32_t idle = 0;
+
+    for (;;) {
+        RAW_QUEUE_ITEM* it = raw_queue_peek(&self->q);
+        if (!it) {
+            // stop: source가 멈춘 뒤 queue가 빌 때까지 drain
+            if (plat_load_i32(&g_workers_stop)) {
+                if (raw_queue_is_empty(&self->q)) break;
+                continue;
+            }
+            // spin -> yield -> sleep backoff
+            if (idle < 64) {
+                idle++;
+            } else if (idle < 128) {
+                idle++;
+                plat_yield();
+            } else {
+                plat_sleep_ms(1);
+            }
+            continue;
+        }
+        idle = 0;
+
+        RAW_EVENT* ev = &it->ev;
+        if (ev->native && g_cfg.fallback->native_rebind) g_cfg.fallback->native_rebind(ev->native, ev);
+        self->origin_ns = it->origin_ns;
+        run_handler(self, (const DISPATCH_ENTRY*)it->route, ev, it->origin_ns ? plat_now_ns() : 0);
+
+        // release 후에야 lane_pending이 0 -> writer merge는 이 record를 본 다음에 진행
+        raw_queue_release(&self->q);
+    }
+}
+
+// EVENT_WRITER_CONFIG.lane_pending
+static int worker_pending(uint32_t lane)
+{
+    return lane < g_nworkers && !raw_queue_is_empty(&g_shards[lane].q);
+}
+
+static void stop_workers(uint32_t started)
+{
+    plat_store_i32(&g_workers_stop, 1);
+    for (uint32_t i = 0; i < started; i++) plat_thread_join(g_shards[i].thread);
+    for (uint32_t i = 0; i < g_nworkers; i++) {
+        PIPE_SHARD* sh = &g_shards[i];
+        if (!sh->q.buf) continue;
+        raw_queue_get_stats(&sh->q, &sh->qstats);
+        raw_queue_free(&sh->q);
+    }
+}
+
+static int start_workers(RING_FULL_POLICY policy)
+{
+    plat_store_i32(&g_workers_stop, 0);
+    for (uint32_t i = 0; i < g_nworkers; i++) {
+        if (!raw_queue_init(&g_shards[i].q, PIPELINE_WORKER_QUEUE_BYTES, policy)) {
+            stop_workers(0);
+            return 0;
+        }
+    }
+    for (uint32_t i = 0; i < g_nworkers; i++) {
+        if (!plat_thread_start(&g_shards[i].thread, worker_main, &g_shards[i])) {
+            stop_workers(i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// ============================================================
+// lifecycle
+// ============================================================
+static void free_shards(void)
+{
+    for (uint32_t i = 0; i < g_nshards; i++) {
+        pid_map_free(&g_shards[i].pids);
+        proc_table_free(&g_shards[i].procs);
+        scratch_free(&g_shards[i].scratch);
+        rule_match_free(&g_shards[i].rm);
+        plat_mutex_destroy(&g_shards[i].lock);
+    }
+    free(g_shards);
+    g_shards = NULL;
+    g_nshards = 0;
+}
+
+int pipeline_init(const PIPELINE_CONFIG* cfg)
+{
+    memset(&g_cfg, 0, sizeof(g_cfg));
+    if (cfg) g_cfg = *cfg;
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    g_nworkers = g_cfg.workers;
+    if (g_nworkers > PIPELINE_WORKERS_MAX) g_nworkers = PIPELINE_WORKERS_MAX;
+    if (g_nworkers > EVENT_WRITER_LANES_MAX) g_nworkers = EVENT_WRITER_LANES_MAX;
+    if (g_nworkers > COLLECTOR_STATS_WORKERS_MAX) g_nworkers = COLLECTOR_STATS_WORKERS_MAX;
+    collector_stats_reset(g_nworkers);
+    g_src_st = collector_stats_source();
+    plat_mutex_init(&g_fallback_lock);
+
+    register_default_handlers();
+
+    // 상한(PID_MAP_MAX_ENTRIES 등)은 shard 수로 나눔: 전체 메모리는 workers와 무관
+    uint32_t n = g_nworkers ? g_nworkers : 1;
+    g_shards = (PIPE_SHARD*)calloc(n, sizeof(PIPE_SHARD));
+    if (!g_shards) return 0;
+    for (g_nshards = 0; g_nshards < n; g_nshards++) {
+        PIPE_SHARD* sh = &g_shards[g_nshards];
+        sh->index = g_nshards;
+        sh->st = g_nworkers ? collector_stats_worker(g_nshards) : g_src_st;
+        plat_mutex_init(&sh->lock);
+
+        if (!pid_map_init(&sh->pids, PID_MAP_INITIAL_CAP, (PID_MAP_MAX_ENTRIES + n - 1) / n,
+                          (uint64_t)PID_MAP_MAX_AGE_SEC * 10000000ULL)) {
+            fprintf(stderr, "pid->guid map init failed\n");
+            free_shards();
+            return 0;
+        }
+        if (!proc_table_init(&sh->procs, (PROC_TABLE_MAX_RECORDS + n - 1) / n,
+                             (PROC_TABLE_INITIAL_RECORDS + n - 1) / n, PROC_TABLE_POOL_BYTES / n)) {
+            fprintf(stderr, "process table init failed\n");
+            pid_map_free(&sh->pids);
+            free_shards();
+            return 0;
+        }
+        if (!scratch_init(&sh->scratch, PIPELINE_SCRATCH_BYTES)) {
+            fprintf(stderr, "scratch arena init failed\n");
+            pid_map_free(&sh->pids);
+            proc_table_free(&sh->procs);
+            free_shards();
+            return 0;
+        }
+    }
+    if (g_nworkers && !scratch_init(&g_src_scratch, PIPELINE_SCRATCH_BYTES)) {
+        fprintf(stderr, "scratch arena init failed\n");
+        free_shards();
+        return 0;
+    }
+
+    memset(&g_filter, 0, sizeof(g_filter));
+    if (g_cfg.filter_path && !event_filter_load(&g_filter, g_cfg.filter_path, FILTER_PID_SLOTS)) {
+        // 설정한 filter를 못 읽으면 시작하지 않음 (조용히 전부 쓰는 것보다 나음)
+        free_shards();
+        scratch_free(&g_src_scratch);
+        return 0;
+    }
+
+    memset(&g_rules, 0, sizeof(g_rules));
+    if (g_cfg.rules_path) {
+        int ok = rule_engine_load(&g_rules, g_cfg.rules_path);
+        for (uint32_t i = 0; ok && i < g_nshards; i++) ok = rule_match_init(&g_shards[i].rm, &g_rules);
+        if (!ok) {
+            // filter와 같음: 설정한 rules를 못 읽으면 시작하지 않음
+            fprintf(stderr, "rules: load failed\n");
+            free_shards();
+            scratch_free(&g_src_scratch);
+            event_filter_free(&g_filter);
+            rule_engine_free(&g_rules);
+            return 0;
+        }
+    }
+
+    memset(&g_rec, 0, sizeof(g_rec));
+    if (g_cfg.record_path && !replay_recorder_open(&g_rec, g_cfg.record_path)) {
+        // 녹화 실패는 수집을 막지 않음
+        fprintf(stderr, "raw event recording disabled (open failed)\n");
+    }
+    return 1;
+}
+
+int pipeline_run(EVENT_SOURCE* src, const EVENT_WRITER_CONFIG* wcfg)
+{
+    if (!src || !src->run || !wcfg) return 0;
+    collector_stats_attach(src);
+
+    // workers: lane per worker, writer merges by timestamp
+    EVENT_WRITER_CONFIG w = *wcfg;
+    if (g_nworkers) {
+        w.lanes = g_nworkers;
+        w.reorder_ms = PIPELINE_REORDER_MS;
+        w.lane_pending = worker_pending;
+    }
+    w.rules = g_rules.rules ? &g_rules : NULL;
+    if (!event_writer_start(&w)) {
+        fprintf(stderr, "writer thread start failed\n");
+        return 0;
+    }
+    if (g_nworkers && !start_workers(w.policy)) {
+        fprintf(stderr, "decode worker start failed\n");
+        event_writer_stop();
+        return 0;
+    }
+
+    // ETW ProcessTrace / replay / netlink: sink은 run()을 부른 thread에서 호출됨
+    scratch_bind(g_nworkers ? &g_src_scratch : &g_shards[0].scratch);
+    int ok = src->run(src, pipeline_on_event, NULL);
+    scratch_bind(NULL);
+
+    // source thread 종료 후 worker queue drain -> ring drain (+ 마지막 collector_stats)
+    if (g_nworkers) stop_workers(g_nworkers);
+    event_writer_stop();
+    collector_stats_attach(NULL);
+    return ok;
+}
+
+// decoding threads' arenas (read after the threads stopped)
+static void scratch_sum(SCRATCH_STATS* out)
+{
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = 0; i <= g_nshards; i++) {
+        const SCRATCH* a = i < g_nshards ? &g_shards[i].scratch : &g_src_scratch;
+        out->allocs += a->st.allocs;
+        out->spills += a->st.spills;
+        if (a->st.high_water > out->high_water) out->high_water = a->st.high_water;
+    }
+}
+
+void pipeline_shutdown(void)
+{
+    if (g_rec.fp) {
+        fprintf(stderr, "raw events recorded: %llu (%llu bytes)\n",
+                (unsigned long long)g_rec.records, (unsigned long long)g_rec.bytes);
+        replay_recorder_close(&g_rec);
+    }
+
+    PID_MAP_STATS ps;
+    PROC_TABLE_STATS ts;
+    memset(&ps, 0, sizeof(ps));
+    memset(&ts, 0, sizeof(ts));
+    for (uint32_t i = 0; i < g_nshards; i++) {
+        PID_MAP_STATS p;
+        PROC_TABLE_STATS t;
+        pid_map_get_stats(&g_shards[i].pids, &p);
+        proc_table_get_stats(&g_shards[i].procs, &t);
+        ps.size += p.size;
+        ps.cap += p.cap;
+        ps.hits += p.hits;
+        ps.lookups += p.lookups;
+        ps.stale_rejects += p.stale_rejects;
+        ps.evict_age += p.evict_age;
+        ps.evict_cap += p.evict_cap;
+        if (p.probe_max > ps.probe_max) ps.probe_max = p.probe_max;
+        ts.records += t.records;
+        ts.bytes += t.bytes;
+        ts.interned += t.interned;
+        ts.pool_used += t.pool_used;
+        ts.evicted += t.evicted;
+        ts.compactions += t.compactions;
+    }
+    fprintf(stderr, "pid map: size=%llu cap=%llu hits=%llu/%llu stale=%llu evict_age=%llu evict_cap=%llu probe_max=%llu\n",
+            (unsigned long long)ps.size, (unsigned long long)ps.cap,
+            (unsigned long long)ps.hits, (unsigned long long)ps.lookups,
+            (unsigned long long)ps.stale_rejects, (unsigned long long)ps.evict_age,
+            (unsigned long long)ps.evict_cap, (unsigned long long)ps.probe_max);
+    fprintf(stderr, "proc table: records=%llu bytes=%llu (%llu/record) images=%llu pool=%llu evicted=%llu compactions=%llu\n",
+            (unsigned long long)ts.records, (unsigned long long)ts.bytes,
+            (unsigned long long)(ts.records ? ts.bytes / ts.records : 0),
+            (unsigned long long)ts.interned, (unsigned long long)ts.pool_used,
+            (unsigned long long)ts.evicted, (unsigned long long)ts.compactions);
+
+    if (g_nworkers) {
+        RAW_QUEUE_STATS qs;
+        memset(&qs, 0, sizeof(qs));
+        for (uint32_t i = 0; i < g_nworkers; i++) {
+            const RAW_QUEUE_STATS* q = &g_shards[i].qstats;
+            qs.pushed += q->pushed;
+            qs.dropped_full += q->dropped_full;
+            qs.dropped_oversize += q->dropped_oversize;
+            qs.block_waits += q->block_waits;
+            if (q->high_water > qs.high_water) qs.high_water = q->high_water;
+        }
+        EVENT_WRITER_MERGE_STATS ms;
+        event_writer_get_merge_stats(&ms);
+        fprintf(stderr, "decode workers: %u queued=%llu dropped=%llu oversize=%llu block_waits=%llu high_water=%llu bytes\n",
+                g_nworkers, (unsigned long long)qs.pushed, (unsigned long long)qs.dropped_full,
+                (unsigned long long)qs.dropped_oversize, (unsigned long long)qs.block_waits,
+                (unsigned long long)qs.high_water);
+        fprintf(stderr, "merge: records=%llu waits=%llu timeouts=%llu out_of_order=%llu\n",
+                (unsigned long long)ms.merged, (unsigned long long)ms.waits,
+                (unsigned long long)ms.timeouts, (unsigned long long)ms.out_of_order);
+    }
+
+    FLOW_AGG_STATS fs;
+    event_writer_get_flow_stats(&fs);
+    if (fs.connects) {
+        fprintf(stderr, "flows: connects=%llu first_seen=%llu folded=%llu summaries=%llu expired=%llu evicted=%llu passthrough=%llu high_water=%llu\n",
+                (unsigned long long)fs.connects, (unsigned long long)fs.first_seen,
+                (unsigned long long)fs.folded, (unsigned long long)fs.summaries,
+                (unsigned long long)fs.expired, (unsigned long long)fs.evicted, (unsigned long long)fs.passthrough,
+                (unsigned long long)fs.high_water);
+    }
+
+    if (g_filter.rules) {
+        fprintf(stderr, "filter: rules=%u dropped=%llu followed_pids=%u pid_overflow=%llu\n",
+                g_filter.nrules, (unsigned long long)g_filter.st.dropped, g_filter.pid_count,
+                (unsigned long long)g_filter.st.pid_overflow);
+        for (uint32_t i = 0; i < g_filter.nrules; i++) {
+            const FILTER_RULE* r = &g_filter.rules[i];
+            fprintf(stderr, "  line %u %s %s: hits=%llu followed=%llu\n", r->line,
+                    r->kind == FILTER_IMAGE ? "image" : "dst", r->text,
+                    (unsigned long long)r->hits, (unsigned long long)r->followed);
+        }
+    }
+
+    if (g_rules.rules) {
+        uint64_t tags = 0;
+        for (uint32_t i = 0; i < g_nshards; i++) tags += plat_counter_load(&g_shards[i].st->tags);
+        fprintf(stderr, "rules: rules=%u parent_conds=%u states=%u classes=%u tags=%llu\n",
+                g_rules.nrules, g_rules.nparent, g_rules.nstates, g_rules.nclass, (unsigned long long)tags);
+    }
+
+    SCRATCH_STATS ss;
+    scratch_sum(&ss);
+    fprintf(stderr, "scratch: arenas=%u x %uKB allocs=%llu spills=%llu high_water=%llu bytes\n",
+            g_nshards + (g_src_scratch.base ? 1 : 0), (unsigned)(PIPELINE_SCRATCH_BYTES / 1024),
+            (unsigned long long)ss.allocs, (unsigned long long)ss.spills, (unsigned long long)ss.high_water);
+
+    free_shards();
+    scratch_free(&g_src_scratch);
+    event_filter_free(&g_filter);
+    rule_engine_free(&g_rules);
+    plat_mutex_destroy(&g_fallback_lock);
+}
+
+void pipeline_get_stats(PIPELINE_STATS* out)
+{
+    if (!out) return;
+    *out = g_stats;
+    if (!g_src_st) return;
+    out->events = plat_counter_load(&g_src_st->events);
+    out->routed = plat_counter_load(&g_src_st->routed);
+    out->filtered = plat_counter_load(&g_src_st->filtered);
+    out->tags = 0;
+    for (uint32_t i = 0; i < g_nshards; i++) out->tags += plat_counter_load(&g_shards[i].st->tags);
+    // workers 0: shard 0의 stats block이 곧 source thread의 것
+    out->decode_fallbacks = g_nworkers ? 0 : plat_counter_load(&g_src_st->decode_fallbacks);
+    for (uint32_t i = 0; i < g_nworkers; i++) {
+        out->decode_fallbacks += plat_counter_load(&g_shards[i].st->decode_fallbacks);
+    }
+    for (uint32_t i = 0; i < g_nshards; i++) {
+        for (int s = 0; s < PIPE_STAGE_COUNT; s++) out->stage_ns[s] += g_shards[i].stage_ns[s];
+    }
+    event_writer_get_timing(&out->written, &out->write_ns);
+
+    SCRATCH_STATS ss;
+    scratch_sum(&ss);
+    out->scratch_spills = ss.spills;
+    out->scratch_high_water = ss.high_water;
+}
+
+const EVENT_FILTER* pipeline_get_filter(void)
+{
+    return g_filter.rules ? &g_filter : NULL;
+}
+
+const RULE_ENGINE* pipeline_get_rules(void)
+{
+    return g_rules.rules ? &g_rules : NULL;
+}
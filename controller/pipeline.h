@@ -0,0 +1,100 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+#include "event_dispatch.h"
+#include "event_filter.h"
+#include "event_source.h"
+#include "event_writer.h"
+#include "rule_engine.h"
+
+// ============================================================
+// Event pipeline: RAW_EVENT -> route -> filter -> decode -> process state -> rules -> ring
+// - everything downstream of the event source (was etw_consumer.c on_event)
+// - workers 0: runs on the source's thread
+// - workers N: the source thread only routes and copies the raw record into
+//   one of N queues (raw_queue.h), sharded by process id so one process's
+//   start/connect/end stay in order; worker i decodes into writer lane i and
+//   the writer merges lanes by timestamp (event_writer.h)
+// - pid map / process table are sharded the same way; the only cross-shard
+//   access is the parent lookup at process start (per-shard lock)
+// - serialization stays on the writer thread (binary dictionary / TS_BASE
+//   and segment rotation are per output file)
+// - no heap allocation per event: decode temporaries come from the decoding
+//   thread's scratch arena (scratch.h), reset after every event
+// - rules (rule_engine.h): evaluated at process start on the decoding thread,
+//   fired rules ride in the proc_start record (EVENT_REC.tags)
+// - portable: TDH (Windows) is plugged in as a decode fallback
+// ============================================================
+
+// fixed layout decode(mof_decode.h)가 실패했을 때 (unknown version 등)
+// 필요 없는 출력은 NULL. 성공: 1, 실패: 0
+// 임시 buffer는 scratch_thread() (scratch.h): event 처리가 끝나면 reset됨
+typedef struct PIPELINE_FALLBACK {
+    int (*process)(const RAW_EVENT* ev, uint32_t* pid, uint32_t* ppid,
+                   wchar_t* image, size_t image_cap, wchar_t* cmd, size_t cmd_cap);
+    int (*tcp)(const RAW_EVENT* ev, uint32_t* pid,
+               char src_ip[64], uint16_t* src_port, char dst_ip[64], uint16_t* dst_port);
+
+    // decode workers only. fallback calls are serialized (TDH schema cache is single-threaded)
+    int (*pid)(const RAW_EVENT* ev, uint32_t* pid);     // shard key, fixed layout failed
+    uint32_t native_size;       // bytes of ev->native queued with the event (0: workers see NULL)
+    void (*native_rebind)(void* native, const RAW_EVENT* ev);  // point the copy at ev->user_data
+
+    // drop filter (event_filter.h): raw image bytes inside ev->user_data, no conversion
+    int (*image)(const RAW_EVENT* ev, uint32_t* pid, const char** image, size_t* len);
+} PIPELINE_FALLBACK;
+
+typedef struct PIPELINE_CONFIG {
+    const PIPELINE_FALLBACK* fallback;  // NULL: fixed layout only (replay on Linux)
+    const wchar_t* record_path;         // NULL: no recording (replay.h)
+    const wchar_t* filter_path;         // NULL: no drop filter (event_filter.h)
+    const wchar_t* rules_path;          // NULL: no tagging (rule_engine.h, rules/mitre_rules.yaml)
+    uint32_t workers;                   // decode threads, 0: decode on the source thread
+} PIPELINE_CONFIG;
+
+#define PIPELINE_WORKERS_MAX 16
+
+typedef enum PIPE_STAGE {
+    PIPE_STAGE_ROUTE = 0,       // dispatch lookup (+ recording)
+    PIPE_STAGE_DECODE,          // UserData -> EVENT_REC fields, guid hash
+    PIPE_STAGE_STATE,           // pid map / process table
+    PIPE_STAGE_EMIT,            // ring reserve / commit
+    PIPE_STAGE_COUNT
+} PIPE_STAGE;
+
+typedef struct PIPELINE_STATS {
+    uint64_t events;            // sink calls
+    uint64_t routed;            // reached a handler
+    uint64_t filtered;          // dropped by the filter after routing (event_filter.h)
+    uint64_t decode_fallbacks;  // fixed layout failed
+    uint64_t tags;              // rules fired at process start (rule_engine.h)
+    uint64_t stage_ns[PIPE_STAGE_COUNT];    // PIPELINE_TIMING only, summed over workers
+    uint64_t written;           // writer thread: records serialized
+    uint64_t write_ns;          // writer thread: jsonl_write_* (PIPELINE_TIMING only)
+    uint64_t scratch_spills;    // decode scratch arena overflowed to the heap (scratch.h)
+    uint64_t scratch_high_water; // max arena bytes used by one event
+} PIPELINE_STATS;
+
+// 성공: 1, 실패: 0
+int pipeline_init(const PIPELINE_CONFIG* cfg);
+void pipeline_shutdown(void);   // stats to stderr, frees state
+
+// 추가 이벤트 타입 handler (pipeline_init 전에 호출). handler의 ev는 const RAW_EVENT*
+int pipeline_register(const void* provider, uint16_t id, uint8_t opcode,
+                      EVENT_HANDLER handler, void* ctx);
+
+// RAW_EVENT_SINK
+void pipeline_on_event(const RAW_EVENT* ev, void* ctx);
+
+// writer thread (+ decode workers) start -> src->run -> drain. jsonl_open 이후에 호출. 성공: 1, 실패: 0
+int pipeline_run(EVENT_SOURCE* src, const EVENT_WRITER_CONFIG* wcfg);
+
+void pipeline_get_stats(PIPELINE_STATS* out);
+
+// loaded drop filter (per-rule hits) or NULL
+const EVENT_FILTER* pipeline_get_filter(void);
+
+// loaded rules or NULL
+const RULE_ENGINE* pipeline_get_rules(void);
@@ -0,0 +1,235 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================
+// Minimal platform shim (threads, atomics, clock)
+// - Windows: Win32 API, Linux/POSIX: pthread + __atomic builtins
+// - 필요한 것만 둠. header-only
+// ============================================================
+
+// thread-local static (decode worker / writer lane)
+#ifdef _MSC_VER
+#define PLAT_TLS __declspec(thread)
+#else
+#define PLAT_TLS __thread
+#endif
+
+#ifdef _WIN32
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <intrin.h>
+
+typedef HANDLE PLAT_THREAD;
+
+typedef struct PLAT_THREAD_START {
+    void (*fn)(void*);
+    void* arg;
+} PLAT_THREAD_START;
+
+static __inline DWORD WINAPI plat_thread_trampoline(LPVOID p)
+{
+    PLAT_THREAD_START s = *(PLAT_THREAD_START*)p;
+    HeapFree(GetProcessHeap(), 0, p);
+    s.fn(s.arg);
+    return 0;
+}
+
+// 성공: 1, 실패: 0
+static __inline int plat_thread_start(PLAT_THREAD* t, void (*fn)(void*), void* arg)
+{
+    PLAT_THREAD_START* s = (PLAT_THREAD_START*)HeapAlloc(GetProcessHeap(), 0, sizeof(*s));
+    if (!s) return 0;
+    s->fn = fn;
+    s->arg = arg;
+    *t = CreateThread(NULL, 0, plat_thread_trampoline, s, 0, NULL);
+    if (!*t) {
+        HeapFree(GetProcessHeap(), 0, s);
+        return 0;
+    }
+    return 1;
+}
+
+static __inline void plat_thread_join(PLAT_THREAD t)
+{
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+// short critical sections only (no recursion)
+typedef SRWLOCK PLAT_MUTEX;
+static __inline void plat_mutex_init(PLAT_MUTEX* m) { InitializeSRWLock(m); }
+static __inline void plat_mutex_destroy(PLAT_MUTEX* m) { (void)m; }
+static __inline void plat_mutex_lock(PLAT_MUTEX* m) { AcquireSRWLockExclusive(m); }
+static __inline void plat_mutex_unlock(PLAT_MUTEX* m) { ReleaseSRWLockExclusive(m); }
+
+static __inline void plat_yield(void) { SwitchToThread(); }
+static __inline void plat_sleep_ms(uint32_t ms) { Sleep(ms); }
+
+static __inline uint64_t plat_now_ns(void)
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&c);
+    return (uint64_t)((double)c.QuadPart * 1e9 / (double)freq.QuadPart);
+}
+
+// x86/x64 (TSO): plain volatile access + compiler barrier is acquire/release
+#if defined(_M_X64) || defined(_M_IX86)
+static __inline uint64_t plat_load_acquire_u64(const volatile uint64_t* p)
+{
+    uint64_t v = *p;
+    _ReadWriteBarrier();
+    return v;
+}
+static __inline void plat_store_release_u64(volatile uint64_t* p, uint64_t v)
+{
+    _ReadWriteBarrier();
+    *p = v;
+}
+#else
+static __inline uint64_t plat_load_acquire_u64(const volatile uint64_t* p)
+{
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+}
+static __inline void plat_store_release_u64(volatile uint64_t* p, uint64_t v)
+{
+    InterlockedExchange64((volatile LONG64*)p, (LONG64)v);
+}
+#endif
+
+static __inline uint64_t plat_atomic_add_u64(volatile uint64_t* p, uint64_t v)
+{
+    return (uint64_t)InterlockedExchangeAdd64((volatile LONG64*)p, (LONG64)v) + v;
+}
+
+static __inline int32_t plat_load_i32(const volatile int32_t* p)
+{
+    return (int32_t)InterlockedCompareExchange((volatile LONG*)p, 0, 0);
+}
+
+static __inline void plat_store_i32(volatile int32_t* p, int32_t v)
+{
+    InterlockedExchange((volatile LONG*)p, (LONG)v);
+}
+
+// single-writer counter: owner thread adds, any thread reads (no lock prefix)
+// x64: aligned 64-bit volatile access is atomic
+static __inline void plat_counter_add(volatile uint64_t* p, uint64_t v) { *p = *p + v; }
+static __inline uint64_t plat_counter_load(const volatile uint64_t* p) { return *p; }
+
+// wall clock, FILETIME (100ns since 1601, UTC)
+static __inline uint64_t plat_filetime_now(void)
+{
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    return ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+
+#else // POSIX
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef pthread_t PLAT_THREAD;
+
+typedef struct PLAT_THREAD_START {
+    void (*fn)(void*);
+    void* arg;
+} PLAT_THREAD_START;
+
+static inline void* plat_thread_trampoline(void* p)
+{
+    PLAT_THREAD_START s = *(PLAT_THREAD_START*)p;
+    free(p);
+    s.fn(s.arg);
+    return NULL;
+}
+
+static inline int plat_thread_start(PLAT_THREAD* t, void (*fn)(void*), void* arg)
+{
+    PLAT_THREAD_START* s = (PLAT_THREAD_START*)malloc(sizeof(*s));
+    if (!s) return 0;
+    s->fn = fn;
+    s->arg = arg;
+    if (pthread_create(t, NULL, plat_thread_trampoline, s) != 0) {
+        free(s);
+        return 0;
+    }
+    return 1;
+}
+
+static inline void plat_thread_join(PLAT_THREAD t) { pthread_join(t, NULL); }
+
+typedef pthread_mutex_t PLAT_MUTEX;
+static inline void plat_mutex_init(PLAT_MUTEX* m) { pthread_mutex_init(m, NULL); }
+static inline void plat_mutex_destroy(PLAT_MUTEX* m) { pthread_mutex_destroy(m); }
+static inline void plat_mutex_lock(PLAT_MUTEX* m) { pthread_mutex_lock(m); }
+static inline void plat_mutex_unlock(PLAT_MUTEX* m) { pthread_mutex_unlock(m); }
+
+static inline void plat_yield(void) { sched_yield(); }
+
+static inline void plat_sleep_ms(uint32_t ms)
+{
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static inline uint64_t plat_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t plat_load_acquire_u64(const volatile uint64_t* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void plat_store_release_u64(volatile uint64_t* p, uint64_t v)
+{
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline uint64_t plat_atomic_add_u64(volatile uint64_t* p, uint64_t v)
+{
+    return __atomic_add_fetch(p, v, __ATOMIC_RELAXED);
+}
+
+static inline int32_t plat_load_i32(const volatile int32_t* p)
+{
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+static inline void plat_store_i32(volatile int32_t* p, int32_t v)
+{
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+// single-writer counter: owner thread adds, any thread reads (relaxed load + store, no RMW)
+static inline void plat_counter_add(volatile uint64_t* p, uint64_t v)
+{
+    __atomic_store_n(p, __atomic_load_n(p, __ATOMIC_RELAXED) + v, __ATOMIC_RELAXED);
+}
+static inline uint64_t plat_counter_load(const volatile uint64_t* p)
+{
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+// wall clock, FILETIME (100ns since 1601, UTC)
+static inline uint64_t plat_filetime_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return 116444736000000000ULL + (uint64_t)ts.tv_sec * 10000000ULL + (uint64_t)ts.tv_nsec / 100;
+}
+
+#endif
@@ -0,0 +1,393 @@
+#include "proc_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct POOL_SLOT {
+    uint64_t hash;          // 0: empty
+    uint32_t off;
+    uint32_t len;
+} POOL_SLOT;
+
+// FNV-1a over code units
+static uint64_t hash_wunits(const wchar_t* s, size_t n)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (uint64_t)(uint32_t)s[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h ? h : 1;
+}
+
+uint64_t proc_hash_wstr(const wchar_t* s)
+{
+    if (!s || !*s) return 0;
+    return hash_wunits(s, wcslen(s));
+}
+
+static uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static size_t pow2_at_least(size_t n)
+{
+    size_t c = 16;
+    while (c < n) c <<= 1;
+    return c;
+}
+
+// ============================================================
+// string pool (interning)
+// ============================================================
+static int pool_index_rebuild(PROC_TABLE* t, size_t cap)
+{
+    POOL_SLOT* ix = (POOL_SLOT*)calloc(cap, sizeof(POOL_SLOT));
+    if (!ix) return 0;
+
+    if (t->pool_index) {
+        for (size_t i = 0; i < t->pool_index_cap; i++) {
+            POOL_SLOT* s = &t->pool_index[i];
+            if (!s->hash) continue;
+            size_t j = (size_t)s->hash & (cap - 1);
+            while (ix[j].hash) j = (j + 1) & (cap - 1);
+            ix[j] = *s;
+        }
+        free(t->pool_index);
+    }
+    t->pool_index = ix;
+    t->pool_index_cap = cap;
+    return 1;
+}
+
+// 이미 있으면 그 offset, 없으면 append. 공간 없으면 PROC_IMAGE_NONE
+static uint32_t pool_intern(PROC_TABLE* t, const wchar_t* s, size_t n)
+{
+    uint64_t h = hash_wunits(s, n);
+    size_t mask = t->pool_index_cap - 1;
+    size_t j = (size_t)h & mask;
+
+    while (t->pool_index[j].hash) {
+        POOL_SLOT* p = &t->pool_index[j];
+        if (p->hash == h && p->len == n && memcmp(t->pool + p->off, s, n * sizeof(wchar_t)) == 0) {
+            t->st.intern_hits++;
+            return p->off;
+        }
+        j = (j + 1) & mask;
+    }
+
+    if (t->pool_used + n > t->pool_cap) {
+        if (t->pool_used + n > t->pool_limit) return PROC_IMAGE_NONE;
+        size_t nc = t->pool_cap ? t->pool_cap : 4096;
+        while (nc < t->pool_used + n) nc *= 2;
+        if (nc > t->pool_limit) nc = t->pool_limit;
+        wchar_t* np = (wchar_t*)realloc(t->pool, nc * sizeof(wchar_t));
+        if (!np) return PROC_IMAGE_NONE;
+        t->pool = np;
+        t->pool_cap = nc;
+    }
+
+    uint32_t off = (uint32_t)t->pool_used;
+    memcpy(t->pool + off, s, n * sizeof(wchar_t));
+    t->pool_used += n;
+
+    t->pool_index[j].hash = h;
+    t->pool_index[j].off = off;
+    t->pool_index[j].len = (uint32_t)n;
+    t->pool_count++;
+
+    // load factor 0.5
+    if (t->pool_count * 2 > t->pool_index_cap) pool_index_rebuild(t, t->pool_index_cap * 2);
+    return off;
+}
+
+// pool이 가득 차면 살아있는 record의 image만 새 pool로 옮김
+static void pool_compact(PROC_TABLE* t)
+{
+    wchar_t* old = t->pool;
+    size_t old_cap = t->pool_cap;
+
+    // 새 pool은 지난번 것을 재사용: steady state의 compaction은 malloc 없음
+    if (!t->pool_spare || t->pool_spare_cap < old_cap) {
+        wchar_t* np = (wchar_t*)realloc(t->pool_spare, old_cap * sizeof(wchar_t));
+        if (!np) return;
+        t->pool_spare = np;
+        t->pool_spare_cap = old_cap;
+    }
+    t->pool = t->pool_spare;
+    t->pool_cap = t->pool_spare_cap;
+    t->pool_used = 0;
+    t->pool_count = 0;
+    memset(t->pool_index, 0, t->pool_index_cap * sizeof(POOL_SLOT));
+
+    for (uint32_t i = 0; i < t->rec_used; i++) {
+        PROC_REC* r = &t->recs[i];
+        if (!r->guid || r->image_off == PROC_IMAGE_NONE) continue;
+        uint64_t hits = t->st.intern_hits;
+        r->image_off = pool_intern(t, old + r->image_off, r->image_len);
+        t->st.intern_hits = hits;   // compaction은 hit로 안 셈
+        if (r->image_off == PROC_IMAGE_NONE) r->image_len = 0;
+    }
+    t->pool_spare = old;
+    t->pool_spare_cap = old_cap;
+    t->st.compactions++;
+
+    // 거의 다 살아있는 image면 당분간 compaction 해도 소용없음
+    if (t->pool_used * 4 >= t->pool_limit * 3) t->compact_after = t->st.inserts + t->max_records / 4;
+}
+
+// ============================================================
+// guid -> record index (linear probing, backward-shift delete)
+// ============================================================
+static size_t index_home(const PROC_TABLE* t, uint64_t guid)
+{
+    return (size_t)mix64(guid) & (t->index_cap - 1);
+}
+
+static size_t index_find(const PROC_TABLE* t, uint64_t guid)
+{
+    size_t mask = t->index_cap - 1;
+    size_t j = index_home(t, guid);
+    while (t->index[j] && t->recs[t->index[j] - 1].guid != guid) j = (j + 1) & mask;
+    return j;
+}
+
+static void index_delete_at(PROC_TABLE* t, size_t i)
+{
+    size_t mask = t->index_cap - 1;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!t->index[j]) break;
+        size_t k = index_home(t, t->recs[t->index[j] - 1].guid);
+        int movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            t->index[i] = t->index[j];
+            i = j;
+        }
+    }
+    t->index[i] = 0;
+}
+
+static int index_rebuild(PROC_TABLE* t, size_t cap)
+{
+    uint32_t* ix = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    if (!ix) return 0;
+    free(t->index);
+    t->index = ix;
+    t->index_cap = cap;
+
+    for (uint32_t i = 0; i < t->rec_used; i++) {
+        if (!t->recs[i].guid) continue;
+        size_t j = index_find(t, t->recs[i].guid);
+        t->index[j] = i + 1;
+    }
+    return 1;
+}
+
+// ============================================================
+// records
+// ============================================================
+int proc_table_init(PROC_TABLE* t, uint32_t max_records, uint32_t initial_records, size_t pool_bytes)
+{
+    memset(t, 0, sizeof(*t));
+    if (max_records < 16) max_records = 16;
+    t->max_records = max_records;
+    t->pool_limit = pool_bytes / sizeof(wchar_t);
+    if (t->pool_limit < 4096) t->pool_limit = 4096;
+    if (t->pool_limit > PROC_IMAGE_NONE - 1) t->pool_limit = PROC_IMAGE_NONE - 1;
+
+    if (!initial_records || initial_records > max_records) initial_records = max_records;
+    t->rec_cap = initial_records;
+    t->recs = (PROC_REC*)calloc(t->rec_cap, sizeof(PROC_REC));
+    if (!t->recs) return 0;
+
+    size_t pcap = pow2_at_least(t->rec_cap);
+    if (pcap < 256) pcap = 256;
+    if (!index_rebuild(t, pow2_at_least((size_t)t->rec_cap * 2)) || !pool_index_rebuild(t, pcap)) {
+        proc_table_free(t);
+        return 0;
+    }
+    return 1;
+}
+
+void proc_table_free(PROC_TABLE* t)
+{
+    if (!t) return;
+    free(t->recs);
+    free(t->index);
+    free(t->pool);
+    free(t->pool_spare);
+    free(t->pool_index);
+    memset(t, 0, sizeof(*t));
+}
+
+static void rec_release(PROC_TABLE* t, uint32_t i)
+{
+    memset(&t->recs[i], 0, sizeof(PROC_REC));
+    t->recs[i].pid = t->free_head;   // free list link
+    t->free_head = i + 1;
+    t->count--;
+}
+
+static void remove_rec(PROC_TABLE* t, uint32_t i)
+{
+    index_delete_at(t, index_find(t, t->recs[i].guid));
+    rec_release(t, i);
+}
+
+// max_records에 걸림: 32개 sample 중 last_seen 최소
+static void evict_one(PROC_TABLE* t)
+{
+    uint32_t victim = UINT32_MAX;
+    uint64_t oldest = UINT64_MAX;
+    uint32_t seen = 0;
+
+    for (uint32_t n = 0; n < t->rec_used && seen < 32; n++) {
+        uint32_t i = (t->evict_pos + n) % t->rec_used;
+        if (!t->recs[i].guid) continue;
+        seen++;
+        if (t->recs[i].last_seen < oldest) {
+            oldest = t->recs[i].last_seen;
+            victim = i;
+        }
+    }
+    if (victim == UINT32_MAX) return;
+
+    t->evict_pos = victim + 1;
+    remove_rec(t, victim);
+    t->st.evicted++;
+}
+
+static int rec_alloc(PROC_TABLE* t, uint32_t* out)
+{
+    if (t->count >= t->max_records) evict_one(t);
+
+    if (t->free_head) {
+        uint32_t i = t->free_head - 1;
+        t->free_head = t->recs[i].pid;
+        t->recs[i].pid = 0;
+        *out = i;
+        t->count++;
+        return 1;
+    }
+
+    if (t->rec_used == t->rec_cap) {
+        uint32_t nc = t->rec_cap * 2;
+        if (nc > t->max_records) nc = t->max_records;
+        if (nc <= t->rec_cap) return 0;
+
+        PROC_REC* nr = (PROC_REC*)realloc(t->recs, (size_t)nc * sizeof(PROC_REC));
+        if (!nr) return 0;
+        memset(nr + t->rec_cap, 0, (size_t)(nc - t->rec_cap) * sizeof(PROC_REC));
+        t->recs = nr;
+        t->rec_cap = nc;
+
+        size_t icap = pow2_at_least((size_t)nc * 2);
+        if (icap > t->index_cap && !index_rebuild(t, icap)) return 0;
+    }
+
+    *out = t->rec_used++;
+    t->count++;
+    return 1;
+}
+
+int proc_table_put(PROC_TABLE* t, uint64_t guid, uint64_t parent_guid,
+                   uint32_t pid, uint32_t ppid, uint64_t start_ts,
+                   const wchar_t* image, const wchar_t* cmdline, uint64_t rule_bits)
+{
+    if (!t->recs || !guid) return 0;
+
+    size_t j = index_find(t, guid);
+    uint32_t i;
+    if (t->index[j]) {
+        i = t->index[j] - 1;
+    } else {
+        if (!rec_alloc(t, &i)) return 0;
+        // eviction/rebuild가 index를 바꿨을 수 있음
+        j = index_find(t, guid);
+        t->index[j] = i + 1;
+        t->st.inserts++;
+    }
+
+    PROC_REC* r = &t->recs[i];
+    r->guid = guid;
+    r->parent_guid = parent_guid;
+    r->pid = pid;
+    r->ppid = ppid;
+    r->start_ts = start_ts;
+    r->last_seen = start_ts;
+    r->cmdline_hash = proc_hash_wstr(cmdline);
+    r->rule_bits = rule_bits;
+    r->image_off = PROC_IMAGE_NONE;
+    r->image_len = 0;
+
+    size_t n = image ? wcslen(image) : 0;
+    if (n) {
+        uint32_t off = pool_intern(t, image, n);
+        if (off == PROC_IMAGE_NONE && t->st.inserts >= t->compact_after) {
+            pool_compact(t);
+            off = pool_intern(t, image, n);
+        }
+        if (off != PROC_IMAGE_NONE) {
+            r->image_off = off;
+            r->image_len = (uint32_t)n;
+        }
+    }
+    return 1;
+}
+
+const PROC_REC* proc_table_get(PROC_TABLE* t, uint64_t guid, uint64_t ts)
+{
+    if (!t->recs || !guid) return NULL;
+    t->st.lookups++;
+
+    size_t j = index_find(t, guid);
+    if (!t->index[j]) return NULL;
+
+    PROC_REC* r = &t->recs[t->index[j] - 1];
+    if (ts > r->last_seen) r->last_seen = ts;
+    t->st.hits++;
+    return r;
+}
+
+int proc_table_del(PROC_TABLE* t, uint64_t guid)
+{
+    if (!t->recs || !guid) return 0;
+
+    size_t j = index_find(t, guid);
+    if (!t->index[j]) return 0;
+
+    uint32_t i = t->index[j] - 1;
+    index_delete_at(t, j);
+    rec_release(t, i);
+    t->st.deletes++;
+    return 1;
+}
+
+const wchar_t* proc_table_image(const PROC_TABLE* t, const PROC_REC* rec, size_t* len)
+{
+    if (!rec || rec->image_off == PROC_IMAGE_NONE) {
+        if (len) *len = 0;
+        return NULL;
+    }
+    if (len) *len = rec->image_len;
+    return t->pool + rec->image_off;
+}
+
+void proc_table_get_stats(const PROC_TABLE* t, PROC_TABLE_STATS* out)
+{
+    *out = t->st;
+    out->records = t->count;
+    out->record_cap = t->rec_cap;
+    out->pool_used = (uint64_t)t->pool_used * sizeof(wchar_t);
+    out->interned = t->pool_count;
+    out->bytes = (uint64_t)t->rec_cap * sizeof(PROC_REC)
+               + (uint64_t)t->index_cap * sizeof(uint32_t)
+               + (uint64_t)(t->pool_cap + t->pool_spare_cap) * sizeof(wchar_t)
+               + (uint64_t)t->pool_index_cap * sizeof(POOL_SLOT);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// ============================================================
+// Process table: process guid -> process record
+// - records live in one array (free list), indexed by guid hash
+// - image paths are interned in a shared string pool (same exe -> one copy)
+// - bounded: max_records (oldest last_seen evicted) + pool_bytes (compaction)
+// - no locking inside, portable: one table per pipeline shard (pipeline.c),
+//   every call made with that shard's lock held (workers 0: single thread, no lock).
+//   proc_start looks the parent up under the parent shard's lock and unlocks it
+//   before locking its own shard (never two shard locks at once)
+// ============================================================
+
+#define PROC_IMAGE_NONE 0xFFFFFFFFu
+
+typedef struct PROC_REC {
+    uint64_t guid;          // process guid hash (guid.h), 0: free
+    uint64_t parent_guid;   // 0: unknown parent
+    uint64_t start_ts;      // 100ns
+    uint64_t last_seen;     // 100ns
+    uint64_t cmdline_hash;
+    uint64_t rule_bits;     // parent conditions this process satisfies (rule_engine.h)
+    uint32_t pid;
+    uint32_t ppid;
+    uint32_t image_off;     // string pool offset (wchar_t units), PROC_IMAGE_NONE
+    uint32_t image_len;
+} PROC_REC;
+
+typedef struct PROC_TABLE_STATS {
+    uint64_t records;
+    uint64_t record_cap;
+    uint64_t bytes;            // records + index + pool (all allocations)
+    uint64_t pool_used;        // bytes
+    uint64_t interned;         // distinct strings in pool
+    uint64_t intern_hits;      // image already present
+    uint64_t inserts;
+    uint64_t deletes;
+    uint64_t evicted;          // dropped at max_records
+    uint64_t compactions;
+    uint64_t lookups;
+    uint64_t hits;
+} PROC_TABLE_STATS;
+
+typedef struct PROC_TABLE {
+    PROC_REC* recs;
+    uint32_t rec_cap;
+    uint32_t rec_used;         // high water of recs[] (free list below it)
+    uint32_t free_head;        // rec index + 1, 0: none
+    uint32_t count;
+    uint32_t max_records;
+
+    uint32_t* index;           // guid -> rec index + 1 (0: empty)
+    size_t index_cap;          // power of 2, 2x rec_cap
+
+    wchar_t* pool;
+    size_t pool_cap;           // wchar_t units
+    size_t pool_used;
+    size_t pool_limit;         // wchar_t units
+    struct POOL_SLOT* pool_index;
+    size_t pool_index_cap;     // power of 2
+    size_t pool_count;
+    wchar_t* pool_spare;       // 지난 compaction의 pool (다음 compaction에 재사용)
+    size_t pool_spare_cap;
+    uint64_t compact_after;    // st.inserts threshold (compaction storm 방지)
+
+    uint32_t evict_pos;
+    PROC_TABLE_STATS st;
+} PROC_TABLE;
+
+// initial_records: 0 -> all of max_records up front (no realloc / rehash while running)
+// 성공: 1, 실패: 0
+int proc_table_init(PROC_TABLE* t, uint32_t max_records, uint32_t initial_records, size_t pool_bytes);
+void proc_table_free(PROC_TABLE* t);
+
+// insert (or replace same guid). image/cmdline: NUL-terminated, may be NULL
+int proc_table_put(PROC_TABLE* t, uint64_t guid, uint64_t parent_guid,
+                   uint32_t pid, uint32_t ppid, uint64_t start_ts,
+                   const wchar_t* image, const wchar_t* cmdline, uint64_t rule_bits);
+
+// NULL: unknown. pointer is valid until the next put/del and while the shard lock is held
+const PROC_REC* proc_table_get(PROC_TABLE* t, uint64_t guid, uint64_t ts);
+int proc_table_del(PROC_TABLE* t, uint64_t guid);
+
+// interned image of rec (not NUL-terminated, len in wchar_t)
+const wchar_t* proc_table_image(const PROC_TABLE* t, const PROC_REC* rec, size_t* len);
+
+uint64_t proc_hash_wstr(const wchar_t* s);
+
+void proc_table_get_stats(const PROC_TABLE* t, PROC_TABLE_STATS* out);
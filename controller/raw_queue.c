@@ -0,0 +1,146 @@
+#include "raw_queue.h"
+#include "plat.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGN8(n) (((n) + 7) & ~(uint64_t)7)
+
+int raw_queue_init(RAW_QUEUE* q, size_t cap_bytes_pow2, RING_FULL_POLICY policy)
+{
+    memset(q, 0, sizeof(*q));
+    if (cap_bytes_pow2 < 4096 || (cap_bytes_pow2 & (cap_bytes_pow2 - 1))) return 0;
+
+    q->buf = (uint8_t*)malloc(cap_bytes_pow2);
+    if (!q->buf) return 0;
+
+    q->cap = cap_bytes_pow2;
+    q->mask = cap_bytes_pow2 - 1;
+    q->policy = policy;
+    return 1;
+}
+
+void raw_queue_free(RAW_QUEUE* q)
+{
+    if (!q) return;
+    free(q->buf);
+    memset(q, 0, sizeof(*q));
+}
+
+void raw_queue_close(RAW_QUEUE* q)
+{
+    plat_store_i32(&q->closed, 1);
+}
+
+// ============================================================
+// producer
+// ============================================================
+int raw_queue_push(RAW_QUEUE* q, const RAW_EVENT* ev, uint32_t native_len,
+                   const void* route, uint64_t origin_ns)
+{
+    uint64_t need = ALIGN8(sizeof(RAW_QUEUE_ITEM) + (uint64_t)ev->user_data_len + native_len);
+    if (need > q->cap / 2) {
+        q->pstats.dropped_oversize++;
+        return 0;
+    }
+
+    // 끝까지 남은 공간이 모자라면 pad item으로 채우고 처음부터
+    uint64_t head = q->head;
+    uint64_t off = head & q->mask;
+    uint64_t pad = q->cap - off < need ? q->cap - off : 0;
+    uint64_t total = pad + need;
+
+    uint64_t used = head - q->cached_tail;
+    if (used + total > q->cap) {
+        q->cached_tail = plat_load_acquire_u64(&q->tail);
+        used = head - q->cached_tail;
+    }
+
+    if (used + total > q->cap) {
+        if (q->policy != RING_FULL_BLOCK) {
+            q->pstats.dropped_full++;
+            return 0;
+        }
+
+        // spin -> yield -> sleep backoff (event_ring.c와 같음)
+        for (uint32_t spins = 0; used + total > q->cap; spins++) {
+            if (plat_load_i32(&q->closed)) {
+                q->pstats.dropped_full++;
+                return 0;
+            }
+            q->pstats.block_waits++;
+            if (spins < 64) {
+                // busy
+            } else if (spins < 128) {
+                plat_yield();
+            } else {
+                plat_sleep_ms(1);
+            }
+            q->cached_tail = plat_load_acquire_u64(&q->tail);
+            used = head - q->cached_tail;
+        }
+    }
+
+    if (pad) {
+        *(uint32_t*)(q->buf + off) = (uint32_t)pad | RAW_QUEUE_PAD;
+        off = 0;
+    }
+
+    RAW_QUEUE_ITEM* it = (RAW_QUEUE_ITEM*)(q->buf + off);
+    uint8_t* data = (uint8_t*)(it + 1);
+    it->size = (uint32_t)need;
+    it->native_len = native_len;
+    it->origin_ns = origin_ns;
+    it->route = route;
+    it->ev = *ev;
+    if (ev->user_data_len) memcpy(data, ev->user_data, ev->user_data_len);
+    it->ev.user_data = data;
+    if (native_len && ev->native) {
+        memcpy(data + ev->user_data_len, ev->native, native_len);
+        it->ev.native = data + ev->user_data_len;
+    } else {
+        it->native_len = 0;
+        it->ev.native = NULL;
+    }
+
+    q->pstats.pushed++;
+    if (used + total > q->pstats.high_water) q->pstats.high_water = used + total;
+    plat_store_release_u64(&q->head, head + total);
+    return 1;
+}
+
+// ============================================================
+// consumer
+// ============================================================
+RAW_QUEUE_ITEM* raw_queue_peek(RAW_QUEUE* q)
+{
+    for (;;) {
+        uint64_t tail = q->tail;
+        if (tail == q->cached_head) {
+            q->cached_head = plat_load_acquire_u64(&q->head);
+            if (tail == q->cached_head) return NULL;
+        }
+
+        RAW_QUEUE_ITEM* it = (RAW_QUEUE_ITEM*)(q->buf + (tail & q->mask));
+        if (!(it->size & RAW_QUEUE_PAD)) return it;
+
+        // pad: 처음으로 (producer는 같은 publish로 다음 item까지 보냈음)
+        plat_store_release_u64(&q->tail, tail + (it->size & ~RAW_QUEUE_PAD));
+    }
+}
+
+void raw_queue_release(RAW_QUEUE* q)
+{
+    RAW_QUEUE_ITEM* it = (RAW_QUEUE_ITEM*)(q->buf + (q->tail & q->mask));
+    plat_store_release_u64(&q->tail, q->tail + it->size);
+}
+
+int raw_queue_is_empty(RAW_QUEUE* q)
+{
+    return plat_load_acquire_u64(&q->head) == plat_load_acquire_u64(&q->tail);
+}
+
+void raw_queue_get_stats(RAW_QUEUE* q, RAW_QUEUE_STATS* out)
+{
+    *out = q->pstats;
+}
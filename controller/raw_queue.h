@@ -0,0 +1,72 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_ring.h"
+#include "event_source.h"
+
+// ============================================================
+// Bounded single-producer / single-consumer queue of raw event copies
+// - producer: source thread (pipeline_on_event), consumer: one decode worker
+// - variable-size items in a byte ring: header + UserData (+ native copy),
+//   no per-event allocation; an item never wraps (pad to the end instead)
+// - lock-free like event_ring.h (head/tail byte offsets, acquire/release)
+// ============================================================
+
+#define RAW_QUEUE_PAD 0x80000000u   // item.size flag: filler up to the end of the buffer
+
+typedef struct RAW_QUEUE_ITEM {
+    uint32_t size;              // bytes incl. header, multiple of 8 (| RAW_QUEUE_PAD)
+    uint32_t native_len;        // bytes of native copy after UserData (0: none)
+    uint64_t origin_ns;         // pipeline entry (sampled, else 0)
+    const void* route;          // opaque for the queue (DISPATCH_ENTRY*)
+    RAW_EVENT ev;               // user_data / native point into this item
+} RAW_QUEUE_ITEM;
+
+typedef struct RAW_QUEUE_STATS {
+    uint64_t pushed;
+    uint64_t dropped_full;
+    uint64_t dropped_oversize;  // item larger than half the buffer
+    uint64_t block_waits;       // producer backoff rounds (BLOCK policy)
+    uint64_t high_water;        // max bytes in use seen by producer
+} RAW_QUEUE_STATS;
+
+typedef struct RAW_QUEUE {
+    uint8_t* buf;
+    uint64_t cap;               // bytes, power of 2
+    uint64_t mask;
+    RING_FULL_POLICY policy;    // BLOCK or drop (SAMPLE behaves as DROP_NEWEST)
+
+    // producer side
+    char pad0[64];
+    volatile uint64_t head;
+    uint64_t cached_tail;
+    RAW_QUEUE_STATS pstats;     // written by producer only
+
+    // consumer side
+    char pad1[64];
+    volatile uint64_t tail;
+    uint64_t cached_head;
+
+    char pad2[64];
+    volatile int32_t closed;    // consumer gone -> producer never blocks
+} RAW_QUEUE;
+
+// 성공: 1, 실패: 0
+int raw_queue_init(RAW_QUEUE* q, size_t cap_bytes_pow2, RING_FULL_POLICY policy);
+void raw_queue_free(RAW_QUEUE* q);
+
+// producer: copies ev header, UserData and native_len bytes of ev->native.
+// pushed: 1, dropped by policy: 0
+int raw_queue_push(RAW_QUEUE* q, const RAW_EVENT* ev, uint32_t native_len,
+                   const void* route, uint64_t origin_ns);
+
+// consumer: next item or NULL if empty. valid until raw_queue_release
+RAW_QUEUE_ITEM* raw_queue_peek(RAW_QUEUE* q);
+void raw_queue_release(RAW_QUEUE* q);
+
+void raw_queue_close(RAW_QUEUE* q);
+int raw_queue_is_empty(RAW_QUEUE* q);
+
+// snapshot (producer counters, cross-thread reads are approximate)
+void raw_queue_get_stats(RAW_QUEUE* q, RAW_QUEUE_STATS* out);
@@ -0,0 +1,229 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "replay.h"
+#include "plat.h"
+#include "segment.h"   // seg_fopen (wide path)
+
+#include <stdlib.h>
+#include <string.h>
+
+static void wr_u16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr_u32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+static void wr_u64(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+
+static uint16_t rd_u16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static uint64_t rd_u64(const uint8_t* p) { return (uint64_t)rd_u32(p) | ((uint64_t)rd_u32(p + 4) << 32); }
+
+// ============================================================
+// recorder
+// ============================================================
+int replay_recorder_open(REPLAY_RECORDER* r, const wchar_t* path)
+{
+    memset(r, 0, sizeof(*r));
+    r->fp = seg_fopen(path, "wb");
+    if (!r->fp) return 0;
+    setvbuf(r->fp, NULL, _IOFBF, 1 << 20);
+
+    uint8_t hdr[REPLAY_HEADER_SIZE] = { 0 };
+    memcpy(hdr, REPLAY_MAGIC, 4);
+    hdr[4] = REPLAY_VERSION;
+    if (fwrite(hdr, 1, sizeof(hdr), r->fp) != sizeof(hdr)) {
+        fclose(r->fp);
+        r->fp = NULL;
+        return 0;
+    }
+    r->bytes = sizeof(hdr);
+    return 1;
+}
+
+void replay_record(REPLAY_RECORDER* r, const RAW_EVENT* ev)
+{
+    if (!r->fp) return;
+
+    uint8_t h[REPLAY_REC_HEADER];
+    wr_u32(h, ev->user_data_len);
+    memcpy(h + 4, ev->provider, 16);
+    wr_u16(h + 20, ev->id);
+    h[22] = ev->opcode;
+    h[23] = ev->version;
+    wr_u16(h + 24, ev->flags);
+    h[26] = ev->ptr_size;
+    h[27] = 0;
+    wr_u32(h + 28, ev->pid);
+    wr_u32(h + 32, ev->tid);
+    wr_u64(h + 36, ev->ts_100ns);
+
+    fwrite(h, 1, sizeof(h), r->fp);
+    if (ev->user_data_len) fwrite(ev->user_data, 1, ev->user_data_len, r->fp);
+    r->records++;
+    r->bytes += sizeof(h) + ev->user_data_len;
+}
+
+void replay_recorder_close(REPLAY_RECORDER* r)
+{
+    if (r->fp) fclose(r->fp);
+    r->fp = NULL;
+}
+
+// ============================================================
+// replay source: 전부 미리 parse -> run은 배열을 도는 loop뿐
+// ============================================================
+typedef struct REPLAY_SOURCE {
+    uint8_t* data;
+    RAW_EVENT* events;
+    size_t count;
+    uint32_t loops;
+    uint64_t span;              // last ts - first ts + 1 (loop마다 shift)
+    volatile int32_t stop;
+    REPLAY_STATS st;
+} REPLAY_SOURCE;
+
+static int replay_run(EVENT_SOURCE* src, RAW_EVENT_SINK sink, void* ctx)
+{
+    REPLAY_SOURCE* s = (REPLAY_SOURCE*)src->impl;
+    uint64_t t0 = plat_now_ns();
+
+    for (uint32_t loop = 0; loop < s->loops; loop++) {
+        uint64_t shift = s->span * loop;
+        for (size_t i = 0; i < s->count; i++) {
+            // stop은 드물게만 확인 (loop 비용 최소화)
+            if ((i & 1023) == 0 && plat_load_i32(&s->stop)) goto done;
+
+            RAW_EVENT ev = s->events[i];
+            ev.ts_100ns += shift;
+            sink(&ev, ctx);
+            s->st.emitted++;
+        }
+    }
+done:
+    s->st.run_ns = plat_now_ns() - t0;
+    return 1;
+}
+
+static void replay_request_stop(EVENT_SOURCE* src)
+{
+    REPLAY_SOURCE* s = (REPLAY_SOURCE*)src->impl;
+    plat_store_i32(&s->stop, 1);
+}
+
+static void replay_close(EVENT_SOURCE* src)
+{
+    REPLAY_SOURCE* s = (REPLAY_SOURCE*)src->impl;
+    if (!s) return;
+    free(s->events);
+    free(s->data);
+    free(s);
+    src->impl = NULL;
+}
+
+static uint8_t* read_all(const wchar_t* path, size_t* out_n)
+{
+    FILE* fp = seg_fopen(path, "rb");
+    if (!fp) return NULL;
+
+    size_t cap = 1 << 20, n = 0;
+    uint8_t* buf = (uint8_t*)malloc(cap);
+    while (buf) {
+        if (n == cap) {
+            uint8_t* nb = (uint8_t*)realloc(buf, cap * 2);
+            if (!nb) {
+                free(buf);
+                buf = NULL;
+                break;
+            }
+            buf = nb;
+            cap *= 2;
+        }
+        size_t k = fread(buf + n, 1, cap - n, fp);
+        if (k == 0) break;
+        n += k;
+    }
+    if (buf && ferror(fp)) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    *out_n = n;
+    return buf;
+}
+
+int replay_source_open(EVENT_SOURCE* src, const wchar_t* path, uint32_t loops)
+{
+    memset(src, 0, sizeof(*src));
+
+    REPLAY_SOURCE* s = (REPLAY_SOURCE*)calloc(1, sizeof(REPLAY_SOURCE));
+    if (!s) return 0;
+    s->loops = loops ? loops : 1;
+
+    size_t n = 0;
+    s->data = read_all(path, &n);
+    if (!s->data || n < REPLAY_HEADER_SIZE || memcmp(s->data, REPLAY_MAGIC, 4) != 0 ||
+        s->data[4] != REPLAY_VERSION) {
+        free(s->data);
+        free(s);
+        return 0;
+    }
+
+    // 1st pass: count, 2nd pass: fill
+    for (int pass = 0; pass < 2; pass++) {
+        size_t off = REPLAY_HEADER_SIZE, k = 0;
+        uint64_t ts_min = UINT64_MAX, ts_max = 0;
+
+        while (off + REPLAY_REC_HEADER <= n) {
+            const uint8_t* h = s->data + off;
+            uint32_t len = rd_u32(h);
+            if (len > n - off - REPLAY_REC_HEADER) break;
+
+            if (pass == 1) {
+                RAW_EVENT* ev = &s->events[k];
+                memset(ev, 0, sizeof(*ev));
+                memcpy(ev->provider, h + 4, 16);
+                ev->id = rd_u16(h + 20);
+                ev->opcode = h[22];
+                ev->version = h[23];
+                ev->flags = rd_u16(h + 24);
+                ev->ptr_size = h[26];
+                ev->pid = rd_u32(h + 28);
+                ev->tid = rd_u32(h + 32);
+                ev->ts_100ns = rd_u64(h + 36);
+                ev->user_data = h + REPLAY_REC_HEADER;
+                ev->user_data_len = len;
+                if (ev->ts_100ns < ts_min) ts_min = ev->ts_100ns;
+                if (ev->ts_100ns > ts_max) ts_max = ev->ts_100ns;
+            }
+            off += REPLAY_REC_HEADER + len;
+            k++;
+        }
+
+        if (pass == 0) {
+            s->count = k;
+            s->st.records = k;
+            s->st.bad_tail = off != n;
+            s->events = (RAW_EVENT*)malloc((k ? k : 1) * sizeof(RAW_EVENT));
+            if (!s->events) {
+                free(s->data);
+                free(s);
+                return 0;
+            }
+        } else {
+            s->span = k ? ts_max - ts_min + 1 : 0;
+        }
+    }
+
+    src->name = "replay";
+    src->run = replay_run;
+    src->request_stop = replay_request_stop;
+    src->close = replay_close;
+    src->impl = s;
+    return 1;
+}
+
+void replay_source_get_stats(EVENT_SOURCE* src, REPLAY_STATS* out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (src && src->impl) *out = ((REPLAY_SOURCE*)src->impl)->st;
+}
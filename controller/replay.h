@@ -0,0 +1,48 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <wchar.h>
+
+#include "event_source.h"
+
+// ============================================================
+// Raw event recording + replay source
+//
+// file:    "MSYR" u8 version u8[3] reserved
+// record:  u32 user_data_len, u8 provider[16], u16 id, u8 opcode, u8 version,
+//          u16 flags, u8 ptr_size, u8 reserved, u32 pid, u32 tid, u64 ts_100ns,
+//          user_data                                     (all little endian)
+//
+// - recorder: pipeline에서 routing을 통과한 이벤트만 기록 (ETW box에서 캡처)
+// - replay: 파일 전체를 메모리에 올려 두고 sink로 최대 속도로 밀어넣음
+//   (loops > 1: 매 회차 ts를 녹화 길이만큼 밀어서 시간이 계속 증가하도록)
+// - portable: Linux에서 pipeline 전체를 build / profile / regression test
+// ============================================================
+
+#define REPLAY_MAGIC        "MSYR"
+#define REPLAY_VERSION      1
+#define REPLAY_HEADER_SIZE  8
+#define REPLAY_REC_HEADER   44
+
+typedef struct REPLAY_RECORDER {
+    FILE* fp;
+    uint64_t records;
+    uint64_t bytes;
+} REPLAY_RECORDER;
+
+// 성공: 1, 실패: 0 (truncates an existing file)
+int replay_recorder_open(REPLAY_RECORDER* r, const wchar_t* path);
+void replay_record(REPLAY_RECORDER* r, const RAW_EVENT* ev);
+void replay_recorder_close(REPLAY_RECORDER* r);
+
+typedef struct REPLAY_STATS {
+    uint64_t records;       // per loop
+    uint64_t emitted;       // total sink calls
+    uint64_t bad_tail;      // 1: file ended inside a record (ignored)
+    uint64_t run_ns;
+} REPLAY_STATS;
+
+// 성공: 1, 실패(open/read/header): 0. loops 0 -> 1
+int replay_source_open(EVENT_SOURCE* src, const wchar_t* path, uint32_t loops);
+void replay_source_get_stats(EVENT_SOURCE* src, REPLAY_STATS* out);
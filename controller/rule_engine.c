@@ -0,0 +1,730 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "rule_engine.h"
+#include "segment.h"   // seg_fopen (wide path)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RULES_FILE_MAX   (16 * 1024 * 1024)
+#define DFA_CELLS_MAX    (64u * 1024 * 1024)     // next[] entries (256MB)
+
+// ============================================================
+// loader state: rules + patterns before compilation
+// ============================================================
+typedef struct PATTERN {
+    uint16_t* units;            // UTF-16, ASCII lowercased
+    uint32_t n;
+    RULE_TARGET target;
+} PATTERN;
+
+typedef struct PARENT_COND {
+    uint8_t field;
+    char* key;                  // patterns, each NUL-terminated (dedup)
+    size_t key_n;
+} PARENT_COND;
+
+typedef struct LOADER {
+    RULE_ENGINE* e;
+    uint32_t rule_cap;
+    PATTERN* pats;
+    uint32_t npats, pat_cap;
+    PARENT_COND parents[RULE_PARENT_CONDS_MAX];
+
+    // current rule / condition
+    RULE* rule;
+    int key_indent;
+    int in_if;
+    int cond_indent;
+    uint8_t seen;               // condition keys seen (1 << field)
+    int list_field;             // block list pending ("key:" + "- item" lines), -1: none
+    int list_indent;
+    char list_items[4096];      // list items, each NUL-terminated
+    size_t list_len;
+    uint32_t list_count;
+    uint32_t lineno;
+} LOADER;
+
+static int fail(LOADER* L, const char* msg)
+{
+    fprintf(stderr, "rules: line %u: %s\n", L->lineno, msg);
+    return 0;
+}
+
+// ============================================================
+// scalars: "double" (escapes), 'single' ('' = '), plain
+// ============================================================
+static char* put_utf8(char* d, uint32_t cp)
+{
+    if (cp < 0x80) {
+        *d++ = (char)cp;
+    } else if (cp < 0x800) {
+        *d++ = (char)(0xC0 | (cp >> 6));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *d++ = (char)(0xE0 | (cp >> 12));
+        *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *d++ = (char)(0xF0 | (cp >> 18));
+        *d++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    }
+    return d;
+}
+
+static int hex_digits(const char* s, int n, uint32_t* out)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < n; i++) {
+        char c = s[i];
+        int h = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        if (h < 0) return 0;
+        v = v * 16 + (uint32_t)h;
+    }
+    *out = v;
+    return 1;
+}
+
+// *p: scalar 시작. stop: plain scalar를 끝내는 문자 ("" / ",]"). 성공: 1, out은 NUL-terminated
+static int parse_scalar(LOADER* L, const char** p, const char* stop, char out[RULE_TEXT_MAX])
+{
+    const char* s = *p;
+    char* d = out;
+    char* end = out + RULE_TEXT_MAX - 5;    // UTF-8 4 bytes + NUL
+
+    if (*s == '"') {
+        for (s++; *s != '"'; s++) {
+            if (!*s) return fail(L, "unterminated string");
+            if (d >= end) return fail(L, "string too long");
+            if (*s != '\\') {
+                *d++ = *s;
+                continue;
+            }
+            uint32_t cp;
+            switch (*++s) {
+            case '\\': *d++ = '\\'; break;
+            case '"':  *d++ = '"'; break;
+            case '/':  *d++ = '/'; break;
+            case 'n':  *d++ = '\n'; break;
+            case 't':  *d++ = '\t'; break;
+            case 'r':  *d++ = '\r'; break;
+            case '0':  return fail(L, "NUL in string");
+            case 'x':
+                if (!hex_digits(s + 1, 2, &cp)) return fail(L, "bad \\x escape");
+                d = put_utf8(d, cp);
+                s += 2;
+                break;
+            case 'u':
+                if (!hex_digits(s + 1, 4, &cp)) return fail(L, "bad \\u escape");
+                d = put_utf8(d, cp);
+                s += 4;
+                break;
+            default:
+                return fail(L, "unsupported escape");
+            }
+        }
+        s++;
+    } else if (*s == '\'') {
+        for (s++;; s++) {
+            if (!*s) return fail(L, "unterminated string");
+            if (*s == '\'') {
+                if (s[1] != '\'') break;
+                s++;
+            }
+            if (d >= end) return fail(L, "string too long");
+            *d++ = *s;
+        }
+        s++;
+    } else {
+        const char* b = s;
+        while (*s && !strchr(stop, *s)) s++;
+        const char* e = s;
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t')) e--;
+        if ((size_t)(e - b) >= RULE_TEXT_MAX) return fail(L, "string too long");
+        memcpy(d, b, (size_t)(e - b));
+        d += e - b;
+    }
+    *d = '\0';
+    while (*s == ' ' || *s == '\t') s++;
+    *p = s;
+    return 1;
+}
+
+// ============================================================
+// rules -> patterns
+// ============================================================
+// UTF-8 -> UTF-16 units, ASCII lowercase. invalid byte -> U+FFFD
+static uint32_t to_units(const char* s, uint16_t* out)
+{
+    const uint8_t* p = (const uint8_t*)s;
+    uint32_t n = 0;
+    while (*p) {
+        uint32_t c = *p;
+        int k = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+        if (k < 0) {
+            out[n++] = 0xFFFD;
+            p++;
+            continue;
+        }
+        c = k ? c & (0x3F >> k) : c;
+        p++;
+        for (int i = 0; i < k; i++, p++) {
+            if ((*p & 0xC0) != 0x80) break;
+            c = (c << 6) | (*p & 0x3F);
+        }
+        if (c >= 'A' && c <= 'Z') c += 32;
+        if (c >= 0x10000) {
+            c -= 0x10000;
+            out[n++] = (uint16_t)(0xD800 + (c >> 10));
+            out[n++] = (uint16_t)(0xDC00 + (c & 0x3FF));
+        } else {
+            out[n++] = (uint16_t)c;
+        }
+    }
+    return n;
+}
+
+static int add_pattern(LOADER* L, const char* s, uint32_t ref, uint8_t field)
+{
+    if (L->npats == L->pat_cap) {
+        uint32_t cap = L->pat_cap ? L->pat_cap * 2 : 64;
+        PATTERN* p = (PATTERN*)realloc(L->pats, cap * sizeof(PATTERN));
+        if (!p) return fail(L, "out of memory");
+        L->pats = p;
+        L->pat_cap = cap;
+    }
+    PATTERN* p = &L->pats[L->npats];
+    p->units = (uint16_t*)malloc((strlen(s) * 2 + 1) * sizeof(uint16_t));
+    if (!p->units) return fail(L, "out of memory");
+    p->n = to_units(s, p->units);
+    p->target.ref = ref;
+    p->target.field = field;
+    p->target.endswith = (uint8_t)(field == RULE_FIELD_IMAGE || field == RULE_FIELD_PARENT_IMAGE);
+    L->npats++;
+    return 1;
+}
+
+// 한 condition의 pattern 목록. 빈 pattern이 있으면 항상 참
+static int add_condition(LOADER* L, uint8_t field, const char* items, uint32_t count)
+{
+    RULE* r = L->rule;
+    uint32_t ri = (uint32_t)(r - L->e->rules);
+    if (L->seen & (1u << field)) return fail(L, "duplicate condition");
+    L->seen |= (uint8_t)(1u << field);
+
+    if (!count) {
+        r->dead = 1;        // any([]) == False
+        return 1;
+    }
+    // items: count개의 NUL-terminated string
+    size_t key_n = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        size_t n = strlen(items + key_n);
+        if (!n) return 1;   // "" matches everything (str.endswith("") / "" in s)
+        key_n += n + 1;
+    }
+
+    if (field == RULE_FIELD_IMAGE || field == RULE_FIELD_CMD) {
+        r->need |= field == RULE_FIELD_IMAGE ? RULE_COND_IMAGE : RULE_COND_CMD;
+        for (const char* s = items; s < items + key_n; s += strlen(s) + 1) {
+            if (!add_pattern(L, s, ri, field)) return 0;
+        }
+        return 1;
+    }
+
+    // parent condition: 같은 (field, patterns)는 한 bit
+    uint32_t pi = 0;
+    for (; pi < L->e->nparent; pi++) {
+        const PARENT_COND* pc = &L->parents[pi];
+        if (pc->field == field && pc->key_n == key_n && memcmp(pc->key, items, key_n) == 0) break;
+    }
+    if (pi == L->e->nparent) {
+        if (pi == RULE_PARENT_CONDS_MAX) return fail(L, "too many distinct parent conditions");
+        char* key = (char*)malloc(key_n);
+        if (!key) return fail(L, "out of memory");
+        memcpy(key, items, key_n);
+        L->parents[pi].field = field;
+        L->parents[pi].key = key;
+        L->parents[pi].key_n = key_n;
+        L->e->nparent++;
+        for (const char* s = items; s < items + key_n; s += strlen(s) + 1) {
+            if (!add_pattern(L, s, pi, field)) return 0;
+        }
+    }
+    r->parent_need |= 1ULL << pi;
+    return 1;
+}
+
+// ============================================================
+// YAML subset, line by line
+// ============================================================
+static int field_of(const char* key)
+{
+    if (strcmp(key, "image_endswith") == 0) return RULE_FIELD_IMAGE;
+    if (strcmp(key, "cmd_contains") == 0) return RULE_FIELD_CMD;
+    if (strcmp(key, "parent_image_endswith") == 0) return RULE_FIELD_PARENT_IMAGE;
+    if (strcmp(key, "parent_cmd_contains") == 0) return RULE_FIELD_PARENT_CMD;
+    return -1;
+}
+
+static int list_push(LOADER* L, const char* item)
+{
+    size_t n = strlen(item);
+    if (L->list_len + n + 2 > sizeof(L->list_items)) return fail(L, "list too long");
+    memcpy(L->list_items + L->list_len, item, n + 1);
+    L->list_len += n + 1;
+    L->list_items[L->list_len] = '\0';
+    L->list_count++;
+    return 1;
+}
+
+static void list_reset(LOADER* L)
+{
+    L->list_len = 0;
+    L->list_count = 0;
+    L->list_items[0] = '\0';
+    L->list_items[1] = '\0';
+}
+
+static int list_end(LOADER* L)
+{
+    if (L->list_field < 0) return 1;
+    int ok = add_condition(L, (uint8_t)L->list_field, L->list_items, L->list_count);
+    L->list_field = -1;
+    return ok;
+}
+
+// "[a, "b", ...]"
+static int parse_flow_list(LOADER* L, const char* s, int field)
+{
+    list_reset(L);
+    char item[RULE_TEXT_MAX];
+    s++;
+    while (*s == ' ' || *s == '\t') s++;
+    if (*s != ']') {
+        for (;;) {
+            if (!parse_scalar(L, &s, ",]", item)) return 0;
+            if (!list_push(L, item)) return 0;
+            if (*s == ']') break;
+            if (*s != ',') return fail(L, "expected ',' or ']'");
+            s++;
+            while (*s == ' ' || *s == '\t') s++;
+        }
+    }
+    s++;
+    while (*s == ' ' || *s == '\t') s++;
+    if (*s) return fail(L, "text after ']'");
+    return add_condition(L, (uint8_t)field, L->list_items, L->list_count);
+}
+
+static int begin_rule(LOADER* L)
+{
+    RULE_ENGINE* e = L->e;
+    if (e->nrules == RULE_COUNT_MAX) return fail(L, "too many rules");
+    if (e->nrules == L->rule_cap) {
+        uint32_t cap = L->rule_cap ? L->rule_cap * 2 : 64;
+        RULE* r = (RULE*)realloc(e->rules, cap * sizeof(RULE));
+        if (!r) return fail(L, "out of memory");
+        e->rules = r;
+        L->rule_cap = cap;
+    }
+    L->rule = &e->rules[e->nrules++];
+    memset(L->rule, 0, sizeof(*L->rule));
+    strcpy(L->rule->id, "rule.unknown");
+    L->rule->line = L->lineno;
+    L->in_if = 0;
+    L->cond_indent = -1;
+    L->seen = 0;
+    return 1;
+}
+
+static int rule_key(LOADER* L, const char* key, const char* val)
+{
+    RULE* r = L->rule;
+    L->in_if = 0;
+    if (strcmp(key, "if") == 0) {
+        if (*val) return fail(L, "if: expected a mapping");
+        L->in_if = 1;
+        L->cond_indent = -1;
+        return 1;
+    }
+
+    char buf[RULE_TEXT_MAX];
+    if (!parse_scalar(L, &val, "", buf)) return 0;
+    if (*val) return fail(L, "text after value");
+    if (strcmp(key, "id") == 0) strcpy(r->id, buf);
+    else if (strcmp(key, "technique") == 0) strcpy(r->technique, buf);
+    else if (strcmp(key, "evidence") == 0) strcpy(r->evidence, buf);
+    else if (strcmp(key, "severity") == 0) r->severity = (int32_t)strtol(buf, NULL, 10);
+    // 그 밖의 key (description 등)는 tagger처럼 무시
+    return 1;
+}
+
+// '#' comment (quote 밖), 끝 공백 제거
+static void strip_comment(char* s)
+{
+    char q = 0;
+    for (char* p = s; *p; p++) {
+        if (q) {
+            if (*p == '\\' && q == '"' && p[1]) p++;
+            else if (*p == q) q = 0;
+        } else if (*p == '"' || *p == '\'') {
+            q = *p;
+        } else if (*p == '#' && (p == s || p[-1] == ' ' || p[-1] == '\t')) {
+            *p = '\0';
+            break;
+        }
+    }
+    size_t n = strlen(s);
+    while (n && (s[n - 1] == ' ' || s[n - 1] == '\t' || s[n - 1] == '\r')) s[--n] = '\0';
+}
+
+static int parse_line(LOADER* L, char* line, int* in_rules)
+{
+    strip_comment(line);
+    int indent = 0;
+    while (line[indent] == ' ') indent++;
+    char* s = line + indent;
+    if (!*s) return 1;
+    if (*s == '\t') return fail(L, "tab indentation");
+
+    // block list item of the pending condition
+    if (L->list_field >= 0) {
+        if ((s[0] == '-' && (s[1] == ' ' || !s[1])) && indent >= L->list_indent) {
+            char item[RULE_TEXT_MAX];
+            const char* v = s + 1;
+            while (*v == ' ') v++;
+            if (!parse_scalar(L, &v, "", item)) return 0;
+            if (*v) return fail(L, "text after list item");
+            return list_push(L, item);
+        }
+        if (!list_end(L)) return 0;
+    }
+
+    if (indent == 0) {
+        if (strcmp(s, "rules:") != 0) return fail(L, "expected 'rules:'");
+        *in_rules = 1;
+        return 1;
+    }
+    if (!*in_rules) return fail(L, "expected 'rules:'");
+
+    // "- key: value": 새 rule, key는 '-' 뒤 위치에서 시작
+    if (s[0] == '-' && (s[1] == ' ' || !s[1])) {
+        if (L->rule && L->in_if && indent > L->key_indent) return fail(L, "list item outside a condition");
+        if (!begin_rule(L)) return 0;
+        s++;
+        while (*s == ' ') s++;
+        L->key_indent = (int)(s - line);
+        indent = L->key_indent;
+        if (!*s) return 1;
+    }
+    if (!L->rule) return fail(L, "expected '- ' rule item");
+
+    char* colon = s;
+    while (*colon && !(*colon == ':' && (colon[1] == ' ' || !colon[1]))) colon++;
+    if (!*colon) return fail(L, "expected 'key: value'");
+    *colon = '\0';
+    const char* val = colon + 1;
+    while (*val == ' ') val++;
+
+    if (indent == L->key_indent) return rule_key(L, s, val);
+    if (indent < L->key_indent || !L->in_if) return fail(L, "bad indentation");
+
+    if (L->cond_indent < 0) L->cond_indent = indent;
+    if (indent != L->cond_indent) return fail(L, "bad indentation");
+
+    int field = field_of(s);
+    if (field < 0) return fail(L, "unknown condition");
+    if (*val == '[') return parse_flow_list(L, val, field);
+    if (*val) return fail(L, "condition: expected a list");
+    list_reset(L);
+    L->list_field = field;
+    L->list_indent = indent;
+    return 1;
+}
+
+// ============================================================
+// compile: patterns -> DFA
+// ============================================================
+static int target_cmp(const void* a, const void* b)
+{
+    const uint32_t* x = (const uint32_t*)a;
+    const uint32_t* y = (const uint32_t*)b;
+    return x[0] != y[0] ? (x[0] < y[0] ? -1 : 1) : (x[1] < y[1] ? -1 : x[1] > y[1]);
+}
+
+static int compile(LOADER* L)
+{
+    RULE_ENGINE* e = L->e;
+
+    // alphabet: pattern에 나오는 unit만 class를 가짐 (나머지는 class 0 -> root)
+    e->cls = (uint16_t*)calloc(0x10000, sizeof(uint16_t));
+    if (!e->cls) return 0;
+    e->nclass = 1;
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < L->npats; i++) {
+        for (uint32_t k = 0; k < L->pats[i].n; k++) {
+            uint16_t u = L->pats[i].units[k];
+            if (!e->cls[u]) e->cls[u] = (uint16_t)e->nclass++;
+        }
+        total += L->pats[i].n;
+    }
+
+    uint32_t max_states = total + 1;
+    if ((uint64_t)max_states * e->nclass > DFA_CELLS_MAX) {
+        fprintf(stderr, "rules: automaton too large (%u states x %u classes)\n", max_states, e->nclass);
+        return 0;
+    }
+    e->next = (uint32_t*)calloc((size_t)max_states * e->nclass, sizeof(uint32_t));
+    uint32_t* fail_link = (uint32_t*)calloc(max_states, sizeof(uint32_t));
+    uint32_t* queue = (uint32_t*)malloc(max_states * sizeof(uint32_t));
+    uint32_t* ends = (uint32_t*)malloc(((size_t)L->npats + 1) * 2 * sizeof(uint32_t));   // (state, pattern)
+    e->out_first = (uint32_t*)calloc(max_states, sizeof(uint32_t));
+    e->out_count = (uint32_t*)calloc(max_states, sizeof(uint32_t));
+    e->dict = (uint32_t*)calloc(max_states, sizeof(uint32_t));
+    e->targets = (RULE_TARGET*)malloc(((size_t)L->npats + 1) * sizeof(RULE_TARGET));
+    int ok = e->next && fail_link && queue && ends && e->out_first && e->out_count && e->dict && e->targets;
+
+    // trie
+    e->nstates = 1;
+    uint32_t nends = 0;
+    for (uint32_t i = 0; ok && i < L->npats; i++) {
+        const PATTERN* p = &L->pats[i];
+        uint32_t s = 0;
+        for (uint32_t k = 0; k < p->n; k++) {
+            uint32_t* cell = &e->next[(size_t)s * e->nclass + e->cls[p->units[k]]];
+            if (!*cell) *cell = e->nstates++;
+            s = *cell;
+        }
+        ends[nends * 2] = s;
+        ends[nends * 2 + 1] = i;
+        nends++;
+    }
+
+    // outputs, state 순서
+    if (ok) {
+        qsort(ends, nends, 2 * sizeof(uint32_t), target_cmp);
+        for (uint32_t i = 0; i < nends; i++) {
+            uint32_t s = ends[i * 2];
+            if (!e->out_count[s]) e->out_first[s] = i;
+            e->out_count[s]++;
+            e->targets[i] = L->pats[ends[i * 2 + 1]].target;
+        }
+        e->ntargets = nends;
+    }
+
+    // BFS: fail link, 빠진 transition은 fail 쪽 transition으로 채움 (완전한 DFA)
+    if (ok) {
+        uint32_t qh = 0, qt = 0;
+        for (uint32_t c = 1; c < e->nclass; c++) {
+            uint32_t t = e->next[c];
+            if (t) queue[qt++] = t;     // fail = root
+        }
+        while (qh < qt) {
+            uint32_t s = queue[qh++];
+            uint32_t* row = &e->next[(size_t)s * e->nclass];
+            const uint32_t* frow = &e->next[(size_t)fail_link[s] * e->nclass];
+            for (uint32_t c = 1; c < e->nclass; c++) {
+                uint32_t t = row[c];
+                if (t) {
+                    uint32_t f = frow[c];
+                    fail_link[t] = f;
+                    e->dict[t] = e->out_count[f] ? f : e->dict[f];
+                    queue[qt++] = t;
+                } else {
+                    row[c] = frow[c];
+                }
+            }
+        }
+    }
+
+    free(fail_link);
+    free(queue);
+    free(ends);
+    if (!ok) return 0;
+
+    for (uint32_t i = 0; i < e->nrules; i++) {
+        if (!e->rules[i].need) e->nno_own++;
+    }
+    e->no_own = (uint32_t*)malloc(((size_t)e->nno_own + 1) * sizeof(uint32_t));
+    if (!e->no_own) return 0;
+    e->nno_own = 0;
+    for (uint32_t i = 0; i < e->nrules; i++) {
+        if (!e->rules[i].need) e->no_own[e->nno_own++] = i;
+    }
+    return 1;
+}
+
+int rule_engine_load(RULE_ENGINE* e, const wchar_t* path)
+{
+    memset(e, 0, sizeof(*e));
+    FILE* fp = seg_fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "rules: open failed\n");
+        return 0;
+    }
+    char* text = (char*)malloc(RULES_FILE_MAX + 1);
+    size_t n = text ? fread(text, 1, RULES_FILE_MAX + 1, fp) : 0;
+    fclose(fp);
+    if (!text || n > RULES_FILE_MAX) {
+        fprintf(stderr, "rules: file too large\n");
+        free(text);
+        return 0;
+    }
+    text[n] = '\0';
+
+    LOADER* L = (LOADER*)calloc(1, sizeof(LOADER));
+    int ok = L != NULL;
+    if (ok) {
+        L->e = e;
+        L->list_field = -1;
+        int in_rules = 0;
+        char* line = text;
+        while (ok && line) {
+            char* nl = strchr(line, '\n');
+            if (nl) *nl = '\0';
+            L->lineno++;
+            ok = parse_line(L, line, &in_rules);
+            line = nl ? nl + 1 : NULL;
+        }
+        if (ok) ok = list_end(L);
+        if (ok) ok = compile(L);
+
+        for (uint32_t i = 0; i < L->npats; i++) free(L->pats[i].units);
+        free(L->pats);
+        for (uint32_t i = 0; i < RULE_PARENT_CONDS_MAX; i++) free(L->parents[i].key);
+        free(L);
+    }
+    free(text);
+
+    if (!ok) rule_engine_free(e);
+    return ok;
+}
+
+void rule_engine_free(RULE_ENGINE* e)
+{
+    if (!e) return;
+    free(e->rules);
+    free(e->next);
+    free(e->cls);
+    free(e->out_first);
+    free(e->out_count);
+    free(e->dict);
+    free(e->targets);
+    free(e->no_own);
+    memset(e, 0, sizeof(*e));
+}
+
+// ============================================================
+// matching (decoding thread)
+// ============================================================
+int rule_match_init(RULE_MATCH* m, const RULE_ENGINE* e)
+{
+    memset(m, 0, sizeof(*m));
+    size_t n = e->nrules ? e->nrules : 1;
+    m->stamp = (uint32_t*)calloc(n, sizeof(uint32_t));
+    m->have = (uint8_t*)calloc(n, 1);
+    m->touched = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (!m->stamp || !m->have || !m->touched) {
+        rule_match_free(m);
+        return 0;
+    }
+    return 1;
+}
+
+void rule_match_free(RULE_MATCH* m)
+{
+    if (!m) return;
+    free(m->stamp);
+    free(m->have);
+    free(m->touched);
+    memset(m, 0, sizeof(*m));
+}
+
+static void emit(const RULE_ENGINE* e, RULE_MATCH* m, uint32_t s, uint8_t own, int at_end)
+{
+    for (uint32_t k = e->out_count[s] ? s : e->dict[s]; k; k = e->dict[k]) {
+        const RULE_TARGET* t = e->targets + e->out_first[k];
+        for (uint32_t i = 0; i < e->out_count[k]; i++, t++) {
+            if (t->endswith && !at_end) continue;
+            if (t->field == own) {
+                uint32_t r = t->ref;
+                if (m->stamp[r] != m->cur) {
+                    m->stamp[r] = m->cur;
+                    m->have[r] = 0;
+                    m->touched[m->ntouched++] = r;
+                }
+                m->have[r] |= own == RULE_FIELD_IMAGE ? RULE_COND_IMAGE : RULE_COND_CMD;
+            } else if (t->field == own + 2) {
+                m->self_bits |= 1ULL << t->ref;
+            }
+        }
+    }
+}
+
+static void scan_text(const RULE_ENGINE* e, RULE_MATCH* m, const wchar_t* s, uint8_t own)
+{
+    if (!s) return;
+    int image = own == RULE_FIELD_IMAGE;
+    uint32_t state = 0;
+    const uint32_t* next = e->next;
+    uint32_t nclass = e->nclass;
+
+    for (size_t i = 0; s[i]; i++) {
+        uint32_t u = (uint32_t)s[i];
+        if (u >= 0x10000) {
+            // UTF-32 (Linux): UTF-16 surrogate pair로 (pattern과 같은 단위)
+            u -= 0x10000;
+            state = next[(size_t)state * nclass + e->cls[0xD800 + (u >> 10)]];
+            u = 0xDC00 + (u & 0x3FF);
+        } else if (u >= 'A' && u <= 'Z') {
+            u += 32;
+        } else if (u == '/' && image) {
+            u = '\\';
+        }
+        state = next[(size_t)state * nclass + e->cls[u]];
+        if (e->out_count[state] || e->dict[state]) emit(e, m, state, own, s[i + 1] == 0);
+    }
+}
+
+void rule_scan(const RULE_ENGINE* e, RULE_MATCH* m, const wchar_t* image, const wchar_t* cmdline)
+{
+    if (++m->cur == 0) {
+        memset(m->stamp, 0, e->nrules * sizeof(uint32_t));
+        m->cur = 1;
+    }
+    m->ntouched = 0;
+    m->self_bits = 0;
+    if (!e->nstates) return;
+    scan_text(e, m, image, RULE_FIELD_IMAGE);
+    scan_text(e, m, cmdline, RULE_FIELD_CMD);
+}
+
+uint32_t rule_eval(const RULE_ENGINE* e, RULE_MATCH* m, uint64_t parent_bits, uint16_t* out, uint32_t cap)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < m->ntouched && n < cap; i++) {
+        uint32_t r = m->touched[i];
+        const RULE* rl = &e->rules[r];
+        if (rl->dead || m->have[r] != rl->need) continue;
+        if ((parent_bits & rl->parent_need) != rl->parent_need) continue;
+        out[n++] = (uint16_t)r;
+    }
+    for (uint32_t i = 0; i < e->nno_own && n < cap; i++) {
+        const RULE* rl = &e->rules[e->no_own[i]];
+        if (rl->dead || (parent_bits & rl->parent_need) != rl->parent_need) continue;
+        out[n++] = (uint16_t)e->no_own[i];
+    }
+
+    // rules file 순서 (tagger와 같은 순서로 tag가 나가게)
+    for (uint32_t i = 1; i < n; i++) {
+        uint16_t v = out[i];
+        uint32_t j = i;
+        for (; j > 0 && out[j - 1] > v; j--) out[j] = out[j - 1];
+        out[j] = v;
+    }
+    return n;
+}
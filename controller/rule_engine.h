@@ -0,0 +1,100 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// ============================================================
+// Streaming rule engine: analyzer rules (rules/mitre_rules.yaml) at proc_start
+// - YAML subset: rules: list of { id, technique, severity, evidence, if },
+//   if: image_endswith / cmd_contains / parent_image_endswith /
+//   parent_cmd_contains, each a list of strings ([..] or "- item" lines)
+// - same semantics as tagger.apply_rules: lowercase, image '/' == '\\',
+//   any pattern of a condition, all conditions of a rule
+// - every pattern of every rule in one Aho-Corasick automaton (DFA over
+//   case-folded wchar_t units, pattern characters as a compact alphabet):
+//   one pass over image and one over cmdline, cost independent of rule count
+// - a match sets a condition bit of its rule; a rule fires when its bits
+//   are complete (only rules touched by a match are tested)
+// - parent conditions are matched once at the parent's own start and kept
+//   as a bit set of distinct parent conditions (PROC_REC.rule_bits):
+//   at most RULE_PARENT_CONDS_MAX distinct ones
+// - lowercase: ASCII only (tagger uses str.lower)
+// - engine is read-only after load; per-thread state in RULE_MATCH
+// ============================================================
+
+#define RULE_TEXT_MAX          256      // id / technique / evidence / pattern (UTF-8 bytes)
+#define RULE_PARENT_CONDS_MAX  64
+#define RULE_COUNT_MAX         65535    // tag = rule index (uint16_t, EVENT_REC.tags)
+
+// condition bits
+#define RULE_COND_IMAGE   0x01
+#define RULE_COND_CMD     0x02
+
+typedef enum RULE_FIELD {
+    RULE_FIELD_IMAGE = 0,       // image_endswith
+    RULE_FIELD_CMD,             // cmd_contains
+    RULE_FIELD_PARENT_IMAGE,    // parent_image_endswith
+    RULE_FIELD_PARENT_CMD,      // parent_cmd_contains
+} RULE_FIELD;
+
+typedef struct RULE {
+    char id[RULE_TEXT_MAX];
+    char technique[RULE_TEXT_MAX];
+    char evidence[RULE_TEXT_MAX];
+    int32_t severity;
+    uint32_t line;              // rules file line of "- "
+    uint8_t need;               // RULE_COND_* the process itself must match
+    uint8_t dead;               // a condition with an empty list: never fires
+    uint64_t parent_need;       // distinct parent conditions (bit per RULE_PARENT_CONDS_MAX)
+} RULE;
+
+typedef struct RULE_TARGET {
+    uint32_t ref;               // rule index (own condition) or parent condition index
+    uint8_t field;              // RULE_FIELD_*
+    uint8_t endswith;           // match must end at the end of the text
+} RULE_TARGET;
+
+typedef struct RULE_ENGINE {
+    RULE* rules;
+    uint32_t nrules;
+    uint32_t nparent;           // distinct parent conditions
+
+    // DFA: next[state * nclass + class], state 0 = root, class 0 = not in any pattern
+    uint32_t* next;
+    uint32_t nstates;
+    uint32_t nclass;
+    uint16_t* cls;              // wchar_t unit (< 0x10000, folded) -> class
+
+    // outputs: targets of patterns ending at a state + dictionary suffix link
+    uint32_t* out_first;
+    uint32_t* out_count;
+    uint32_t* dict;             // next state on the fail chain with outputs (0: none)
+    RULE_TARGET* targets;
+    uint32_t ntargets;
+
+    uint32_t* no_own;           // rules with need == 0 (parent only / unconditional)
+    uint32_t nno_own;
+} RULE_ENGINE;
+
+// per decoding thread
+typedef struct RULE_MATCH {
+    uint32_t* stamp;            // per rule: event stamp of have[]
+    uint8_t* have;              // per rule: RULE_COND_* seen in this event
+    uint32_t* touched;          // rules with stamp == cur
+    uint32_t ntouched;
+    uint32_t cur;
+    uint64_t self_bits;         // parent conditions this process satisfies (for its children)
+} RULE_MATCH;
+
+// 성공: 1, 실패: 0 (open / parse error -> stderr with the line)
+int rule_engine_load(RULE_ENGINE* e, const wchar_t* path);
+void rule_engine_free(RULE_ENGINE* e);
+
+// 성공: 1, 실패: 0
+int rule_match_init(RULE_MATCH* m, const RULE_ENGINE* e);
+void rule_match_free(RULE_MATCH* m);
+
+// process start, 1) own image / cmdline (NUL-terminated) -> m->self_bits
+void rule_scan(const RULE_ENGINE* e, RULE_MATCH* m, const wchar_t* image, const wchar_t* cmdline);
+// 2) + parent's rule_bits -> fired rule indices in rules file order. returns count (<= cap)
+uint32_t rule_eval(const RULE_ENGINE* e, RULE_MATCH* m, uint64_t parent_bits, uint16_t* out, uint32_t cap);
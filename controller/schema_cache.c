@@ -0,0 +1,291 @@
+#include "schema_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// Field aliases (was try_read_u32_any name lists in etw_consumer.c)
+// - resolved once per schema, not per event
+// ============================================================
+static const char* const k_alias_pid[]    = { "ProcessId", "PID", "Pid", "processId", NULL };
+static const char* const k_alias_ppid[]   = { "ParentId", "ParentProcessId", "PPID", "ParentPid", NULL };
+static const char* const k_alias_image[]  = { "ImageFileName", "ImageName", "ProcessName", "FileName", NULL };
+static const char* const k_alias_cmd[]    = { "CommandLine", "CmdLine", "ProcessCommandLine", NULL };
+static const char* const k_alias_sport[]  = { "SourcePort", "sport", "SrcPort", "src_port", NULL };
+static const char* const k_alias_dport[]  = { "DestPort", "DestinationPort", "dport", "DstPort", "dst_port", NULL };
+static const char* const k_alias_saddr[]  = { "SourceAddress", "saddr", "SrcAddr", "src_ip", "Saddr", NULL };
+static const char* const k_alias_daddr[]  = { "DestAddress", "DestinationAddress", "daddr", "DstAddr", "dst_ip", "Daddr", NULL };
+
+static const char* const* const k_field_aliases[SF_COUNT] = {
+    k_alias_pid,
+    k_alias_ppid,
+    k_alias_image,
+    k_alias_cmd,
+    k_alias_sport,
+    k_alias_dport,
+    k_alias_saddr,
+    k_alias_daddr,
+};
+
+// ============================================================
+// key hash / compare
+// ============================================================
+static uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static uint64_t key_hash(const SCHEMA_KEY* k)
+{
+    uint64_t a, b;
+    memcpy(&a, k->provider, 8);
+    memcpy(&b, k->provider + 8, 8);
+    uint64_t t = ((uint64_t)k->id << 24) | ((uint64_t)k->opcode << 16)
+               | ((uint64_t)k->version << 8) | k->ptr64;
+    return mix64(a ^ mix64(b ^ mix64(t)));
+}
+
+static int key_eq(const SCHEMA_KEY* a, const SCHEMA_KEY* b)
+{
+    return a->id == b->id && a->opcode == b->opcode && a->version == b->version
+        && a->ptr64 == b->ptr64 && memcmp(a->provider, b->provider, 16) == 0;
+}
+
+// ============================================================
+// UTF-16 helpers (blob 안의 문자열은 정렬 보장이 없으니 byte 단위로 읽음)
+// ============================================================
+static uint16_t rd16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint16_t ascii_lower16(uint16_t c)
+{
+    return (c >= 'A' && c <= 'Z') ? (uint16_t)(c + 32) : c;
+}
+
+int schema_wstr_eqi_ascii(const uint16_t* w, const char* a)
+{
+    if (!w || !a) return 0;
+    const uint8_t* p = (const uint8_t*)w;
+    for (;; p += 2, a++) {
+        uint16_t c = ascii_lower16(rd16(p));
+        uint16_t d = ascii_lower16((uint8_t)*a);
+        if (c != d) return 0;
+        if (c == 0) return 1;
+    }
+}
+
+const uint16_t* schema_blob_wstr(const SCHEMA_ENTRY* e, uint32_t offset)
+{
+    if (!e || !offset || offset >= e->blob_size) return NULL;
+
+    // must be NUL terminated inside the blob
+    for (uint32_t i = offset; i + 1 < e->blob_size; i += 2) {
+        if (e->blob[i] == 0 && e->blob[i + 1] == 0) {
+            return (const uint16_t*)(e->blob + offset);
+        }
+    }
+    return NULL;
+}
+
+uint16_t schema_find_prop_ascii(const SCHEMA_ENTRY* e, const char* name)
+{
+    if (!e || !name) return SCHEMA_PROP_NONE;
+    for (uint16_t i = 0; i < e->prop_count; i++) {
+        const uint16_t* pn = schema_blob_wstr(e, e->props[i].name_offset);
+        if (pn && schema_wstr_eqi_ascii(pn, name)) return i;
+    }
+    return SCHEMA_PROP_NONE;
+}
+
+uint16_t schema_find_prop(const SCHEMA_ENTRY* e, const uint16_t* name)
+{
+    if (!e || !name) return SCHEMA_PROP_NONE;
+
+    for (uint16_t i = 0; i < e->prop_count; i++) {
+        const uint16_t* pn = schema_blob_wstr(e, e->props[i].name_offset);
+        if (!pn) continue;
+
+        const uint8_t* a = (const uint8_t*)pn;
+        const uint8_t* b = (const uint8_t*)name;
+        for (;; a += 2, b += 2) {
+            uint16_t ca = ascii_lower16(rd16(a));
+            uint16_t cb = ascii_lower16(rd16(b));
+            if (ca != cb) break;
+            if (ca == 0) return i;
+        }
+    }
+    return SCHEMA_PROP_NONE;
+}
+
+static void resolve_fields(SCHEMA_ENTRY* e)
+{
+    for (int f = 0; f < SF_COUNT; f++) {
+        e->field_index[f] = SCHEMA_PROP_NONE;
+        for (const char* const* n = k_field_aliases[f]; *n; n++) {
+            uint16_t idx = schema_find_prop_ascii(e, *n);
+            if (idx != SCHEMA_PROP_NONE) {
+                e->field_index[f] = idx;
+                break;
+            }
+        }
+    }
+}
+
+// ============================================================
+// open addressing table (schemas are few and never removed)
+// ============================================================
+int schema_cache_init(SCHEMA_CACHE* c, size_t cap_pow2)
+{
+    memset(c, 0, sizeof(*c));
+    if (cap_pow2 < 16) cap_pow2 = 16;
+    c->slots = (SCHEMA_ENTRY*)calloc(cap_pow2, sizeof(SCHEMA_ENTRY));
+    if (!c->slots) return 0;
+    c->cap = cap_pow2;
+    return 1;
+}
+
+void schema_cache_free(SCHEMA_CACHE* c)
+{
+    if (!c) return;
+    for (size_t i = 0; i < c->cap; i++) {
+        if (c->slots[i].used) free(c->slots[i].blob);
+    }
+    free(c->slots);
+    memset(c, 0, sizeof(*c));
+}
+
+static SCHEMA_ENTRY* probe_slot(SCHEMA_ENTRY* slots, size_t cap, const SCHEMA_KEY* key)
+{
+    size_t idx = (size_t)(key_hash(key) & (cap - 1));
+    for (size_t probe = 0; probe < cap; probe++) {
+        SCHEMA_ENTRY* e = &slots[idx];
+        if (!e->used || key_eq(&e->key, key)) return e;
+        idx = (idx + 1) & (cap - 1);
+    }
+    return NULL;
+}
+
+SCHEMA_ENTRY* schema_cache_find(SCHEMA_CACHE* c, const SCHEMA_KEY* key)
+{
+    if (!c || !c->slots || !key) return NULL;
+    SCHEMA_ENTRY* e = probe_slot(c->slots, c->cap, key);
+    if (e && e->used) {
+        c->hits++;
+        return e;
+    }
+    c->misses++;
+    return NULL;
+}
+
+static int grow(SCHEMA_CACHE* c)
+{
+    size_t new_cap = c->cap * 2;
+    SCHEMA_ENTRY* slots = (SCHEMA_ENTRY*)calloc(new_cap, sizeof(SCHEMA_ENTRY));
+    if (!slots) return 0;
+
+    for (size_t i = 0; i < c->cap; i++) {
+        if (!c->slots[i].used) continue;
+        SCHEMA_ENTRY* dst = probe_slot(slots, new_cap, &c->slots[i].key);
+        *dst = c->slots[i];
+    }
+    free(c->slots);
+    c->slots = slots;
+    c->cap = new_cap;
+    return 1;
+}
+
+SCHEMA_ENTRY* schema_cache_insert(
+    SCHEMA_CACHE* c,
+    const SCHEMA_KEY* key,
+    const void* blob, uint32_t blob_size,
+    const SCHEMA_PROP* props, uint16_t prop_count,
+    uint32_t task_name_offset,
+    uint32_t opcode_name_offset
+){
+    if (!c || !c->slots || !key || !blob || !blob_size) return NULL;
+    if (prop_count && !props) return NULL;
+
+    // load factor ~ 0.75
+    if ((c->size + 1) * 4 > c->cap * 3 && !grow(c)) return NULL;
+
+    SCHEMA_ENTRY* e = probe_slot(c->slots, c->cap, key);
+    if (!e) return NULL;
+    if (e->used) return e; // already cached
+
+    // blob + props in one allocation (props aligned after blob)
+    size_t props_off = ((size_t)blob_size + 7) & ~(size_t)7;
+    uint8_t* mem = (uint8_t*)malloc(props_off + (size_t)prop_count * sizeof(SCHEMA_PROP));
+    if (!mem) return NULL;
+
+    memcpy(mem, blob, blob_size);
+    if (prop_count) memcpy(mem + props_off, props, (size_t)prop_count * sizeof(SCHEMA_PROP));
+
+    memset(e, 0, sizeof(*e));
+    e->key = *key;
+    e->used = 1;
+    e->blob = mem;
+    e->blob_size = blob_size;
+    e->props = (SCHEMA_PROP*)(mem + props_off);
+    e->prop_count = prop_count;
+    e->task_name_offset = task_name_offset;
+    e->opcode_name_offset = opcode_name_offset;
+    resolve_fields(e);
+
+    c->size++;
+    return e;
+}
+
+// ============================================================
+// TRACE_EVENT_INFO by offset (tdh.h layout, no windows.h here)
+// - EventPropertyInfoArray starts at 112: sizeof(TRACE_EVENT_INFO) already
+//   counts one EVENT_PROPERTY_INFO (ANYSIZE_ARRAY), so it is not the array start
+// ============================================================
+#define TEI_TASK_NAME_OFF       68
+#define TEI_OPCODE_NAME_OFF     72
+#define TEI_TOP_LEVEL_COUNT_OFF 104
+#define TEI_PROPS_OFF           112
+#define EPI_SIZE                24      // EVENT_PROPERTY_INFO
+#define EPI_NAME_OFF            4
+#define EPI_IN_TYPE_OFF         8
+#define EPI_FLAG_STRUCT         0x1u    // PropertyStruct
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+SCHEMA_ENTRY* schema_cache_insert_info(
+    SCHEMA_CACHE* c,
+    const SCHEMA_KEY* key,
+    const void* info, uint32_t info_size
+){
+    const uint8_t* b = (const uint8_t*)info;
+    if (!b || info_size < TEI_PROPS_OFF) return NULL;
+
+    uint32_t count = rd32(b + TEI_TOP_LEVEL_COUNT_OFF);
+    if (count > 0xFFFFu || (uint64_t)TEI_PROPS_OFF + (uint64_t)count * EPI_SIZE > info_size) return NULL;
+
+    SCHEMA_PROP* props = NULL;
+    if (count) {
+        props = (SCHEMA_PROP*)malloc(count * sizeof(SCHEMA_PROP));
+        if (!props) return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* epi = b + TEI_PROPS_OFF + (size_t)i * EPI_SIZE;
+        props[i].name_offset = rd32(epi + EPI_NAME_OFF);
+        props[i].is_struct = (rd32(epi) & EPI_FLAG_STRUCT) ? 1 : 0;
+        props[i].in_type = props[i].is_struct ? 0 : rd16(epi + EPI_IN_TYPE_OFF);
+    }
+
+    SCHEMA_ENTRY* e = schema_cache_insert(c, key, info, info_size, props, (uint16_t)count,
+                                          rd32(b + TEI_TASK_NAME_OFF), rd32(b + TEI_OPCODE_NAME_OFF));
+    free(props);
+    return e;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// Per-schema event metadata cache
+// - portable C (no windows.h): TRACE_EVENT_INFO is kept as an opaque blob,
+//   property names are UTF-16 (uint16_t) strings inside that blob
+// - key: provider GUID + id/opcode/version (+ pointer size)
+// ============================================================
+
+typedef struct SCHEMA_KEY {
+    uint8_t provider[16];   // GUID bytes, in-memory layout
+    uint16_t id;
+    uint8_t opcode;
+    uint8_t version;
+    uint8_t ptr64;          // 1: 64bit header, 0: 32bit
+    uint8_t pad[3];
+} SCHEMA_KEY;
+
+// collector가 실제로 읽는 필드들. alias 목록은 schema_cache.c에 있음
+typedef enum SCHEMA_FIELD {
+    SF_PROCESS_ID = 0,
+    SF_PARENT_ID,
+    SF_IMAGE,
+    SF_CMDLINE,
+    SF_SRC_PORT,
+    SF_DST_PORT,
+    SF_SRC_ADDR,
+    SF_DST_ADDR,
+    SF_COUNT
+} SCHEMA_FIELD;
+
+#define SCHEMA_PROP_NONE 0xFFFFu
+
+// flattened EVENT_PROPERTY_INFO (only what we need)
+typedef struct SCHEMA_PROP {
+    uint32_t name_offset;   // offset of UTF-16 name inside blob (0: none)
+    uint16_t in_type;
+    uint16_t is_struct;
+} SCHEMA_PROP;
+
+typedef struct SCHEMA_ENTRY {
+    SCHEMA_KEY key;
+    uint8_t used;
+
+    uint8_t* blob;          // raw TRACE_EVENT_INFO bytes (owned)
+    uint32_t blob_size;
+    uint32_t task_name_offset;
+    uint32_t opcode_name_offset;
+
+    SCHEMA_PROP* props;     // same allocation as blob
+    uint16_t prop_count;
+
+    // resolved once at insert: SCHEMA_FIELD -> top-level property index
+    uint16_t field_index[SF_COUNT];
+} SCHEMA_ENTRY;
+
+typedef struct SCHEMA_CACHE {
+    SCHEMA_ENTRY* slots;
+    size_t cap;             // power of 2
+    size_t size;
+    uint64_t hits;
+    uint64_t misses;
+} SCHEMA_CACHE;
+
+// 성공: 1, 실패: 0
+int schema_cache_init(SCHEMA_CACHE* c, size_t cap_pow2);
+void schema_cache_free(SCHEMA_CACHE* c);
+
+// NULL if not cached
+SCHEMA_ENTRY* schema_cache_find(SCHEMA_CACHE* c, const SCHEMA_KEY* key);
+
+// copies blob/props, resolves field indices. returns cached entry or NULL (OOM / bad blob)
+SCHEMA_ENTRY* schema_cache_insert(
+    SCHEMA_CACHE* c,
+    const SCHEMA_KEY* key,
+    const void* blob, uint32_t blob_size,
+    const SCHEMA_PROP* props, uint16_t prop_count,
+    uint32_t task_name_offset,
+    uint32_t opcode_name_offset
+);
+
+// raw TRACE_EVENT_INFO (TdhGetEventInformation output): top-level EVENT_PROPERTY_INFO
+// -> SCHEMA_PROP, task/opcode name offsets from the header, then schema_cache_insert
+// NULL: OOM, or a blob too short for its header / property array
+SCHEMA_ENTRY* schema_cache_insert_info(
+    SCHEMA_CACHE* c,
+    const SCHEMA_KEY* key,
+    const void* info, uint32_t info_size
+);
+
+// UTF-16 string inside the blob, NULL if offset is 0 / out of range / unterminated
+const uint16_t* schema_blob_wstr(const SCHEMA_ENTRY* e, uint32_t offset);
+
+// case-insensitive (ASCII) name lookup. SCHEMA_PROP_NONE if missing
+uint16_t schema_find_prop(const SCHEMA_ENTRY* e, const uint16_t* name);
+uint16_t schema_find_prop_ascii(const SCHEMA_ENTRY* e, const char* name);
+
+// ASCII case-insensitive compare of a UTF-16 string against an ASCII literal
+int schema_wstr_eqi_ascii(const uint16_t* w, const char* a);
@@ -0,0 +1,72 @@
+#include "scratch.h"
+#include "plat.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGN16(n) (((n) + 15) & ~(size_t)15)
+
+typedef struct SCRATCH_SPILL {
+    struct SCRATCH_SPILL* next;
+    uint8_t pad_[8];            // data 16-byte aligned
+} SCRATCH_SPILL;
+
+static PLAT_TLS SCRATCH* t_scratch;
+
+int scratch_init(SCRATCH* a, size_t cap)
+{
+    memset(a, 0, sizeof(*a));
+    cap = ALIGN16(cap);
+    a->base = (uint8_t*)malloc(cap);
+    if (!a->base) return 0;
+    a->cap = cap;
+    return 1;
+}
+
+void scratch_free(SCRATCH* a)
+{
+    if (!a) return;
+    scratch_reset(a);
+    free(a->base);
+    memset(a, 0, sizeof(*a));
+}
+
+void* scratch_alloc(SCRATCH* a, size_t n)
+{
+    n = ALIGN16(n ? n : 1);
+    a->st.allocs++;
+    if (n <= a->cap - a->used) {
+        void* p = a->base + a->used;
+        a->used += n;
+        return p;
+    }
+
+    // 넘치면 heap (reset에서 해제). 자주 보이면 SCRATCH_ARENA_BYTES를 키울 것
+    SCRATCH_SPILL* s = (SCRATCH_SPILL*)malloc(sizeof(SCRATCH_SPILL) + n);
+    if (!s) return NULL;
+    s->next = a->spill;
+    a->spill = s;
+    a->st.spills++;
+    return s + 1;
+}
+
+void scratch_reset(SCRATCH* a)
+{
+    if (a->used > a->st.high_water) a->st.high_water = a->used;
+    a->used = 0;
+    while (a->spill) {
+        SCRATCH_SPILL* s = a->spill;
+        a->spill = s->next;
+        free(s);
+    }
+}
+
+void scratch_bind(SCRATCH* a)
+{
+    t_scratch = a;
+}
+
+SCRATCH* scratch_thread(void)
+{
+    return t_scratch;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// Per-thread scratch arena: bump allocator, reset after every event
+// - decode temporaries (TDH property buffers, drop-path EVENT_REC) come
+//   from here instead of malloc / big stack frames
+// - one arena per decoding thread (source thread or decode worker),
+//   bound with scratch_bind. single thread, no locking
+// - request that does not fit: heap block chained to the arena, freed at
+//   reset and counted in spills (steady state should stay at 0)
+// ============================================================
+
+typedef struct SCRATCH_STATS {
+    uint64_t allocs;
+    uint64_t spills;            // heap fallback (arena too small)
+    uint64_t high_water;        // max bytes used between two resets
+} SCRATCH_STATS;
+
+typedef struct SCRATCH {
+    uint8_t* base;
+    size_t cap;
+    size_t used;
+    struct SCRATCH_SPILL* spill;
+    SCRATCH_STATS st;
+} SCRATCH;
+
+// 성공: 1, 실패: 0
+int scratch_init(SCRATCH* a, size_t cap);
+void scratch_free(SCRATCH* a);
+
+// 16-byte aligned, valid until scratch_reset. NULL only if the heap fallback fails
+void* scratch_alloc(SCRATCH* a, size_t n);
+void scratch_reset(SCRATCH* a);
+
+// calling thread's arena (NULL: none bound -> callers use the heap)
+void scratch_bind(SCRATCH* a);
+SCRATCH* scratch_thread(void);
@@ -0,0 +1,312 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "segment.h"
+#include "event_ring.h"
+#include "gz_deflate.h"
+#include "json_out.h"
+#include "plat.h"
+#include "ts_format.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+// wide path helpers
+// ============================================================
+#ifndef _WIN32
+static int to_mb(const wchar_t* path, char* mb, size_t cap)
+{
+    size_t n = wcstombs(mb, path, cap - 1);
+    if (n == (size_t)-1) return 0;
+    mb[n] = '\0';
+    return 1;
+}
+#endif
+
+FILE* seg_fopen(const wchar_t* path, const char* mode)
+{
+#ifdef _WIN32
+    wchar_t wmode[8];
+    size_t i = 0;
+    for (; mode[i] && i < 7; i++) wmode[i] = (wchar_t)mode[i];
+    wmode[i] = L'\0';
+    return _wfopen(path, wmode);
+#else
+    char mb[SEG_PATH_MAX * 4];
+    if (!to_mb(path, mb, sizeof(mb))) return NULL;
+    return fopen(mb, mode);
+#endif
+}
+
+int seg_remove(const wchar_t* path)
+{
+#ifdef _WIN32
+    return _wremove(path) == 0;
+#else
+    char mb[SEG_PATH_MAX * 4];
+    if (!to_mb(path, mb, sizeof(mb))) return 0;
+    return remove(mb) == 0;
+#endif
+}
+
+// Windows는 rename 대상이 있으면 실패 -> 먼저 지움 (대상은 우리 .tmp 결과물뿐)
+static int seg_rename(const wchar_t* from, const wchar_t* to)
+{
+#ifdef _WIN32
+    _wremove(to);
+    return _wrename(from, to) == 0;
+#else
+    char a[SEG_PATH_MAX * 4], b[SEG_PATH_MAX * 4];
+    if (!to_mb(from, a, sizeof(a)) || !to_mb(to, b, sizeof(b))) return 0;
+    return rename(a, b) == 0;
+#endif
+}
+
+static int file_exists(const wchar_t* path)
+{
+    FILE* fp = seg_fopen(path, "rb");
+    if (!fp) return 0;
+    fclose(fp);
+    return 1;
+}
+
+static const wchar_t* base_name(const wchar_t* path)
+{
+    const wchar_t* b = path;
+    for (const wchar_t* p = path; *p; p++) {
+        if (*p == L'/' || *p == L'\\') b = p + 1;
+    }
+    return b;
+}
+
+// ============================================================
+// names
+// ============================================================
+int seg_path(wchar_t* out, size_t cap, const wchar_t* base, uint32_t seq)
+{
+    // extension = 마지막 '.' (file name 안에서만, 맨 앞 '.'은 제외)
+    const wchar_t* name = base_name(base);
+    const wchar_t* dot = wcsrchr(name, L'.');
+    if (dot == name) dot = NULL;
+    size_t stem_n = dot ? (size_t)(dot - base) : wcslen(base);
+    const wchar_t* ext = dot ? dot : L"";
+
+    wchar_t num[16];
+    swprintf(num, 16, L".%06u", seq);
+
+    if (stem_n + wcslen(num) + wcslen(ext) + 4 > cap) return 0;   // + ".gz" later
+    wmemcpy(out, base, stem_n);
+    out[stem_n] = L'\0';
+    wcscat(out, num);
+    wcscat(out, ext);
+    return 1;
+}
+
+int seg_index_path(wchar_t* out, size_t cap, const wchar_t* base)
+{
+    size_t n = wcslen(base);
+    if (n + 7 > cap) return 0;
+    wmemcpy(out, base, n);
+    wcscpy(out + n, L".index");
+    return 1;
+}
+
+static int gz_path(wchar_t* out, size_t cap, const wchar_t* path, const wchar_t* suffix)
+{
+    size_t n = wcslen(path), k = wcslen(suffix);
+    if (n + k + 1 > cap) return 0;
+    wmemcpy(out, path, n);
+    wcscpy(out + n, suffix);
+    return 1;
+}
+
+// index의 마지막 seq ("seq":N 중 최대)
+static uint32_t index_max_seq(const wchar_t* base)
+{
+    wchar_t ip[SEG_PATH_MAX];
+    if (!seg_index_path(ip, SEG_PATH_MAX, base)) return 0;
+    FILE* fp = seg_fopen(ip, "rb");
+    if (!fp) return 0;
+
+    uint32_t max_seq = 0;
+    char line[4096];
+    while (fgets(line, sizeof(line), fp)) {
+        const char* p = strstr(line, "\"seq\":");
+        if (!p) continue;
+        uint32_t v = (uint32_t)strtoul(p + 6, NULL, 10);
+        if (v > max_seq) max_seq = v;
+    }
+    fclose(fp);
+    return max_seq;
+}
+
+uint32_t seg_next_seq(const wchar_t* base)
+{
+    uint32_t seq = index_max_seq(base) + 1;
+
+    // index에 없는 segment (비정상 종료로 index 기록 전에 끝난 것)는 건너뜀
+    wchar_t p[SEG_PATH_MAX], gz[SEG_PATH_MAX];
+    while (seg_path(p, SEG_PATH_MAX, base, seq) &&
+           (file_exists(p) || (gz_path(gz, SEG_PATH_MAX, p, L".gz") && file_exists(gz)))) {
+        seq++;
+    }
+    return seq;
+}
+
+int seg_index_append(const wchar_t* base, const wchar_t* path, const SEG_INFO* info,
+                     const char* format, int compressed, int ts_digits)
+{
+    wchar_t ip[SEG_PATH_MAX];
+    if (!seg_index_path(ip, SEG_PATH_MAX, base)) return 0;
+
+    const wchar_t* name = base_name(path);
+    size_t name_n = wcslen(name), fmt_n = strlen(format);
+    char* line = (char*)malloc(256 + 2 * TS_ISO_MAX + JSON_WSTR_BOUND(name_n + 3) + JSON_STR_BOUND(fmt_n));
+    if (!line) return 0;
+
+    TS_CACHE tc;
+    ts_cache_init(&tc);
+
+    char* d = line;
+    d = JSON_LIT(d, "{\"seq\":");
+    d = json_put_u32(d, info->seq);
+    d = JSON_LIT(d, ",\"path\":\"");
+    d = json_put_wstr(d, name, name_n);
+    if (compressed) d = JSON_LIT(d, ".gz");
+    d = JSON_LIT(d, "\",\"first_ts\":\"");
+    d += ts_format_filetime(&tc, info->first_ts, ts_digits, d);
+    d = JSON_LIT(d, "\",\"last_ts\":\"");
+    d += ts_format_filetime(&tc, info->last_ts, ts_digits, d);
+    d = JSON_LIT(d, "\",\"records\":");
+    d = json_put_u64(d, info->records);
+    d = JSON_LIT(d, ",\"bytes\":");
+    d = json_put_u64(d, info->bytes);
+    d = JSON_LIT(d, ",\"format\":\"");
+    d = json_put_str(d, format, fmt_n);
+    d = JSON_LIT(d, "\",\"compressed\":");
+    d = compressed ? JSON_LIT(d, "true") : JSON_LIT(d, "false");
+    d = JSON_LIT(d, "}\n");
+
+    int ok = 0;
+    FILE* fp = seg_fopen(ip, "ab");
+    if (fp) {
+        size_t n = (size_t)(d - line);
+        ok = fwrite(line, 1, n, fp) == n;
+        if (fclose(fp) != 0) ok = 0;
+    }
+    free(line);
+    return ok;
+}
+
+// ============================================================
+// background compressor
+// - producer: writer thread (segment close), consumer: compressor thread
+// - x -> x.gz.tmp -> rename x.gz -> remove x
+// ============================================================
+typedef struct SEG_JOB {
+    wchar_t path[SEG_PATH_MAX];
+} SEG_JOB;
+
+static EVENT_RING g_jobs;
+static PLAT_THREAD g_thread;
+static volatile int32_t g_running = 0;
+static volatile int32_t g_stop_req = 0;
+static SEG_STATS g_st;          // queued/skipped: producer, rest: compressor thread
+
+static int compress_one(const wchar_t* path)
+{
+    wchar_t tmp[SEG_PATH_MAX], dst[SEG_PATH_MAX];
+    if (!gz_path(tmp, SEG_PATH_MAX, path, L".gz.tmp") || !gz_path(dst, SEG_PATH_MAX, path, L".gz")) return 0;
+
+    FILE* in = seg_fopen(path, "rb");
+    if (!in) return 0;
+    FILE* out = seg_fopen(tmp, "wb");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+
+    GZ_RESULT res;
+    int ok = gz_compress_stream(in, out, &res);
+    fclose(in);
+    if (fclose(out) != 0) ok = 0;
+
+    // rename이 끝나기 전까지 원본을 지우지 않음 (reader는 둘 중 하나를 항상 봄)
+    if (!ok || !seg_rename(tmp, dst)) {
+        seg_remove(tmp);
+        return 0;
+    }
+    seg_remove(path);
+
+    g_st.bytes_in += res.in_bytes;
+    g_st.bytes_out += res.out_bytes;
+    return 1;
+}
+
+static void compressor_main(void* arg)
+{
+    (void)arg;
+    for (;;) {
+        SEG_JOB* job = (SEG_JOB*)ring_peek(&g_jobs);
+        if (job) {
+            if (compress_one(job->path)) g_st.compressed++;
+            else g_st.failed++;
+            ring_release(&g_jobs);
+            continue;
+        }
+        if (plat_load_i32(&g_stop_req)) {
+            if (ring_is_empty(&g_jobs)) break;
+            continue;
+        }
+        // segment는 분 단위로 닫히므로 느긋하게 poll
+        plat_sleep_ms(50);
+    }
+}
+
+int seg_compressor_start(uint32_t queue_cap)
+{
+    if (plat_load_i32(&g_running)) return 1;
+
+    size_t cap = 1;
+    while (cap < queue_cap) cap <<= 1;
+    if (!ring_init(&g_jobs, sizeof(SEG_JOB), cap, RING_FULL_DROP_NEWEST, 0)) return 0;
+
+    memset(&g_st, 0, sizeof(g_st));
+    plat_store_i32(&g_stop_req, 0);
+    if (!plat_thread_start(&g_thread, compressor_main, NULL)) {
+        ring_free(&g_jobs);
+        return 0;
+    }
+    plat_store_i32(&g_running, 1);
+    return 1;
+}
+
+int seg_compress_async(const wchar_t* path)
+{
+    if (!plat_load_i32(&g_running) || wcslen(path) >= SEG_PATH_MAX) return 0;
+
+    SEG_JOB* job = (SEG_JOB*)ring_reserve(&g_jobs);
+    if (!job) {
+        g_st.skipped++;
+        return 0;
+    }
+    wcscpy(job->path, path);
+    ring_commit(&g_jobs);
+    g_st.queued++;
+    return 1;
+}
+
+void seg_compressor_stop(void)
+{
+    if (!plat_load_i32(&g_running)) return;
+
+    plat_store_i32(&g_running, 0);
+    plat_store_i32(&g_stop_req, 1);
+    plat_thread_join(g_thread);
+    ring_close(&g_jobs);
+    ring_free(&g_jobs);
+}
+
+void seg_get_stats(SEG_STATS* out)
+{
+    if (out) *out = g_st;
+}
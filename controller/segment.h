@@ -0,0 +1,62 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <wchar.h>
+
+// ============================================================
+// Output segments (jsonl_writer rotation)
+//
+// base "dir/telemetry-raw.jsonl" ->
+//   dir/telemetry-raw.000001.jsonl      segment (active or closed)
+//   dir/telemetry-raw.000001.jsonl.gz   closed + compressed (source removed)
+//   dir/telemetry-raw.jsonl.index       one JSON line per closed segment:
+//     {"seq":1,"path":"telemetry-raw.000001.jsonl.gz","first_ts":"..","last_ts":"..",
+//      "records":N,"bytes":N,"format":"text","compressed":true}
+//
+// - index line is written when the segment is closed, before compression
+//   finishes: readers fall back to the uncompressed name while .gz is missing
+// - compression runs on its own thread (gz_deflate.h), fed by an SPSC ring;
+//   queue full -> segment simply stays uncompressed (writer never waits)
+// - portable
+// ============================================================
+
+#define SEG_PATH_MAX 1024
+
+typedef struct SEG_INFO {
+    uint32_t seq;
+    uint64_t first_ts;      // FILETIME 100ns, min/max over the segment's events
+    uint64_t last_ts;
+    uint64_t records;       // events
+    uint64_t bytes;         // uncompressed
+} SEG_INFO;
+
+typedef struct SEG_STATS {
+    uint64_t queued;
+    uint64_t compressed;
+    uint64_t failed;        // left uncompressed
+    uint64_t skipped;       // queue full, left uncompressed
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+} SEG_STATS;
+
+// wide path fopen (Windows: _wfopen, POSIX: wcstombs + fopen)
+FILE* seg_fopen(const wchar_t* path, const char* mode);
+int seg_remove(const wchar_t* path);
+
+// 성공: 1, 실패(path too long): 0
+int seg_path(wchar_t* out, size_t cap, const wchar_t* base, uint32_t seq);
+int seg_index_path(wchar_t* out, size_t cap, const wchar_t* base);
+
+// first seq after everything in the index / on disk (1 for a fresh base)
+uint32_t seg_next_seq(const wchar_t* base);
+
+// append the closed segment's line to the index. 성공: 1, 실패: 0
+int seg_index_append(const wchar_t* base, const wchar_t* path, const SEG_INFO* info,
+                     const char* format, int compressed, int ts_digits);
+
+// background compressor (one per process)
+int seg_compressor_start(uint32_t queue_cap);       // 성공: 1, 실패: 0
+int seg_compress_async(const wchar_t* path);        // 1: queued, 0: not queued
+void seg_compressor_stop(void);                     // finishes queued segments
+void seg_get_stats(SEG_STATS* out);                 // exact after stop
@@ -1,6 +1,7 @@
 #define _CRT_SECURE_NO_WARNINGS
 #define WIN32_LEAN_AND_MEAN
 #include "tdh_reader.h"
+#include "scratch.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,7 +12,19 @@ DWORD tdh_last_error(void) { return g_last_err; }
 
 static void set_err(DWORD e) { g_last_err = e; }
 
-// TRACE_EVENT_INFO 로드
+// 임시 buffer: pipeline의 decoding thread면 scratch arena (event 끝에 reset), 아니면 heap
+static void* tmp_alloc(size_t size)
+{
+    SCRATCH* a = scratch_thread();
+    return a ? scratch_alloc(a, size) : malloc(size);
+}
+
+static void tmp_free(void* p)
+{
+    if (!scratch_thread()) free(p);
+}
+
+// TRACE_EVENT_INFO 로드 (cache miss 때만 호출됨)
 static PTRACE_EVENT_INFO load_event_info(PEVENT_RECORD ev, ULONG* out_size)
 {
     *out_size = 0;
@@ -24,7 +37,7 @@ static PTRACE_EVENT_INFO load_event_info(PEVENT_RECORD ev, ULONG* out_size)
         return NULL;
     }
 
-    PTRACE_EVENT_INFO info = (PTRACE_EVENT_INFO)malloc(size);
+    PTRACE_EVENT_INFO info = (PTRACE_EVENT_INFO)tmp_alloc(size);
     if (!info) {
         set_err(ERROR_OUTOFMEMORY);
         return NULL;
@@ -32,7 +45,7 @@ static PTRACE_EVENT_INFO load_event_info(PEVENT_RECORD ev, ULONG* out_size)
 
     status = TdhGetEventInformation(ev, 0, NULL, info, &size);
     if (status != ERROR_SUCCESS) {
-        free(info);
+        tmp_free(info);
         set_err(status);
         return NULL;
     }
@@ -41,32 +54,74 @@ static PTRACE_EVENT_INFO load_event_info(PEVENT_RECORD ev, ULONG* out_size)
     return info;
 }
 
-// property name -> index
-static int find_prop_index(PTRACE_EVENT_INFO info, const wchar_t* prop_name, ULONG* out_index)
-{
-    if (!info || !prop_name) return 0;
+// ============================================================
+// Schema cache: provider/id/opcode/version -> parsed metadata
+// ============================================================
+static SCHEMA_CACHE g_schemas;
+static int g_schemas_ready = 0;
 
-    USHORT count = info->TopLevelPropertyCount;
-    PEVENT_PROPERTY_INFO arr = (PEVENT_PROPERTY_INFO)((PBYTE)info + sizeof(TRACE_EVENT_INFO));
+static void make_schema_key(PEVENT_RECORD ev, SCHEMA_KEY* key)
+{
+    ZeroMemory(key, sizeof(*key));
+    memcpy(key->provider, &ev->EventHeader.ProviderId, sizeof(key->provider));
+    key->id = ev->EventHeader.EventDescriptor.Id;
+    key->opcode = ev->EventHeader.EventDescriptor.Opcode;
+    key->version = ev->EventHeader.EventDescriptor.Version;
+    key->ptr64 = (ev->EventHeader.Flags & EVENT_HEADER_FLAG_64_BIT_HEADER) ? 1 : 0;
+}
 
-    for (USHORT i = 0; i < count; i++) {
-        ULONG off = arr[i].NameOffset;
-        if (!off) continue;
+const SCHEMA_ENTRY* tdh_schema_get(PEVENT_RECORD ev)
+{
+    if (!ev) return NULL;
 
-        const wchar_t* name = (const wchar_t*)((PBYTE)info + off);
-        if (name && _wcsicmp(name, prop_name) == 0) {
-            *out_index = i;
-            return 1;
+    if (!g_schemas_ready) {
+        if (!schema_cache_init(&g_schemas, 64)) {
+            set_err(ERROR_OUTOFMEMORY);
+            return NULL;
         }
+        g_schemas_ready = 1;
     }
-    return 0;
+
+    SCHEMA_KEY key;
+    make_schema_key(ev, &key);
+
+    SCHEMA_ENTRY* e = schema_cache_find(&g_schemas, &key);
+    if (e) return e;
+
+    ULONG info_sz = 0;
+    PTRACE_EVENT_INFO info = load_event_info(ev, &info_sz);
+    if (!info) return NULL;
+
+    // EVENT_PROPERTY_INFO -> SCHEMA_PROP (portable view, schema_cache.c)
+    e = schema_cache_insert_info(&g_schemas, &key, info, info_sz);
+    tmp_free(info);
+
+    if (!e) set_err(ERROR_OUTOFMEMORY);
+    return e;
+}
+
+void tdh_reader_shutdown(void)
+{
+    if (!g_schemas_ready) return;
+    schema_cache_free(&g_schemas);
+    g_schemas_ready = 0;
+}
+
+const wchar_t* tdh_schema_task_name(const SCHEMA_ENTRY* e)
+{
+    return (const wchar_t*)schema_blob_wstr(e, e ? e->task_name_offset : 0);
+}
+
+const wchar_t* tdh_schema_opcode_name(const SCHEMA_ENTRY* e)
+{
+    return (const wchar_t*)schema_blob_wstr(e, e ? e->opcode_name_offset : 0);
 }
 
 // TDH Property 데이터 가져오기 (raw bytes)
 static int get_property_bytes(
     PEVENT_RECORD ev,
-    PTRACE_EVENT_INFO info,
-    ULONG prop_index,
+    const SCHEMA_ENTRY* schema,
+    uint16_t prop_index,
     PBYTE* out_buf,
     ULONG* out_len
 ){
@@ -76,8 +131,12 @@ static int get_property_bytes(
 
     PROPERTY_DATA_DESCRIPTOR desc;
     ZeroMemory(&desc, sizeof(desc));
-    desc.PropertyName = (ULONGLONG)((PBYTE)info + ((PEVENT_PROPERTY_INFO)((PBYTE)info + sizeof(TRACE_EVENT_INFO)))[prop_index].NameOffset);
+    desc.PropertyName = (ULONGLONG)schema_blob_wstr(schema, schema->props[prop_index].name_offset);
     desc.ArrayIndex = ULONG_MAX; // not array index
+    if (!desc.PropertyName) {
+        set_err(ERROR_NOT_FOUND);
+        return 0;
+    }
 
     ULONG size = 0;
     ULONG status = TdhGetPropertySize(ev, 0, NULL, 1, &desc, &size);
@@ -86,7 +145,7 @@ static int get_property_bytes(
         return 0;
     }
 
-    PBYTE buf = (PBYTE)malloc(size);
+    PBYTE buf = (PBYTE)tmp_alloc(size);
     if (!buf) {
         set_err(ERROR_OUTOFMEMORY);
         return 0;
@@ -95,7 +154,7 @@ static int get_property_bytes(
 
     status = TdhGetProperty(ev, 0, NULL, 1, &desc, size, buf);
     if (status != ERROR_SUCCESS) {
-        free(buf);
+        tmp_free(buf);
         set_err(status);
         return 0;
     }
@@ -106,210 +165,138 @@ static int get_property_bytes(
 }
 
 // property의 InType 확인
-static int get_in_type(PTRACE_EVENT_INFO info, ULONG prop_index, USHORT* out_inType)
+static int get_in_type(const SCHEMA_ENTRY* schema, uint16_t prop_index, USHORT* out_inType)
 {
-    PEVENT_PROPERTY_INFO arr = (PEVENT_PROPERTY_INFO)((PBYTE)info + sizeof(TRACE_EVENT_INFO));
-    PEVENT_PROPERTY_INFO p = &arr[prop_index];
+    const SCHEMA_PROP* p = &schema->props[prop_index];
 
-    if (p->Flags & PropertyStruct) {
+    if (p->is_struct) {
         return 0; // struct는 여기서 처리 안 함
     }
 
-    *out_inType = p->nonStructType.InType;
+    *out_inType = p->in_type;
     return 1;
 }
 
-int tdh_read_uint32(PEVENT_RECORD ev, const wchar_t* prop_name, uint32_t* out)
+// name -> (schema, index). 이름 비교는 cache된 blob 위에서만 함
+static const SCHEMA_ENTRY* resolve_name(PEVENT_RECORD ev, const wchar_t* prop_name, uint16_t* out_idx)
 {
-    if (!ev || !prop_name || !out) return 0;
+    const SCHEMA_ENTRY* schema = tdh_schema_get(ev);
+    if (!schema) return NULL;
 
-    ULONG info_sz = 0;
-    PTRACE_EVENT_INFO info = load_event_info(ev, &info_sz);
-    if (!info) return 0;
-
-    ULONG idx = 0;
-    if (!find_prop_index(info, prop_name, &idx)) {
-        free(info);
+    uint16_t idx = schema_find_prop(schema, (const uint16_t*)prop_name);
+    if (idx == SCHEMA_PROP_NONE) {
         set_err(ERROR_NOT_FOUND);
-        return 0;
-    }
-
-    PBYTE buf = NULL;
-    ULONG len = 0;
-    if (!get_property_bytes(ev, info, idx, &buf, &len)) {
-        free(info);
-        return 0;
-    }
-
-    if (len < sizeof(uint32_t)) {
-        free(buf);
-        free(info);
-        set_err(ERROR_INVALID_DATA);
-        return 0;
-    }
-
-    // 타입 확인(가능하면)
-    USHORT inType = 0;
-    if (get_in_type(info, idx, &inType)) {
-        if (!(inType == TDH_INTYPE_UINT32 || inType == TDH_INTYPE_INT32)) {
-            // 그래도 len>=4면 읽기는 가능, 하지만 타입 mismatch는 알려두자
-            // (확장기에서 조정 가능)
-        }
+        return NULL;
     }
-
-    memcpy(out, buf, sizeof(uint32_t));
-    free(buf);
-    free(info);
-    set_err(ERROR_SUCCESS);
-    return 1;
+    *out_idx = idx;
+    return schema;
 }
 
-int tdh_read_uint64(PEVENT_RECORD ev, const wchar_t* prop_name, uint64_t* out)
+static const SCHEMA_ENTRY* resolve_field(PEVENT_RECORD ev, SCHEMA_FIELD field, uint16_t* out_idx)
 {
-    if (!ev || !prop_name || !out) return 0;
+    if ((unsigned)field >= SF_COUNT) return NULL;
 
-    ULONG info_sz = 0;
-    PTRACE_EVENT_INFO info = load_event_info(ev, &info_sz);
-    if (!info) return 0;
+    const SCHEMA_ENTRY* schema = tdh_schema_get(ev);
+    if (!schema) return NULL;
 
-    ULONG idx = 0;
-    if (!find_prop_index(info, prop_name, &idx)) {
-        free(info);
+    uint16_t idx = schema->field_index[field];
+    if (idx == SCHEMA_PROP_NONE) {
         set_err(ERROR_NOT_FOUND);
-        return 0;
+        return NULL;
     }
+    *out_idx = idx;
+    return schema;
+}
 
+static int read_fixed(PEVENT_RECORD ev, const SCHEMA_ENTRY* schema, uint16_t idx, void* out, ULONG need)
+{
     PBYTE buf = NULL;
     ULONG len = 0;
-    if (!get_property_bytes(ev, info, idx, &buf, &len)) {
-        free(info);
-        return 0;
-    }
+    if (!get_property_bytes(ev, schema, idx, &buf, &len)) return 0;
 
-    if (len < sizeof(uint64_t)) {
-        free(buf);
-        free(info);
+    if (len < need) {
+        tmp_free(buf);
         set_err(ERROR_INVALID_DATA);
         return 0;
     }
 
-    memcpy(out, buf, sizeof(uint64_t));
-    free(buf);
-    free(info);
+    memcpy(out, buf, need);
+    tmp_free(buf);
     set_err(ERROR_SUCCESS);
     return 1;
 }
 
-int tdh_read_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wchar_t* out, size_t out_wcap)
+static int read_wstring_at(PEVENT_RECORD ev, const SCHEMA_ENTRY* schema, uint16_t idx,
+                           wchar_t* out, size_t out_wcap)
 {
-    if (!ev || !prop_name || !out || out_wcap == 0) return 0;
-    out[0] = L'\0';
-
-    ULONG info_sz = 0;
-    PTRACE_EVENT_INFO info = load_event_info(ev, &info_sz);
-    if (!info) return 0;
-
-    ULONG idx = 0;
-    if (!find_prop_index(info, prop_name, &idx)) {
-        free(info);
-        set_err(ERROR_NOT_FOUND);
-        return 0;
-    }
-
     // 타입 확인: UNICODESTRING 인지 먼저 확인해보자
     USHORT inType = 0;
-    int hasType = get_in_type(info, idx, &inType);
-
-    PBYTE buf = NULL;
-    ULONG len = 0;
-    if (!get_property_bytes(ev, info, idx, &buf, &len)) {
-        free(info);
-        return 0;
-    }
+    int hasType = get_in_type(schema, idx, &inType);
 
     if (hasType && inType == TDH_INTYPE_ANSISTRING) {
         // ANSI면 변환 함수로 유도
-        free(buf);
-        free(info);
         set_err(ERROR_INVALID_DATATYPE);
         return 0;
     }
 
+    PBYTE buf = NULL;
+    ULONG len = 0;
+    if (!get_property_bytes(ev, schema, idx, &buf, &len)) return 0;
+
     // TDH는 문자열을 보통 null-terminated wide로 줌(이벤트에 따라 len이 바이트 단위)
     // len이 wchar_t의 배수 아닐 수도 있으니 안전 처리
     size_t wchar_count = len / sizeof(wchar_t);
 
     // 최소 1 wchar라도 없으면 실패
     if (wchar_count == 0) {
-        free(buf);
-        free(info);
+        tmp_free(buf);
         set_err(ERROR_INVALID_DATA);
         return 0;
     }
 
     const wchar_t* ws = (const wchar_t*)buf;
 
-    // out_wcap-1만 복사 후 널 종료
-    wcsncpy(out, ws, out_wcap - 1);
-    out[out_wcap - 1] = L'\0';
+    // out_wcap-1만 복사 후 널 종료 (buffer 끝을 넘지 않게 wchar_count로도 제한)
+    size_t n = wchar_count < out_wcap - 1 ? wchar_count : out_wcap - 1;
+    wcsncpy(out, ws, n);
+    out[n] = L'\0';
 
-    free(buf);
-    free(info);
+    tmp_free(buf);
     set_err(ERROR_SUCCESS);
     return 1;
 }
 
-int tdh_read_astring_to_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wchar_t* out, size_t out_wcap)
+static int read_astring_at(PEVENT_RECORD ev, const SCHEMA_ENTRY* schema, uint16_t idx,
+                           wchar_t* out, size_t out_wcap)
 {
-    if (!ev || !prop_name || !out || out_wcap == 0) return 0;
-    out[0] = L'\0';
-
-    ULONG info_sz = 0;
-    PTRACE_EVENT_INFO info = load_event_info(ev, &info_sz);
-    if (!info) return 0;
-
-    ULONG idx = 0;
-    if (!find_prop_index(info, prop_name, &idx)) {
-        free(info);
-        set_err(ERROR_NOT_FOUND);
-        return 0;
-    }
-
     USHORT inType = 0;
-    int hasType = get_in_type(info, idx, &inType);
-
-    PBYTE buf = NULL;
-    ULONG len = 0;
-    if (!get_property_bytes(ev, info, idx, &buf, &len)) {
-        free(info);
-        return 0;
-    }
+    int hasType = get_in_type(schema, idx, &inType);
 
     if (hasType && inType != TDH_INTYPE_ANSISTRING) {
         // ANSI가 아닌데 여기로 들어왔으면 mismatch
         // 그래도 변환 시도는 가능하지만 일단 실패 처리
-        free(buf);
-        free(info);
         set_err(ERROR_INVALID_DATATYPE);
         return 0;
     }
 
+    PBYTE buf = NULL;
+    ULONG len = 0;
+    if (!get_property_bytes(ev, schema, idx, &buf, &len)) return 0;
+
     // buf는 null-terminated ANSI 문자열일 가능성이 큼
     const char* s = (const char*)buf;
     // len이 바이트이지만, null-termination 보장 안 될 수 있으니 안전하게 복사
     // MultiByteToWideChar는 null을 만나면 stop하므로, 여기서는 길이 기반으로 변환
     int src_len = (int)len;
     if (src_len <= 0) {
-        free(buf);
-        free(info);
+        tmp_free(buf);
         set_err(ERROR_INVALID_DATA);
         return 0;
     }
 
     int needed = MultiByteToWideChar(CP_ACP, 0, s, src_len, NULL, 0);
     if (needed <= 0) {
-        free(buf);
-        free(info);
+        tmp_free(buf);
         set_err(GetLastError());
         return 0;
     }
@@ -318,15 +305,93 @@ int tdh_read_astring_to_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wcha
     int to_write = (needed < (int)out_wcap - 1) ? needed : (int)out_wcap - 1;
     int written = MultiByteToWideChar(CP_ACP, 0, s, src_len, out, to_write);
     if (written <= 0) {
-        free(buf);
-        free(info);
+        tmp_free(buf);
         set_err(GetLastError());
         return 0;
     }
     out[written] = L'\0';
 
-    free(buf);
-    free(info);
+    tmp_free(buf);
     set_err(ERROR_SUCCESS);
     return 1;
 }
+
+// ============================================================
+// name-based API
+// ============================================================
+int tdh_read_uint32(PEVENT_RECORD ev, const wchar_t* prop_name, uint32_t* out)
+{
+    if (!ev || !prop_name || !out) return 0;
+
+    uint16_t idx = 0;
+    const SCHEMA_ENTRY* schema = resolve_name(ev, prop_name, &idx);
+    if (!schema) return 0;
+
+    return read_fixed(ev, schema, idx, out, sizeof(uint32_t));
+}
+
+int tdh_read_uint64(PEVENT_RECORD ev, const wchar_t* prop_name, uint64_t* out)
+{
+    if (!ev || !prop_name || !out) return 0;
+
+    uint16_t idx = 0;
+    const SCHEMA_ENTRY* schema = resolve_name(ev, prop_name, &idx);
+    if (!schema) return 0;
+
+    return read_fixed(ev, schema, idx, out, sizeof(uint64_t));
+}
+
+int tdh_read_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wchar_t* out, size_t out_wcap)
+{
+    if (!ev || !prop_name || !out || out_wcap == 0) return 0;
+    out[0] = L'\0';
+
+    uint16_t idx = 0;
+    const SCHEMA_ENTRY* schema = resolve_name(ev, prop_name, &idx);
+    if (!schema) return 0;
+
+    return read_wstring_at(ev, schema, idx, out, out_wcap);
+}
+
+int tdh_read_astring_to_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wchar_t* out, size_t out_wcap)
+{
+    if (!ev || !prop_name || !out || out_wcap == 0) return 0;
+    out[0] = L'\0';
+
+    uint16_t idx = 0;
+    const SCHEMA_ENTRY* schema = resolve_name(ev, prop_name, &idx);
+    if (!schema) return 0;
+
+    return read_astring_at(ev, schema, idx, out, out_wcap);
+}
+
+// ============================================================
+// field-based API (index resolved once per schema)
+// ============================================================
+int tdh_read_field_u32(PEVENT_RECORD ev, SCHEMA_FIELD field, uint32_t* out)
+{
+    if (!ev || !out) return 0;
+
+    uint16_t idx = 0;
+    const SCHEMA_ENTRY* schema = resolve_field(ev, field, &idx);
+    if (!schema) return 0;
+
+    return read_fixed(ev, schema, idx, out, sizeof(uint32_t));
+}
+
+int tdh_read_field_wstring(PEVENT_RECORD ev, SCHEMA_FIELD field, wchar_t* out, size_t out_wcap)
+{
+    if (!ev || !out || out_wcap == 0) return 0;
+    out[0] = L'\0';
+
+    uint16_t idx = 0;
+    const SCHEMA_ENTRY* schema = resolve_field(ev, field, &idx);
+    if (!schema) return 0;
+
+    // kernel ImageFileName 같은 ANSI 필드도 여기서 같이 처리
+    USHORT inType = 0;
+    if (get_in_type(schema, idx, &inType) && inType == TDH_INTYPE_ANSISTRING) {
+        return read_astring_at(ev, schema, idx, out, out_wcap);
+    }
+    return read_wstring_at(ev, schema, idx, out, out_wcap);
+}
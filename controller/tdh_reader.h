@@ -6,6 +6,8 @@
 #include <tdh.h>
 #include <stdint.h>
 
+#include "schema_cache.h"
+
 // 성공: 1, 실패: 0
 int tdh_read_uint32(PEVENT_RECORD ev, const wchar_t* prop_name, uint32_t* out);
 int tdh_read_uint64(PEVENT_RECORD ev, const wchar_t* prop_name, uint64_t* out);
@@ -17,5 +19,18 @@ int tdh_read_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wchar_t* out, s
 // ANSI 문자열을 wide로 변환해서 반환
 int tdh_read_astring_to_wstring(PEVENT_RECORD ev, const wchar_t* prop_name, wchar_t* out, size_t out_wcap);
 
+// cached schema (TRACE_EVENT_INFO + resolved field indices). NULL on failure
+const SCHEMA_ENTRY* tdh_schema_get(PEVENT_RECORD ev);
+const wchar_t* tdh_schema_task_name(const SCHEMA_ENTRY* schema);
+const wchar_t* tdh_schema_opcode_name(const SCHEMA_ENTRY* schema);
+
+// alias 목록으로 미리 resolve된 필드 읽기 (성공: 1, 실패: 0)
+int tdh_read_field_u32(PEVENT_RECORD ev, SCHEMA_FIELD field, uint32_t* out);
+// UNICODE/ANSI 둘 다 wide로
+int tdh_read_field_wstring(PEVENT_RECORD ev, SCHEMA_FIELD field, wchar_t* out, size_t out_wcap);
+
+// schema cache 해제 (consumer 종료 시)
+void tdh_reader_shutdown(void);
+
 // 디버깅
 DWORD tdh_last_error(void);
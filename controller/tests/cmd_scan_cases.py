@@ -0,0 +1,108 @@
+"""
+Cases for test_cmd_scan.c: random cmdlines with the analyzer's answers (enrich.py).
+
+  python3 cmd_scan_cases.py [count] [seed] > cmd_scan_cases.txt
+
+One line per case: "<base64_sus> <cmd_flags bits> <risk_path_tier> <UTF-16 units, hex>".
+The units are what the collector scans; the answers come from the text the analyzer
+gets after the JSON round trip (json_out.c: lone surrogates -> U+FFFD).
+"""
+import random
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2] / "analyzer"))
+
+from minisysmon.enrich import BASE64_LIKE, CMD_FLAG_KEYWORDS, _tier_from_image  # noqa: E402
+
+B64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+
+# units next to a run decide \b: ASCII word / non-word, and non-ASCII of both kinds
+# (Python \w: letters / digits of any script; not NBSP, U+2028, marks, symbols, emoji)
+BOUNDARY = [
+    " ", "\t", "\"", "'", "-", "_", ".", ",", ":", "\\", "=", "==", "+", "/", "a", "Z", "7",
+    "\u00a0", "\u2028", "\u3000", "\u00e9", "\u00b2", "\u0430", "\u4e2d", "\u0663", "\u0307",
+    "\u2122", "\ufffd", "\ufeff", "\u212a", "\u0130", "\u017f", "\u0131",
+    "\U0001f600", "\U0001d400", "\U0001d7ce",
+    "\ud800", "\udc00",         # lone surrogates (U+FFFD for the analyzer)
+]
+
+PATH_HINTS = [
+    "\\Users\\alice\\AppData\\Local\\Temp\\", "\\Users\\bob\\Downloads\\", "\\Users\\x\\Desktop\\",
+    "\\AppData\\Roaming\\", "\\Windows\\System32\\", "\\Program Files\\", "\\Program Files (x86)\\",
+]
+
+# spellings str.lower() / re.IGNORECASE treat as the ASCII letter (or not)
+CASE_TWISTS = {"k": "\u212a", "s": "\u017f", "i": "\u0131"}
+
+
+def twist(s: str, rng: random.Random) -> str:
+    out = []
+    for ch in s:
+        r = rng.random()
+        if r < 0.3:
+            ch = ch.upper()
+        elif r < 0.36 and ch.lower() in CASE_TWISTS:
+            ch = CASE_TWISTS[ch.lower()]
+        elif r < 0.38 and ch.lower() == "i":
+            ch = "\u0130"
+        out.append(ch)
+    return "".join(out)
+
+
+def piece(rng: random.Random) -> str:
+    r = rng.random()
+    if r < 0.35:
+        # run around the 120 threshold, '+' '/' at its edges now and then
+        n = rng.choice((rng.randint(110, 130), rng.randint(119, 122), rng.randint(1, 20)))
+        run = [rng.choice(B64[:62]) for _ in range(n)]
+        for k in (0, 1, n - 2, n - 1):
+            if 0 <= k < n and rng.random() < 0.15:
+                run[k] = rng.choice("+/")
+        return rng.choice(BOUNDARY) + "".join(run) + rng.choice(("", "=", "==")) + rng.choice(BOUNDARY)
+    if r < 0.55:
+        return twist(rng.choice(CMD_FLAG_KEYWORDS), rng)
+    if r < 0.65:
+        return twist(rng.choice(PATH_HINTS), rng)
+    if r < 0.8:
+        return rng.choice(BOUNDARY)
+    return "".join(rng.choice(B64 + " -_=\\.\"") for _ in range(rng.randint(1, 12)))
+
+
+def utf16_units(s: str) -> list:
+    b = s.encode("utf-16-le", "surrogatepass")
+    return [b[i] | b[i + 1] << 8 for i in range(0, len(b), 2)]
+
+
+def analyzer_view(s: str) -> str:
+    return "".join("\ufffd" if 0xD800 <= ord(ch) <= 0xDFFF else ch for ch in s)
+
+
+def case_line(s: str) -> str:
+    t = analyzer_view(s)
+    low = t.lower()
+    flags = sum(1 << i for i, kw in enumerate(CMD_FLAG_KEYWORDS) if kw in low)
+    b64 = 1 if BASE64_LIKE.search(t) else 0
+    units = " ".join("%x" % u for u in utf16_units(s))
+    return f"{b64} {flags} {_tier_from_image(t)} {units}"
+
+
+def main():
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 20000
+    rng = random.Random(int(sys.argv[2]) if len(sys.argv) > 2 else 1)
+
+    fixed = []
+    run = "QUJD" * 30
+    for b in BOUNDARY:
+        fixed += [b + run + b, "x" + run + b, b + run + "x", b + run + "=" + b, b + run + "==" + b, b + run]
+    fixed += ["p" + run[:119] + "\u00a0", "\u00a0" + run[:119] + "+\u00a0", "invo\u212ae-expression", "C:\\Users\\a\\De\u017fktop\\x.exe"]
+    out = sys.stdout
+    for s in fixed:
+        out.write(case_line(s) + "\n")
+    for _ in range(count):
+        s = "".join(piece(rng) for _ in range(rng.randint(1, 6)))
+        out.write(case_line(s) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+// ============================================================
+// bin_format: crc32 / dictionary / wstr against references (Linux / any POSIX)
+//   cc -O2 -Wall -I.. -fshort-wchar test_bin_format.c ../bin_format.c ../json_out.c -o test_bin_format
+//   cc -O2 -Wall -I.. -fshort-wchar -mpclmul -msse4.1 test_bin_format.c ../bin_format.c ../json_out.c -o test_bin_format
+//   cc -O2 -Wall -I.. test_bin_format.c ../bin_format.c ../json_out.c -o test_bin_format     (UTF-32 wchar_t)
+//   ./test_bin_format      (exit 0: all checks passed)
+// - bin_crc32 (slicing-by-8, PCLMULQDQ fold with -mpclmul) vs bit-at-a-time CRC-32:
+//   every length 0..1100 at every alignment, and chained (crc of a split == crc of the whole)
+// - bin_dict_intern: same string -> same id, strings that differ in one unit / length -> new ids
+// - bin_put_wstr: varint length matches the UTF-8 bytes after it (ASCII guess wrong or right)
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "bin_format.h"
+#include "json_out.h"
+
+static int g_fail = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); g_fail++; } \
+} while (0)
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+static uint32_t ref_crc32(uint32_t crc, const uint8_t* p, size_t n)
+{
+    uint32_t c = ~crc;
+    while (n--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    return ~c;
+}
+
+static void test_crc(void)
+{
+    static uint8_t buf[1200];
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)rng();
+
+    CHECK(bin_crc32(0, "123456789", 9) == 0xCBF43926u);    // CRC-32/ISO-HDLC check value
+
+    int bad = 0;
+    for (size_t off = 0; off < 16; off++) {
+        for (size_t n = 0; n + off <= 1100; n++) {
+            if (bin_crc32(7, buf + off, n) != ref_crc32(7, buf + off, n)) bad++;
+        }
+    }
+    CHECK(bad == 0);
+
+    bad = 0;
+    for (int it = 0; it < 2000; it++) {
+        size_t n = (size_t)(rng() % 1100);
+        size_t k = n ? (size_t)(rng() % n) : 0;
+        if (bin_crc32(bin_crc32(0, buf, k), buf + k, n - k) != bin_crc32(0, buf, n)) bad++;
+    }
+    CHECK(bad == 0);
+}
+
+static void test_dict(void)
+{
+    BIN_DICT d;
+    CHECK(bin_dict_init(&d, 4096));
+
+    // 길이 1..63, 마지막 unit 또는 길이만 다른 문자열들 (word 단위 hash의 꼬리 처리)
+    static wchar_t s[64];
+    for (int i = 0; i < 64; i++) s[i] = (wchar_t)(L'a' + i % 26);
+    uint32_t ids[64][2];
+    int is_new;
+    for (size_t n = 1; n < 64; n++) {
+        ids[n][0] = bin_dict_intern(&d, s, n, &is_new);
+        CHECK(is_new && ids[n][0] == (uint32_t)(2 * n - 1));
+        wchar_t keep = s[n - 1];
+        s[n - 1] = (wchar_t)0x4E2D;
+        ids[n][1] = bin_dict_intern(&d, s, n, &is_new);
+        CHECK(is_new && ids[n][1] == (uint32_t)(2 * n));
+        s[n - 1] = keep;
+    }
+    for (size_t n = 1; n < 64; n++) {
+        CHECK(bin_dict_intern(&d, s, n, &is_new) == ids[n][0] && !is_new);
+        wchar_t keep = s[n - 1];
+        s[n - 1] = (wchar_t)0x4E2D;
+        CHECK(bin_dict_intern(&d, s, n, &is_new) == ids[n][1] && !is_new);
+        s[n - 1] = keep;
+    }
+
+    // random paths, then all of them again
+    static wchar_t pool[2000][24];
+    static uint32_t pid[2000];
+    for (int i = 0; i < 2000; i++) {
+        for (int k = 0; k < 24; k++) pool[i][k] = (wchar_t)(L'A' + rng() % 40);
+        pid[i] = bin_dict_intern(&d, pool[i], 24, &is_new);
+        CHECK(pid[i] != 0);
+    }
+    int bad = 0;
+    for (int i = 0; i < 2000; i++) {
+        if (bin_dict_intern(&d, pool[i], 24, &is_new) != pid[i] || is_new) bad++;
+    }
+    CHECK(bad == 0);
+    bin_dict_free(&d);
+}
+
+static uint64_t get_varint(const char** p)
+{
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = (uint8_t)*(*p)++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return v;
+    }
+}
+
+static void test_wstr(void)
+{
+    static wchar_t s[400];
+    static char out[BIN_WSTR_BOUND(400)];
+    static char want[400 * 4];
+    int bad = 0;
+    for (size_t n = 0; n < 400; n++) {
+        for (int mode = 0; mode < 3; mode++) {
+            // ASCII, one wide unit (varint grows at 128 bytes), all wide
+            for (size_t i = 0; i < n; i++) s[i] = (wchar_t)(L'a' + i % 26);
+            if (mode == 1 && n) s[rng() % n] = (wchar_t)0x00E9;
+            if (mode == 2) for (size_t i = 0; i < n; i++) s[i] = (wchar_t)0x4E2D;
+
+            size_t wn = (size_t)(json_put_wstr_utf8(want, s, n) - want);
+            char* end = bin_put_wstr(out, s, n);
+            const char* p = out;
+            uint64_t len = get_varint(&p);
+            if (len != wn || (size_t)(end - p) != wn || memcmp(p, want, wn) != 0) bad++;
+        }
+    }
+    CHECK(bad == 0);
+}
+
+int main(void)
+{
+    test_crc();
+    test_dict();
+    test_wstr();
+
+    if (g_fail) {
+        fprintf(stderr, "%d check(s) failed\n", g_fail);
+        return 1;
+    }
+    fprintf(stderr, "all checks passed\n");
+    return 0;
+}
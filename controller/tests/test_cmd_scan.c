@@ -0,0 +1,111 @@
+// ============================================================
+// cmd_scan vs the analyzer (enrich.py) on random cmdlines (Linux / any POSIX)
+//   python3 cmd_scan_cases.py > cmd_scan_cases.txt        (answers from enrich.py's regex / keywords)
+//   cc -O2 -Wall -I.. -fshort-wchar test_cmd_scan.c ../cmd_scan.c -o test_cmd_scan             (UTF-16, SSE2)
+//   cc -O2 -Wall -I.. -fshort-wchar -mavx2 test_cmd_scan.c ../cmd_scan.c -o test_cmd_scan      (UTF-16, AVX2)
+//   cc -O2 -Wall -I.. -fshort-wchar -DCMD_SCAN_NO_SIMD test_cmd_scan.c ../cmd_scan.c -o test_cmd_scan
+//   cc -O2 -Wall -I.. test_cmd_scan.c ../cmd_scan.c -o test_cmd_scan                           (UTF-32 wchar_t)
+//   ./test_cmd_scan cmd_scan_cases.txt      (exit 0: all checks passed)
+// - per case: cmd_flags and risk_path_tier equal, base64_sus equal or undecided
+//   (-1: left to enrich.py, cmd_scan.h) - a wrong 0 / 1 is a miss the analyzer never re-checks
+// - -fshort-wchar gives wchar_t the Windows layout, so the 16-bit SIMD paths run here
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "cmd_scan.h"
+
+#define MAX_UNITS 4096
+
+#if WCHAR_MAX <= 0xFFFF
+// -fshort-wchar: glibc's wcslen walks 4-byte units, cmd_scan needs the 2-byte one
+size_t wcslen(const wchar_t* s)
+{
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+#endif
+
+static int g_fail = 0;
+
+static void dump(const char* what, unsigned long line, int want, int got)
+{
+    if (g_fail++ < 10) fprintf(stderr, "FAIL line %lu: %s want %d got %d\n", line, what, want, got);
+}
+
+int main(int argc, char** argv)
+{
+    FILE* f = argc > 1 ? fopen(argv[1], "r") : stdin;
+    if (!f) {
+        fprintf(stderr, "open failed: %s\n", argv[1]);
+        return 2;
+    }
+
+    static char text[MAX_UNITS * 6 + 64];
+    static wchar_t s[MAX_UNITS + 1];
+    unsigned long line = 0, cases = 0, undecided = 0, undecided_pos = 0, positives = 0;
+
+    while (fgets(text, sizeof(text), f)) {
+        line++;
+        int want_b64, want_tier;
+        unsigned want_flags;
+        int used = 0;
+        if (sscanf(text, "%d %u %d%n", &want_b64, &want_flags, &want_tier, &used) != 3) continue;
+
+        // UTF-16 units; UTF-32 wchar_t: pairs -> one code point (lone surrogates stay)
+        size_t n = 0;
+        char* p = text + used;
+        for (;;) {
+            char* e;
+            unsigned long u = strtoul(p, &e, 16);
+            if (e == p || n >= MAX_UNITS) break;
+            p = e;
+#if WCHAR_MAX > 0xFFFF
+            if (u >= 0xDC00 && u <= 0xDFFF && n && (uint32_t)s[n - 1] >= 0xD800 && (uint32_t)s[n - 1] <= 0xDBFF) {
+                s[n - 1] = (wchar_t)(0x10000 + (((uint32_t)s[n - 1] - 0xD800) << 10) + (u - 0xDC00));
+                continue;
+            }
+#endif
+            s[n++] = (wchar_t)u;
+        }
+        s[n] = 0;
+        cases++;
+        positives += want_b64;
+
+        int b64 = 0;
+        uint32_t flags = cmd_scan_cmdline(s, n, &b64);
+        if (flags != want_flags) dump("cmd_flags", line, (int)want_flags, (int)flags);
+        int tier = cmd_scan_tier(s);
+        if (tier != want_tier) dump("risk_path_tier", line, want_tier, tier);
+        if (b64 < 0) {
+            undecided++;
+            undecided_pos += want_b64;
+        } else if (b64 != want_b64) {
+            dump("base64_sus", line, want_b64, b64);
+        }
+
+        CMD_SCAN sc;
+        cmd_scan(s, s, &sc);
+        if (sc.undecided != (b64 < 0) || sc.base64_sus != (b64 > 0) || sc.flags != flags || sc.tier != tier) {
+            dump("cmd_scan", line, b64, sc.undecided ? -1 : sc.base64_sus);
+        }
+    }
+    if (f != stdin) fclose(f);
+
+    fprintf(stderr, "cmd_scan %s, wchar_t %zu bytes: %lu cases, %lu base64 positives, "
+            "%lu undecided (%lu positive) -> enrich.py\n",
+            cmd_scan_simd_name(), sizeof(wchar_t), cases, positives, undecided, undecided_pos);
+    if (!cases) {
+        fprintf(stderr, "no cases read\n");
+        return 1;
+    }
+    if (g_fail) {
+        fprintf(stderr, "%d check(s) failed\n", g_fail);
+        return 1;
+    }
+    fprintf(stderr, "all checks passed\n");
+    return 0;
+}
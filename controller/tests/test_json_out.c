@@ -0,0 +1,273 @@
+// ============================================================
+// json_put_wstr (SIMD escaper) vs a scalar reference (Linux / any POSIX)
+//   cc -O2 -Wall -I.. -fshort-wchar test_json_out.c ../json_out.c -o test_json_out         (UTF-16, SSE2)
+//   cc -O2 -Wall -I.. -fshort-wchar -mavx2 test_json_out.c ../json_out.c -o test_json_out  (UTF-16, AVX2)
+//   cc -O2 -Wall -I.. test_json_out.c ../json_out.c -o test_json_out                       (UTF-32 wchar_t)
+//   ./test_json_out [iterations]      (exit 0: all checks passed)
+// - -fshort-wchar gives wchar_t the Windows layout, so the 16-bit SIMD paths run here
+// - byte-for-byte against ref_escape: \" \\ \b \f \n \r \t, other < 0x20 -> \u00xx,
+//   surrogate pairs -> 4-byte UTF-8, lone surrogates -> U+FFFD
+// - one special unit at every position of plain runs around the block sizes
+//   (15/16/17, 31/32/33 ...), pairs split across a block boundary, then random strings
+// - nothing written past JSON_WSTR_BOUND(n); json_put_wstr_utf8 against the same decoder
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "json_out.h"
+
+static int g_fail = 0;
+static uint64_t g_checked = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); g_fail++; } \
+} while (0)
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+#define UNIT_MAX ((uint32_t)WCHAR_MAX)
+#define MAX_UNITS 256
+#define CANARY 0xA5
+
+// ============================================================
+// reference: one unit at a time, no tables shared with json_out.c
+// ============================================================
+static size_t ref_utf8(char* d, uint32_t cp)
+{
+    if (cp < 0x80) {
+        d[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        d[0] = (char)(0xC0 | (cp >> 6));
+        d[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        d[0] = (char)(0xE0 | (cp >> 12));
+        d[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        d[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    d[0] = (char)(0xF0 | (cp >> 18));
+    d[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    d[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    d[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// next code point at s[*i], advancing *i past it
+static uint32_t ref_decode(const wchar_t* s, size_t* i, size_t n)
+{
+    uint32_t c = (uint32_t)s[*i];
+    *i += 1;
+    if (c >= 0xD800 && c <= 0xDBFF) {
+        if (*i < n && (uint32_t)s[*i] >= 0xDC00 && (uint32_t)s[*i] <= 0xDFFF) {
+            uint32_t lo = (uint32_t)s[*i];
+            *i += 1;
+            return 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+        }
+        return 0xFFFD;
+    }
+    if (c >= 0xDC00 && c <= 0xDFFF) return 0xFFFD;
+    if (c > 0x10FFFF) return 0xFFFD;
+    return c;
+}
+
+static size_t ref_escape(char* out, const wchar_t* s, size_t n)
+{
+    size_t o = 0, i = 0;
+    while (i < n) {
+        uint32_t cp = ref_decode(s, &i, n);
+        const char* esc = NULL;
+        switch (cp) {
+        case '"':  esc = "\\\""; break;
+        case '\\': esc = "\\\\"; break;
+        case 0x08: esc = "\\b"; break;
+        case 0x0C: esc = "\\f"; break;
+        case 0x0A: esc = "\\n"; break;
+        case 0x0D: esc = "\\r"; break;
+        case 0x09: esc = "\\t"; break;
+        default: break;
+        }
+        if (esc) {
+            out[o++] = esc[0];
+            out[o++] = esc[1];
+        } else if (cp < 0x20) {
+            o += (size_t)sprintf(out + o, "\\u%04x", cp);
+        } else {
+            o += ref_utf8(out + o, cp);
+        }
+    }
+    return o;
+}
+
+static size_t ref_utf8_str(char* out, const wchar_t* s, size_t n)
+{
+    size_t o = 0, i = 0;
+    while (i < n) {
+        // json_put_wstr_utf8: ASCII (controls included) as is
+        if ((uint32_t)s[i] < 0x80) out[o++] = (char)s[i++];
+        else o += ref_utf8(out + o, ref_decode(s, &i, n));
+    }
+    return o;
+}
+
+// ============================================================
+// one string through both escapers (and the UTF-8 path), at offset 0 and 1
+// ============================================================
+static void dump(const char* what, const wchar_t* s, size_t n)
+{
+    fprintf(stderr, "  %s n=%zu:", what, n);
+    for (size_t i = 0; i < n; i++) fprintf(stderr, " %04x", (unsigned)s[i]);
+    fprintf(stderr, "\n");
+}
+
+static void check_one(const wchar_t* src, size_t n)
+{
+    static wchar_t buf[MAX_UNITS + 1];
+    static char want[JSON_WSTR_BOUND(MAX_UNITS) + 1];
+    static char got[JSON_WSTR_BOUND(MAX_UNITS) + 64];
+
+    for (int shift = 0; shift < 2; shift++) {
+        // unaligned source for the loadu paths
+        wchar_t* s = buf + shift;
+        memcpy(s, src, n * sizeof(wchar_t));
+
+        size_t wn = ref_escape(want, s, n);
+        memset(got, CANARY, sizeof(got));
+        char* end = json_put_wstr(got, s, n);
+        size_t gn = (size_t)(end - got);
+        int ok = gn == wn && memcmp(got, want, wn) == 0;
+        for (size_t k = JSON_WSTR_BOUND(n); k < sizeof(got); k++) ok &= (uint8_t)got[k] == CANARY;
+        CHECK(ok);
+        if (!ok && g_fail < 8) dump("json_put_wstr", s, n);
+
+        wn = ref_utf8_str(want, s, n);
+        memset(got, CANARY, sizeof(got));
+        end = json_put_wstr_utf8(got, s, n);
+        gn = (size_t)(end - got);
+        ok = gn == wn && memcmp(got, want, wn) == 0;
+        for (size_t k = n * 3; k < sizeof(got); k++) ok &= (uint8_t)got[k] == CANARY;
+        CHECK(ok);
+        if (!ok && g_fail < 8) dump("json_put_wstr_utf8", s, n);
+
+        g_checked++;
+    }
+}
+
+// plain, escape-free ASCII
+static wchar_t plain_unit(void)
+{
+    wchar_t c;
+    do c = (wchar_t)(0x20 + rng() % 0x60); while (c == '"' || c == '\\');
+    return c;
+}
+
+// weighted: mostly plain ASCII, the rest every class the escaper distinguishes
+static wchar_t random_unit(void)
+{
+    uint32_t r = (uint32_t)(rng() % 100);
+    if (r < 60) return plain_unit();
+    if (r < 66) return (wchar_t)(rng() % 0x20);                 // control
+    if (r < 70) return (rng() & 1) ? L'"' : L'\\';
+    if (r < 72) return (wchar_t)0x7F;
+    if (r < 78) return (wchar_t)(0x80 + rng() % 0x780);         // 2-byte
+    if (r < 84) return (wchar_t)(0x800 + rng() % 0xD000);       // 3-byte below surrogates
+    if (r < 87) return (wchar_t)(0xE000 + rng() % 0x2000);      // 3-byte above surrogates
+    if (r < 93) return (wchar_t)(0xD800 + rng() % 0x400);       // high surrogate
+    if (r < 99) return (wchar_t)(0xDC00 + rng() % 0x400);       // low surrogate
+    return (wchar_t)(UNIT_MAX - rng() % 4);                     // 0xFFFF.. / past U+10FFFF
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t iters = argc > 1 ? strtoull(argv[1], NULL, 10) : 200000;
+    wchar_t s[MAX_UNITS];
+
+    fprintf(stderr, "json_out: %s, wchar_t %zu bytes\n", json_out_simd_name(), sizeof(wchar_t));
+
+    // every special unit, alone
+    static const uint32_t specials[] = {
+        0x00, 0x01, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x1F, '"', '\\', '/', 0x7F, 0x80,
+        0xFF, 0x7FF, 0x800, 0xD7FF, 0xD800, 0xDBFF, 0xDC00, 0xDFFF, 0xE000, 0xFFFD, 0xFFFF,
+    };
+    const size_t nspecial = sizeof(specials) / sizeof(specials[0]);
+    for (size_t k = 0; k < nspecial; k++) {
+        s[0] = (wchar_t)specials[k];
+        check_one(s, 1);
+    }
+    check_one(s, 0);
+
+    // fixed expectations (the reference itself)
+    {
+        static const wchar_t in[] = { 'a', '"', '\\', '\n', 0x01, 0xD83D, 0xDE00, 0xDC00, 0xD800, 'z' };
+        char out[128];
+        size_t o = ref_escape(out, in, sizeof(in) / sizeof(in[0]));
+        static const char exp[] = "a\\\"\\\\\\n\\u0001\xF0\x9F\x98\x80\xEF\xBF\xBD\xEF\xBF\xBDz";
+        CHECK(o == sizeof(exp) - 1 && memcmp(out, exp, o) == 0);
+        char* end = json_put_wstr(out, in, sizeof(in) / sizeof(in[0]));
+        CHECK((size_t)(end - out) == sizeof(exp) - 1 && memcmp(out, exp, sizeof(exp) - 1) == 0);
+    }
+
+    // plain runs of every length up to 70 (block sizes 4/8/16 and their neighbours),
+    // then one special unit at every position
+    for (size_t n = 0; n <= 70; n++) {
+        for (size_t i = 0; i < n; i++) s[i] = plain_unit();
+        check_one(s, n);
+        for (size_t pos = 0; pos < n; pos++) {
+            for (size_t k = 0; k < nspecial; k++) {
+                wchar_t keep = s[pos];
+                s[pos] = (wchar_t)specials[k];
+                check_one(s, n);
+                s[pos] = keep;
+            }
+        }
+    }
+
+    // surrogate pair straddling each position: high at pos, low at pos+1,
+    // and the pair cut by the end of the string
+    static const size_t lens[] = { 15, 16, 17, 31, 32, 33, 47, 48, 49, 64, 65 };
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        size_t n = lens[l];
+        for (size_t pos = 0; pos < n; pos++) {
+            for (size_t i = 0; i < n; i++) s[i] = plain_unit();
+            s[pos] = (wchar_t)(0xD800 + rng() % 0x400);
+            if (pos + 1 < n) s[pos + 1] = (wchar_t)(0xDC00 + rng() % 0x400);
+            check_one(s, n);
+            // reversed order: two lone surrogates
+            if (pos + 1 < n) {
+                wchar_t t = s[pos];
+                s[pos] = s[pos + 1];
+                s[pos + 1] = t;
+                check_one(s, n);
+            }
+        }
+    }
+
+    // random strings: mostly short, some long enough for several SIMD blocks
+    for (uint64_t it = 0; it < iters; it++) {
+        size_t n = (it & 7) ? (size_t)(rng() % 40) : (size_t)(rng() % MAX_UNITS);
+        // plain runs with the occasional special, so the fast path actually engages
+        int dense = (int)(rng() % 4);
+        for (size_t i = 0; i < n; i++) s[i] = (rng() % 8) < (uint64_t)dense + 1 ? random_unit() : plain_unit();
+        check_one(s, n);
+    }
+
+    if (g_fail) {
+        fprintf(stderr, "%d check(s) failed (%llu strings)\n", g_fail, (unsigned long long)g_checked);
+        return 1;
+    }
+    fprintf(stderr, "all checks passed (%llu strings)\n", (unsigned long long)g_checked);
+    return 0;
+}
@@ -0,0 +1,255 @@
+// ============================================================
+// mof_decode over hand-built kernel MOF UserData (Linux / any POSIX)
+//   cc -O2 -Wall -I.. test_mof_decode.c ../mof_decode.c -o test_mof_decode
+//   cc -O1 -g -Wall -I.. -fsanitize=address,undefined test_mof_decode.c ../mof_decode.c -o test_mof_decode
+//   ./test_mof_decode      (exit 0: all checks passed)
+// - Process_TypeGroup1 v2 / v3 / v4, 32- and 64-bit pointers, UserSID NULL (4 zero
+//   bytes) and TOKEN_USER + SID with 0..15 sub-authorities, CommandLine with and
+//   without its NUL, v4 PackageFullName / ApplicationId after it
+// - every prefix of every blob, copied to a buffer of exactly that size (ASan
+//   catches a read past it): 0 until ImageFileName's NUL is inside, then 1 with
+//   the CommandLine units that fit
+// - TcpIp / TcpIp6 connect, unknown version / opcode / ptr_size, ProcessId peeks
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mof_decode.h"
+
+static int g_fail = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); g_fail++; } \
+} while (0)
+
+// ============================================================
+// UserData builder (little endian, no padding: the kernel packs MOF fields)
+// ============================================================
+typedef struct BLOB {
+    uint8_t b[512];
+    size_t n;
+} BLOB;
+
+static void put(BLOB* w, const void* p, size_t n)
+{
+    memcpy(w->b + w->n, p, n);
+    w->n += n;
+}
+
+static void put_u32(BLOB* w, uint32_t v)
+{
+    uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    put(w, b, 4);
+}
+
+static void put_ptr(BLOB* w, int ptr_size, uint64_t v)
+{
+    put_u32(w, (uint32_t)v);
+    if (ptr_size == 8) put_u32(w, (uint32_t)(v >> 32));
+}
+
+static void put_utf16z(BLOB* w, const char* s, int nul)
+{
+    for (; *s; s++) {
+        uint8_t u[2] = { (uint8_t)*s, 0 };
+        put(w, u, 2);
+    }
+    if (nul) put(w, "\0\0", 2);
+}
+
+typedef struct PROC_CASE {
+    uint8_t version;
+    int ptr_size;
+    int sub_count;              // -1: NULL UserSID
+    int cmd_nul;                // CommandLine NUL terminated
+    const char* image;
+    const char* cmdline;
+    size_t image_off;           // filled by build_process
+    size_t image_end;           // offset after ImageFileName's NUL
+} PROC_CASE;
+
+static void build_process(BLOB* w, PROC_CASE* c)
+{
+    w->n = 0;
+    put_ptr(w, c->ptr_size, 0xFFFFA0012345678ULL);     // UniqueProcessKey
+    put_u32(w, 4321);                                   // ProcessId
+    put_u32(w, 1234);                                   // ParentId
+    put_u32(w, 1);                                      // SessionId
+    put_u32(w, (uint32_t)-5);                           // ExitStatus
+    if (c->version >= 3) put_ptr(w, c->ptr_size, 0x1AD000ULL);     // DirectoryTableBase
+    if (c->version >= 4) put_u32(w, 0x10);                          // Flags
+
+    if (c->sub_count < 0) {
+        put_u32(w, 0);
+    } else {
+        // TOKEN_USER { PSID Sid; DWORD Attributes } (pointer-sized slots), then the SID
+        put_ptr(w, c->ptr_size, 0xFFFFB00000001000ULL);
+        put_ptr(w, c->ptr_size, 0);
+        uint8_t hdr[8] = { 1, (uint8_t)c->sub_count, 0, 0, 0, 0, 0, 5 };
+        put(w, hdr, 8);
+        for (int i = 0; i < c->sub_count; i++) put_u32(w, 21 + (uint32_t)i);
+    }
+
+    c->image_off = w->n;
+    put(w, c->image, strlen(c->image) + 1);
+    c->image_end = w->n;
+    put_utf16z(w, c->cmdline, c->cmd_nul);
+    if (c->version >= 4 && c->cmd_nul) {
+        put_utf16z(w, "Pkg_1.0", 1);                    // PackageFullName
+        put_utf16z(w, "App", 1);                        // ApplicationId
+    }
+}
+
+static int cmdline_eq(const MOF_PROCESS* m, const char* s, size_t units)
+{
+    if (m->cmdline_len != units) return 0;
+    for (size_t i = 0; i < units; i++) {
+        if (m->cmdline[i * 2] != (uint8_t)s[i] || m->cmdline[i * 2 + 1] != 0) return 0;
+    }
+    return 1;
+}
+
+static void test_process(void)
+{
+    static const uint8_t versions[] = { 2, 3, 4 };
+    static const int ptrs[] = { 4, 8 };
+    static const int subs[] = { -1, 0, 1, 2, 5, 15 };
+    const char* image = "powershell.exe";
+    const char* cmdline = "powershell -nop -enc SQBFAFgA";
+    int bad = 0, cases = 0;
+
+    for (size_t vi = 0; vi < sizeof(versions); vi++)
+    for (size_t pi = 0; pi < 2; pi++)
+    for (size_t si = 0; si < sizeof(subs) / sizeof(subs[0]); si++)
+    for (int nul = 0; nul < 2; nul++) {
+        PROC_CASE c = { versions[vi], ptrs[pi], subs[si], nul, image, cmdline, 0, 0 };
+        BLOB w;
+        build_process(&w, &c);
+        cases++;
+
+        // whole blob
+        MOF_PROCESS m;
+        memset(&m, 0, sizeof(m));
+        int ok = mof_decode_process(w.b, w.n, c.version, c.ptr_size, &m);
+        if (!ok || m.pid != 4321 || m.ppid != 1234 || m.session_id != 1 || m.exit_status != -5 ||
+            m.image != (const char*)w.b + c.image_off || m.image_len != strlen(image) ||
+            memcmp(m.image, image, m.image_len) != 0 || !cmdline_eq(&m, cmdline, strlen(cmdline))) {
+            fprintf(stderr, "v%u ptr%d sub%d nul%d: decode mismatch\n", c.version, c.ptr_size, c.sub_count, nul);
+            bad++;
+        }
+        uint32_t pid = 0;
+        if (!mof_process_pid(w.b, w.n, c.version, c.ptr_size, &pid) || pid != 4321) bad++;
+
+        // every prefix, in a buffer of exactly that size
+        for (size_t len = 0; len < w.n; len++) {
+            uint8_t* p = (uint8_t*)malloc(len ? len : 1);
+            memcpy(p, w.b, len);
+            memset(&m, 0, sizeof(m));
+            ok = mof_decode_process(p, len, c.version, c.ptr_size, &m);
+            if (len < c.image_end) {
+                if (ok) {
+                    fprintf(stderr, "v%u ptr%d sub%d: %zu of %zu bytes decoded\n",
+                            c.version, c.ptr_size, c.sub_count, len, w.n);
+                    bad++;
+                }
+            } else {
+                size_t fit = (len - c.image_end) / 2;
+                size_t want = fit < strlen(cmdline) ? fit : strlen(cmdline);
+                if (!ok || m.image_len != strlen(image) || !cmdline_eq(&m, cmdline, want)) bad++;
+            }
+            if (mof_process_pid(p, len, c.version, c.ptr_size, &pid) != (len >= (size_t)c.ptr_size + 4)) bad++;
+            free(p);
+        }
+    }
+    CHECK(bad == 0);
+    CHECK(cases == 72);
+
+    // unknown version / pointer size: 0 (TDH fallback), nothing read
+    PROC_CASE c = { 3, 8, -1, 1, image, cmdline, 0, 0 };
+    BLOB w;
+    build_process(&w, &c);
+    MOF_PROCESS m;
+    uint32_t pid;
+    CHECK(mof_decode_process(w.b, w.n, 1, 8, &m) == 0);
+    CHECK(mof_decode_process(w.b, w.n, 5, 8, &m) == 0);
+    CHECK(mof_decode_process(w.b, w.n, 3, 2, &m) == 0);
+    CHECK(mof_decode_process(NULL, w.n, 3, 8, &m) == 0);
+    CHECK(mof_process_pid(w.b, w.n, 5, 8, &pid) == 0);
+    CHECK(mof_process_pid(w.b, w.n, 3, 2, &pid) == 0);
+
+    // SID claiming more sub-authorities than the payload has
+    c.sub_count = 2;
+    build_process(&w, &c);
+    size_t sid_count_at = 8 + 16 + 8 + 16 + 1;          // key, ids, DTB, TOKEN_USER, SID revision
+    w.b[sid_count_at] = 200;
+    CHECK(mof_decode_process(w.b, w.n, 3, 8, &m) == 0);
+
+    // no NUL after ImageFileName
+    c.sub_count = -1;
+    build_process(&w, &c);
+    w.n = c.image_end - 1;
+    CHECK(mof_decode_process(w.b, w.n, 3, 8, &m) == 0);
+}
+
+// ============================================================
+// TcpIp
+// ============================================================
+static void test_tcpip(void)
+{
+    static const uint8_t d4[4] = { 10, 0, 0, 7 }, s4[4] = { 192, 168, 1, 20 };
+    static const uint8_t d6[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+    static const uint8_t s6[16] = { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55 };
+    int bad = 0;
+
+    for (int v6 = 0; v6 < 2; v6++) {
+        size_t alen = v6 ? 16 : 4;
+        uint8_t opcode = v6 ? MOF_TCPIP_OPCODE_CONNECT_V6 : MOF_TCPIP_OPCODE_CONNECT_V4;
+        BLOB w = { { 0 }, 0 };
+        put_u32(&w, 888);                   // PID
+        put_u32(&w, 0);                     // size
+        put(&w, v6 ? d6 : d4, alen);
+        put(&w, v6 ? s6 : s4, alen);
+        uint8_t ports[4] = { 0x01, 0xBB, 0xC3, 0x50 };  // 443, 50000 (network order)
+        put(&w, ports, 4);
+        size_t need = w.n;
+        put_u32(&w, 0);                     // mss, sackopt, ... (not read)
+
+        MOF_TCP t;
+        if (!mof_decode_tcpip(w.b, w.n, opcode, 2, &t) || t.pid != 888 || t.family != (v6 ? 6 : 4) ||
+            memcmp(t.daddr, v6 ? d6 : d4, alen) != 0 || memcmp(t.saddr, v6 ? s6 : s4, alen) != 0 ||
+            t.dport != 443 || t.sport != 50000) {
+            bad++;
+        }
+        char ip[64];
+        mof_ip_to_string(t.family, t.daddr, ip);
+        CHECK(strcmp(ip, v6 ? "2001:db8::1" : "10.0.0.7") == 0);
+        mof_ip_to_string(t.family, t.saddr, ip);
+        CHECK(strcmp(ip, v6 ? "fe80::211:22ff:fe33:4455" : "192.168.1.20") == 0);
+
+        for (size_t len = 0; len < w.n; len++) {
+            uint8_t* p = (uint8_t*)malloc(len ? len : 1);
+            memcpy(p, w.b, len);
+            if (mof_decode_tcpip(p, len, opcode, 2, &t) != (len >= need)) bad++;
+            uint32_t pid = 0;
+            if (mof_tcpip_pid(p, len, opcode, 2, &pid) != (len >= 4)) bad++;
+            free(p);
+        }
+        CHECK(mof_decode_tcpip(w.b, w.n, opcode, 3, &t) == 0);
+        CHECK(mof_decode_tcpip(w.b, w.n, 13, 2, &t) == 0);     // disconnect: not decoded here
+    }
+    CHECK(bad == 0);
+}
+
+int main(void)
+{
+    test_process();
+    test_tcpip();
+
+    if (g_fail) {
+        fprintf(stderr, "%d check(s) failed\n", g_fail);
+        return 1;
+    }
+    fprintf(stderr, "all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+// ============================================================
+// pid_map vs a per-pid reference under churn with eviction (Linux / any POSIX)
+//   cc -O2 -Wall -I.. test_pid_map.c ../pid_map.c -o test_pid_map
+//   ./test_pid_map      (exit 0: all checks passed)
+// - random put (new / PID reuse) / del (right and stale gen) / get / sweep, small
+//   max_entries and max_age; time alternates slow / fast every 5000 operations so
+//   evict_for_room and age sweeps both run
+// - after every operation: every live slot reachable from its home (backward-shift
+//   delete_at kept the clusters intact), no pid twice, size == occupied slots,
+//   every reference entry either found unchanged or counted as evicted
+// - age eviction only takes entries past max_age; at most one cap eviction per put
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pid_map.h"
+
+#define PIDS      1024          // pid = k * 4 + 4
+#define MAX_ENT   200
+#define MAX_AGE   5000          // 100ns
+#define OPS       100000
+
+static int g_fail = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond) && g_fail++ < 10) fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+} while (0)
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t rng(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+// 기대값: pid별 마지막 put (gen 0: 없음)
+static PID_ENTRY g_ref[PIDS];
+static int g_slot_of[PIDS];
+
+enum { OP_PUT, OP_DEL, OP_GET, OP_SWEEP };
+
+// slot 배열을 직접 훑음 (pid_map_get은 last_seen / stats를 건드림)
+static void check_table(PID_MAP* m, int op, uint64_t now, uint64_t* evicted_seen)
+{
+    size_t used = 0;
+    for (int k = 0; k < PIDS; k++) g_slot_of[k] = -1;
+    for (size_t i = 0; i < m->cap; i++) {
+        const PID_ENTRY* e = &m->slots[i];
+        if (!e->gen) continue;
+        used++;
+        int k = (int)(e->pid / 4) - 1;
+        CHECK(e->pid % 4 == 0 && k >= 0 && k < PIDS);
+        if (k < 0 || k >= PIDS) continue;
+        CHECK(g_slot_of[k] < 0);    // pid twice
+        g_slot_of[k] = (int)i;
+
+        // reachable: linear probe from home finds this slot before an empty one
+        PID_ENTRY got;
+        CHECK(pid_map_get(m, e->pid, 0, &got) && got.gen == e->gen);
+    }
+    CHECK(used == m->size);
+    CHECK(m->size <= MAX_ENT);
+
+    uint64_t gone = 0, young_gone = 0;
+    for (int k = 0; k < PIDS; k++) {
+        PID_ENTRY* r = &g_ref[k];
+        if (!r->gen) {
+            CHECK(g_slot_of[k] < 0);
+            continue;
+        }
+        if (g_slot_of[k] < 0) {
+            // eviction: 기준에서도 지움
+            if (now < MAX_AGE || r->last_seen >= now - MAX_AGE) young_gone++;
+            memset(r, 0, sizeof(*r));
+            gone++;
+            continue;
+        }
+        const PID_ENTRY* e = &m->slots[g_slot_of[k]];
+        CHECK(e->gen == r->gen && e->guid == r->guid && e->start_ts == r->start_ts && e->last_seen == r->last_seen);
+    }
+    if (op == OP_DEL || op == OP_GET) CHECK(gone == 0);
+    if (op == OP_SWEEP) CHECK(young_gone == 0);
+    if (op == OP_PUT) CHECK(young_gone <= 1);
+    *evicted_seen += gone;
+}
+
+int main(void)
+{
+    PID_MAP m;
+    CHECK(pid_map_init(&m, 16, MAX_ENT, MAX_AGE));
+
+    uint64_t ts = 132000000000000000ULL;
+    uint64_t evicted_seen = 0;
+    for (int i = 0; i < OPS; i++) {
+        // xorshift: 연속된 두 값의 하위 bit는 서로 얽혀 있음 -> 한 값을 나눠 씀
+        uint64_t x = rng();
+        // 느린 구간: max_entries에 걸림 (evict_for_room), 빠른 구간: max_age가 지남 (sweep)
+        ts += 1 + (x >> 40) % ((i / 5000) & 1 ? 200 : 4);
+        int k = (int)(x % PIDS);
+        uint32_t pid = (uint32_t)k * 4 + 4;
+        PID_ENTRY* r = &g_ref[k];
+        int op = (int)((x >> 32) % 8);
+        op = op < 3 ? OP_PUT : op < 5 ? OP_DEL : op < 7 ? OP_GET : OP_SWEEP;
+
+        if (op == OP_PUT) {
+            uint64_t guid = rng() | 1;
+            uint32_t gen = pid_map_put(&m, pid, ts, guid);
+            CHECK(gen != 0);
+            r->pid = pid;
+            r->gen = gen;
+            r->guid = guid;
+            r->start_ts = ts;
+            r->last_seen = ts;
+        } else if (op == OP_DEL) {
+            if (r->gen && (rng() & 3)) {
+                CHECK(pid_map_del(&m, pid, r->gen + 1) == 0);    // stale generation
+                CHECK(pid_map_del(&m, pid, r->gen) == 1);
+                memset(r, 0, sizeof(*r));
+            } else if (!r->gen) {
+                CHECK(pid_map_del(&m, pid, 0) == 0);
+            }
+        } else if (op == OP_GET) {
+            PID_ENTRY e;
+            int hit = pid_map_get(&m, pid, ts, &e);
+            CHECK(hit == (r->gen != 0));
+            if (hit && r->gen) {
+                CHECK(e.gen == r->gen && e.guid == r->guid);
+                r->last_seen = ts;
+            }
+        } else {
+            pid_map_sweep(&m, ts, 1 + (size_t)(rng() % 16));
+        }
+        check_table(&m, op, ts, &evicted_seen);
+    }
+
+    PID_MAP_STATS st;
+    pid_map_get_stats(&m, &st);
+    fprintf(stderr, "ops=%d size=%llu cap=%llu grows=%llu evict_age=%llu evict_cap=%llu deletes=%llu replaced=%llu\n",
+            OPS, (unsigned long long)st.size, (unsigned long long)st.cap, (unsigned long long)st.grows,
+            (unsigned long long)st.evict_age, (unsigned long long)st.evict_cap,
+            (unsigned long long)st.deletes, (unsigned long long)st.replaced);
+    CHECK(st.evict_age > 0);
+    CHECK(st.evict_cap > 0);
+    CHECK(st.evict_age + st.evict_cap == evicted_seen);
+    CHECK(st.grows > 0);
+    pid_map_free(&m);
+
+    if (g_fail) {
+        fprintf(stderr, "%d check(s) failed\n", g_fail);
+        return 1;
+    }
+    fprintf(stderr, "all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+// ============================================================
+// schema_cache over TRACE_EVENT_INFO blobs (Linux / any POSIX)
+//   cc -O2 -Wall -I.. test_schema_cache.c ../schema_cache.c -o test_schema_cache
+//   ./test_schema_cache            (exit 0: all checks passed)
+// - blobs laid out byte for byte as TdhGetEventInformation returns them
+//   (header, top-level EVENT_PROPERTY_INFO array at 112, UTF-16LE names after it)
+//   for Kernel-Process ProcessStart v3 and Kernel-Network TcpIp connect
+// - property name offsets / in_type / struct flag, alias -> field_index,
+//   task / opcode names, hit / miss counters, growth, malformed blobs
+// - then ns per cached lookup (the per-event path)
+// ============================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "schema_cache.h"
+
+static int g_fail = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); g_fail++; } \
+} while (0)
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+// ============================================================
+// TRACE_EVENT_INFO builder (tdh.h layout, little endian)
+// ============================================================
+#define TEI_HEADER   112
+#define EPI_SIZE     24
+
+// TDH_INTYPE_*
+#define IN_UINT16         5
+#define IN_UINT32         7
+#define IN_UINT64         9
+#define IN_FILETIME       17
+#define IN_UNICODESTRING  1
+#define IN_BINARY         14
+
+typedef struct PROP_SPEC {
+    const char* name;
+    uint16_t in_type;
+    int is_struct;
+} PROP_SPEC;
+
+typedef struct BLOB {
+    uint8_t b[4096];
+    uint32_t size;
+    uint32_t name_off[32];      // where each property name was written
+} BLOB;
+
+static void wr16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr32(uint8_t* p, uint32_t v) { wr16(p, (uint16_t)v); wr16(p + 2, (uint16_t)(v >> 16)); }
+
+// ASCII -> UTF-16LE + NUL at the end of the blob, returns its offset
+static uint32_t put_name(BLOB* bl, const char* s)
+{
+    uint32_t off = bl->size;
+    for (; *s; s++, bl->size += 2) wr16(bl->b + bl->size, (uint8_t)*s);
+    wr16(bl->b + bl->size, 0);
+    bl->size += 2;
+    return off;
+}
+
+static void build_info(BLOB* bl, const PROP_SPEC* props, uint32_t n, const char* task, const char* opcode)
+{
+    memset(bl, 0, sizeof(*bl));
+    bl->size = TEI_HEADER + n * EPI_SIZE;
+    wr32(bl->b + 100, n);                                   // PropertyCount
+    wr32(bl->b + 104, n);                                   // TopLevelPropertyCount
+    for (uint32_t i = 0; i < n; i++) {
+        uint8_t* epi = bl->b + TEI_HEADER + i * EPI_SIZE;
+        bl->name_off[i] = put_name(bl, props[i].name);
+        wr32(epi, props[i].is_struct ? 0x1u : 0);           // Flags (PropertyStruct)
+        wr32(epi + 4, bl->name_off[i]);                     // NameOffset
+        wr16(epi + 8, props[i].is_struct ? 0 : props[i].in_type);
+        wr16(epi + 16, 1);                                  // count
+    }
+    wr32(bl->b + 68, put_name(bl, task));                   // TaskNameOffset
+    wr32(bl->b + 72, put_name(bl, opcode));                 // OpcodeNameOffset
+}
+
+static const PROP_SPEC k_process_start[] = {
+    { "ProcessID", IN_UINT32, 0 },
+    { "CreateTime", IN_FILETIME, 0 },
+    { "ParentProcessID", IN_UINT32, 0 },
+    { "SessionID", IN_UINT32, 0 },
+    { "Flags", IN_UINT32, 0 },
+    { "ImageName", IN_UNICODESTRING, 0 },
+    { "ImageChecksum", IN_UINT32, 0 },
+    { "TimeDateStamp", IN_UINT32, 0 },
+    { "PackageFullName", IN_UNICODESTRING, 0 },
+    { "PackageRelativeAppId", IN_UNICODESTRING, 0 },
+};
+
+static const PROP_SPEC k_tcp_connect[] = {
+    { "PID", IN_UINT32, 0 },
+    { "size", IN_UINT32, 0 },
+    { "daddr", IN_BINARY, 0 },
+    { "saddr", IN_BINARY, 0 },
+    { "dport", IN_UINT16, 0 },
+    { "sport", IN_UINT16, 0 },
+    { "ExtraInfo", 0, 1 },
+    { "connid", IN_UINT64, 0 },
+};
+
+#define COUNT_OF(a) (uint32_t)(sizeof(a) / sizeof((a)[0]))
+
+static void make_key(SCHEMA_KEY* k, uint8_t provider_tag, uint16_t id, uint8_t version)
+{
+    memset(k, 0, sizeof(*k));
+    for (int i = 0; i < 16; i++) k->provider[i] = (uint8_t)(provider_tag * 16 + i);
+    k->id = id;
+    k->opcode = 0;
+    k->version = version;
+    k->ptr64 = 1;
+}
+
+// every top-level property: name at the offset the blob says, same in_type / struct flag
+static void check_props(const SCHEMA_ENTRY* e, const BLOB* bl, const PROP_SPEC* spec, uint32_t n)
+{
+    CHECK(e->prop_count == n);
+    for (uint32_t i = 0; i < n && i < e->prop_count; i++) {
+        CHECK(e->props[i].name_offset == bl->name_off[i]);
+        CHECK(schema_wstr_eqi_ascii(schema_blob_wstr(e, e->props[i].name_offset), spec[i].name));
+        CHECK(e->props[i].is_struct == (spec[i].is_struct ? 1 : 0));
+        CHECK(e->props[i].in_type == (spec[i].is_struct ? 0 : spec[i].in_type));
+        CHECK(schema_find_prop_ascii(e, spec[i].name) == i);
+    }
+}
+
+int main(void)
+{
+    SCHEMA_CACHE c;
+    CHECK(schema_cache_init(&c, 16));
+
+    static BLOB ps, tcp;
+    build_info(&ps, k_process_start, COUNT_OF(k_process_start), "ProcessStart", "win:Start");
+    build_info(&tcp, k_tcp_connect, COUNT_OF(k_tcp_connect), "TcpIp", "Connect");
+
+    SCHEMA_KEY kps, ktcp;
+    make_key(&kps, 1, 1, 3);
+    make_key(&ktcp, 2, 12, 0);
+
+    // miss -> insert -> hit
+    CHECK(schema_cache_find(&c, &kps) == NULL);
+    CHECK(c.misses == 1 && c.hits == 0);
+    SCHEMA_ENTRY* e = schema_cache_insert_info(&c, &kps, ps.b, ps.size);
+    CHECK(e != NULL);
+    if (!e) return 1;
+    CHECK(schema_cache_find(&c, &kps) == e);
+    CHECK(c.hits == 1);
+
+    check_props(e, &ps, k_process_start, COUNT_OF(k_process_start));
+    CHECK(e->field_index[SF_PROCESS_ID] == 0);          // ProcessID ~ "ProcessId"
+    CHECK(e->field_index[SF_PARENT_ID] == 2);           // ParentProcessID
+    CHECK(e->field_index[SF_IMAGE] == 5);               // ImageName
+    CHECK(e->field_index[SF_CMDLINE] == SCHEMA_PROP_NONE);
+    CHECK(e->field_index[SF_DST_PORT] == SCHEMA_PROP_NONE);
+    CHECK(schema_wstr_eqi_ascii(schema_blob_wstr(e, e->task_name_offset), "ProcessStart"));
+    CHECK(schema_wstr_eqi_ascii(schema_blob_wstr(e, e->opcode_name_offset), "win:start"));
+    CHECK(memcmp(e->blob, ps.b, ps.size) == 0);         // owned copy of the whole blob
+
+    SCHEMA_ENTRY* t = schema_cache_insert_info(&c, &ktcp, tcp.b, tcp.size);
+    CHECK(t != NULL && t != e);
+    if (!t) return 1;
+    check_props(t, &tcp, k_tcp_connect, COUNT_OF(k_tcp_connect));
+    CHECK(t->field_index[SF_PROCESS_ID] == 0);          // PID
+    CHECK(t->field_index[SF_DST_ADDR] == 2);            // daddr
+    CHECK(t->field_index[SF_SRC_ADDR] == 3);
+    CHECK(t->field_index[SF_DST_PORT] == 4);
+    CHECK(t->field_index[SF_SRC_PORT] == 5);
+    CHECK(t->field_index[SF_IMAGE] == SCHEMA_PROP_NONE);
+
+    // same blob twice: the cached entry, no second copy
+    CHECK(schema_cache_insert_info(&c, &kps, ps.b, ps.size) == e);
+    CHECK(c.size == 2);
+
+    // any key field differs -> miss
+    SCHEMA_KEY k = kps;
+    k.version = 2;
+    CHECK(schema_cache_find(&c, &k) == NULL);
+    k = kps;
+    k.ptr64 = 0;
+    CHECK(schema_cache_find(&c, &k) == NULL);
+    k = kps;
+    k.provider[15] ^= 1;
+    CHECK(schema_cache_find(&c, &k) == NULL);
+    CHECK(c.misses == 4);
+
+    // malformed: shorter than the header / property array past the end
+    CHECK(schema_cache_insert_info(&c, &k, ps.b, 100) == NULL);
+    CHECK(schema_cache_insert_info(&c, &k, ps.b, TEI_HEADER + 2 * EPI_SIZE) == NULL);
+    CHECK(schema_cache_find(&c, &k) == NULL);
+
+    // name offset outside the blob / name not terminated: no name, no match
+    static BLOB bad;
+    bad = ps;
+    wr32(bad.b + TEI_HEADER + 4, bad.size + 64);
+    bad.b[bad.size - 2] = 'x';                          // opcode name loses its NUL
+    make_key(&k, 3, 1, 3);
+    SCHEMA_ENTRY* be = schema_cache_insert_info(&c, &k, bad.b, bad.size);
+    CHECK(be != NULL);
+    if (be) {
+        CHECK(schema_blob_wstr(be, be->props[0].name_offset) == NULL);
+        CHECK(be->field_index[SF_PROCESS_ID] == SCHEMA_PROP_NONE);
+        CHECK(be->field_index[SF_PARENT_ID] == 2);
+        CHECK(schema_blob_wstr(be, be->opcode_name_offset) == NULL);
+    }
+
+    // growth past 16 * 0.75: every entry still found, same contents
+    for (uint16_t id = 100; id < 200; id++) {
+        make_key(&k, 4, id, 0);
+        SCHEMA_ENTRY* x = schema_cache_insert_info(&c, &k, tcp.b, tcp.size);
+        CHECK(x != NULL);
+    }
+    CHECK(c.size == 103 && c.cap >= 256);
+    for (uint16_t id = 100; id < 200; id++) {
+        make_key(&k, 4, id, 0);
+        SCHEMA_ENTRY* x = schema_cache_find(&c, &k);
+        CHECK(x != NULL && x->key.id == id);
+        if (x) check_props(x, &tcp, k_tcp_connect, COUNT_OF(k_tcp_connect));
+    }
+    e = schema_cache_find(&c, &kps);
+    CHECK(e != NULL);
+    if (e) check_props(e, &ps, k_process_start, COUNT_OF(k_process_start));
+
+    // per-event path: hit lookup
+    const uint64_t n = 10000000;
+    uint64_t hits0 = c.hits, t0 = now_ns();
+    uintptr_t acc = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        const SCHEMA_KEY* kk = (i & 1) ? &kps : &ktcp;
+        acc += (uintptr_t)schema_cache_find(&c, kk);
+    }
+    uint64_t dt = now_ns() - t0;
+    CHECK(c.hits - hits0 == n);
+    fprintf(stderr, "schema_cache: %llu schemas, hit lookup %.1f ns (%s)\n",
+            (unsigned long long)c.size, (double)dt / (double)n, acc ? "ok" : "-");
+
+    schema_cache_free(&c);
+    if (g_fail) {
+        fprintf(stderr, "%d check(s) failed\n", g_fail);
+        return 1;
+    }
+    fprintf(stderr, "all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,216 @@
+// ============================================================
+// bin2jsonl: binary telemetry (bin_format.h) -> JSONL, same lines as the TEXT writer
+//   cc -O2 -I.. bin2jsonl.c ../bin_format.c ../cmd_scan.c ../json_out.c ../ts_format.c -o bin2jsonl
+//   bin2jsonl [--us] <in.msb|-> [out.jsonl]
+// - timestamps: 3 or 6 fractional digits as the header says (--us: always 6)
+// ============================================================
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bin_format.h"
+#include "cmd_scan.h"
+#include "json_out.h"
+#include "ts_format.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#define PUT_STR(d, s) do { *(d)++ = '"'; (d) = json_put_str((d), (s).p, (s).n); *(d)++ = '"'; } while (0)
+
+static char* put_ts(char* d, TS_CACHE* c, uint64_t ts, int digits)
+{
+    *d++ = '"';
+    d += ts_format_filetime(c, ts, digits, d);
+    *d++ = '"';
+    return d;
+}
+
+// 한 line의 최대 길이
+static size_t line_bound(const BIN_EVENT* e)
+{
+    size_t n = e->image.n + e->cmdline.n + e->host.n + e->guid.n + e->parent_guid.n + e->src_ip.n + e->dst_ip.n +
+               e->rule_id.n + e->technique.n + e->evidence.n;
+    return 256 + 3 * TS_ISO_MAX + JSON_STR_BOUND(n) + e->fields.n + CMD_FLAGS_TEXT_MAX;
+}
+
+static char* format_event(char* d, const BIN_EVENT* e, TS_CACHE* tc, int digits)
+{
+    d = JSON_LIT(d, "{\"ts\":");
+    d = put_ts(d, tc, e->ts_100ns, digits);
+
+    switch (e->type) {
+    case BIN_REC_PROC_START:
+        d = JSON_LIT(d, ",\"event_type\":\"proc_start\",\"pid\":");
+        d = json_put_u32(d, e->pid);
+        d = JSON_LIT(d, ",\"ppid\":");
+        d = json_put_u32(d, e->ppid);
+        d = JSON_LIT(d, ",\"image\":");
+        PUT_STR(d, e->image);
+        d = JSON_LIT(d, ",\"cmdline\":");
+        PUT_STR(d, e->cmdline);
+        d = JSON_LIT(d, ",\"host\":");
+        PUT_STR(d, e->host);
+        d = JSON_LIT(d, ",\"process_guid\":");
+        PUT_STR(d, e->guid);
+        d = JSON_LIT(d, ",\"parent_process_guid\":");
+        PUT_STR(d, e->parent_guid);
+        if (e->has_scan) {
+            d = JSON_LIT(d, ",\"risk_path_tier\":");
+            d = json_put_u32(d, e->risk_path_tier);
+            d = JSON_LIT(d, ",\"cmd_flags\":\"");
+            d += cmd_scan_flags_text(e->cmd_flags, d);
+            d = JSON_LIT(d, "\",\"base64_sus\":");
+            d = json_put_u32(d, e->base64_sus);
+        }
+        break;
+
+    case BIN_REC_PROC_END:
+        d = JSON_LIT(d, ",\"event_type\":\"proc_end\",\"pid\":");
+        d = json_put_u32(d, e->pid);
+        d = JSON_LIT(d, ",\"process_guid\":");
+        PUT_STR(d, e->guid);
+        break;
+
+    case BIN_REC_NET_CONNECT:
+        d = JSON_LIT(d, ",\"event_type\":\"net_connect\",\"pid\":");
+        d = json_put_u32(d, e->pid);
+        d = JSON_LIT(d, ",\"process_guid\":");
+        PUT_STR(d, e->guid);
+        d = JSON_LIT(d, ",\"src_ip\":");
+        PUT_STR(d, e->src_ip);
+        d = JSON_LIT(d, ",\"src_port\":");
+        d = json_put_u32(d, e->src_port);
+        d = JSON_LIT(d, ",\"dst_ip\":");
+        PUT_STR(d, e->dst_ip);
+        d = JSON_LIT(d, ",\"dst_port\":");
+        d = json_put_u32(d, e->dst_port);
+        if (e->has_image) {
+            d = JSON_LIT(d, ",\"image\":");
+            PUT_STR(d, e->image);
+        }
+        if (e->has_parent) {
+            d = JSON_LIT(d, ",\"parent_process_guid\":");
+            PUT_STR(d, e->parent_guid);
+        }
+        break;
+
+    case BIN_REC_NET_FLOW:
+        d = JSON_LIT(d, ",\"event_type\":\"net_flow_summary\",\"pid\":");
+        d = json_put_u32(d, e->pid);
+        d = JSON_LIT(d, ",\"process_guid\":");
+        PUT_STR(d, e->guid);
+        d = JSON_LIT(d, ",\"dst_ip\":");
+        PUT_STR(d, e->dst_ip);
+        d = JSON_LIT(d, ",\"dst_port\":");
+        d = json_put_u32(d, e->dst_port);
+        d = JSON_LIT(d, ",\"proto\":");
+        d = json_put_u32(d, e->proto);
+        d = JSON_LIT(d, ",\"count\":");
+        d = json_put_u64(d, e->count);
+        d = JSON_LIT(d, ",\"first_ts\":");
+        d = put_ts(d, tc, e->first_ts, digits);
+        d = JSON_LIT(d, ",\"last_ts\":");
+        d = put_ts(d, tc, e->last_ts, digits);
+        break;
+
+    case BIN_REC_TAG:
+        d = JSON_LIT(d, ",\"event_type\":\"tag\",\"process_guid\":");
+        PUT_STR(d, e->guid);
+        d = JSON_LIT(d, ",\"rule_id\":");
+        PUT_STR(d, e->rule_id);
+        d = JSON_LIT(d, ",\"technique\":");
+        PUT_STR(d, e->technique);
+        d = JSON_LIT(d, ",\"severity\":");
+        if (e->severity < 0) *d++ = '-';
+        d = json_put_u32(d, e->severity < 0 ? 0u - (uint32_t)e->severity : (uint32_t)e->severity);
+        d = JSON_LIT(d, ",\"evidence\":");
+        PUT_STR(d, e->evidence);
+        break;
+
+    case BIN_REC_STATS:
+        d = JSON_LIT(d, ",\"event_type\":\"collector_stats\",\"host\":");
+        PUT_STR(d, e->host);
+        *d++ = ',';
+        d = json_put_raw(d, e->fields.p, e->fields.n);   // already JSON
+        break;
+    }
+
+    return JSON_LIT(d, "}\n");
+}
+
+int main(int argc, char** argv)
+{
+    int digits = 0;     // 0: from the file header (the writer's ts_digits)
+    int ai = 1;
+    if (ai < argc && strcmp(argv[ai], "--us") == 0) {
+        digits = 6;
+        ai++;
+    }
+    if (ai >= argc) {
+        fprintf(stderr, "usage: bin2jsonl [--us] <in.msb|-> [out.jsonl]\n");
+        return 2;
+    }
+
+    FILE* in = stdin;
+    if (strcmp(argv[ai], "-") != 0) in = fopen(argv[ai], "rb");
+#ifdef _WIN32
+    else _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    if (!in) {
+        fprintf(stderr, "cannot open %s\n", argv[ai]);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (ai + 1 < argc) out = fopen(argv[ai + 1], "wb");
+#ifdef _WIN32
+    else _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    if (!out) {
+        fprintf(stderr, "cannot open %s\n", argv[ai + 1]);
+        return 1;
+    }
+
+    BIN_READER r;
+    if (!bin_reader_open(&r, in)) {
+        fprintf(stderr, "not a binary telemetry file (bad header)\n");
+        return 1;
+    }
+    if (!digits) digits = r.ts_digits;
+
+    TS_CACHE tc;
+    ts_cache_init(&tc);
+
+    size_t cap = 64 * 1024;
+    char* line = (char*)malloc(cap);
+    if (!line) return 1;
+
+    BIN_EVENT e;
+    int rc;
+    while ((rc = bin_reader_next(&r, &e)) > 0) {
+        size_t need = line_bound(&e);
+        if (need > cap) {
+            char* nl = (char*)realloc(line, need);
+            if (!nl) break;
+            line = nl;
+            cap = need;
+        }
+        char* end = format_event(line, &e, &tc, digits);
+        fwrite(line, 1, (size_t)(end - line), out);
+    }
+
+    fprintf(stderr, "records=%llu events=%llu crc_errors=%llu bad=%llu%s\n",
+            (unsigned long long)r.st.records, (unsigned long long)r.st.events,
+            (unsigned long long)r.st.crc_errors, (unsigned long long)r.st.bad_records,
+            rc < 0 ? " (truncated)" : "");
+
+    free(line);
+    bin_reader_close(&r);
+    if (in != stdin) fclose(in);
+    if (out != stdout) fclose(out);
+    return rc < 0 ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+// ============================================================
+// linux_collector: netlink proc connector -> pipeline -> JSONL (linux_consumer.h)
+//   cc -O2 -I.. linux_collector.c ../linux_consumer.c ../pipeline.c ../replay.c
+//      ../event_writer.c ../event_ring.c ../event_dispatch.c ../jsonl_writer.c
+//      ../segment.c ../gz_deflate.c ../bin_format.c ../json_out.c ../ts_format.c
+//      ../mof_decode.c ../pid_map.c ../proc_table.c ../guid.c ../lat_hist.c ../collector_stats.c
+//      ../raw_queue.c ../scratch.c ../flow_agg.c ../event_filter.c ../rule_engine.c ../cmd_scan.c
+//      -lpthread -o linux_collector
+//   sudo ./linux_collector [--record raw.msyr] [--filter drop.conf] [--rules mitre_rules.yaml] [out.jsonl]
+// - out defaults to telemetry-raw.jsonl (rotation / compression from config.h)
+// - Ctrl+C / SIGTERM: stop, drain, print per-event overhead
+// ============================================================
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "guid.h"
+#include "jsonl_writer.h"
+#include "linux_consumer.h"
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    linux_consumer_request_stop();
+}
+
+static void to_wide(const char* s, wchar_t* out, size_t cap)
+{
+    size_t n = mbstowcs(out, s, cap - 1);
+    if (n == (size_t)-1) n = 0;
+    out[n] = L'\0';
+}
+
+int main(int argc, char** argv)
+{
+    const char* out_arg = "telemetry-raw.jsonl";
+    const char* rec_arg = NULL;
+    const char* filter_arg = NULL;
+    const char* rules_arg = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) rec_arg = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter_arg = argv[++i];
+        else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) rules_arg = argv[++i];
+        else out_arg = argv[i];
+    }
+
+    wchar_t out_path[1024], rec_path[1024], filter_path[1024], rules_path[1024];
+    to_wide(out_arg, out_path, 1024);
+    if (rec_arg) {
+        to_wide(rec_arg, rec_path, 1024);
+        linux_consumer_set_record_path(rec_path);
+    }
+    if (filter_arg) {
+        to_wide(filter_arg, filter_path, 1024);
+        linux_consumer_set_filter_path(filter_path);
+    }
+    if (rules_arg) {
+        to_wide(rules_arg, rules_path, 1024);
+        linux_consumer_set_rules_path(rules_path);
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (!jsonl_open(out_path)) {
+        fprintf(stderr, "output open failed: %s\n", out_arg);
+        return 1;
+    }
+    guid_init_boot_id();
+
+    int ok = linux_consume();
+    jsonl_close();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include "ts_format.h"
+
+#include <string.h>
+
+void ts_cache_init(TS_CACHE* c)
+{
+    c->sec = UINT64_MAX;
+    c->prefix[0] = '\0';
+}
+
+static void put2(char* d, unsigned v)
+{
+    d[0] = (char)('0' + v / 10);
+    d[1] = (char)('0' + v % 10);
+}
+
+// days since 1970-01-01 -> civil date (H. Hinnant, civil_from_days)
+static void civil_from_days(int64_t z, int64_t* y, unsigned* m, unsigned* d)
+{
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = (unsigned)(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t yy = (int64_t)yoe + era * 400;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = yy + (*m <= 2);
+}
+
+static void build_prefix(TS_CACHE* c, uint64_t sec1601)
+{
+    // 1601-01-01 -> 1970-01-01 = 134774 days
+    int64_t days = (int64_t)(sec1601 / 86400) - 134774;
+    unsigned sod = (unsigned)(sec1601 % 86400);
+
+    int64_t y;
+    unsigned mo, dd;
+    civil_from_days(days, &y, &mo, &dd);
+    if (y < 0) y = 0;
+    if (y > 9999) y = 9999;
+
+    char* p = c->prefix;
+    unsigned yy = (unsigned)y;
+    p[0] = (char)('0' + yy / 1000);
+    p[1] = (char)('0' + (yy / 100) % 10);
+    p[2] = (char)('0' + (yy / 10) % 10);
+    p[3] = (char)('0' + yy % 10);
+    p[4] = '-';
+    put2(p + 5, mo);
+    p[7] = '-';
+    put2(p + 8, dd);
+    p[10] = 'T';
+    put2(p + 11, sod / 3600);
+    p[13] = ':';
+    put2(p + 14, (sod / 60) % 60);
+    p[16] = ':';
+    put2(p + 17, sod % 60);
+    p[19] = '\0';
+
+    c->sec = sec1601;
+}
+
+size_t ts_format_filetime(TS_CACHE* c, uint64_t ft100ns, int digits, char out[TS_ISO_MAX])
+{
+    uint64_t sec = ft100ns / 10000000ULL;
+    uint32_t frac = (uint32_t)(ft100ns % 10000000ULL);   // 100ns units
+
+    if (sec != c->sec) build_prefix(c, sec);
+
+    memcpy(out, c->prefix, 19);
+    out[19] = '.';
+
+    // fraction: ms(3) or us(6)
+    uint32_t v;
+    int n;
+    if (digits >= 6) {
+        v = frac / 10;
+        n = 6;
+    } else {
+        v = frac / 10000;
+        n = 3;
+    }
+    for (int i = n; i > 0; i--) {
+        out[19 + i] = (char)('0' + v % 10);
+        v /= 10;
+    }
+    out[20 + n] = 'Z';
+    out[21 + n] = '\0';
+    return (size_t)(21 + n);
+}
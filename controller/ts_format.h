@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// FILETIME (100ns since 1601-01-01 UTC) -> ISO8601 "YYYY-MM-DDTHH:MM:SS.fffZ"
+// - "YYYY-MM-DDTHH:MM:SS" prefix is cached per second, only the fraction
+//   digits are patched per call (no syscall, no printf)
+// - portable
+// ============================================================
+
+#define TS_ISO_MAX 32   // incl. NUL
+
+typedef struct TS_CACHE {
+    uint64_t sec;       // FILETIME seconds of cached prefix (UINT64_MAX: empty)
+    char prefix[20];    // 19 chars + NUL
+} TS_CACHE;
+
+void ts_cache_init(TS_CACHE* c);
+
+// digits: 3 (ms) or 6 (us). returns length (without NUL)
+size_t ts_format_filetime(TS_CACHE* c, uint64_t ft100ns, int digits, char out[TS_ISO_MAX]);
+
+// FILETIME <-> unix epoch helpers
+#define TS_FILETIME_UNIX_EPOCH 116444736000000000ULL